@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include "lexer/string_pool.hpp"
+
+class Name;
+// 全局标识符驻留表，编号即 Name 的编号
+using Interner = StringPool<Name>;
+
+// 驻留后的名字。相等比较与哈希都只看编号。
+// 由字符串构造时要查驻留表，且驻留表不是线程安全的，因此构造与取回字符串都须显式写出；
+// 反复用到的固定名字见 names 中预先驻留的常量
+class Name {
+private:
+    uint32_t id = 0;
+public:
+    Name() = default;
+    explicit Name(std::string_view text): id(Interner::global().intern(text)) {}
+
+    static Name fromId(uint32_t);
+    uint32_t getId() const { return id; }
+    bool empty() const { return id == 0; }
+    const std::string& str() const { return Interner::global().str(id); }
+
+    bool operator==(const Name& other) const { return id == other.id; }
+    bool operator!=(const Name& other) const { return id != other.id; }
+};
+
+std::string operator+(const std::string&, const Name&);
+std::string operator+(const Name&, const std::string&);
+std::string operator+(const char*, const Name&);
+std::string operator+(const Name&, const char*);
+std::ostream& operator<<(std::ostream&, const Name&);
+
+template <>
+struct std::hash<Name> {
+    size_t operator()(const Name& name) const noexcept { return name.getId(); }
+};
+
+// 固定名字在进入 main 之前驻留一次，之后只比编号，解析线程中也不必再查驻留表。
+// 这里是语法分析自己生成的名字，语义分析用到的见 semantic/names.hpp
+namespace names {
+inline const Name kSelfValue{"self"};
+inline const Name kSelfType{"Self"};
+}
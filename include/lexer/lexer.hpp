@@ -1,225 +1,54 @@
 #pragma once
 
-#include <boost/regex.hpp>
-
-enum class Token {
-    // strict keywords
-    kAs,
-    kBreak,
-    kConst,
-    kContinue,
-    kCrate,
-    kElse,
-    kEnum,
-    kFalse,
-    kFn,
-    kFor,
-    kIf,
-    kImpl,
-    kIn,
-    kLet,
-    kLoop,
-    kMatch,
-    kMod,
-    kMove,
-    kMut,
-    // kPub, do not need to implement
-    kRef,
-    kReturn,
-    kSelf, // self
-    kSelf_, // Self
-    kStatic,
-    kStruct,
-    kSuper,
-    kTrait,
-    kTrue,
-    kType,
-    kUnsafe,
-    kUse,
-    kWhere,
-    kWhile,
-    kDyn,
-
-    // identifier
-    kIdentifier,
-
-    // comments
-    kComment,
-
-    // literals
-    kCharLiteral,
-    kStringLiteral,
-    kRawStringLiteral,
-    kCStringLiteral,
-    kRawCStringLiteral,
-    kIntegerLiteral,
-
-    // punctuations
-    kPlus,
-    kMinus,
-    kStar,
-    kSlash,
-    kPercent,
-    kCaret,
-    kNot,
-    kAnd,
-    kOr,
-    kAndAnd,
-    kOrOr,
-    kShl,
-    kShr,
-    kPlusEq,
-    kMinusEq,
-    kStarEq,
-    kSlashEq,
-    kPercentEq,
-    kCaretEq,
-    kAndEq,
-    kOrEq,
-    kShlEq,
-    kShrEq,
-    kEq,
-    kEqEq,
-    kNe,
-    kGt,
-    kLt,
-    kGe,
-    kLe,
-    kAt,
-    kUnderscore,
-    kDot,
-    kDotDot,
-    kDotDotDot,
-    kDotDotEq,
-    kComma,
-    kSemi,
-    kColon,
-    kPathSep,
-    kRArrow,
-    kFatArrow,
-    kLArrow,
-    kPound,
-    kDollar,
-    kQuestion,
-    kTilde,
-
-    // delimiters
-    kLCurly,
-    kRCurly,
-    kLSquare,
-    kRSquare,
-    kLParenthese,
-    kRParenthese,
-
-    kEOF,
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "lexer/token.hpp"
+#include "lexer/token_ring.hpp"
+#include "lexer/token_stream.hpp"
+
+// 对源码的一次编辑：把 [begin, end) 替换为 text
+struct TextEdit {
+    size_t begin;
+    size_t end;
+    std::string text;
 };
 
 class Lexer {
 private:
-    std::vector<std::pair<Token, boost::regex>> patterns = {
-        {Token::kAs, boost::regex("as")},
-        {Token::kBreak, boost::regex("break")},
-        {Token::kConst, boost::regex("const")},
-        {Token::kContinue, boost::regex("continue")},
-        {Token::kCrate, boost::regex("crate")},
-        {Token::kElse, boost::regex("else")},
-        {Token::kEnum, boost::regex("enum")},
-        {Token::kFalse, boost::regex("false")},
-        {Token::kFn, boost::regex("fn")},
-        {Token::kFor, boost::regex("for")},
-        {Token::kIf, boost::regex("if")},
-        {Token::kImpl, boost::regex("impl")},
-        {Token::kIn, boost::regex("in")},
-        {Token::kLet, boost::regex("let")},
-        {Token::kLoop, boost::regex("loop")},
-        {Token::kMatch, boost::regex("match")},
-        {Token::kMod, boost::regex("mod")},
-        {Token::kMove, boost::regex("move")},
-        {Token::kMut, boost::regex("mut")},
-        {Token::kRef, boost::regex("ref")},
-        {Token::kReturn, boost::regex("return")},
-        {Token::kSelf, boost::regex("self")},
-        {Token::kSelf_, boost::regex("Self")},
-        {Token::kStatic, boost::regex("static")},
-        {Token::kStruct, boost::regex("struct")},
-        {Token::kSuper, boost::regex("super")},
-        {Token::kTrait, boost::regex("trait")},
-        {Token::kTrue, boost::regex("true")},
-        {Token::kType, boost::regex("type")},
-        {Token::kUnsafe, boost::regex("unsafe")},
-        {Token::kUse, boost::regex("use")},
-        {Token::kWhere, boost::regex("where")},
-        {Token::kWhile, boost::regex("while")},
-        {Token::kDyn, boost::regex("dyn")},
-
-        {Token::kIdentifier, boost::regex("[a-zA-Z][a-zA-Z0-9_]*")},
-
-        // {Token::kComment, boost::regex("((//([^\\n])*(\\n)?)|(\\/\\*[\\s\\S]*\\*\\/))")},
-
-        {Token::kCharLiteral, boost::regex(R"('([^'\\\n\r\t]|\\'|\\"|\\x[0-7][0-9a-fA-F]|\\n|\\r|\\t|\\\\|\\0)')")},
-        {Token::kStringLiteral, boost::regex(R"("(([^"\\\r\t])|(\\')|(\\")|((\\x[0-7][0-9a-fA-F])|(\\n)|(\\r)|(\\t)|(\\\\)|(\\0))|(\\\n))*"([a-zA-Z][a-zA-Z0-9_]*)?)")},
-        {Token::kRawStringLiteral, boost::regex(R"(r([#]+)([^\r])*?(\1))")},
-        {Token::kCStringLiteral, boost::regex(R"(c"(([^"\\\r\0])|(\\x[0-7][0-9a-fA-F])|(\\n)|(\\r)|(\\t)|\\\\|(\\\n))*")")},
-        {Token::kRawCStringLiteral, boost::regex(R"(cr([#]+)([^\r\0])*?(\1))")},
-        {Token::kIntegerLiteral, boost::regex("((0b[0-1_]*[0-1][0-1_]*)|(0o[0-7_]*[0-7][0-7_]*)|(0x[0-9a-fA-F_]*[0-9a-fA-F][0-9a-fA-F_]*)|([0-9][0-9_]*))((u32)|(i32)|(usize)|(isize))?")},
-
-        {Token::kPlus, boost::regex(R"(\+)")},
-        {Token::kMinus, boost::regex("-")},
-        {Token::kStar, boost::regex(R"(\*)")},
-        {Token::kSlash, boost::regex(R"(/)")},
-        {Token::kPercent, boost::regex(R"(%)")},
-        {Token::kCaret, boost::regex(R"(\^)")},
-        {Token::kNot, boost::regex(R"(!)")},
-        {Token::kAnd, boost::regex(R"(&)")},
-        {Token::kOr, boost::regex(R"(\|)")},
-        {Token::kAndAnd, boost::regex(R"(&&)")},
-        {Token::kOrOr, boost::regex(R"(\|\|)")},
-        {Token::kShl, boost::regex(R"(<<)")},
-        {Token::kShr, boost::regex(R"(>>)")},
-        {Token::kPlusEq, boost::regex(R"(\+=)")},
-        {Token::kMinusEq, boost::regex(R"(-=)")},
-        {Token::kStarEq, boost::regex(R"(\*=)")},
-        {Token::kSlashEq, boost::regex(R"(/=)")},
-        {Token::kPercentEq, boost::regex(R"(%=)")},
-        {Token::kCaretEq, boost::regex(R"(\^=)")},
-        {Token::kAndEq, boost::regex(R"(&=)")},
-        {Token::kOrEq, boost::regex(R"(\|=)")},
-        {Token::kShlEq, boost::regex(R"(<<=)")},
-        {Token::kShrEq, boost::regex(R"(>>=)")},
-        {Token::kEq, boost::regex(R"(=)")},
-        {Token::kEqEq, boost::regex(R"(==)")},
-        {Token::kNe, boost::regex(R"(!=)")},
-        {Token::kGt, boost::regex(R"(>)")},
-        {Token::kLt, boost::regex(R"(<)")},
-        {Token::kGe, boost::regex(R"(>=)")},
-        {Token::kLe, boost::regex(R"(<=)")},
-        {Token::kAt, boost::regex(R"(@)")},
-        {Token::kUnderscore, boost::regex(R"(_)")},
-        {Token::kDot, boost::regex(R"(\.)")},
-        {Token::kDotDot, boost::regex(R"(\.\.)")},
-        {Token::kDotDotDot, boost::regex(R"(\.\.\.)")},
-        {Token::kDotDotEq, boost::regex(R"(\.\.=)")},
-        {Token::kComma, boost::regex(R"(,)")},
-        {Token::kSemi, boost::regex(R"(;)")},
-        {Token::kColon, boost::regex(R"(:)")},
-        {Token::kPathSep, boost::regex(R"(::)")},
-        {Token::kRArrow, boost::regex(R"(->)")},
-        {Token::kFatArrow, boost::regex(R"(=>)")},
-        {Token::kLArrow, boost::regex(R"(<-)")},
-        {Token::kPound, boost::regex(R"(#)")},
-        {Token::kDollar, boost::regex(R"(\$)")},
-        {Token::kQuestion, boost::regex(R"(\?)")},
-        {Token::kTilde, boost::regex(R"(~)")},
-
-        {Token::kLCurly, boost::regex(R"(\{)")},
-        {Token::kRCurly, boost::regex(R"(\})")},
-        {Token::kLSquare, boost::regex(R"(\[)")},
-        {Token::kRSquare, boost::regex(R"(\])")},
-        {Token::kLParenthese, boost::regex(R"(\()")},
-        {Token::kRParenthese, boost::regex(R"(\))")},
-    };
+    // 输入不小于该字节数时按块并行扫描
+    size_t parallel_threshold = size_t(4) << 20;
+    // 并行扫描的线程数，0 表示取硬件并发数
+    size_t thread_count = 0;
+
+    size_t skipTrivia(std::string_view, size_t);
+    std::pair<Token, size_t> scanToken(std::string_view, size_t);
+    std::pair<Token, size_t> matchPattern(std::string_view, size_t);
+    // 从停靠位置 i 扫描一个 token，返回下一个停靠位置（已跳过空白与注释）
+    size_t lexStep(std::string_view, size_t i, TokenStream&);
+    // 从 begin 开始扫描，直到停靠位置不小于 end，返回最终的停靠位置
+    size_t lexRange(std::string_view, size_t begin, size_t end, TokenStream&);
 public:
-    std::vector<std::pair<Token, std::string>> lex(std::string);
-};
-
-std::string tokenToString(Token token);
\ No newline at end of file
+    // 手写的最长匹配状态机，一趟扫描；token 只记录在源码中的偏移与长度
+    TokenStream lex(std::shared_ptr<const SourceBuffer>);
+    TokenStream lex(std::string);
+    // 将输入切成 chunks 块并行扫描后拼接，结果与顺序扫描完全一致
+    TokenStream lexParallel(std::shared_ptr<const SourceBuffer>, size_t chunks);
+
+    // 流式扫描：每扫描出一批 token 就写入 ring，以 kEOF 结束；消费者关闭队列时提前返回
+    void lexStreaming(std::shared_ptr<const SourceBuffer>, TokenRing& ring);
+    // 增量扫描：在 tokens 上应用编辑，只重扫受影响的区间并拼回原 token 数组，返回重扫的 token 数。
+    // 结果与对编辑后全文调用 lex 完全一致。扫描与校验只涉及编辑附近，但仍要拷贝整份源码、
+    // 平移编辑点之后全部 token 的偏移，这部分开销与文件大小成正比
+    size_t relex(TokenStream& tokens, const TextEdit& edit);
+
+    void setParallelThreshold(size_t bytes) { parallel_threshold = bytes; }
+    void setThreadCount(size_t threads) { thread_count = threads; }
+    // UTF-8 校验，非法时抛出 std::runtime_error。lex 按块与扫描交替校验，
+    // lexParallel 与流式扫描在扫描前整体校验一遍，relex 只校验新插入的文本
+    static void validateSource(const SourceBuffer&);
+    static void validateSource(const SourceBuffer&, size_t begin, size_t end);
+    // 基于正则表达式表的参考实现，用于一致性与性能对比
+    TokenStream lexReference(std::shared_ptr<const SourceBuffer>);
+};
\ No newline at end of file
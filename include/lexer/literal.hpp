@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include "lexer/string_pool.hpp"
+#include "lexer/token.hpp"
+
+enum class IntegerSuffix {
+    kNone,
+    kI32,
+    kU32,
+    kISize,
+    kUSize,
+};
+
+// 词法分析时解码好的整数字面量
+struct IntegerValue {
+    uint64_t value = 0; // 超出 64 位时饱和为 UINT64_MAX
+    uint8_t radix = 10; // 2、8、10 或 16
+    IntegerSuffix suffix = IntegerSuffix::kNone;
+};
+
+// text 须为一个完整的 kIntegerLiteral token
+IntegerValue decodeIntegerLiteral(std::string_view text);
+
+// 去掉引号、分隔符与后缀并展开转义后的字符、字符串字面量内容。
+// kind 为 kCharLiteral、kStringLiteral、kRawStringLiteral、kCStringLiteral 或 kRawCStringLiteral，
+// text 须为对应的完整 token
+std::string decodeTextLiteral(Token kind, std::string_view text);
+
+class LiteralId;
+// 全局字面量池：相同内容的字符、字符串字面量只保存一份，编号即 LiteralId 的编号
+using LiteralPool = StringPool<LiteralId>;
+
+// 字面量池中的一项，相等比较只看编号
+class LiteralId {
+private:
+    uint32_t id = 0;
+public:
+    LiteralId() = default;
+    explicit LiteralId(std::string_view text): id(LiteralPool::global().intern(text)) {}
+
+    static LiteralId fromId(uint32_t);
+    uint32_t getId() const { return id; }
+    const std::string& str() const { return LiteralPool::global().str(id); }
+
+    bool operator==(const LiteralId& other) const { return id == other.id; }
+    bool operator!=(const LiteralId& other) const { return id != other.id; }
+};
+
+std::ostream& operator<<(std::ostream&, const LiteralId&);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+enum class SimdLevel {
+    kScalar,
+    kSSE2,
+    kAVX2,
+};
+
+// 词法分析中的批量字节扫描。首次调用时按 CPU 支持的指令集选择实现，
+// 非 x86 平台上始终使用逐字节的标量实现
+class SimdScanner {
+public:
+    static SimdLevel detect();
+    static SimdLevel level();
+    // 强制使用不高于 CPU 支持的指令集，便于对比测试
+    static void setLevel(SimdLevel);
+
+    // 从 i 开始跳过 ASCII 空白，返回第一个非空白字符的位置，不存在则返回 n
+    static size_t skipSpace(const char* p, size_t i, size_t n);
+    // 返回 [i, n) 中第一个等于 a、b、c、d 之一的字节位置，不存在则返回 n
+    static size_t findAny(const char* p, size_t i, size_t n, char a, char b, char c, char d);
+    // 校验 [i, n) 是否为合法的 UTF-8（i 须位于字符边界），返回第一个非法序列的位置，全部合法时返回 n。
+    // 纯 ASCII 的部分成块跳过；AVX2 下多字节序列也按 32 字节一块查表校验，其余实现逐个序列检查
+    static size_t validateUtf8(const char* p, size_t i, size_t n);
+};
+
+const char* simdLevelToString(SimdLevel);
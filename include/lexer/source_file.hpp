@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// 只读的源文件内容。普通文件通过 mmap 映射，并提示内核按顺序访问；
+// 管道等无法映射的输入则一次性读入内存
+class SourceFile {
+private:
+    const char* data = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+    std::string fallback;
+
+    void release();
+public:
+    SourceFile() = default;
+    SourceFile(const SourceFile&) = delete;
+    SourceFile& operator=(const SourceFile&) = delete;
+    SourceFile(SourceFile&&) noexcept;
+    SourceFile& operator=(SourceFile&&) noexcept;
+    ~SourceFile();
+
+    static SourceFile open(const std::string& path);
+    // 不接管 fd 的所有权
+    static SourceFile fromDescriptor(int fd);
+
+    std::string_view view() const;
+    size_t size() const { return length; }
+    bool isMapped() const { return mapped; }
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// 全局字符串驻留表：每个不同的字符串只保存一份，并分配一个稠密的 32 位编号，编号 0 保留给空串。
+// Id 是对外使用的编号类型（Name、LiteralId），只用来区分表，每种编号各有一张独立的表
+template <typename Id>
+class StringPool {
+private:
+    std::deque<std::string> strings;
+    std::unordered_map<std::string_view, uint32_t> ids;
+
+    StringPool() { intern(""); }
+public:
+    static StringPool& global() {
+        static StringPool pool;
+        return pool;
+    }
+
+    uint32_t intern(std::string_view text) {
+        auto it = ids.find(text);
+        if (it != ids.end()) return it->second;
+        uint32_t id = strings.size();
+        // deque 扩容时已有元素不会移动，键中的 string_view 始终有效
+        const std::string& stored = strings.emplace_back(text);
+        ids.emplace(stored, id);
+        return id;
+    }
+    const std::string& str(uint32_t id) const { return strings[id]; }
+    size_t size() const { return strings.size(); }
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <string>
+
+// 关键字表：Token 枚举、tokenToString 以及词法分析器的关键字哈希表都由这一份列表生成
+#define RCOMPILER_KEYWORDS(X) \
+    X(kAs, "as") \
+    X(kBreak, "break") \
+    X(kConst, "const") \
+    X(kContinue, "continue") \
+    X(kCrate, "crate") \
+    X(kElse, "else") \
+    X(kEnum, "enum") \
+    X(kFalse, "false") \
+    X(kFn, "fn") \
+    X(kFor, "for") \
+    X(kIf, "if") \
+    X(kImpl, "impl") \
+    X(kIn, "in") \
+    X(kLet, "let") \
+    X(kLoop, "loop") \
+    X(kMatch, "match") \
+    X(kMod, "mod") \
+    X(kMove, "move") \
+    X(kMut, "mut") \
+    /* kPub, do not need to implement */ \
+    X(kRef, "ref") \
+    X(kReturn, "return") \
+    X(kSelf, "self") \
+    X(kSelf_, "Self") \
+    X(kStatic, "static") \
+    X(kStruct, "struct") \
+    X(kSuper, "super") \
+    X(kTrait, "trait") \
+    X(kTrue, "true") \
+    X(kType, "type") \
+    X(kUnsafe, "unsafe") \
+    X(kUse, "use") \
+    X(kWhere, "where") \
+    X(kWhile, "while") \
+    X(kDyn, "dyn")
+
+enum class Token {
+    // strict keywords
+#define X(name, text) name,
+    RCOMPILER_KEYWORDS(X)
+#undef X
+
+    // identifier
+    kIdentifier,
+
+    // comments
+    kComment,
+
+    // literals
+    kCharLiteral,
+    kStringLiteral,
+    kRawStringLiteral,
+    kCStringLiteral,
+    kRawCStringLiteral,
+    kIntegerLiteral,
+
+    // punctuations
+    kPlus,
+    kMinus,
+    kStar,
+    kSlash,
+    kPercent,
+    kCaret,
+    kNot,
+    kAnd,
+    kOr,
+    kAndAnd,
+    kOrOr,
+    kShl,
+    kShr,
+    kPlusEq,
+    kMinusEq,
+    kStarEq,
+    kSlashEq,
+    kPercentEq,
+    kCaretEq,
+    kAndEq,
+    kOrEq,
+    kShlEq,
+    kShrEq,
+    kEq,
+    kEqEq,
+    kNe,
+    kGt,
+    kLt,
+    kGe,
+    kLe,
+    kAt,
+    kUnderscore,
+    kDot,
+    kDotDot,
+    kDotDotDot,
+    kDotDotEq,
+    kComma,
+    kSemi,
+    kColon,
+    kPathSep,
+    kRArrow,
+    kFatArrow,
+    kLArrow,
+    kPound,
+    kDollar,
+    kQuestion,
+    kTilde,
+
+    // delimiters
+    kLCurly,
+    kRCurly,
+    kLSquare,
+    kRSquare,
+    kLParenthese,
+    kRParenthese,
+
+    kEOF,
+};
+
+std::string tokenToString(Token token);
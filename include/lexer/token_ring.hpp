@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "lexer/token.hpp"
+#include "lexer/token_stream.hpp"
+
+// 环形队列中传递的 token，附加数据由消费者取出后再解析
+struct RawToken {
+    Token kind;
+    uint32_t offset;
+    uint32_t length;
+};
+
+// 单生产者单消费者的无锁环形队列，容量取 2 的幂
+class TokenRing {
+private:
+    std::vector<RawToken> slots;
+    size_t mask;
+    // 下一个待读的位置，只由消费者写入
+    alignas(64) std::atomic<size_t> head{0};
+    // 下一个待写的位置，只由生产者写入
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) std::atomic<bool> closed{false};
+public:
+    explicit TokenRing(size_t capacity);
+
+    // 生产者：写入 n 个 token，队列满时等待；消费者已关闭队列时返回 false
+    bool push(const RawToken* tokens, size_t n);
+    // 消费者：读出至多 max 个 token，队列空时等待，返回读出的个数
+    size_t pop(RawToken* out, size_t max);
+    // 消费者不再读取，让等待中的生产者退出
+    void close();
+};
+
+// 流式词法分析：在独立线程中扫描整份源码，依次写入环形队列，最后一个 token 为 kEOF
+class TokenPipe {
+private:
+    std::shared_ptr<const SourceBuffer> source;
+    TokenRing ring;
+    std::thread worker;
+public:
+    TokenPipe(std::shared_ptr<const SourceBuffer> source, size_t capacity);
+    ~TokenPipe();
+    TokenPipe(const TokenPipe&) = delete;
+    TokenPipe& operator=(const TokenPipe&) = delete;
+
+    // 读出至多 max 个 token，尚未扫描出时等待
+    size_t read(RawToken* out, size_t max) { return ring.pop(out, max); }
+    const std::shared_ptr<const SourceBuffer>& buffer() const { return source; }
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "lexer/interner.hpp"
+#include "lexer/literal.hpp"
+#include "lexer/source_file.hpp"
+#include "lexer/token.hpp"
+
+struct SourceLocation {
+    uint32_t line;   // 从 1 开始
+    uint32_t column; // 从 1 开始，按字节计
+};
+
+// 持有整份源码（内存中的字符串或映射的文件），token 只记录其中的偏移与长度
+class SourceBuffer {
+private:
+    std::string owned;
+    SourceFile file;
+    std::string_view text;
+    // 每一行起始处的字节偏移，首次查询位置时才建立。并行解析的各个线程共用同一份源码，
+    // 都可能在报错时查询位置，由 call_once 保证只建立一次
+    mutable std::vector<uint32_t> line_starts;
+    mutable std::once_flag line_starts_built;
+
+    void buildLineStarts() const;
+public:
+    explicit SourceBuffer(std::string text);
+    explicit SourceBuffer(SourceFile file);
+
+    std::string_view view() const;
+    size_t size() const;
+    SourceLocation location(uint32_t offset) const;
+};
+
+// 一次可能读到 token 之后任意远处的扫描：起始偏移，以及扫描最终停下的位置
+// （其后至多再读 kLookahead 个字节）
+struct FarScan {
+    uint32_t offset;
+    uint32_t reach;
+};
+
+// 词法分析结果，按结构体数组的形式存放：
+// 种类、起始偏移、长度分别是三个独立的数组，Parser::peek() 只需访问 kinds
+class TokenStream {
+private:
+    std::shared_ptr<const SourceBuffer> source;
+    std::vector<Token> kinds;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lengths;
+    // 每个 token 的附加数据：标识符为驻留后的名字编号，整数字面量为 integers 中的下标，
+    // 字符、字符串字面量为解码后内容在字面量池中的编号，其余为 0
+    std::vector<uint32_t> payloads;
+    std::vector<IntegerValue> integers;
+    // 扫描时读到了 token 之后任意远处的位置（失败的字面量尝试等），按偏移升序。
+    // 增量扫描据此判断编辑是否影响了编辑点之前的扫描
+    std::vector<FarScan> far_scans;
+public:
+    TokenStream() = default;
+    explicit TokenStream(std::shared_ptr<const SourceBuffer> source);
+
+    void reserve(size_t);
+    void clear();
+    void push(Token, uint32_t offset, uint32_t length);
+    // 追加 other 中从 from 开始的全部 token，二者须指向同一份源码
+    void append(const TokenStream& other, size_t from);
+    // 复制 [first, last) 中已解析附加数据的 token，末尾补一个位于第 last 个 token 处的 kEOF
+    TokenStream slice(size_t first, size_t last) const;
+    // 驻留从 from 开始的标识符，解码整数与字符、字符串字面量，填写 payloads
+    void resolvePayloads(size_t from = 0);
+    // 丢弃最前面的 count 个 token，整数表只保留剩余 token 用到的部分
+    void discardFront(size_t count);
+    void markFarScan(uint32_t offset, uint32_t reach) { far_scans.push_back({offset, reach}); }
+    // 用 replacement 替换 [first, last) 中的 token：region_begin 是被替换区域的起始偏移，
+    // last 及之后的 token 偏移平移 delta；region_begin 之前的远距离扫描若停在 edit_end 及之后，
+    // 停下的位置同样平移 delta。之后整个流指向 replacement 的源码
+    void splice(size_t first, size_t last, const TokenStream& replacement, uint32_t region_begin, uint32_t edit_end,
+                int64_t delta);
+
+    size_t size() const { return kinds.size(); }
+    Token kind(size_t i) const { return kinds[i]; }
+    uint32_t offset(size_t i) const { return offsets[i]; }
+    uint32_t length(size_t i) const { return lengths[i]; }
+    std::string_view text(size_t i) const { return source->view().substr(offsets[i], lengths[i]); }
+    SourceLocation location(size_t i) const { return source->location(offsets[i]); }
+    Name name(size_t i) const { return Name::fromId(payloads[i]); }
+    const IntegerValue& integer(size_t i) const { return integers[payloads[i]]; }
+    LiteralId literal(size_t i) const { return LiteralId::fromId(payloads[i]); }
+
+    const std::vector<Token>& getKinds() const { return kinds; }
+    const std::vector<FarScan>& getFarScans() const { return far_scans; }
+    const SourceBuffer& buffer() const { return *source; }
+    std::shared_ptr<const SourceBuffer> sharedBuffer() const { return source; }
+};
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+// 非 ASCII 码点是否可以开始 / 延续标识符（Unicode XID_Start / XID_Continue）
+bool isXidStart(uint32_t cp);
+bool isXidContinue(uint32_t cp);
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bump allocator that owns every AST node of one Crate. Nodes are constructed in place
+// inside large blocks and linked through plain pointers; they live exactly as long as
+// the arena. Nodes with non-trivial destructors are destroyed in reverse order of
+// creation when the arena goes away, then the blocks are released.
+class ASTArena {
+private:
+    static constexpr size_t kBlockSize = size_t(64) << 10;
+
+    struct Destructor {
+        void* object;
+        void (*destroy)(void*);
+    };
+
+    std::vector<std::unique_ptr<std::byte[]>> blocks;
+    std::byte* cursor = nullptr;
+    std::byte* limit = nullptr;
+    std::vector<Destructor> destructors;
+    size_t node_count = 0;
+    size_t bytes_used = 0;
+    size_t bytes_reserved = 0;
+
+    void* allocate(size_t size, size_t align) {
+        auto address = reinterpret_cast<uintptr_t>(cursor);
+        size_t padding = (align - address % align) % align;
+        if (cursor == nullptr || padding + size > size_t(limit - cursor)) {
+            grow(size + align);
+            address = reinterpret_cast<uintptr_t>(cursor);
+            padding = (align - address % align) % align;
+        }
+        std::byte* memory = cursor + padding;
+        cursor = memory + size;
+        bytes_used += size;
+        return memory;
+    }
+    void grow(size_t minimum);
+public:
+    ASTArena() = default;
+    ASTArena(const ASTArena&) = delete;
+    ASTArena& operator=(const ASTArena&) = delete;
+    ~ASTArena();
+
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        T* node = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            destructors.push_back({node, [](void* object) { static_cast<T*>(object)->~T(); }});
+        }
+        ++node_count;
+        return node;
+    }
+
+    // Takes over every node of `other`, which is left empty; they are destroyed together with this arena
+    void adopt(ASTArena&& other);
+
+    size_t nodeCount() const { return node_count; }
+    size_t bytesUsed() const { return bytes_used; }
+    size_t bytesReserved() const { return bytes_reserved; }
+};
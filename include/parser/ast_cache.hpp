@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "parser/astnode.hpp"
+
+// Crate 的二进制序列化。文件里只有节点种类、节点编号、标量字段和字符串表下标，不含指针，
+// 与加载地址无关；整数按宿主字节序写入。source 是解析出这棵树的源码，其长度与哈希记在文件头中，
+// 加载时与给出的 source 核对；整个文件另有一个校验和，解码前先行核对。
+// 延迟解析的函数体在写入前全部解析
+std::string serializeCrate(Crate& crate, std::string_view source);
+// 数据损坏、格式版本不符或与 source 不对应时抛出 std::runtime_error
+std::shared_ptr<Crate> deserializeCrate(std::string_view bytes, std::string_view source);
+
+// 以源码内容为键的 AST 缓存。缓存文件名是源码、格式版本与构建标识的哈希，命中时直接映射文件并还原出
+// Crate，跳过词法与语法分析。缓存文件只是加速手段：读不出来、内容不对一律当作未命中
+class ASTCache {
+public:
+    // 文件格式或 AST 结构变化时必须递增，旧的缓存文件随之失效。文件头中另记有构建标识：编译器版本与
+    // 构建系统对词法、语法分析源码内容求出的哈希（PARSER_BUILD_ID），这些源码有任何改动，其他构建
+    // 写下的缓存都不再使用；不经 CMake 构建、未定义该哈希时，只能靠递增版本号让旧缓存失效
+    static constexpr uint32_t kFormatVersion = 4;
+
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t invalid = 0; // 未命中中缓存文件存在但无法使用的次数
+        size_t stores = 0;
+        size_t bytes_loaded = 0;
+        size_t bytes_stored = 0;
+        double load_ms = 0;
+        double store_ms = 0;
+    };
+
+    explicit ASTCache(std::filesystem::path directory);
+
+    // 未命中时返回 nullptr
+    std::shared_ptr<Crate> load(std::string_view source);
+    // 写入临时文件后改名，并发的编译不会读到写了一半的文件；写入失败时静默放弃
+    void store(std::string_view source, Crate& crate);
+
+    std::filesystem::path pathFor(std::string_view source) const;
+    const Stats& stats() const { return statistics; }
+    void printStats(std::ostream&) const;
+private:
+    std::filesystem::path directory;
+    Stats statistics;
+};
@@ -2,144 +2,281 @@
 
 #include <vector>
 #include <memory>
+#include "lexer/interner.hpp"
+#include "lexer/literal.hpp"
+#include "parser/ast_arena.hpp"
+#include "parser/casting.hpp"
 #include "parser/utils.hpp"
-#include "parser/visitor.hpp"
 
 // 前向声明
 class ASTPrinter;
+class Parser;
+
+// 每个具体节点类对应一个 kind，构造时写入节点，配合 isa/cast/dyn_cast 判断节点类型。
+// 表达式节点的 kind 连续排列，Expression::classof 按区间判断
+enum class NodeKind : uint8_t {
+    kCrate,
+    kItem,
+    // 声明类节点
+    kFunction,
+    kStruct,
+    kEnumeration,
+    kConstantItem,
+    kTrait,
+    kImplementation,
+    kFunctionParameters,
+    kSelfParam,
+    kShorthandSelf,
+    kTypedSelf,
+    kFunctionParam,
+    kFunctionReturnType,
+    kStructStruct,
+    kStructFields,
+    kStructField,
+    kEnumVariants,
+    kEnumVariant,
+    kAssociatedItem,
+    kInherentImpl,
+    kTraitImpl,
+    // 语句类节点
+    kStatement,
+    kLetStatement,
+    kExpressionStatement,
+    kStatements,
+    // 表达式类节点
+    kCharLiteral,
+    kStringLiteral,
+    kRawStringLiteral,
+    kCStringLiteral,
+    kRawCStringLiteral,
+    kIntegerLiteral,
+    kBoolLiteral,
+    kPathExpression,
+    kUnaryExpression,
+    kBorrowExpression,
+    kDereferenceExpression,
+    kGroupedExpression,
+    kArrayExpression,
+    kIndexExpression,
+    kStructExpression,
+    kCallExpression,
+    kMethodCallExpression,
+    kFieldExpression,
+    kContinueExpression,
+    kBreakExpression,
+    kReturnExpression,
+    kBlockExpression,
+    kLoopExpression,
+    kInfiniteLoopExpression,
+    kPredicateLoopExpression,
+    kCondition,
+    kIfExpression,
+    kAssignmentExpression,
+    kCompoundAssignmentExpression,
+    kBinaryExpression,
+    kTypeCastExpression,
+    // 模式、类型与路径等辅助节点
+    kPatternNoTopAlt,
+    kIdentifierPattern,
+    kReferencePattern,
+    kType,
+    kReferenceType,
+    kArrayType,
+    kUnitType,
+    kPathInExpression,
+    kArrayElements,
+    kStructExprFields,
+    kStructExprField,
+    kCallParams,
+    kPathIdentSegment,
+    // 错误恢复模式下代替无法解析的项或语句
+    kErrorNode,
+
+    kFirstExpression = kCharLiteral,
+    kLastExpression = kTypeCastExpression,
+};
+
+// 节点编号：解析时按创建顺序分配，同一 Crate 内从 0 起连续，用作附加信息表（NodeTable）的下标
+using NodeId = uint32_t;
 
 class ASTNode {
 public:
-    bool mutability;
-    std::string type;
-    ASTNode() = default;
-    virtual ~ASTNode() = default;
-    virtual void accept(ASTVisitor*) = 0;
+    const NodeKind kind;
+    NodeId id = 0;
+    explicit ASTNode(NodeKind kind) : kind(kind) {}
+    static bool classof(const ASTNode*) { return true; }
 };
 
+// 语法上带块的表达式：if、循环与块表达式
+inline bool isExpressionWithBlock(const ASTNode* node) {
+    return node->kind == NodeKind::kIfExpression
+        || node->kind == NodeKind::kLoopExpression
+        || node->kind == NodeKind::kBlockExpression;
+}
+
+// 根节点，持有整棵树所在的 arena：其余节点都分配在 arena 中，随 Crate 一起释放
 class Crate : public ASTNode {
 public:
-    std::vector<std::shared_ptr<Item>> items;
+    std::vector<Item*> items;
+    std::unique_ptr<ASTArena> arena;
+    // 整棵树的节点编号都小于 node_count（包括 Crate 自身）；延迟解析的函数体解析后会继续增长
+    size_t node_count = 0;
+    // 延迟解析模式下负责解析函数体的解析器，持有全部 token 与函数体节点所在的 arena
+    std::unique_ptr<Parser> lazy_parser;
 public:
-    Crate(std::vector<std::shared_ptr<Item>>&& items)
-        : items(std::move(items)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    Crate(std::vector<Item*>&& items, std::unique_ptr<ASTArena> arena);
+    ~Crate();
+    // 解析全部尚未解析的函数体
+    void parseLazyBodies();
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kCrate; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        for (auto* child : items) f(child);
     }
 };
 
 class Item : public ASTNode {
 public:
-    std::shared_ptr<ASTNode> item; // Function, Struct, Enumeration, ConstantItem, Trait, Implementation
+    ASTNode* item = nullptr; // Function, Struct, Enumeration, ConstantItem, Trait, Implementation
 public:
-    Item(std::shared_ptr<ASTNode> item)
-        : item(std::move(item)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    Item(ASTNode* item)
+        : ASTNode(NodeKind::kItem), item(std::move(item)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kItem; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(item);
     }
 };
 
 class Function : public ASTNode {
 public:
     bool is_const;
-    std::string identifier;
-    std::shared_ptr<FunctionParameters> function_parameters;
-    std::shared_ptr<FunctionReturnType> function_return_type;
-    std::shared_ptr<BlockExpression> block_expression;
+    Name identifier;
+    FunctionParameters* function_parameters = nullptr;
+    FunctionReturnType* function_return_type = nullptr;
+    BlockExpression* block_expression = nullptr;
+    // 延迟解析时 lazy_parser 非空，函数体尚未解析，位于 token 区间 [body_begin, body_end)
+    Parser* lazy_parser = nullptr;
+    uint32_t body_begin = 0;
+    uint32_t body_end = 0;
 public:
     Function(bool is_const,
-        std::string identifier,
-        std::shared_ptr<FunctionParameters> function_parameters,
-        std::shared_ptr<FunctionReturnType> function_return_type,
-        std::shared_ptr<BlockExpression> block_expression)
-        : is_const(is_const),
+        Name identifier,
+        FunctionParameters* function_parameters,
+        FunctionReturnType* function_return_type,
+        BlockExpression* block_expression)
+        : ASTNode(NodeKind::kFunction), is_const(is_const),
         identifier(std::move(identifier)),
         function_parameters(std::move(function_parameters)),
         function_return_type(std::move(function_return_type)),
         block_expression(std::move(block_expression)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kFunction; }
+    // 函数体，没有函数体时为 nullptr；延迟解析的函数体在第一次调用时解析，不是线程安全的
+    BlockExpression* body();
+    // 是否有函数体，不会触发解析
+    bool hasBody() const { return block_expression || lazy_parser; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(function_parameters);
+        f(function_return_type);
+        f(body());
     }
 };
 
 class Struct : public ASTNode {
 public:
-    std::shared_ptr<StructStruct> struct_struct;
+    StructStruct* struct_struct = nullptr;
 public:
-    Struct(std::shared_ptr<StructStruct> struct_struct)
-        : struct_struct(std::move(struct_struct)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    Struct(StructStruct* struct_struct)
+        : ASTNode(NodeKind::kStruct), struct_struct(std::move(struct_struct)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kStruct; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(struct_struct);
     }
 };
 
 class Enumeration : public ASTNode {
 public:
-    std::string identifier;
-    std::shared_ptr<EnumVariants> enum_variants;
+    Name identifier;
+    EnumVariants* enum_variants = nullptr;
 public:
-    Enumeration(std::string identifier, std::shared_ptr<EnumVariants> enum_variants)
-        : identifier(std::move(identifier)), enum_variants(std::move(enum_variants)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    Enumeration(Name identifier, EnumVariants* enum_variants)
+        : ASTNode(NodeKind::kEnumeration), identifier(std::move(identifier)), enum_variants(std::move(enum_variants)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kEnumeration; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(enum_variants);
     }
 };
     
 class ConstantItem : public ASTNode {
 public:
-    std::string identifier;
-    std::shared_ptr<Type> type;
-    std::shared_ptr<Expression> expression;
+    Name identifier;
+    Type* type = nullptr;
+    Expression* expression = nullptr;
 public:
-    ConstantItem(std::string identifier, std::shared_ptr<Type> type, std::shared_ptr<Expression> expression)
-        : identifier(std::move(identifier)), type(std::move(type)), expression(std::move(expression)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    ConstantItem(Name identifier, Type* type, Expression* expression)
+        : ASTNode(NodeKind::kConstantItem), identifier(std::move(identifier)), type(std::move(type)), expression(std::move(expression)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kConstantItem; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(type);
+        f(expression);
     }
 };
 
 class Trait : public ASTNode {
 public:
-    std::string identifier;
-    std::vector<std::shared_ptr<AssociatedItem>> associated_item;
+    Name identifier;
+    std::vector<AssociatedItem*> associated_item;
 public:
-    Trait(std::string identifier, std::vector<std::shared_ptr<AssociatedItem>> associated_item)
-        : identifier(std::move(identifier)), associated_item(std::move(associated_item)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    Trait(Name identifier, std::vector<AssociatedItem*> associated_item)
+        : ASTNode(NodeKind::kTrait), identifier(std::move(identifier)), associated_item(std::move(associated_item)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kTrait; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        for (auto* child : associated_item) f(child);
     }
 };
 
 class Implementation : public ASTNode {
 public:
-    std::shared_ptr<ASTNode> impl; // InherentImpl, TraitImpl
+    ASTNode* impl = nullptr; // InherentImpl, TraitImpl
 public:
-    Implementation(std::shared_ptr<ASTNode> impl) : impl(std::move(impl)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    Implementation(ASTNode* impl) : ASTNode(NodeKind::kImplementation), impl(std::move(impl)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kImplementation; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(impl);
     }
 };
 
 class FunctionParameters : public ASTNode {
 public:
-    std::shared_ptr<SelfParam> self_param;
-    std::vector<std::shared_ptr<FunctionParam>> function_param;
+    SelfParam* self_param = nullptr;
+    std::vector<FunctionParam*> function_param;
 public:
-    FunctionParameters(std::shared_ptr<SelfParam> self_param, std::vector<std::shared_ptr<FunctionParam>> function_param)
-        : self_param(std::move(self_param)), function_param(std::move(function_param)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    FunctionParameters(SelfParam* self_param, std::vector<FunctionParam*> function_param)
+        : ASTNode(NodeKind::kFunctionParameters), self_param(std::move(self_param)), function_param(std::move(function_param)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kFunctionParameters; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(self_param);
+        for (auto* child : function_param) f(child);
     }
 };
 
 class SelfParam : public ASTNode {
 public:
-    std::shared_ptr<ASTNode> child; // ShorthandSelf, TypedSelf
+    ASTNode* child = nullptr; // ShorthandSelf, TypedSelf
 public:
-    SelfParam(std::shared_ptr<ASTNode> child)
-        : child(std::move(child)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    SelfParam(ASTNode* child)
+        : ASTNode(NodeKind::kSelfParam), child(std::move(child)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kSelfParam; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(child);
     }
 };
 
@@ -149,21 +286,23 @@ public:
     bool is_mutable;
 public:
     ShorthandSelf(bool is_reference, bool is_mutable)
-        : is_reference(is_reference), is_mutable(is_mutable) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }
+        : ASTNode(NodeKind::kShorthandSelf), is_reference(is_reference), is_mutable(is_mutable) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kShorthandSelf; }
+    template <typename F>
+    void forEachChild(F&&) {}
 };
 
 class TypedSelf : public ASTNode {
 public:
     bool is_mutable;
-    std::shared_ptr<Type> type;
+    Type* type = nullptr;
 public:
-    TypedSelf(bool is_mutable, std::shared_ptr<Type> type)
-        : is_mutable(is_mutable), type(std::move(type)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    TypedSelf(bool is_mutable, Type* type)
+        : ASTNode(NodeKind::kTypedSelf), is_mutable(is_mutable), type(std::move(type)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kTypedSelf; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(type);
     }
     
     friend class ASTPrinter;
@@ -171,13 +310,16 @@ public:
 
 class FunctionParam : public ASTNode {
 public:
-    std::shared_ptr<PatternNoTopAlt> pattern_no_top_alt;
-    std::shared_ptr<Type> type;
+    PatternNoTopAlt* pattern_no_top_alt = nullptr;
+    Type* type = nullptr;
 public:
-    FunctionParam(std::shared_ptr<PatternNoTopAlt> pattern_no_top_alt, std::shared_ptr<Type> type)
-        : pattern_no_top_alt(std::move(pattern_no_top_alt)), type(std::move(type)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    FunctionParam(PatternNoTopAlt* pattern_no_top_alt, Type* type)
+        : ASTNode(NodeKind::kFunctionParam), pattern_no_top_alt(std::move(pattern_no_top_alt)), type(std::move(type)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kFunctionParam; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(pattern_no_top_alt);
+        f(type);
     }
     
     friend class ASTPrinter;
@@ -185,12 +327,14 @@ public:
 
 class FunctionReturnType : public ASTNode {
 public:
-    std::shared_ptr<Type> type;
+    Type* type = nullptr;
 public:
-    FunctionReturnType(std::shared_ptr<Type> type)
-        : type(std::move(type)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    FunctionReturnType(Type* type)
+        : ASTNode(NodeKind::kFunctionReturnType), type(std::move(type)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kFunctionReturnType; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(type);
     }
     
     friend class ASTPrinter;
@@ -198,272 +342,270 @@ public:
 
 class StructStruct : public ASTNode {
 public:
-    std::string identifier;
-    std::shared_ptr<StructFields> struct_fields;
+    Name identifier;
+    StructFields* struct_fields = nullptr;
 public:
-    StructStruct(std::string identifier, std::shared_ptr<StructFields> struct_fields)
-        : identifier(std::move(identifier)), struct_fields(std::move(struct_fields)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    StructStruct(Name identifier, StructFields* struct_fields)
+        : ASTNode(NodeKind::kStructStruct), identifier(std::move(identifier)), struct_fields(std::move(struct_fields)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kStructStruct; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(struct_fields);
     }
 };
 
 class StructFields : public ASTNode {
 public:
-    std::vector<std::shared_ptr<StructField>> struct_fields;
+    std::vector<StructField*> struct_fields;
 public:
-    StructFields(std::vector<std::shared_ptr<StructField>> struct_fields)
-        : struct_fields(std::move(struct_fields)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    StructFields(std::vector<StructField*> struct_fields)
+        : ASTNode(NodeKind::kStructFields), struct_fields(std::move(struct_fields)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kStructFields; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        for (auto* child : struct_fields) f(child);
     }
 };
 
 class StructField : public ASTNode {
 public:
-    std::string identifier;
-    std::shared_ptr<Type> type;
+    Name identifier;
+    Type* type = nullptr;
 public:
-    StructField(std::string identifier, std::shared_ptr<Type> type)
-        : identifier(std::move(identifier)), type(std::move(type)){}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    StructField(Name identifier, Type* type)
+        : ASTNode(NodeKind::kStructField), identifier(std::move(identifier)), type(std::move(type)){}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kStructField; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(type);
     }
 };
 
 class EnumVariants : public ASTNode {
 public:
-    std::vector<std::shared_ptr<EnumVariant>> enum_variant;
+    std::vector<EnumVariant*> enum_variant;
 public:
-    EnumVariants(std::vector<std::shared_ptr<EnumVariant>> enum_variant)
-        : enum_variant(std::move(enum_variant)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    EnumVariants(std::vector<EnumVariant*> enum_variant)
+        : ASTNode(NodeKind::kEnumVariants), enum_variant(std::move(enum_variant)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kEnumVariants; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        for (auto* child : enum_variant) f(child);
     }
 };
 
 class EnumVariant : public ASTNode {
 public:
-    std::string identifier;
+    Name identifier;
 public:
-    EnumVariant(std::string identifier)
-        : identifier(identifier) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }    
+    EnumVariant(Name identifier)
+        : ASTNode(NodeKind::kEnumVariant), identifier(identifier) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kEnumVariant; }
+    template <typename F>
+    void forEachChild(F&&) {}
 };
 
 class AssociatedItem : public ASTNode {
 public:
-    std::shared_ptr<ASTNode> child; // ConstantItem, Function
+    ASTNode* child = nullptr; // ConstantItem, Function
 public:
-    AssociatedItem(std::shared_ptr<ASTNode> child)
-        : child(std::move(child)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    AssociatedItem(ASTNode* child)
+        : ASTNode(NodeKind::kAssociatedItem), child(std::move(child)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kAssociatedItem; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(child);
     }
 };
 
 class InherentImpl : public ASTNode {
 public:
-    std::shared_ptr<Type> type;
-    std::vector<std::shared_ptr<AssociatedItem>> associated_item;
+    Type* type = nullptr;
+    std::vector<AssociatedItem*> associated_item;
 public:
-    InherentImpl(std::shared_ptr<Type> type, std::vector<std::shared_ptr<AssociatedItem>> associated_item)
-        : type(std::move(type)), associated_item(std::move(associated_item)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    InherentImpl(Type* type, std::vector<AssociatedItem*> associated_item)
+        : ASTNode(NodeKind::kInherentImpl), type(std::move(type)), associated_item(std::move(associated_item)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kInherentImpl; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(type);
+        for (auto* child : associated_item) f(child);
     }
 };
 class TraitImpl : public ASTNode {
 public:
-    std::string identifier;
-    std::shared_ptr<Type> type;
-    std::vector<std::shared_ptr<AssociatedItem>> associated_item;
+    Name identifier;
+    Type* type = nullptr;
+    std::vector<AssociatedItem*> associated_item;
 public:
-    TraitImpl(std::string identifier, std::shared_ptr<Type> type, std::vector<std::shared_ptr<AssociatedItem>> associated_item)
-    : identifier(std::move(identifier)), type(std::move(type)), associated_item(std::move(associated_item)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    TraitImpl(Name identifier, Type* type, std::vector<AssociatedItem*> associated_item)
+    : ASTNode(NodeKind::kTraitImpl), identifier(std::move(identifier)), type(std::move(type)), associated_item(std::move(associated_item)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kTraitImpl; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(type);
+        for (auto* child : associated_item) f(child);
     }
 };
 
 class Statement : public ASTNode {
 public:
-    std::shared_ptr<ASTNode> child; // nullptr(,), Item, LetStatement, ExpressionStatement
+    ASTNode* child = nullptr; // nullptr(,), Item, LetStatement, ExpressionStatement
 public:
-    Statement(std::shared_ptr<ASTNode> child)
-        : child(std::move(child)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    Statement(ASTNode* child)
+        : ASTNode(NodeKind::kStatement), child(std::move(child)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kStatement; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(child);
     }
 };
 
 class LetStatement : public ASTNode {
 public:
-    std::shared_ptr<PatternNoTopAlt> pattern_no_top_alt;
-    std::shared_ptr<Type> type;
-    std::shared_ptr<Expression> expression;
+    PatternNoTopAlt* pattern_no_top_alt = nullptr;
+    Type* type = nullptr;
+    Expression* expression = nullptr;
 public:
-    LetStatement(std::shared_ptr<PatternNoTopAlt> pattern_no_top_alt, 
-        std::shared_ptr<Type> type, 
-        std::shared_ptr<Expression> expression)
-        : pattern_no_top_alt(std::move(pattern_no_top_alt)),
+    LetStatement(PatternNoTopAlt* pattern_no_top_alt, 
+        Type* type, 
+        Expression* expression)
+        : ASTNode(NodeKind::kLetStatement), pattern_no_top_alt(std::move(pattern_no_top_alt)),
         type(std::move(type)),
         expression(std::move(expression))  {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kLetStatement; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(pattern_no_top_alt);
+        f(type);
+        f(expression);
     }
 };
 
 class ExpressionStatement : public ASTNode {
 public:
-    std::shared_ptr<ASTNode> child; // ExpressionWithoutBlock, ExpressionWithBlock
+    Expression* child = nullptr;
     bool has_semi;
 public:
-    ExpressionStatement(std::shared_ptr<ASTNode> child, bool has_semi)
-        : child(std::move(child)), has_semi(has_semi) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    ExpressionStatement(Expression* child, bool has_semi)
+        : ASTNode(NodeKind::kExpressionStatement), child(std::move(child)), has_semi(has_semi) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kExpressionStatement; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(child);
     }
 };
 
 class Statements : public ASTNode {
 public:
-    std::vector<std::shared_ptr<ASTNode>> statements; // Statement+ or Statement+ ExpressionWithoutBlock or ExpressionWithoutBlock
+    std::vector<ASTNode*> statements; // Statement* followed by an optional tail Expression (without block)
 public:
-    Statements(std::vector<std::shared_ptr<ASTNode>> statements)
-        : statements(std::move(statements)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    Statements(std::vector<ASTNode*> statements)
+        : ASTNode(NodeKind::kStatements), statements(std::move(statements)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kStatements; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        for (auto* child : statements) f(child);
     }
 };
 
 class Expression : public ASTNode {
 public:
-    std::shared_ptr<ASTNode> child; // ExpressionWithoutBlock, ExpressionWithBlock
-public:
-    Expression() = default;
-    Expression(std::shared_ptr<ASTNode> child)
-        : child(std::move(child)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }
-};
-
-class ExpressionWithoutBlock : public Expression {
-public:
-    std::shared_ptr<ASTNode> child;
-    // LiteralExpression, PathExpression, OperatorExpression, GroupedExpression,
-    // ArrayExpression, IndexExpression, StructExpression, CallExpression,
-    // MethodCallExpression, FieldExpression, ContinueExpression, BreakExpression, ReturnExpression.
-    ExpressionWithoutBlock(std::shared_ptr<ASTNode> child)
-        : child(std::move(child)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    explicit Expression(NodeKind kind) : ASTNode(kind) {}
+    static bool classof(const ASTNode* node) {
+        return node->kind >= NodeKind::kFirstExpression && node->kind <= NodeKind::kLastExpression;
     }
 };
 
-class ExpressionWithBlock : public Expression {
-public:
-    std::shared_ptr<ASTNode> child;
-public:
-    ExpressionWithBlock(std::shared_ptr<ASTNode> child)
-        : child(std::move(child)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }
-};
-
-
 class CharLiteral : public Expression {
 public:
-    std::string value;
+    // 解码后的内容，存放在全局字面量池中
+    LiteralId value;
 public:
-    CharLiteral(std::string value) : value(std::move(value)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }
+    CharLiteral(LiteralId value) : Expression(NodeKind::kCharLiteral), value(value) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kCharLiteral; }
+    template <typename F>
+    void forEachChild(F&&) {}
 };
 
 class StringLiteral : public Expression {
 public:
-    std::string value;
+    LiteralId value;
 public:
-    StringLiteral(std::string value) : value(std::move(value)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }
+    StringLiteral(LiteralId value) : Expression(NodeKind::kStringLiteral), value(value) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kStringLiteral; }
+    template <typename F>
+    void forEachChild(F&&) {}
 };
 
 class RawStringLiteral : public Expression {
 public:
-    std::string value;
+    LiteralId value;
 public:
-    RawStringLiteral(std::string value) : value(std::move(value)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }
+    RawStringLiteral(LiteralId value) : Expression(NodeKind::kRawStringLiteral), value(value) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kRawStringLiteral; }
+    template <typename F>
+    void forEachChild(F&&) {}
 };
 
 class CStringLiteral : public Expression {
 public:
-    std::string value;
+    LiteralId value;
 public:
-    CStringLiteral(std::string value) : value(std::move(value)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }
+    CStringLiteral(LiteralId value) : Expression(NodeKind::kCStringLiteral), value(value) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kCStringLiteral; }
+    template <typename F>
+    void forEachChild(F&&) {}
 };
 
 class RawCStringLiteral : public Expression {
 public:
-    std::string value;
+    LiteralId value;
 public:
-    RawCStringLiteral(std::string value) : value(std::move(value)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }
+    RawCStringLiteral(LiteralId value) : Expression(NodeKind::kRawCStringLiteral), value(value) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kRawCStringLiteral; }
+    template <typename F>
+    void forEachChild(F&&) {}
 };
 
 class IntegerLiteral : public Expression {
 public:
     std::string value;
+    // 词法分析时解码的数值、进制与类型后缀
+    uint64_t number;
+    uint8_t radix;
+    IntegerSuffix suffix;
 public:
-    IntegerLiteral(std::string value) : value(std::move(value)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }
+    IntegerLiteral(std::string value, IntegerValue decoded)
+        : Expression(NodeKind::kIntegerLiteral), value(std::move(value)), number(decoded.value), radix(decoded.radix), suffix(decoded.suffix) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kIntegerLiteral; }
+    template <typename F>
+    void forEachChild(F&&) {}
 };
 
 class BoolLiteral : public Expression {
 public:
     bool value;
 public:
-    BoolLiteral(bool value) : value(value) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }
+    BoolLiteral(bool value) : Expression(NodeKind::kBoolLiteral), value(value) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kBoolLiteral; }
+    template <typename F>
+    void forEachChild(F&&) {}
 };
 
 class PathExpression : public Expression {
 public:
-    std::shared_ptr<PathInExpression> path_in_expression;
+    PathInExpression* path_in_expression = nullptr;
 public:
-    PathExpression(std::shared_ptr<PathInExpression> path_in_expression)
-        : path_in_expression(std::move(path_in_expression)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    PathExpression(PathInExpression* path_in_expression)
+        : Expression(NodeKind::kPathExpression), path_in_expression(std::move(path_in_expression)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kPathExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(path_in_expression);
     }
 };
 
-class OperatorExpression : public Expression {
-public:
-    OperatorExpression() {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }
-};
 
 class UnaryExpression : public Expression {
 public:
@@ -475,14 +617,16 @@ public:
     
 public:
     UnaryType type;
-    std::shared_ptr<Expression> expression;
+    Expression* expression = nullptr;
     
 public:
-    UnaryExpression(UnaryType type, std::shared_ptr<Expression> expression)
-        : type(type), expression(std::move(expression)) {}
+    UnaryExpression(UnaryType type, Expression* expression)
+        : Expression(NodeKind::kUnaryExpression), type(type), expression(std::move(expression)) {}
     
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kUnaryExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(expression);
     }
 };
 
@@ -490,227 +634,271 @@ class BorrowExpression : public Expression {
 public:
     bool is_double;     // true for &&, false for &
     bool is_mutable;    // true if mut keyword present
-    std::shared_ptr<Expression> expression;
+    Expression* expression = nullptr;
     
 public:
-    BorrowExpression(bool is_double, bool is_mutable, std::shared_ptr<Expression> expression)
-        : is_double(is_double), is_mutable(is_mutable), expression(std::move(expression)) {}
+    BorrowExpression(bool is_double, bool is_mutable, Expression* expression)
+        : Expression(NodeKind::kBorrowExpression), is_double(is_double), is_mutable(is_mutable), expression(std::move(expression)) {}
     
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kBorrowExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(expression);
     }
 };
 
 class DereferenceExpression : public Expression {
 public:
-    std::shared_ptr<Expression> expression;
+    Expression* expression = nullptr;
     
 public:
-    DereferenceExpression(std::shared_ptr<Expression> expression)
-        : expression(std::move(expression)) {}
+    DereferenceExpression(Expression* expression)
+        : Expression(NodeKind::kDereferenceExpression), expression(std::move(expression)) {}
     
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kDereferenceExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(expression);
     }
 };
 
 class GroupedExpression : public Expression {
 public:
-    std::shared_ptr<Expression> expression;
+    Expression* expression = nullptr;
 public:
-    GroupedExpression(std::shared_ptr<Expression> expression)
-        : expression(std::move(expression)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    GroupedExpression(Expression* expression)
+        : Expression(NodeKind::kGroupedExpression), expression(std::move(expression)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kGroupedExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(expression);
     }
 };
 
 class ArrayExpression : public Expression {
 public:
-    std::shared_ptr<ArrayElements> array_elements;
+    ArrayElements* array_elements = nullptr;
 public:
-    ArrayExpression(std::shared_ptr<ArrayElements> array_elements)
-        : array_elements(std::move(array_elements)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    ArrayExpression(ArrayElements* array_elements)
+        : Expression(NodeKind::kArrayExpression), array_elements(std::move(array_elements)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kArrayExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(array_elements);
     }
 };
 
 class IndexExpression : public Expression {
 public:
-    std::shared_ptr<Expression> base_expression;
-    std::shared_ptr<Expression> index_expression;
+    Expression* base_expression = nullptr;
+    Expression* index_expression = nullptr;
 public:
-    IndexExpression(std::shared_ptr<Expression> base_expression, std::shared_ptr<Expression> index_expression)
-        : base_expression(std::move(base_expression)), index_expression(std::move(index_expression)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    IndexExpression(Expression* base_expression, Expression* index_expression)
+        : Expression(NodeKind::kIndexExpression), base_expression(std::move(base_expression)), index_expression(std::move(index_expression)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kIndexExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(base_expression);
+        f(index_expression);
     }
 };
 
 class StructExpression : public Expression {
 public:
-    std::shared_ptr<PathInExpression> path_in_expression;
-    std::shared_ptr<StructExprFields> struct_expr_fields;
+    PathInExpression* path_in_expression = nullptr;
+    StructExprFields* struct_expr_fields = nullptr;
 public:
-    StructExpression(std::shared_ptr<PathInExpression> path_in_expression, std::shared_ptr<StructExprFields> struct_expr_fields)
-        : path_in_expression(std::move(path_in_expression)), struct_expr_fields(std::move(struct_expr_fields)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    StructExpression(PathInExpression* path_in_expression, StructExprFields* struct_expr_fields)
+        : Expression(NodeKind::kStructExpression), path_in_expression(std::move(path_in_expression)), struct_expr_fields(std::move(struct_expr_fields)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kStructExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(path_in_expression);
+        f(struct_expr_fields);
     }
 };
 
 class CallExpression : public Expression {
 public:
-    std::shared_ptr<Expression> expression;
-    std::shared_ptr<CallParams> call_params;
+    Expression* expression = nullptr;
+    CallParams* call_params = nullptr;
 public:
-    CallExpression(std::shared_ptr<Expression> expression, std::shared_ptr<CallParams> call_params)
-        : expression(std::move(expression)), call_params(std::move(call_params)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    CallExpression(Expression* expression, CallParams* call_params)
+        : Expression(NodeKind::kCallExpression), expression(std::move(expression)), call_params(std::move(call_params)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kCallExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(expression);
+        f(call_params);
     }
 };
 
 class MethodCallExpression : public Expression {
 public:
-    std::shared_ptr<Expression> expression;
-    std::shared_ptr<PathIdentSegment> path_ident_segment;
-    std::shared_ptr<CallParams> call_params;
+    Expression* expression = nullptr;
+    PathIdentSegment* path_ident_segment = nullptr;
+    CallParams* call_params = nullptr;
 public:
-    MethodCallExpression(std::shared_ptr<Expression> expression, std::shared_ptr<PathIdentSegment> path_ident_segment, std::shared_ptr<CallParams> call_params)
-        : expression(std::move(expression)), path_ident_segment(std::move(path_ident_segment)), call_params(std::move(call_params)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    MethodCallExpression(Expression* expression, PathIdentSegment* path_ident_segment, CallParams* call_params)
+        : Expression(NodeKind::kMethodCallExpression), expression(std::move(expression)), path_ident_segment(std::move(path_ident_segment)), call_params(std::move(call_params)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kMethodCallExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(expression);
+        f(path_ident_segment);
+        f(call_params);
     }
 };
 
 class FieldExpression : public Expression {
 public:
-    std::shared_ptr<Expression> expression;
-    std::string identifier;
+    Expression* expression = nullptr;
+    Name identifier;
 public:
-    FieldExpression(std::shared_ptr<Expression> expression, std::string identifier)
-        : expression(std::move(expression)), identifier(std::move(identifier)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    FieldExpression(Expression* expression, Name identifier)
+        : Expression(NodeKind::kFieldExpression), expression(std::move(expression)), identifier(std::move(identifier)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kFieldExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(expression);
     }
 };
 
 class ContinueExpression : public Expression {
 public:
-    ContinueExpression() {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }
+    ContinueExpression() : Expression(NodeKind::kContinueExpression) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kContinueExpression; }
+    template <typename F>
+    void forEachChild(F&&) {}
 };
 
 class BreakExpression : public Expression {
 public:
-    std::shared_ptr<Expression> expression;
+    Expression* expression = nullptr;
 public:
-    BreakExpression(std::shared_ptr<Expression> expression)
-        : expression(std::move(expression)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    BreakExpression(Expression* expression)
+        : Expression(NodeKind::kBreakExpression), expression(std::move(expression)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kBreakExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(expression);
     }
 };
 
 class ReturnExpression : public Expression {
 public:
-    std::shared_ptr<Expression> expression;
+    Expression* expression = nullptr;
 public:
-    ReturnExpression(std::shared_ptr<Expression> expression)
-        : expression(std::move(expression)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    ReturnExpression(Expression* expression)
+        : Expression(NodeKind::kReturnExpression), expression(std::move(expression)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kReturnExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(expression);
     }
 };
 
 class BlockExpression : public Expression {
 public:
     bool is_last_stmt_return;
-    std::shared_ptr<Statements> statements;
+    Statements* statements = nullptr;
 public:
-    BlockExpression(std::shared_ptr<Statements> statements)
-        : is_last_stmt_return(false), statements(std::move(statements)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    BlockExpression(Statements* statements)
+        : Expression(NodeKind::kBlockExpression), is_last_stmt_return(false), statements(std::move(statements)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kBlockExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(statements);
     }
 };
 
 class LoopExpression : public Expression {
 public:
     bool is_last_stmt_return;
-    std::shared_ptr<ASTNode> child; // InfiniteLoopExpression or PredicateLoopExpression
+    ASTNode* child = nullptr; // InfiniteLoopExpression or PredicateLoopExpression
 public:
-    LoopExpression(std::shared_ptr<ASTNode> child)
-        : is_last_stmt_return(false), child(std::move(child)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    LoopExpression(ASTNode* child)
+        : Expression(NodeKind::kLoopExpression), is_last_stmt_return(false), child(std::move(child)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kLoopExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(child);
     }
 };
 
 class InfiniteLoopExpression : public Expression {
 public:
     bool is_last_stmt_return;
-    std::shared_ptr<BlockExpression> block_expression;
+    BlockExpression* block_expression = nullptr;
 public:
-    InfiniteLoopExpression(std::shared_ptr<BlockExpression> block_expression)
-        : is_last_stmt_return(false), block_expression(std::move(block_expression)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    InfiniteLoopExpression(BlockExpression* block_expression)
+        : Expression(NodeKind::kInfiniteLoopExpression), is_last_stmt_return(false), block_expression(std::move(block_expression)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kInfiniteLoopExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(block_expression);
     }
 };
 
 class PredicateLoopExpression : public Expression {
 public:
-    std::shared_ptr<Condition> condition;
-    std::shared_ptr<BlockExpression> block_expression;
+    Condition* condition = nullptr;
+    BlockExpression* block_expression = nullptr;
 public:
-    PredicateLoopExpression(std::shared_ptr<Condition> condition, std::shared_ptr<BlockExpression> block_expression)
-        : condition(std::move(condition)), block_expression(std::move(block_expression)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    PredicateLoopExpression(Condition* condition, BlockExpression* block_expression)
+        : Expression(NodeKind::kPredicateLoopExpression), condition(std::move(condition)), block_expression(std::move(block_expression)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kPredicateLoopExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(condition);
+        f(block_expression);
     }
 };
 
 class Condition : public Expression {
 public:
-    std::shared_ptr<Expression> expression; // Expression except StructExpression
+    Expression* expression = nullptr; // Expression except StructExpression
 public:
-    Condition(std::shared_ptr<Expression> expression)
-        : expression(std::move(expression)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    Condition(Expression* expression)
+        : Expression(NodeKind::kCondition), expression(std::move(expression)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kCondition; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(expression);
     }
 };
 
 class IfExpression : public Expression {
 public:
-    std::shared_ptr<Condition> condition;
-    std::shared_ptr<BlockExpression> then_block;
-    std::shared_ptr<Expression> else_branch; // BlockExpression or IfExpression
+    Condition* condition = nullptr;
+    BlockExpression* then_block = nullptr;
+    Expression* else_branch = nullptr; // BlockExpression or IfExpression
 public:
-    IfExpression(std::shared_ptr<Condition> condition,
-                std::shared_ptr<BlockExpression> then_block,
-                std::shared_ptr<Expression> else_branch)
-        : condition(std::move(condition)),
+    IfExpression(Condition* condition,
+                BlockExpression* then_block,
+                Expression* else_branch)
+        : Expression(NodeKind::kIfExpression), condition(std::move(condition)),
           then_block(std::move(then_block)),
           else_branch(std::move(else_branch)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kIfExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(condition);
+        f(then_block);
+        f(else_branch);
     }
 };
 
 class PatternNoTopAlt : public ASTNode {
 public:
-    std::shared_ptr<ASTNode> child;
+    ASTNode* child = nullptr;
 public:
-    PatternNoTopAlt(std::shared_ptr<ASTNode> child) 
-    : child(std::move(child)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    PatternNoTopAlt(ASTNode* child) 
+    : ASTNode(NodeKind::kPatternNoTopAlt), child(std::move(child)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kPatternNoTopAlt; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(child);
     }
 };
 
@@ -718,125 +906,146 @@ class IdentifierPattern : public ASTNode {
 public:
     bool is_ref;
     bool is_mutable;
-    std::string identifier;
+    Name identifier;
 public:
-    IdentifierPattern(bool is_ref, bool is_mutable, std::string identifier)
-        : is_ref(is_ref), is_mutable(is_mutable), identifier(std::move(identifier)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }
+    IdentifierPattern(bool is_ref, bool is_mutable, Name identifier)
+        : ASTNode(NodeKind::kIdentifierPattern), is_ref(is_ref), is_mutable(is_mutable), identifier(std::move(identifier)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kIdentifierPattern; }
+    template <typename F>
+    void forEachChild(F&&) {}
 };
 
 class ReferencePattern : public ASTNode {
 public:
     bool is_double;     // true for &&, false for &
     bool is_mutable;
-    std::shared_ptr<PatternNoTopAlt> pattern;
+    PatternNoTopAlt* pattern = nullptr;
 public:
-    ReferencePattern(bool is_double, bool is_mutable, std::shared_ptr<PatternNoTopAlt> pattern)
-        : is_double(is_double), is_mutable(is_mutable), pattern(std::move(pattern)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    ReferencePattern(bool is_double, bool is_mutable, PatternNoTopAlt* pattern)
+        : ASTNode(NodeKind::kReferencePattern), is_double(is_double), is_mutable(is_mutable), pattern(std::move(pattern)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kReferencePattern; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(pattern);
     }
 };
 
 class Type : public ASTNode {
 public:
-    std::shared_ptr<ASTNode> child; // TypePath (PathIdentSegment), ReferenceType, ArrayType, UnitType
+    ASTNode* child = nullptr; // TypePath (PathIdentSegment), ReferenceType, ArrayType, UnitType
 public:
-    Type(std::shared_ptr<ASTNode> child)
-        : child(std::move(child)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    Type(ASTNode* child)
+        : ASTNode(NodeKind::kType), child(std::move(child)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kType; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(child);
     }
 };
 
 class ReferenceType : public ASTNode {
 public:
     bool is_mutable;
-    std::shared_ptr<Type> type;
+    Type* type = nullptr;
 public:
-    ReferenceType(bool is_mutable, std::shared_ptr<Type> type)
-        : is_mutable(is_mutable), type(std::move(type)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    ReferenceType(bool is_mutable, Type* type)
+        : ASTNode(NodeKind::kReferenceType), is_mutable(is_mutable), type(std::move(type)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kReferenceType; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(type);
     }
 };
 
 class ArrayType : public ASTNode {
 public:
-    std::shared_ptr<Type> type;
-    std::shared_ptr<Expression> expression;
+    Type* type = nullptr;
+    Expression* expression = nullptr;
 public:
-    ArrayType(std::shared_ptr<Type> type, std::shared_ptr<Expression> expression)
-        : type(std::move(type)), expression(std::move(expression)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    ArrayType(Type* type, Expression* expression)
+        : ASTNode(NodeKind::kArrayType), type(std::move(type)), expression(std::move(expression)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kArrayType; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(type);
+        f(expression);
     }
 };
 
 class UnitType : public ASTNode {
 public:
-    UnitType() {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }
+    UnitType() : ASTNode(NodeKind::kUnitType) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kUnitType; }
+    template <typename F>
+    void forEachChild(F&&) {}
 };
 
 class PathInExpression : public ASTNode {
 public:
-    std::shared_ptr<PathIdentSegment> segment1, segment2;
+    PathIdentSegment* segment1 = nullptr;
+    PathIdentSegment* segment2 = nullptr;
 public:
-    PathInExpression(std::shared_ptr<PathIdentSegment> segment1, std::shared_ptr<PathIdentSegment> segment2)
-        : segment1(std::move(segment1)), segment2(std::move(segment2)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    PathInExpression(PathIdentSegment* segment1, PathIdentSegment* segment2)
+        : ASTNode(NodeKind::kPathInExpression), segment1(std::move(segment1)), segment2(std::move(segment2)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kPathInExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(segment1);
+        f(segment2);
     }
 };
 
 class ArrayElements : public ASTNode {
 public:
-    std::vector<std::shared_ptr<Expression>> expressions;
+    std::vector<Expression*> expressions;
     bool is_semicolon_separated; // true for semicolon separated, false for comma separated
 public:
-    ArrayElements(std::vector<std::shared_ptr<Expression>> expressions, bool is_semicolon_separated)
-        : expressions(std::move(expressions)), is_semicolon_separated(is_semicolon_separated) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    ArrayElements(std::vector<Expression*> expressions, bool is_semicolon_separated)
+        : ASTNode(NodeKind::kArrayElements), expressions(std::move(expressions)), is_semicolon_separated(is_semicolon_separated) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kArrayElements; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        for (auto* child : expressions) f(child);
     }
 };
 
 class StructExprFields : public ASTNode {
 public:
-    std::vector<std::shared_ptr<StructExprField>> struct_expr_fields;
+    std::vector<StructExprField*> struct_expr_fields;
 public:
-    StructExprFields(std::vector<std::shared_ptr<StructExprField>> struct_expr_fields)
-        : struct_expr_fields(std::move(struct_expr_fields)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    StructExprFields(std::vector<StructExprField*> struct_expr_fields)
+        : ASTNode(NodeKind::kStructExprFields), struct_expr_fields(std::move(struct_expr_fields)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kStructExprFields; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        for (auto* child : struct_expr_fields) f(child);
     }
 };
 
 class StructExprField : public ASTNode {
 public:
-    std::string identifier;
-    std::shared_ptr<Expression> expression;
+    Name identifier;
+    Expression* expression = nullptr;
 public:
-    StructExprField(std::string identifier, std::shared_ptr<Expression> expression)
-        : identifier(std::move(identifier)), expression(std::move(expression)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    StructExprField(Name identifier, Expression* expression)
+        : ASTNode(NodeKind::kStructExprField), identifier(std::move(identifier)), expression(std::move(expression)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kStructExprField; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(expression);
     }
 };
 
 class CallParams : public ASTNode {
 public:
-    std::vector<std::shared_ptr<Expression>> expressions;
+    std::vector<Expression*> expressions;
 public:
-    CallParams(std::vector<std::shared_ptr<Expression>> expressions)
-        : expressions(std::move(expressions)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    CallParams(std::vector<Expression*> expressions)
+        : ASTNode(NodeKind::kCallParams), expressions(std::move(expressions)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kCallParams; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        for (auto* child : expressions) f(child);
     }
 };
 
@@ -844,24 +1053,27 @@ public:
 class PathIdentSegment: public ASTNode {
 public:
     int path_type; // 0 for identifier, 1 for Self, 2 for self
-    std::string identifier;
+    Name identifier;
 public:
-    PathIdentSegment(int path_type, std::string identifier)
-        : path_type(path_type), identifier(std::move(identifier)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
-    }
+    PathIdentSegment(int path_type, Name identifier)
+        : ASTNode(NodeKind::kPathIdentSegment), path_type(path_type), identifier(std::move(identifier)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kPathIdentSegment; }
+    template <typename F>
+    void forEachChild(F&&) {}
 };
 
 class AssignmentExpression : public Expression {
 public:
-    std::shared_ptr<Expression> lhs;
-    std::shared_ptr<Expression> rhs;
+    Expression* lhs = nullptr;
+    Expression* rhs = nullptr;
 public:
-    AssignmentExpression(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs)
-        : lhs(std::move(lhs)), rhs(std::move(rhs)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    AssignmentExpression(Expression* lhs, Expression* rhs)
+        : Expression(NodeKind::kAssignmentExpression), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kAssignmentExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(lhs);
+        f(rhs);
     }
 };
 
@@ -882,15 +1094,18 @@ public:
     
 public:
     CompoundAssignmentType type;
-    std::shared_ptr<Expression> lhs;
-    std::shared_ptr<Expression> rhs;
+    Expression* lhs = nullptr;
+    Expression* rhs = nullptr;
     
 public:
-    CompoundAssignmentExpression(CompoundAssignmentType type, std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs)
-        : type(type), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+    CompoundAssignmentExpression(CompoundAssignmentType type, Expression* lhs, Expression* rhs)
+        : Expression(NodeKind::kCompoundAssignmentExpression), type(type), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
     
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kCompoundAssignmentExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(lhs);
+        f(rhs);
     }
 };
 
@@ -919,26 +1134,45 @@ public:
     
 public:
     BinaryType binary_type;
-    std::shared_ptr<Expression> lhs;
-    std::shared_ptr<Expression> rhs;
+    Expression* lhs = nullptr;
+    Expression* rhs = nullptr;
     
 public:
-    BinaryExpression(BinaryType binary_type, std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs)
-        : binary_type(binary_type), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+    BinaryExpression(BinaryType binary_type, Expression* lhs, Expression* rhs)
+        : Expression(NodeKind::kBinaryExpression), binary_type(binary_type), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
     
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kBinaryExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(lhs);
+        f(rhs);
     }
 };
 
 class TypeCastExpression : public Expression {
 public:
-    std::shared_ptr<Expression> expression;
-    std::shared_ptr<Type> type;
+    Expression* expression = nullptr;
+    Type* type = nullptr;
 public:
-    TypeCastExpression(std::shared_ptr<Expression> expression, std::shared_ptr<Type> type)
-        : expression(std::move(expression)), type(std::move(type)) {}
-    void accept(ASTVisitor* visitor) override {
-        visitor->visit(*this);
+    TypeCastExpression(Expression* expression, Type* type)
+        : Expression(NodeKind::kTypeCastExpression), expression(std::move(expression)), type(std::move(type)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kTypeCastExpression; }
+    template <typename F>
+    void forEachChild(F&& f) {
+        f(expression);
+        f(type);
     }
-};
\ No newline at end of file
+};
+
+// 错误恢复模式下，解析失败的项（作为 Item 的内容）或语句（放在 Statements 中）由它代替，
+// 对应的 token 已被跳过。message 与不做恢复时抛出的错误信息相同
+class ErrorNode : public ASTNode {
+public:
+    std::string message;
+public:
+    ErrorNode(std::string message)
+        : ASTNode(NodeKind::kErrorNode), message(std::move(message)) {}
+    static bool classof(const ASTNode* node) { return node->kind == NodeKind::kErrorNode; }
+    template <typename F>
+    void forEachChild(F&&) {}
+};
@@ -1,10 +1,10 @@
 #pragma once
 
-#include "parser/visitor.hpp"
+#include "parser/walker.hpp"
 #include <string>
 #include <ostream>
 
-class ASTPrinter : public ASTVisitor {
+class ASTPrinter : public ASTWalker<ASTPrinter> {
 private:
     std::ostream& output;
     int indent_level;
@@ -17,119 +17,119 @@ private:
     std::string reset_color();
     
 public:
+    using ASTWalker<ASTPrinter>::visit;
+
     explicit ASTPrinter(std::ostream& output = std::cout, bool use_colors = true);
-    virtual ~ASTPrinter() = default;
+    ~ASTPrinter() = default;
     
     // 设置选项
     void set_use_colors(bool enabled) { use_colors = enabled; }
     void set_indent_level(int level) { indent_level = level; }
     
     // 顶层节点
-    void visit(Crate& node) override;
-    void visit(Item& node) override;
+    void visit(Crate& node);
+    void visit(Item& node);
     
     // 声明类节点 (Items)
-    void visit(Function& node) override;
-    void visit(Struct& node) override;
-    void visit(Enumeration& node) override;
-    void visit(ConstantItem& node) override;
-    void visit(Trait& node) override;
-    void visit(Implementation& node) override;
+    void visit(Function& node);
+    void visit(Struct& node);
+    void visit(Enumeration& node);
+    void visit(ConstantItem& node);
+    void visit(Trait& node);
+    void visit(Implementation& node);
     
     // 函数相关节点
-    void visit(FunctionParameters& node) override;
-    void visit(SelfParam& node) override;
-    void visit(ShorthandSelf& node) override;
-    void visit(TypedSelf& node) override;
-    void visit(FunctionParam& node) override;
-    void visit(FunctionReturnType& node) override;
+    void visit(FunctionParameters& node);
+    void visit(SelfParam& node);
+    void visit(ShorthandSelf& node);
+    void visit(TypedSelf& node);
+    void visit(FunctionParam& node);
+    void visit(FunctionReturnType& node);
     
     // 结构体相关节点
-    void visit(StructStruct& node) override;
-    void visit(StructFields& node) override;
-    void visit(StructField& node) override;
+    void visit(StructStruct& node);
+    void visit(StructFields& node);
+    void visit(StructField& node);
     
     // 枚举相关节点
-    void visit(EnumVariants& node) override;
-    void visit(EnumVariant& node) override;
+    void visit(EnumVariants& node);
+    void visit(EnumVariant& node);
     
     // 实现相关节点
-    void visit(AssociatedItem& node) override;
-    void visit(InherentImpl& node) override;
-    void visit(TraitImpl& node) override;
+    void visit(AssociatedItem& node);
+    void visit(InherentImpl& node);
+    void visit(TraitImpl& node);
     
     // 语句类节点
-    void visit(Statement& node) override;
-    void visit(LetStatement& node) override;
-    void visit(ExpressionStatement& node) override;
-    void visit(Statements& node) override;
-    
-    // 表达式类节点
-    void visit(Expression& node) override;
-    void visit(ExpressionWithoutBlock& node) override;
-    void visit(ExpressionWithBlock& node) override;
+    void visit(Statement& node);
+    void visit(LetStatement& node);
+    void visit(ExpressionStatement& node);
+    void visit(Statements& node);
     
     // 字面量表达式
-    void visit(CharLiteral& node) override;
-    void visit(StringLiteral& node) override;
-    void visit(RawStringLiteral& node) override;
-    void visit(CStringLiteral& node) override;
-    void visit(RawCStringLiteral& node) override;
-    void visit(IntegerLiteral& node) override;
-    void visit(BoolLiteral& node) override;
+    void visit(CharLiteral& node);
+    void visit(StringLiteral& node);
+    void visit(RawStringLiteral& node);
+    void visit(CStringLiteral& node);
+    void visit(RawCStringLiteral& node);
+    void visit(IntegerLiteral& node);
+    void visit(BoolLiteral& node);
     
     // 路径和访问表达式
-    void visit(PathExpression& node) override;
-    void visit(FieldExpression& node) override;
+    void visit(PathExpression& node);
+    void visit(FieldExpression& node);
     
     // 运算符表达式
-    void visit(UnaryExpression& node) override;
-    void visit(BorrowExpression& node) override;
-    void visit(DereferenceExpression& node) override;
-    void visit(BinaryExpression& node) override;
-    void visit(AssignmentExpression& node) override;
-    void visit(CompoundAssignmentExpression& node) override;
-    void visit(TypeCastExpression& node) override;
+    void visit(UnaryExpression& node);
+    void visit(BorrowExpression& node);
+    void visit(DereferenceExpression& node);
+    void visit(BinaryExpression& node);
+    void visit(AssignmentExpression& node);
+    void visit(CompoundAssignmentExpression& node);
+    void visit(TypeCastExpression& node);
     
     // 调用和索引表达式
-    void visit(CallExpression& node) override;
-    void visit(MethodCallExpression& node) override;
-    void visit(IndexExpression& node) override;
+    void visit(CallExpression& node);
+    void visit(MethodCallExpression& node);
+    void visit(IndexExpression& node);
     
     // 结构体和数组表达式
-    void visit(StructExpression& node) override;
-    void visit(ArrayExpression& node) override;
-    void visit(GroupedExpression& node) override;
+    void visit(StructExpression& node);
+    void visit(ArrayExpression& node);
+    void visit(GroupedExpression& node);
     
     // 控制流表达式
-    void visit(BlockExpression& node) override;
-    void visit(IfExpression& node) override;
-    void visit(LoopExpression& node) override;
-    void visit(InfiniteLoopExpression& node) override;
-    void visit(PredicateLoopExpression& node) override;
-    void visit(BreakExpression& node) override;
-    void visit(ContinueExpression& node) override;
-    void visit(ReturnExpression& node) override;
+    void visit(BlockExpression& node);
+    void visit(IfExpression& node);
+    void visit(LoopExpression& node);
+    void visit(InfiniteLoopExpression& node);
+    void visit(PredicateLoopExpression& node);
+    void visit(BreakExpression& node);
+    void visit(ContinueExpression& node);
+    void visit(ReturnExpression& node);
     
     // 辅助表达式节点
-    void visit(Condition& node) override;
-    void visit(ArrayElements& node) override;
-    void visit(StructExprFields& node) override;
-    void visit(StructExprField& node) override;
-    void visit(CallParams& node) override;
+    void visit(Condition& node);
+    void visit(ArrayElements& node);
+    void visit(StructExprFields& node);
+    void visit(StructExprField& node);
+    void visit(CallParams& node);
     
     // 模式类节点
-    void visit(PatternNoTopAlt& node) override;
-    void visit(IdentifierPattern& node) override;
-    void visit(ReferencePattern& node) override;
+    void visit(PatternNoTopAlt& node);
+    void visit(IdentifierPattern& node);
+    void visit(ReferencePattern& node);
     
     // 类型类节点
-    void visit(Type& node) override;
-    void visit(ReferenceType& node) override;
-    void visit(ArrayType& node) override;
-    void visit(UnitType& node) override;
+    void visit(Type& node);
+    void visit(ReferenceType& node);
+    void visit(ArrayType& node);
+    void visit(UnitType& node);
     
     // 路径类节点
-    void visit(PathInExpression& node) override;
-    void visit(PathIdentSegment& node) override;
+    void visit(PathInExpression& node);
+    void visit(PathIdentSegment& node);
+
+    // 错误恢复时代替项或语句的节点
+    void visit(ErrorNode& node);
 };
\ No newline at end of file
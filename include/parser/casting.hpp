@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cassert>
+
+// 基于 NodeKind 的类型判断与转换，代替 dynamic_cast。
+// 目标类型需提供 static bool classof(const ASTNode*)，只比较节点上的 kind 标记，不依赖 RTTI
+
+// node 是否为 To 类型，node 不能为空
+template <typename To, typename From>
+inline bool isa(const From* node) {
+    assert(node && "isa<> on a null node");
+    return To::classof(node);
+}
+
+// 已知类型时的转换，类型不符时断言失败
+template <typename To, typename From>
+inline To* cast(From* node) {
+    assert(isa<To>(node) && "cast<> to an incompatible node kind");
+    return static_cast<To*>(node);
+}
+
+template <typename To, typename From>
+inline const To* cast(const From* node) {
+    assert(isa<To>(node) && "cast<> to an incompatible node kind");
+    return static_cast<const To*>(node);
+}
+
+// 类型不符或 node 为空时返回 nullptr，用法与 dynamic_cast 相同
+template <typename To, typename From>
+inline To* dyn_cast(From* node) {
+    return node && To::classof(node) ? static_cast<To*>(node) : nullptr;
+}
+
+template <typename To, typename From>
+inline const To* dyn_cast(const From* node) {
+    return node && To::classof(node) ? static_cast<const To*>(node) : nullptr;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cassert>
+#include <vector>
+#include "parser/astnode.hpp"
+
+// 以节点编号为下标的附加信息表。语义信息不写回节点，各遍历各自持有自己的表，
+// 多个遍历（或线程）可以同时为同一棵树记录信息而互不影响。
+// T 为 bool 时底层是按位压缩的 std::vector<bool>，下标运算返回其代理引用。
+// 表长取建表时的 node_count，之后才解析出的节点（延迟解析的函数体）不在表中
+template <typename T>
+class NodeTable {
+private:
+    std::vector<T> values;
+public:
+    NodeTable() = default;
+    explicit NodeTable(const Crate& crate, const T& value = T()) : values(crate.node_count, value) {}
+
+    // 为 crate 的全部节点重新建表，原有内容丢弃
+    void reset(const Crate& crate, const T& value = T()) { values.assign(crate.node_count, value); }
+    size_t size() const { return values.size(); }
+
+    decltype(auto) operator[](const ASTNode& node) {
+        assert(node.id < values.size() && "node does not belong to this table");
+        return values[node.id];
+    }
+    decltype(auto) operator[](const ASTNode& node) const {
+        assert(node.id < values.size() && "node does not belong to this table");
+        return values[node.id];
+    }
+    decltype(auto) operator[](const ASTNode* node) { return (*this)[*node]; }
+    decltype(auto) operator[](const ASTNode* node) const { return (*this)[*node]; }
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include "lexer/token.hpp"
+#include "parser/astnode.hpp"
+
+// Operator precedence for the Pratt parser, as one constexpr table indexed by Token
+
+enum BindingPower {
+    PATH_ACCESS = 200,
+    CALL_INDEX = 190,
+    STRUCT_EXPR = 180,
+    UNARY = 170,
+    TYPE_CAST = 160,
+    MUL_DIV_MOD = 150,
+    ADD_SUB = 140,
+    SHIFT = 130,
+    BIT_AND = 120,
+    BIT_XOR = 110,
+    BIT_OR = 100,
+    COMPARISON = 90,
+    LOGIC_AND = 80,
+    LOGIC_OR = 70,
+    ASSIGNMENT = 60,
+    FLOW_CONTROL = 50
+};
+
+enum class Associativity : uint8_t { kLeft, kRight };
+
+// How a token behaves in an expression; the Pratt loop reads one entry per operator
+struct OperatorInfo {
+    // Binding power as an infix or postfix operator; 0 if the token ends an operand
+    int left_bp = 0;
+    // The right operand stops at operators that bind no tighter than this
+    int right_bp = 0;
+    // Binding power of the operand of a prefix operator; 0 if the token is not one
+    int prefix_bp = 0;
+    Associativity associativity = Associativity::kLeft;
+    // Whether `node` says what the operator builds. Tokens with a binding power but no node
+    // are read as operators and rejected once their right operand is parsed
+    bool has_node = false;
+    // kBinaryExpression, kCompoundAssignmentExpression or kAssignmentExpression for `lhs op rhs`;
+    // kCallExpression, kIndexExpression, kFieldExpression or kTypeCastExpression for the
+    // postfix forms, which the loop parses itself
+    NodeKind node = NodeKind::kBinaryExpression;
+    // BinaryExpression::BinaryType or CompoundAssignmentExpression::CompoundAssignmentType
+    int type = 0;
+};
+
+namespace operators {
+constexpr OperatorInfo infix(int bp, Associativity associativity, NodeKind node, int type = 0) {
+    OperatorInfo info;
+    info.left_bp = bp;
+    info.right_bp = associativity == Associativity::kLeft ? bp + 1 : bp - 1;
+    info.associativity = associativity;
+    info.has_node = true;
+    info.node = node;
+    info.type = type;
+    return info;
+}
+constexpr OperatorInfo binary(int bp, BinaryExpression::BinaryType type) {
+    return infix(bp, Associativity::kLeft, NodeKind::kBinaryExpression, type);
+}
+constexpr OperatorInfo compound(CompoundAssignmentExpression::CompoundAssignmentType type) {
+    return infix(ASSIGNMENT, Associativity::kLeft, NodeKind::kCompoundAssignmentExpression, type);
+}
+constexpr OperatorInfo postfix(int bp, NodeKind node) {
+    OperatorInfo info = infix(bp, Associativity::kLeft, node);
+    info.right_bp = 0;
+    return info;
+}
+// Binding power without a node of its own
+constexpr OperatorInfo reserved(int bp) {
+    OperatorInfo info;
+    info.left_bp = bp;
+    info.right_bp = bp + 1;
+    return info;
+}
+
+constexpr std::array<OperatorInfo, size_t(Token::kEOF) + 1> makeTable() {
+    std::array<OperatorInfo, size_t(Token::kEOF) + 1> table{};
+    auto at = [&](Token token) -> OperatorInfo& { return table[size_t(token)]; };
+
+    at(Token::kDot) = postfix(PATH_ACCESS, NodeKind::kFieldExpression);
+    at(Token::kPathSep) = reserved(PATH_ACCESS);
+    at(Token::kLParenthese) = postfix(CALL_INDEX, NodeKind::kCallExpression);
+    at(Token::kLSquare) = postfix(CALL_INDEX, NodeKind::kIndexExpression);
+    at(Token::kLCurly) = reserved(STRUCT_EXPR);
+    at(Token::kAs) = postfix(TYPE_CAST, NodeKind::kTypeCastExpression);
+
+    at(Token::kStar) = binary(MUL_DIV_MOD, BinaryExpression::STAR);
+    at(Token::kSlash) = binary(MUL_DIV_MOD, BinaryExpression::SLASH);
+    at(Token::kPercent) = binary(MUL_DIV_MOD, BinaryExpression::PERCENT);
+    at(Token::kPlus) = binary(ADD_SUB, BinaryExpression::PLUS);
+    at(Token::kMinus) = binary(ADD_SUB, BinaryExpression::MINUS);
+    at(Token::kShl) = binary(SHIFT, BinaryExpression::SHL);
+    at(Token::kShr) = binary(SHIFT, BinaryExpression::SHR);
+    at(Token::kAnd) = binary(BIT_AND, BinaryExpression::AND);
+    at(Token::kCaret) = binary(BIT_XOR, BinaryExpression::CARET);
+    at(Token::kOr) = binary(BIT_OR, BinaryExpression::OR);
+    at(Token::kEqEq) = binary(COMPARISON, BinaryExpression::EQ_EQ);
+    at(Token::kNe) = binary(COMPARISON, BinaryExpression::NE);
+    at(Token::kLt) = binary(COMPARISON, BinaryExpression::LT);
+    at(Token::kLe) = binary(COMPARISON, BinaryExpression::LE);
+    at(Token::kGt) = binary(COMPARISON, BinaryExpression::GT);
+    at(Token::kGe) = binary(COMPARISON, BinaryExpression::GE);
+    at(Token::kAndAnd) = binary(LOGIC_AND, BinaryExpression::AND_AND);
+    at(Token::kOrOr) = binary(LOGIC_OR, BinaryExpression::OR_OR);
+
+    // Assignments are read left-associatively, like every other operator
+    at(Token::kEq) = infix(ASSIGNMENT, Associativity::kLeft, NodeKind::kAssignmentExpression);
+    at(Token::kPlusEq) = compound(CompoundAssignmentExpression::PLUS_EQ);
+    at(Token::kMinusEq) = compound(CompoundAssignmentExpression::MINUS_EQ);
+    at(Token::kStarEq) = compound(CompoundAssignmentExpression::STAR_EQ);
+    at(Token::kSlashEq) = compound(CompoundAssignmentExpression::SLASH_EQ);
+    at(Token::kPercentEq) = compound(CompoundAssignmentExpression::PERCENT_EQ);
+    at(Token::kCaretEq) = compound(CompoundAssignmentExpression::CARET_EQ);
+    at(Token::kAndEq) = compound(CompoundAssignmentExpression::AND_EQ);
+    at(Token::kOrEq) = compound(CompoundAssignmentExpression::OR_EQ);
+    at(Token::kShlEq) = compound(CompoundAssignmentExpression::SHL_EQ);
+    at(Token::kShrEq) = compound(CompoundAssignmentExpression::SHR_EQ);
+    // Ranges have no expression node yet; giving them one only takes filling in these entries
+    at(Token::kDotDot) = reserved(ASSIGNMENT);
+    at(Token::kDotDotDot) = reserved(ASSIGNMENT);
+    at(Token::kDotDotEq) = reserved(ASSIGNMENT);
+
+    at(Token::kReturn) = reserved(FLOW_CONTROL);
+    at(Token::kBreak) = reserved(FLOW_CONTROL);
+    at(Token::kContinue) = reserved(FLOW_CONTROL);
+
+    // `-`, `*` and `&` are also binary operators; their prefix entries share the slot
+    for (Token token: {Token::kMinus, Token::kStar, Token::kAnd, Token::kNot, Token::kQuestion}) {
+        at(token).prefix_bp = UNARY;
+    }
+    return table;
+}
+}
+
+inline constexpr auto kOperatorTable = operators::makeTable();
+
+constexpr const OperatorInfo& operatorInfo(Token token) {
+    return kOperatorTable[size_t(token)];
+}
+
+static_assert(operatorInfo(Token::kStar).left_bp > operatorInfo(Token::kPlus).left_bp);
+static_assert(operatorInfo(Token::kPlus).right_bp == ADD_SUB + 1);
+static_assert(operatorInfo(Token::kMinus).prefix_bp == UNARY);
+static_assert(operatorInfo(Token::kIdentifier).left_bp == 0);
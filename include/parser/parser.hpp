@@ -1,144 +1,350 @@
 #pragma once
 
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "lexer/lexer.hpp"
 #include "parser/astnode.hpp"
+#include "parser/operators.hpp"
+
+// A syntax error recorded in recovery mode
+struct ParseDiagnostic {
+    // The message the parser throws for this error when it is not recovering
+    std::string message;
+    // Global index of the token the error was found at
+    size_t token;
+    SourceLocation location;
+};
 
 class Parser {
 private:
-    enum BindingPower {
-        PATH_ACCESS = 200,
-        CALL_INDEX = 190,
-        STRUCT_EXPR = 180,
-        UNARY = 170,
-        TYPE_CAST = 160,
-        MUL_DIV_MOD = 150,
-        ADD_SUB = 140,
-        SHIFT = 130,
-        BIT_AND = 120,
-        BIT_XOR = 110,
-        BIT_OR = 100,
-        COMPARISON = 90,
-        LOGIC_AND = 80,
-        LOGIC_OR = 70,
-        ASSIGNMENT = 60,
-        FLOW_CONTROL = 50
-    };
+    static constexpr size_t npos = size_t(-1);
 
-    std::vector<std::pair<Token, std::string>> tokens;
+    // In streaming mode `tokens` is a sliding window and `base` is the global index of its first token
+    TokenStream tokens;
     size_t pos = 0;
+    size_t base = 0;
+    std::unique_ptr<TokenPipe> pipe;
+    size_t window = 0;
+    bool finished = false;
+    std::vector<RawToken> incoming;
+    // Number of times a block body had to be parsed a second time
+    size_t reparses = 0;
+
+    // Owns every node built so far; handed over to the Crate by parseCrate
+    std::unique_ptr<ASTArena> arena = std::make_unique<ASTArena>();
+    // Id given to the next node; ids are dense and follow creation order
+    NodeId next_id = 0;
+    template <typename Node, typename... Args>
+    Node* make(Args&&... args) {
+        Node* node = arena->make<Node>(std::forward<Args>(args)...);
+        node->id = next_id++;
+        return node;
+    }
+
+    // Packrat memo for the block-like expressions that a block body retry reads again,
+    // keyed by (rule, start position); cleared after each top-level Item
+    enum class MemoRule : uint8_t { kBlockExpression, kIfExpression, kLoopExpression, kCount };
+    struct MemoEntry {
+        ASTNode* node = nullptr;
+        size_t end;
+    };
+    std::unordered_map<uint64_t, MemoEntry> memo;
+    size_t memo_hits = 0;
+    size_t memo_misses = 0;
+
+    static uint64_t memoKey(MemoRule rule, size_t start) {
+        return uint64_t(start) * uint64_t(MemoRule::kCount) + uint64_t(rule);
+    }
+    // On a hit, moves past the memoized production and returns its node
+    template <typename Node>
+    Node* recall(MemoRule rule) {
+        auto it = memo.find(memoKey(rule, pos));
+        if (it == memo.end()) {
+            ++memo_misses;
+            return nullptr;
+        }
+        ++memo_hits;
+        pos = it->second.end;
+        return static_cast<Node*>(it->second.node);
+    }
+    template <typename Node>
+    Node* remember(MemoRule rule, size_t start, Node* node) {
+        memo.emplace(memoKey(rule, start), MemoEntry{node, pos});
+        return node;
+    }
+
+    // Window slot of the token at global `index`, or npos past kEOF
+    size_t at(size_t index) {
+        if (index - base < tokens.size()) return index - base;
+        return fetch(index);
+    }
+    size_t fetch(size_t index);
+
+    // Crates with at least this many tokens have their items parsed on several threads
+    size_t parallel_threshold = size_t(1) << 18;
+    // Worker threads for parallel parsing, 0 means the hardware concurrency
+    size_t thread_count = 0;
+    // Item groups the last parallel parse handed to workers; 0 when it ran sequentially
+    size_t parallel_groups = 0;
+
+    // Lazy mode records function bodies as token ranges instead of parsing them
+    bool lazy_bodies = false;
+    std::vector<Function*> lazy_functions;
+    // Set on the parser a Crate keeps for its lazy bodies
+    Crate* lazy_owner = nullptr;
+    // Moves past a `{ ... }` group, matching (), [] and {} inside it
+    void skipDelimited();
+
+    // Recovery mode records syntax errors and resynchronizes instead of throwing. A broken
+    // item or statement becomes an ErrorNode and its tokens are skipped; the skip first
+    // passes over the tokens from its start to the error again to learn which delimiters
+    // are open, so every token is skipped at most once per error and the cost stays linear
+    bool recovery = false;
+    std::vector<ParseDiagnostic> diagnostics;
+    // Records `error` at the current token, unless an error was already recorded there
+    ErrorNode* report(const std::runtime_error& error);
+    // Skips the rest of the item that starts at `start`, up to the next item outside braces
+    void skipItem(size_t start);
+    // Skips the rest of the statement that starts at `start`, through a `;` outside the
+    // braces it opened, or up to the `}` closing the block or the next item
+    void skipStatement(size_t start);
+    std::string expected(Token);
+
+    // Expressions and blocks are parsed on an explicit stack of frames rather than by
+    // recursion, so their nesting costs heap memory instead of native stack; the stack may
+    // not grow beyond max_depth frames. Nested items and the length of an array type are
+    // still parsed by recursive descent and re-enter that parser; every re-entry pushes a
+    // root frame, so max_depth bounds them as well
+    struct Frame {
+        enum Kind : uint8_t {
+            kRoot,       // the expression asked for by the caller
+            kBinary,     // `lhs op` read, the right operand comes next
+            kPrefix,     // `-`, `!`, `?`, `*`, `&`, `return` or `break` read, its operand comes next
+            kGroup,      // `(` read
+            kCondition,  // `(` of an if or while condition read
+            kIf,         // condition read; the then block and an optional else branch come next
+            kLoop,       // `loop`, or `while` and its condition, read; the body comes next
+            kBlock,      // inside `{ ... }`, between two statements
+            kStatement,  // expression statement, ended by `;` or by being the final expression
+            kLet,        // let statement read up to `=`, the initializer comes next
+            kBlockBody,  // block body read again as a single expression
+            kCall,       // `(` of a call or method call read, between two arguments
+            kIndex,      // `lhs [` read, the index comes next
+            kArray,      // `[` of an array expression read, between two elements
+            kStructField // `Path {` read, the expression of field `field` comes next
+        };
+        Kind kind = kRoot;
+        // The operand of this frame stops at operators that bind no tighter than `bp`
+        int bp = 0;
+        Token op = Token::kEOF;
+        // Table entry of the operator of a kBinary frame
+        const OperatorInfo* info = nullptr;
+        bool is_double = false;
+        bool is_mutable = false;
+        // `[value; length]` array
+        bool is_repeat = false;
+        // `(` right after a block-like statement: a grouped expression starting the next
+        // statement unless it turns out to be an argument list, e.g. `{} ()` or `{} (a, b)`
+        bool maybe_group = false;
+        bool has_body = false;
+        // Memo position of a block, if or loop, and the first token of a block body
+        size_t start = 0;
+        size_t body = 0;
+        // Statements of a block so far are block_statements[statements, end)
+        size_t statements = 0;
+        // Arguments, elements or fields of a list so far are list_elements[elements, end)
+        size_t elements = 0;
+        // First token of the statement being parsed in a block, and whether one of its
+        // statements failed to parse (recovery mode only); such a block is never read again
+        size_t statement = 0;
+        bool recovered = false;
+        Expression* lhs = nullptr;
+        Condition* condition = nullptr;
+        BlockExpression* then_block = nullptr;
+        PatternNoTopAlt* pattern = nullptr;
+        Type* type = nullptr;
+        // Method name of a method call, path of a struct expression
+        ASTNode* part = nullptr;
+        Name field;
+    };
+    std::vector<Frame> frames;
+    // Statements of the blocks being parsed, innermost block last
+    std::vector<ASTNode*> block_statements;
+    // Elements of the lists being parsed, innermost list last
+    std::vector<ASTNode*> list_elements;
+    size_t max_depth = kDefaultMaxDepth;
+    // Parses an expression whose operators bind tighter than `current_bp`; with `with_block`
+    // set, stops after the block, if or loop expression at the current position instead
+    Expression* parseNested(int current_bp, bool with_block);
+
+    std::shared_ptr<Crate> parseCrateSequential();
+    // Token range [begin, end) of every top-level item, found by matching delimiters
+    // without parsing; empty if the delimiters do not balance
+    std::vector<std::pair<size_t, size_t>> splitItems();
+    // Parses consecutive items that end at the given positions; false if an item fails
+    // to parse or does not end where the pre-pass expected
+    bool parseItemsEndingAt(const std::vector<size_t>& ends, std::vector<Item*>& items);
 public:
-    Parser(std::vector<std::pair<Token, std::string>>&& tokens)
+    static constexpr size_t kDefaultWindow = size_t(1) << 18;
+    static constexpr size_t kRingCapacity = size_t(1) << 14;
+    static constexpr size_t kDefaultMaxDepth = size_t(1) << 20;
+
+    Parser(TokenStream&& tokens)
         : tokens(std::move(tokens)) {}
+    // Streaming mode: the lexer runs on its own thread; at most `window` tokens
+    // before the current position are kept for backtracking
+    Parser(std::shared_ptr<const SourceBuffer> source, size_t window = kDefaultWindow);
 
-    Token peek();
-    std::string get_string();
+    // Every choice is made with bounded lookahead, so this stays 0 unless a block
+    // falls back to reading its whole body as a single expression
+    size_t getReparseCount() const { return reparses; }
+    size_t getMemoHits() const { return memo_hits; }
+    size_t getMemoMisses() const { return memo_misses; }
+    size_t getParallelGroups() const { return parallel_groups; }
+
+    // Inline: every step of the Pratt loop looks at the next token
+    Token peek(size_t ahead = 0) {
+        size_t i = at(pos + ahead);
+        return i != npos ? tokens.kind(i) : Token::kEOF;
+    }
+    std::string_view get_string();
+    // 当前标识符 token 在词法分析时驻留的名字
+    Name get_name();
+    // 当前 token 的位置，用于报错信息
+    std::string location();
     void consume();
     void match(Token);
 
-    // Pratt parsing functions
-    int getTokenLeftBP(Token);
-    int getTokenRightBP(Token);
-    int getTokenUnaryBP(Token);
-    std::shared_ptr<ASTNode> parsePrattExpression(int current_bp);
-    std::shared_ptr<ASTNode> parsePrattPrefix();
+    // Pratt parsing functions; binding powers come from the operator table in operators.hpp
+    Expression* parsePrattExpression(int current_bp);
+    Expression* parsePrattPrefix();
 
     std::shared_ptr<Crate> parseCrate();
+    // Splits the token stream into top-level items and parses groups of them on `threads`
+    // threads, each into its own arena. The result, node ids included, is identical to a
+    // sequential parse; on any parse error the crate is parsed again sequentially so that
+    // the same error is reported. Not available in streaming mode
+    std::shared_ptr<Crate> parseCrateParallel(size_t threads);
+    void setParallelThreshold(size_t tokens) { parallel_threshold = tokens; }
+    void setThreadCount(size_t threads) { thread_count = threads; }
+    // Deepest nesting of expressions and blocks accepted; deeper input is a parse error
+    void setMaxDepth(size_t frames) { max_depth = frames; }
+    // Lazy mode: function signatures are parsed right away, bodies only when Function::body()
+    // is first called; syntax errors inside a body surface at that point. Parsing is then
+    // always sequential, and streaming mode ignores the setting
+    void setLazyBodies(bool enabled) { lazy_bodies = enabled; }
+    // Recovery mode: a syntax error no longer ends the parse. It is recorded, the broken item
+    // or statement is replaced by an ErrorNode, and parsing resumes after the next `;` at
+    // statement level, before the `}` closing the block, or at the next item. The first
+    // diagnostic is the error a parse without recovery throws. Parsing is then always
+    // sequential and eager. Nodes of a broken item or statement may stay in the arena
+    // without being reachable from the crate
+    void setRecovery(bool enabled) { recovery = enabled; }
+    const std::vector<ParseDiagnostic>& getDiagnostics() const { return diagnostics; }
+    // Parses the body recorded by a lazily parsed function; called through Function::body()
+    BlockExpression* parseLazyBody(Function&);
+    // Parses every body that is still pending; called through Crate::parseLazyBodies()
+    void parseLazyBodies();
 
-    std::shared_ptr<Item> parseItem();
-    std::shared_ptr<Function> parseFunction();
-    std::shared_ptr<Struct> parseStruct();
-    std::shared_ptr<Enumeration> parseEnumeration();
-    std::shared_ptr<ConstantItem> parseConstantItem();
-    std::shared_ptr<Trait> parseTrait();
-    std::shared_ptr<Implementation> parseImplementation();
-    std::shared_ptr<FunctionParameters> parseFunctionParameters();
-    std::shared_ptr<SelfParam> parseSelfParam();
-    std::shared_ptr<ShorthandSelf> parseShorthandSelf();
-    std::shared_ptr<TypedSelf> parseTypedSelf();
-    std::shared_ptr<FunctionParam> parseFunctionParam();
-    std::shared_ptr<FunctionReturnType> parseFunctionReturnType();
-    std::shared_ptr<StructStruct> parseStructStruct();
-    std::shared_ptr<StructFields> parseStructFields(); 
-    std::shared_ptr<StructField> parseStructField();
-    std::shared_ptr<EnumVariants> parseEnumVariants();
-    std::shared_ptr<EnumVariant> parseEnumVariant();
-    std::shared_ptr<AssociatedItem> parseAssociatedItem();
-    std::shared_ptr<InherentImpl> parseInherentImpl();
-    std::shared_ptr<TraitImpl> parseTraitImpl();
+    Item* parseItem();
+    Function* parseFunction();
+    Struct* parseStruct();
+    Enumeration* parseEnumeration();
+    ConstantItem* parseConstantItem();
+    Trait* parseTrait();
+    Implementation* parseImplementation();
+    FunctionParameters* parseFunctionParameters();
+    SelfParam* parseSelfParam();
+    ShorthandSelf* parseShorthandSelf();
+    TypedSelf* parseTypedSelf();
+    FunctionParam* parseFunctionParam();
+    FunctionReturnType* parseFunctionReturnType();
+    StructStruct* parseStructStruct();
+    StructFields* parseStructFields(); 
+    StructField* parseStructField();
+    EnumVariants* parseEnumVariants();
+    EnumVariant* parseEnumVariant();
+    AssociatedItem* parseAssociatedItem();
+    InherentImpl* parseInherentImpl();
+    TraitImpl* parseTraitImpl();
     
-    std::shared_ptr<Statement> parseStatement();
-    std::shared_ptr<LetStatement> parseLetStatement();
-    std::shared_ptr<ExpressionStatement> parseExpressionStatement();
-    std::shared_ptr<Statements> parseStatements();
-    std::shared_ptr<Expression> parseExpression();
-    std::shared_ptr<ExpressionWithoutBlock> parseExpressionWithoutBlock();
-    std::shared_ptr<ExpressionWithBlock> parseExpressionWithBlock();
-    std::shared_ptr<BlockExpression> parseBlockExpression();
-
-    std::shared_ptr<PatternNoTopAlt> parsePatternNoTopAlt();
-    std::shared_ptr<IdentifierPattern> parseIdentifierPattern();
-    std::shared_ptr<ReferencePattern> parseReferencePattern();
-
-    std::shared_ptr<Type> parseType();
-    std::shared_ptr<ReferenceType> parseReferenceType();
-    std::shared_ptr<ArrayType> parseArrayType();
-    std::shared_ptr<UnitType> parseUnitType();
-
-    std::shared_ptr<PathInExpression> parsePathInExpression();
-    std::shared_ptr<PathIdentSegment> parsePathIdentSegment();
-    std::shared_ptr<CharLiteral> parseCharLiteral();
-    std::shared_ptr<StringLiteral> parseStringLiteral();
-    std::shared_ptr<RawStringLiteral> parseRawStringLiteral();
-    std::shared_ptr<CStringLiteral> parseCStringLiteral();
-    std::shared_ptr<RawCStringLiteral> parseRawCStringLiteral();
-    std::shared_ptr<IntegerLiteral> parseIntegerLiteral();
-    std::shared_ptr<BoolLiteral> parseBoolLiteral();
-    std::shared_ptr<ReturnExpression> parseReturnExpression();
-    std::shared_ptr<IfExpression> parseIfExpression();
-    std::shared_ptr<Condition> parseCondition();
+    Statement* parseStatement();
+    LetStatement* parseLetStatement();
+    ExpressionStatement* parseExpressionStatement();
+    Expression* parseExpression();
+    // Expressions are returned as their concrete node; these two only check which form it is
+    Expression* parseExpressionWithoutBlock();
+    Expression* parseExpressionWithBlock();
+    BlockExpression* parseBlockExpression();
+
+    PatternNoTopAlt* parsePatternNoTopAlt();
+    IdentifierPattern* parseIdentifierPattern();
+    ReferencePattern* parseReferencePattern();
+
+    Type* parseType();
+    ReferenceType* parseReferenceType();
+    ArrayType* parseArrayType();
+    UnitType* parseUnitType();
+
+    PathInExpression* parsePathInExpression();
+    PathIdentSegment* parsePathIdentSegment();
+    CharLiteral* parseCharLiteral();
+    StringLiteral* parseStringLiteral();
+    RawStringLiteral* parseRawStringLiteral();
+    CStringLiteral* parseCStringLiteral();
+    RawCStringLiteral* parseRawCStringLiteral();
+    IntegerLiteral* parseIntegerLiteral();
+    BoolLiteral* parseBoolLiteral();
+    ReturnExpression* parseReturnExpression();
+    IfExpression* parseIfExpression();
+    Condition* parseCondition();
     
     // Loop expressions
-    std::shared_ptr<LoopExpression> parseLoopExpression();
-    std::shared_ptr<InfiniteLoopExpression> parseInfiniteLoopExpression();
-    std::shared_ptr<PredicateLoopExpression> parsePredicateLoopExpression();
-    std::shared_ptr<BreakExpression> parseBreakExpression();
-    std::shared_ptr<ContinueExpression> parseContinueExpression();
+    LoopExpression* parseLoopExpression();
+    InfiniteLoopExpression* parseInfiniteLoopExpression();
+    PredicateLoopExpression* parsePredicateLoopExpression();
+    BreakExpression* parseBreakExpression();
+    ContinueExpression* parseContinueExpression();
     
     // Array and grouped expressions
-    std::shared_ptr<GroupedExpression> parseGroupedExpression();
-    std::shared_ptr<ArrayExpression> parseArrayExpression();
-    std::shared_ptr<ArrayElements> parseArrayElements();
-    std::shared_ptr<IndexExpression> parseIndexExpression();
-    std::shared_ptr<IndexExpression> parseIndexExpressionFromInfix(std::shared_ptr<Expression> lhs);
+    GroupedExpression* parseGroupedExpression();
+    ArrayExpression* parseArrayExpression();
+    ArrayElements* parseArrayElements();
+    IndexExpression* parseIndexExpression();
+    IndexExpression* parseIndexExpressionFromInfix(Expression* lhs);
     
     // Struct expressions
-    std::shared_ptr<StructExpression> parseStructExpression();
-    std::shared_ptr<StructExprFields> parseStructExprFields();
-    std::shared_ptr<StructExprField> parseStructExprField();
+    StructExpression* parseStructExpression();
+    StructExprFields* parseStructExprFields();
+    StructExprField* parseStructExprField();
     
     // Call expressions
-    std::shared_ptr<CallExpression> parseCallExpression();
-    std::shared_ptr<CallExpression> parseCallExpressionFromInfix(std::shared_ptr<Expression> lhs);
-    std::shared_ptr<CallParams> parseCallParams();
+    CallExpression* parseCallExpression();
+    CallExpression* parseCallExpressionFromInfix(Expression* lhs);
+    CallParams* parseCallParams();
     
     // Method call, field, and path expressions
-    std::shared_ptr<MethodCallExpression> parseMethodCallExpression();
-    std::shared_ptr<MethodCallExpression> parseMethodCallExpressionFromInfix(std::shared_ptr<Expression> lhs);
-    std::shared_ptr<FieldExpression> parseFieldExpression();
-    std::shared_ptr<FieldExpression> parseFieldExpressionFromInfix(std::shared_ptr<Expression> lhs);
-    std::shared_ptr<PathExpression> parsePathExpression();
+    MethodCallExpression* parseMethodCallExpression();
+    MethodCallExpression* parseMethodCallExpressionFromInfix(Expression* lhs);
+    FieldExpression* parseFieldExpression();
+    FieldExpression* parseFieldExpressionFromInfix(Expression* lhs);
+    PathExpression* parsePathExpression();
     
     // Unary expressions
-    std::shared_ptr<UnaryExpression> parseUnaryExpression();
-    std::shared_ptr<BorrowExpression> parseBorrowExpression();
-    std::shared_ptr<DereferenceExpression> parseDereferenceExpression();
+    UnaryExpression* parseUnaryExpression();
+    BorrowExpression* parseBorrowExpression();
+    DereferenceExpression* parseDereferenceExpression();
     
     // Binary and assignment expressions
-    std::shared_ptr<AssignmentExpression> parseAssignmentExpression(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs);
-    std::shared_ptr<CompoundAssignmentExpression> parseCompoundAssignmentExpression(CompoundAssignmentExpression::CompoundAssignmentType type, std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs);
-    std::shared_ptr<BinaryExpression> parseBinaryExpression(BinaryExpression::BinaryType type, std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs);
+    AssignmentExpression* parseAssignmentExpression(Expression* lhs, Expression* rhs);
+    CompoundAssignmentExpression* parseCompoundAssignmentExpression(CompoundAssignmentExpression::CompoundAssignmentType type, Expression* lhs, Expression* rhs);
+    BinaryExpression* parseBinaryExpression(BinaryExpression::BinaryType type, Expression* lhs, Expression* rhs);
+    Expression* parseInfixExpression(const OperatorInfo& op, Expression* lhs, Expression* rhs);
     
     // Type cast expression
-    std::shared_ptr<TypeCastExpression> parseTypeCastExpression(std::shared_ptr<Expression> expression, std::shared_ptr<Type> type);
+    TypeCastExpression* parseTypeCastExpression(Expression* expression, Type* type);
 };
\ No newline at end of file
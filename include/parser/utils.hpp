@@ -1,7 +1,5 @@
 #include <iostream>
 
-class ASTVisitor;
-
 class ASTNode;
 
 class Crate;
@@ -42,11 +40,8 @@ class LetStatement;
 class ExpressionStatement;
 class Statements;
 class Expression;
-class ExpressionWithoutBlock;
-class ExpressionWithBlock;
 class LiteralExpression;
 class PathExpression;
-class OperatorExpression;
 class AssignmentExpression;
 class CompoundAssignmentExpression;
 class BinaryExpression;
@@ -105,4 +100,6 @@ class UnitType;
 /****Paths****/
 class PathInExpression;
 class PathIdentSegment; // also PathExprSegment, TypePath, TypePathSegment
-/****Paths****/
\ No newline at end of file
+/****Paths****/
+
+class ErrorNode;
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "parser/astnode.hpp"
+
+// 静态分派的 AST 遍历器（CRTP）。walk 按节点的 kind 直接调用派生类的 visit，不经过虚函数，
+// 可以被内联。派生类只为关心的节点定义 visit，其余节点由默认的 visit 按 forEachChild
+// 给出的顺序遍历子节点。派生类自己定义了 visit 时，需要 using ASTWalker<Derived>::visit
+// 引入默认版本，否则会被隐藏
+template <typename Derived>
+class ASTWalker {
+public:
+    // 空指针直接忽略
+    void walk(ASTNode* node) {
+        if (!node) {
+            return;
+        }
+        switch (node->kind) {
+            case NodeKind::kCrate: return derived().visit(*static_cast<Crate*>(node));
+            case NodeKind::kItem: return derived().visit(*static_cast<Item*>(node));
+            case NodeKind::kFunction: return derived().visit(*static_cast<Function*>(node));
+            case NodeKind::kStruct: return derived().visit(*static_cast<Struct*>(node));
+            case NodeKind::kEnumeration: return derived().visit(*static_cast<Enumeration*>(node));
+            case NodeKind::kConstantItem: return derived().visit(*static_cast<ConstantItem*>(node));
+            case NodeKind::kTrait: return derived().visit(*static_cast<Trait*>(node));
+            case NodeKind::kImplementation: return derived().visit(*static_cast<Implementation*>(node));
+            case NodeKind::kFunctionParameters: return derived().visit(*static_cast<FunctionParameters*>(node));
+            case NodeKind::kSelfParam: return derived().visit(*static_cast<SelfParam*>(node));
+            case NodeKind::kShorthandSelf: return derived().visit(*static_cast<ShorthandSelf*>(node));
+            case NodeKind::kTypedSelf: return derived().visit(*static_cast<TypedSelf*>(node));
+            case NodeKind::kFunctionParam: return derived().visit(*static_cast<FunctionParam*>(node));
+            case NodeKind::kFunctionReturnType: return derived().visit(*static_cast<FunctionReturnType*>(node));
+            case NodeKind::kStructStruct: return derived().visit(*static_cast<StructStruct*>(node));
+            case NodeKind::kStructFields: return derived().visit(*static_cast<StructFields*>(node));
+            case NodeKind::kStructField: return derived().visit(*static_cast<StructField*>(node));
+            case NodeKind::kEnumVariants: return derived().visit(*static_cast<EnumVariants*>(node));
+            case NodeKind::kEnumVariant: return derived().visit(*static_cast<EnumVariant*>(node));
+            case NodeKind::kAssociatedItem: return derived().visit(*static_cast<AssociatedItem*>(node));
+            case NodeKind::kInherentImpl: return derived().visit(*static_cast<InherentImpl*>(node));
+            case NodeKind::kTraitImpl: return derived().visit(*static_cast<TraitImpl*>(node));
+            case NodeKind::kStatement: return derived().visit(*static_cast<Statement*>(node));
+            case NodeKind::kLetStatement: return derived().visit(*static_cast<LetStatement*>(node));
+            case NodeKind::kExpressionStatement: return derived().visit(*static_cast<ExpressionStatement*>(node));
+            case NodeKind::kStatements: return derived().visit(*static_cast<Statements*>(node));
+            case NodeKind::kCharLiteral: return derived().visit(*static_cast<CharLiteral*>(node));
+            case NodeKind::kStringLiteral: return derived().visit(*static_cast<StringLiteral*>(node));
+            case NodeKind::kRawStringLiteral: return derived().visit(*static_cast<RawStringLiteral*>(node));
+            case NodeKind::kCStringLiteral: return derived().visit(*static_cast<CStringLiteral*>(node));
+            case NodeKind::kRawCStringLiteral: return derived().visit(*static_cast<RawCStringLiteral*>(node));
+            case NodeKind::kIntegerLiteral: return derived().visit(*static_cast<IntegerLiteral*>(node));
+            case NodeKind::kBoolLiteral: return derived().visit(*static_cast<BoolLiteral*>(node));
+            case NodeKind::kPathExpression: return derived().visit(*static_cast<PathExpression*>(node));
+            case NodeKind::kUnaryExpression: return derived().visit(*static_cast<UnaryExpression*>(node));
+            case NodeKind::kBorrowExpression: return derived().visit(*static_cast<BorrowExpression*>(node));
+            case NodeKind::kDereferenceExpression: return derived().visit(*static_cast<DereferenceExpression*>(node));
+            case NodeKind::kGroupedExpression: return derived().visit(*static_cast<GroupedExpression*>(node));
+            case NodeKind::kArrayExpression: return derived().visit(*static_cast<ArrayExpression*>(node));
+            case NodeKind::kIndexExpression: return derived().visit(*static_cast<IndexExpression*>(node));
+            case NodeKind::kStructExpression: return derived().visit(*static_cast<StructExpression*>(node));
+            case NodeKind::kCallExpression: return derived().visit(*static_cast<CallExpression*>(node));
+            case NodeKind::kMethodCallExpression: return derived().visit(*static_cast<MethodCallExpression*>(node));
+            case NodeKind::kFieldExpression: return derived().visit(*static_cast<FieldExpression*>(node));
+            case NodeKind::kContinueExpression: return derived().visit(*static_cast<ContinueExpression*>(node));
+            case NodeKind::kBreakExpression: return derived().visit(*static_cast<BreakExpression*>(node));
+            case NodeKind::kReturnExpression: return derived().visit(*static_cast<ReturnExpression*>(node));
+            case NodeKind::kBlockExpression: return derived().visit(*static_cast<BlockExpression*>(node));
+            case NodeKind::kLoopExpression: return derived().visit(*static_cast<LoopExpression*>(node));
+            case NodeKind::kInfiniteLoopExpression: return derived().visit(*static_cast<InfiniteLoopExpression*>(node));
+            case NodeKind::kPredicateLoopExpression: return derived().visit(*static_cast<PredicateLoopExpression*>(node));
+            case NodeKind::kCondition: return derived().visit(*static_cast<Condition*>(node));
+            case NodeKind::kIfExpression: return derived().visit(*static_cast<IfExpression*>(node));
+            case NodeKind::kAssignmentExpression: return derived().visit(*static_cast<AssignmentExpression*>(node));
+            case NodeKind::kCompoundAssignmentExpression: return derived().visit(*static_cast<CompoundAssignmentExpression*>(node));
+            case NodeKind::kBinaryExpression: return derived().visit(*static_cast<BinaryExpression*>(node));
+            case NodeKind::kTypeCastExpression: return derived().visit(*static_cast<TypeCastExpression*>(node));
+            case NodeKind::kPatternNoTopAlt: return derived().visit(*static_cast<PatternNoTopAlt*>(node));
+            case NodeKind::kIdentifierPattern: return derived().visit(*static_cast<IdentifierPattern*>(node));
+            case NodeKind::kReferencePattern: return derived().visit(*static_cast<ReferencePattern*>(node));
+            case NodeKind::kType: return derived().visit(*static_cast<Type*>(node));
+            case NodeKind::kReferenceType: return derived().visit(*static_cast<ReferenceType*>(node));
+            case NodeKind::kArrayType: return derived().visit(*static_cast<ArrayType*>(node));
+            case NodeKind::kUnitType: return derived().visit(*static_cast<UnitType*>(node));
+            case NodeKind::kPathInExpression: return derived().visit(*static_cast<PathInExpression*>(node));
+            case NodeKind::kArrayElements: return derived().visit(*static_cast<ArrayElements*>(node));
+            case NodeKind::kStructExprFields: return derived().visit(*static_cast<StructExprFields*>(node));
+            case NodeKind::kStructExprField: return derived().visit(*static_cast<StructExprField*>(node));
+            case NodeKind::kCallParams: return derived().visit(*static_cast<CallParams*>(node));
+            case NodeKind::kPathIdentSegment: return derived().visit(*static_cast<PathIdentSegment*>(node));
+            case NodeKind::kErrorNode: return derived().visit(*static_cast<ErrorNode*>(node));
+        }
+    }
+
+    // 默认行为：依次遍历全部子节点
+    template <typename Node>
+    void visit(Node& node) {
+        walkChildren(node);
+    }
+
+    template <typename Node>
+    void walkChildren(Node& node) {
+        node.forEachChild([this](auto* child) { walk(child); });
+    }
+private:
+    Derived& derived() { return static_cast<Derived&>(*this); }
+};
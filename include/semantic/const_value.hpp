@@ -12,14 +12,14 @@ class ASTNode;
 // ConstValue 基类
 class ConstValue {
 protected:
-    std::shared_ptr<ASTNode> expression_node;
+    ASTNode* expression_node = nullptr;
 
 public:
-    ConstValue(std::shared_ptr<ASTNode> node);
+    ConstValue(ASTNode* node);
     ~ConstValue() = default;
     
     // 获取对应的 AST 节点
-    std::shared_ptr<ASTNode> getExpressionNode() const;
+    ASTNode* getExpressionNode() const;
     
     // 获取值的类型（用于类型检查）
     virtual std::string getValueType() const = 0;
@@ -42,7 +42,7 @@ private:
     int value;
 
 public:
-    ConstValueInt(int value, std::shared_ptr<ASTNode> node);
+    ConstValueInt(int value, ASTNode* node);
     
     int getValue() const;
     void setValue(int value);
@@ -59,7 +59,7 @@ private:
     bool value;
 
 public:
-    ConstValueBool(bool value, std::shared_ptr<ASTNode> node);
+    ConstValueBool(bool value, ASTNode* node);
     
     bool getValue() const;
     void setValue(bool value);
@@ -76,7 +76,7 @@ private:
     char value;
 
 public:
-    ConstValueChar(char value, std::shared_ptr<ASTNode> node);
+    ConstValueChar(char value, ASTNode* node);
     
     char getValue() const;
     void setValue(char value);
@@ -90,10 +90,12 @@ public:
 // 字符串常量值
 class ConstValueString : public ConstValue {
 private:
-    std::string value;
+    // 内容存放在字面量池中，复制与比较都只涉及编号
+    LiteralId value;
 
 public:
-    ConstValueString(const std::string& value, std::shared_ptr<ASTNode> node);
+    ConstValueString(LiteralId value, ASTNode* node);
+    LiteralId getLiteral() const { return value; }
     
     const std::string& getValue() const;
     void setValue(const std::string& value);
@@ -111,7 +113,7 @@ private:
     std::unordered_map<std::string, std::shared_ptr<ConstValue>> fields;
 
 public:
-    ConstValueStruct(const std::string& struct_name, std::shared_ptr<ASTNode> node);
+    ConstValueStruct(const std::string& struct_name, ASTNode* node);
     
     const std::string& getStructName() const;
     void setStructName(const std::string& name);
@@ -135,7 +137,7 @@ private:
     std::string variant_name;
 
 public:
-    ConstValueEnum(const std::string& enum_name, const std::string& variant_name, std::shared_ptr<ASTNode> node);
+    ConstValueEnum(const std::string& enum_name, const std::string& variant_name, ASTNode* node);
     
     const std::string& getEnumName() const;
     void setEnumName(const std::string& name);
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "lexer/interner.hpp"
+
+// 语义分析中反复比较或查找的固定名字，与 lexer/interner.hpp 中的 self、Self 同属 names
+namespace names {
+inline const Name kMain{"main"};
+inline const Name kExit{"exit"};
+inline const Name kLen{"len"};
+// 符号自身的占位类型名
+inline const Name kUnknown{"unknown"};
+inline const Name kFunction{"function"};
+inline const Name kTrait{"trait"};
+inline const Name kArray{"array"};
+inline const Name kStruct{"Struct"};
+}
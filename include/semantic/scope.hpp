@@ -8,11 +8,11 @@
 
 // 变量信息结构体，包含类型和可变性标记
 struct VariableInfo {
-    std::string type;
+    SymbolType type;
     bool is_mutable;
     
-    VariableInfo() : type(""), is_mutable(false) {}
-    VariableInfo(const std::string& t, bool mut = false) : type(t), is_mutable(mut) {}
+    VariableInfo() : type(), is_mutable(false) {}
+    VariableInfo(const SymbolType& t, bool mut = false) : type(t), is_mutable(mut) {}
 };
 
 enum class ScopeType {
@@ -28,18 +28,18 @@ class Scope : public std::enable_shared_from_this<Scope> {
 private:
     ScopeType type;
     size_t pos; // 目前应该访问哪个 children?
-    std::string self_type; // for impl scope & function scope
-    std::string break_type;
+    Name self_type; // for impl scope & function scope
+    SymbolType break_type;
     bool has_break;
     bool has_return;
     std::shared_ptr<Scope> parent_scope;
     std::vector<std::shared_ptr<Scope>> children;
-    std::unordered_map<std::string, std::shared_ptr<ConstSymbol>> const_symbols;
-    std::unordered_map<std::string, std::shared_ptr<StructSymbol>> struct_symbols;
-    std::unordered_map<std::string, std::shared_ptr<EnumSymbol>> enum_symbols;
-    std::unordered_map<std::string, std::shared_ptr<FuncSymbol>> func_symbols;
-    std::unordered_map<std::string, std::shared_ptr<TraitSymbol>> trait_symbols;
-    std::unordered_map<std::string, VariableInfo> variable_table;
+    std::unordered_map<Name, std::shared_ptr<ConstSymbol>> const_symbols;
+    std::unordered_map<Name, std::shared_ptr<StructSymbol>> struct_symbols;
+    std::unordered_map<Name, std::shared_ptr<EnumSymbol>> enum_symbols;
+    std::unordered_map<Name, std::shared_ptr<FuncSymbol>> func_symbols;
+    std::unordered_map<Name, std::shared_ptr<TraitSymbol>> trait_symbols;
+    std::unordered_map<Name, VariableInfo> variable_table;
 
 public:
     // 构造函数
@@ -52,11 +52,11 @@ public:
     std::shared_ptr<Scope> getChild() const;
     void nextChild();
     void resetChild();
-    void setSelfType(std::string);
-    std::string getSelfType();
-    void setBreakType(std::string);
-    std::string getBreakType();
-    std::string getImplSelfType();
+    void setSelfType(Name);
+    Name getSelfType();
+    void setBreakType(SymbolType);
+    SymbolType getBreakType();
+    Name getImplSelfType();
     void setHasBreak(bool);
     bool hasBreak();
     void setHasReturn(bool);
@@ -67,64 +67,65 @@ public:
     void setParent(std::shared_ptr<Scope> parent);
     
     // 常量符号管理
-    void addConstSymbol(const std::string& name, std::shared_ptr<ConstSymbol> symbol);
-    std::shared_ptr<ConstSymbol> getConstSymbol(const std::string& name) const;
-    bool hasConstSymbol(const std::string& name) const;
-    const std::unordered_map<std::string, std::shared_ptr<ConstSymbol>>& getConstSymbols() const;
+    void addConstSymbol(const Name& name, std::shared_ptr<ConstSymbol> symbol);
+    std::shared_ptr<ConstSymbol> getConstSymbol(const Name& name) const;
+    bool hasConstSymbol(const Name& name) const;
+    const std::unordered_map<Name, std::shared_ptr<ConstSymbol>>& getConstSymbols() const;
     
     // 结构体符号管理
-    void addStructSymbol(const std::string& name, std::shared_ptr<StructSymbol> symbol);
-    std::shared_ptr<StructSymbol> getStructSymbol(const std::string& name) const;
-    bool hasStructSymbol(const std::string& name) const;
-    const std::unordered_map<std::string, std::shared_ptr<StructSymbol>>& getStructSymbols() const;
+    void addStructSymbol(const Name& name, std::shared_ptr<StructSymbol> symbol);
+    std::shared_ptr<StructSymbol> getStructSymbol(const Name& name) const;
+    bool hasStructSymbol(const Name& name) const;
+    const std::unordered_map<Name, std::shared_ptr<StructSymbol>>& getStructSymbols() const;
     
     // 枚举符号管理
-    void addEnumSymbol(const std::string& name, std::shared_ptr<EnumSymbol> symbol);
-    std::shared_ptr<EnumSymbol> getEnumSymbol(const std::string& name) const;
-    bool hasEnumSymbol(const std::string& name) const;
-    const std::unordered_map<std::string, std::shared_ptr<EnumSymbol>>& getEnumSymbols() const;
+    void addEnumSymbol(const Name& name, std::shared_ptr<EnumSymbol> symbol);
+    std::shared_ptr<EnumSymbol> getEnumSymbol(const Name& name) const;
+    bool hasEnumSymbol(const Name& name) const;
+    const std::unordered_map<Name, std::shared_ptr<EnumSymbol>>& getEnumSymbols() const;
     
     // 函数符号管理
-    void addFuncSymbol(const std::string& name, std::shared_ptr<FuncSymbol> symbol);
-    std::shared_ptr<FuncSymbol> getFuncSymbol(const std::string& name) const;
-    bool hasFuncSymbol(const std::string& name) const;
-    const std::unordered_map<std::string, std::shared_ptr<FuncSymbol>>& getFuncSymbols() const;
+    void addFuncSymbol(const Name& name, std::shared_ptr<FuncSymbol> symbol);
+    std::shared_ptr<FuncSymbol> getFuncSymbol(const Name& name) const;
+    bool hasFuncSymbol(const Name& name) const;
+    const std::unordered_map<Name, std::shared_ptr<FuncSymbol>>& getFuncSymbols() const;
     
     // 特征符号管理
-    void addTraitSymbol(const std::string& name, std::shared_ptr<TraitSymbol> symbol);
-    std::shared_ptr<TraitSymbol> getTraitSymbol(const std::string& name) const;
-    bool hasTraitSymbol(const std::string& name) const;
-    const std::unordered_map<std::string, std::shared_ptr<TraitSymbol>>& getTraitSymbols() const;
+    void addTraitSymbol(const Name& name, std::shared_ptr<TraitSymbol> symbol);
+    std::shared_ptr<TraitSymbol> getTraitSymbol(const Name& name) const;
+    bool hasTraitSymbol(const Name& name) const;
+    const std::unordered_map<Name, std::shared_ptr<TraitSymbol>>& getTraitSymbols() const;
     
     // 变量表管理
-    void addVariable(const std::string& name, const std::string& type, bool is_mutable = false);
-    std::string getVariableType(const std::string& name) const;
-    bool isVariableMutable(const std::string& name) const;
-    bool hasVariable(const std::string& name) const;
-    const std::unordered_map<std::string, VariableInfo>& getVariableTable() const;
-    std::string findVariableType(const std::string& name) const; // 在作用域链中查找
-    bool findVariableMutable(const std::string& name) const; // 在作用域链中查找变量可变性
-    bool variableExists(const std::string& name) const; // 在作用域链中检查变量是否存在
+    void addVariable(const Name& name, const SymbolType& type, bool is_mutable = false);
+    SymbolType getVariableType(const Name& name) const;
+    bool isVariableMutable(const Name& name) const;
+    bool hasVariable(const Name& name) const;
+    const std::unordered_map<Name, VariableInfo>& getVariableTable() const;
+    SymbolType findVariableType(const Name& name) const; // 在作用域链中查找
+    bool findVariableMutable(const Name& name) const; // 在作用域链中查找变量可变性
+    bool variableExists(const Name& name) const; // 在作用域链中检查变量是否存在
     
     // 通用符号查找（在作用域链中查找）
-    std::shared_ptr<Symbol> findSymbol(const std::string& name) const;
-    std::shared_ptr<ConstSymbol> findConstSymbol(const std::string& name) const;
-    std::shared_ptr<StructSymbol> findStructSymbol(const std::string& name) const;
-    std::shared_ptr<EnumSymbol> findEnumSymbol(const std::string& name) const;
-    std::shared_ptr<FuncSymbol> findFuncSymbol(const std::string& name) const;
-    std::shared_ptr<TraitSymbol> findTraitSymbol(const std::string& name) const;
+    std::shared_ptr<Symbol> findSymbol(const Name& name) const;
+    std::shared_ptr<ConstSymbol> findConstSymbol(const Name& name) const;
+    std::shared_ptr<StructSymbol> findStructSymbol(const Name& name) const;
+    std::shared_ptr<EnumSymbol> findEnumSymbol(const Name& name) const;
+    std::shared_ptr<FuncSymbol> findFuncSymbol(const Name& name) const;
+    std::shared_ptr<TraitSymbol> findTraitSymbol(const Name& name) const;
+    std::shared_ptr<Symbol> findTypeSymbol(const Name& name) const; // 作用域链中最近的同名结构体或枚举
     
     // 检查符号是否存在于作用域链中
-    bool symbolExists(const std::string& name) const;
-    bool constSymbolExists(const std::string& name) const;
-    bool structSymbolExists(const std::string& name) const;
-    bool enumSymbolExists(const std::string& name) const;
-    bool funcSymbolExists(const std::string& name) const;
-    bool traitSymbolExists(const std::string& name) const;
+    bool symbolExists(const Name& name) const;
+    bool constSymbolExists(const Name& name) const;
+    bool structSymbolExists(const Name& name) const;
+    bool enumSymbolExists(const Name& name) const;
+    bool funcSymbolExists(const Name& name) const;
+    bool traitSymbolExists(const Name& name) const;
     
     // 仅在当前作用域中查找
-    std::shared_ptr<Symbol> getSymbolInCurrentScope(const std::string& name) const;
-    bool hasSymbolInCurrentScope(const std::string& name) const;
+    std::shared_ptr<Symbol> getSymbolInCurrentScope(const Name& name) const;
+    bool hasSymbolInCurrentScope(const Name& name) const;
     
     // 调试和输出
     void printScope(int indent = 0) const;
@@ -5,12 +5,15 @@
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include "lexer/interner.hpp"
+#include "type_context.hpp"
+#include "names.hpp"
 
 // 前向声明
 class ConstValue;
 class FuncSymbol;
 
-using SymbolType = std::string;
+using SymbolType = TypeId;
 
 class Symbol {
 private:
@@ -24,12 +27,12 @@ public:
 
 class ConstSymbol : public Symbol {
 private:
-    std::string identifier;
+    Name identifier;
     std::shared_ptr<ConstValue> value;
 public:
-    ConstSymbol(const std::string& identifier, const SymbolType& type);
-    ConstSymbol(const std::string& identifier, const SymbolType& type, std::shared_ptr<ConstValue> value);
-    std::string getIdentifier() const;
+    ConstSymbol(const Name& identifier, const SymbolType& type);
+    ConstSymbol(const Name& identifier, const SymbolType& type, std::shared_ptr<ConstValue> value);
+    Name getIdentifier() const;
     std::shared_ptr<ConstValue> getValue() const;
     void setValue(std::shared_ptr<ConstValue> value);
     bool hasValue() const;
@@ -37,51 +40,51 @@ public:
 
 class VariableSymbol : public Symbol {
 private:
-    std::string identifier;
+    Name identifier;
     bool is_ref;
     int is_mut;
 public:
-    VariableSymbol(const std::string identifier, const SymbolType type, bool is_ref = false, int is_mut = 0);
-    std::string getIdentifier() const;
+    VariableSymbol(const Name& identifier, const SymbolType type, bool is_ref = false, int is_mut = 0);
+    Name getIdentifier() const;
     bool isRef() const;
     int getMut() const;
 };
 
 class StructSymbol : public Symbol {
 private:
-    std::string identifier;
-    std::unordered_map<std::string, std::shared_ptr<VariableSymbol>> vars;
-    std::unordered_map<std::string, std::shared_ptr<ConstSymbol>> associated_consts;
-    std::unordered_map<std::string, std::shared_ptr<FuncSymbol>> methods;      // 带 self 参数的方法
-    std::unordered_map<std::string, std::shared_ptr<FuncSymbol>> functions;    // 不带 self 参数的关联函数
+    Name identifier;
+    std::unordered_map<Name, std::shared_ptr<VariableSymbol>> vars;
+    std::unordered_map<Name, std::shared_ptr<ConstSymbol>> associated_consts;
+    std::unordered_map<Name, std::shared_ptr<FuncSymbol>> methods;      // 带 self 参数的方法
+    std::unordered_map<Name, std::shared_ptr<FuncSymbol>> functions;    // 不带 self 参数的关联函数
 public:
-    StructSymbol(const std::string& identifier, const SymbolType& type);
-    std::string getIdentifier() const;
+    StructSymbol(const Name& identifier, const SymbolType& type);
+    Name getIdentifier() const;
     
     // 字段管理
     void addField(std::shared_ptr<VariableSymbol> field);
-    void eraseField(std::string str);
-    bool hasField(const std::string& name) const;
-    std::shared_ptr<VariableSymbol> getField(const std::string& name) const;
+    void eraseField(const Name& name);
+    bool hasField(const Name& name) const;
+    std::shared_ptr<VariableSymbol> getField(const Name& name) const;
     std::vector<std::shared_ptr<VariableSymbol>> getFields() const;
     int getFieldSize() const;
     
     // 关联常量管理
     void addAssociatedConst(std::shared_ptr<ConstSymbol> const_symbol);
-    bool hasAssociatedConst(const std::string& name) const;
-    std::shared_ptr<ConstSymbol> getAssociatedConst(const std::string& name) const;
+    bool hasAssociatedConst(const Name& name) const;
+    std::shared_ptr<ConstSymbol> getAssociatedConst(const Name& name) const;
     std::vector<std::shared_ptr<ConstSymbol>> getAssociatedConsts() const;
     
     // 方法管理（带 self 参数）
     void addMethod(std::shared_ptr<FuncSymbol> method);
-    bool hasMethod(const std::string& name) const;
-    std::shared_ptr<FuncSymbol> getMethod(const std::string& name) const;
+    bool hasMethod(const Name& name) const;
+    std::shared_ptr<FuncSymbol> getMethod(const Name& name) const;
     std::vector<std::shared_ptr<FuncSymbol>> getMethods() const;
     
     // 关联函数管理（不带 self 参数）
     void addAssociatedFunction(std::shared_ptr<FuncSymbol> function);
-    bool hasAssociatedFunction(const std::string& name) const;
-    std::shared_ptr<FuncSymbol> getAssociatedFunction(const std::string& name) const;
+    bool hasAssociatedFunction(const Name& name) const;
+    std::shared_ptr<FuncSymbol> getAssociatedFunction(const Name& name) const;
     std::vector<std::shared_ptr<FuncSymbol>> getAssociatedFunctions() const;
     
     // 获取所有关联项（方法 + 关联函数）
@@ -90,19 +93,19 @@ public:
 
 class EnumVar {
 private:
-    std::string identifier;
+    Name identifier;
 public:
-    EnumVar(const std::string& identifier);
-    std::string getIdentifier() const;
+    EnumVar(const Name& identifier);
+    Name getIdentifier() const;
 };
 
 class EnumSymbol : public Symbol {
 private:
-    std::string identifier;
+    Name identifier;
     std::vector<std::shared_ptr<EnumVar>> vars;
 public:
-    EnumSymbol(const std::string& identifier, const SymbolType& type);
-    std::string getIdentifier() const;
+    EnumSymbol(const Name& identifier, const SymbolType& type);
+    Name getIdentifier() const;
     void addVariant(std::shared_ptr<EnumVar> variant);
     const std::vector<std::shared_ptr<EnumVar>>& getVariants() const;
 };
@@ -120,12 +123,12 @@ class FuncSymbol : public Symbol {
 private:
     bool is_const;
     MethodType method_type;
-    std::string identifier;
+    Name identifier;
     std::vector<std::shared_ptr<VariableSymbol>> func_params;
     SymbolType return_type;
 public:
-    FuncSymbol(const std::string& identifier, const SymbolType& return_type, bool is_const = false, MethodType method_type = MethodType::NOT_METHOD);
-    std::string getIdentifier() const;
+    FuncSymbol(const Name& identifier, const SymbolType& return_type, bool is_const = false, MethodType method_type = MethodType::NOT_METHOD);
+    Name getIdentifier() const;
     bool isConst() const;
     bool isMethod() const;
     MethodType getMethodType() const;
@@ -133,35 +136,35 @@ public:
     void addParameter(std::shared_ptr<VariableSymbol> param);
     const std::vector<std::shared_ptr<VariableSymbol>>& getParameters() const;
     SymbolType getReturnType() const;
-    void setReturnType(std::string);
+    void setReturnType(SymbolType);
 };
 
 class TraitSymbol : public Symbol {
 private:
-    std::string identifier;
-    std::unordered_map<std::string, std::shared_ptr<ConstSymbol>> const_symbols;
-    std::unordered_map<std::string, std::shared_ptr<FuncSymbol>> methods;      // 带 self 参数的方法
-    std::unordered_map<std::string, std::shared_ptr<FuncSymbol>> functions;    // 不带 self 参数的关联函数
+    Name identifier;
+    std::unordered_map<Name, std::shared_ptr<ConstSymbol>> const_symbols;
+    std::unordered_map<Name, std::shared_ptr<FuncSymbol>> methods;      // 带 self 参数的方法
+    std::unordered_map<Name, std::shared_ptr<FuncSymbol>> functions;    // 不带 self 参数的关联函数
 public:
-    TraitSymbol(const std::string& identifier);
-    std::string getIdentifier() const;
+    TraitSymbol(const Name& identifier);
+    Name getIdentifier() const;
     
     // 关联常量管理
     void addConstSymbol(std::shared_ptr<ConstSymbol> const_symbol);
-    bool hasConstSymbol(const std::string& name) const;
-    std::shared_ptr<ConstSymbol> getConstSymbol(const std::string& name) const;
+    bool hasConstSymbol(const Name& name) const;
+    std::shared_ptr<ConstSymbol> getConstSymbol(const Name& name) const;
     std::vector<std::shared_ptr<ConstSymbol>> getConstSymbols() const;
     
     // 方法管理（带 self 参数）
     void addMethod(std::shared_ptr<FuncSymbol> method);
-    bool hasMethod(const std::string& name) const;
-    std::shared_ptr<FuncSymbol> getMethod(const std::string& name) const;
+    bool hasMethod(const Name& name) const;
+    std::shared_ptr<FuncSymbol> getMethod(const Name& name) const;
     std::vector<std::shared_ptr<FuncSymbol>> getMethods() const;
     
     // 关联函数管理（不带 self 参数）
     void addAssociatedFunction(std::shared_ptr<FuncSymbol> function);
-    bool hasAssociatedFunction(const std::string& name) const;
-    std::shared_ptr<FuncSymbol> getAssociatedFunction(const std::string& name) const;
+    bool hasAssociatedFunction(const Name& name) const;
+    std::shared_ptr<FuncSymbol> getAssociatedFunction(const Name& name) const;
     std::vector<std::shared_ptr<FuncSymbol>> getAssociatedFunctions() const;
     
     // 获取所有关联项（方法 + 关联函数）
@@ -171,14 +174,14 @@ public:
 class ArraySymbol : public Symbol {
 private:
     std::string identifier;
-    std::string element_type;
+    SymbolType element_type;
     std::shared_ptr<ConstValue> length;
 public:
-    ArraySymbol(const std::string& identifier, const std::string& element_type);
-    ArraySymbol(const std::string& identifier, const std::string& element_type, std::shared_ptr<ConstValue> length);
+    ArraySymbol(const std::string& identifier, const SymbolType& element_type);
+    ArraySymbol(const std::string& identifier, const SymbolType& element_type, std::shared_ptr<ConstValue> length);
     std::string getIdentifier() const;
-    std::string getElementType() const;
-    void setElementType(const std::string& element_type);
+    SymbolType getElementType() const;
+    void setElementType(const SymbolType& element_type);
     std::shared_ptr<ConstValue> getLength() const;
     void setLength(std::shared_ptr<ConstValue> length);
     bool hasLength() const;
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "parser/visitor.hpp"
+#include "parser/walker.hpp"
 #include "parser/astnode.hpp"
 
 #include "scope.hpp"
@@ -9,121 +9,60 @@
 #include "const_evaluator.hpp"
 #include "utils.hpp"
 #include <memory>
+#include <unordered_map>
 
-class SymbolCollector : public ASTVisitor {
+class SymbolCollector : public ASTWalker<SymbolCollector> {
 private:
     std::shared_ptr<Scope> current_scope;
     std::shared_ptr<Scope> root_scope;
+    // 已声明的结构体与枚举，以声明节点为键
+    std::unordered_map<const ASTNode*, std::shared_ptr<Symbol>> declarations;
     
-    // 辅助方法
-    // 已经全部移动到 utils
+    // 辅助方法，其余已经全部移动到 utils
+    void declareType(ASTNode* item);
+    std::shared_ptr<StructSymbol> declareStruct(StructStruct& node);
+    std::shared_ptr<EnumSymbol> declareEnum(Enumeration& node);
     
 public:
+    using ASTWalker<SymbolCollector>::visit;
+
     SymbolCollector();
     ~SymbolCollector() = default;
     
     std::shared_ptr<Scope> getRootScope() const { return root_scope; }
     
-    // 顶层节点
-    void visit(Crate& node) override;
-    void visit(Item& node) override;
+    void visit(Crate& node);
     
     // 声明类节点 (Items)
-    void visit(Function& node) override;
-    void visit(Struct& node) override;
-    void visit(Enumeration& node) override;
-    void visit(ConstantItem& node) override;
-    void visit(Trait& node) override;
-    void visit(Implementation& node) override;
+    void visit(Function& node);
+    void visit(Enumeration& node);
+    void visit(ConstantItem& node);
+    void visit(Trait& node);
     
     // 函数相关节点
-    void visit(FunctionParameters& node) override;
-    void visit(FunctionParam& node) override;
-    void visit(FunctionReturnType& node) override;
+    void visit(FunctionParam& node);
+    void visit(FunctionReturnType& node);
     
     // 结构体相关节点
-    void visit(StructStruct& node) override;
-    void visit(StructFields& node) override;
-    void visit(StructField& node) override;
+    void visit(StructStruct& node);
+    void visit(StructFields& node);
+    void visit(StructField& node);
     
     // 枚举相关节点
-    void visit(EnumVariants& node) override;
-    void visit(EnumVariant& node) override;
+    void visit(EnumVariants& node);
     
     // 实现相关节点
-    void visit(AssociatedItem& node) override;
-    void visit(InherentImpl& node) override;
-    void visit(TraitImpl& node) override;
+    void visit(InherentImpl& node);
+    void visit(TraitImpl& node);
     
     // 语句类节点
-    void visit(Statement& node) override;
-    void visit(LetStatement& node) override;
-    void visit(ExpressionStatement& node) override;
-    void visit(Statements& node) override;
-    
-    // 表达式类节点
-    void visit(Expression& node) override;
-    void visit(ExpressionWithoutBlock& node) override;
-    void visit(ExpressionWithBlock& node) override;
+    void visit(LetStatement& node);
     
     // 控制流表达式
-    void visit(BlockExpression& node) override;
-    void visit(IfExpression& node) override;
-    void visit(LoopExpression& node) override;
-    void visit(InfiniteLoopExpression& node) override;
-    void visit(PredicateLoopExpression& node) override;
-    
-    // 模式类节点
-    void visit(PatternNoTopAlt& node) override;
-    void visit(IdentifierPattern& node) override;
-    
-    // 类型类节点
-    void visit(Type& node) override;
-    void visit(PathInExpression& node) override;
-    void visit(PathIdentSegment& node) override;
-    
-    // 其他需要遍历的节点
-    void visit(CallExpression& node) override;
-    void visit(MethodCallExpression& node) override;
-    void visit(FieldExpression& node) override;
-    void visit(IndexExpression& node) override;
-    void visit(StructExpression& node) override;
-    void visit(ArrayExpression& node) override;
-    void visit(GroupedExpression& node) override;
-    void visit(UnaryExpression& node) override;
-    void visit(BorrowExpression& node) override;
-    void visit(DereferenceExpression& node) override;
-    void visit(BinaryExpression& node) override;
-    void visit(AssignmentExpression& node) override;
-    void visit(CompoundAssignmentExpression& node) override;
-    void visit(TypeCastExpression& node) override;
-    void visit(PathExpression& node) override;
-    void visit(Condition& node) override;
-    void visit(ArrayElements& node) override;
-    void visit(StructExprFields& node) override;
-    void visit(StructExprField& node) override;
-    void visit(CallParams& node) override;
-    void visit(ReferenceType& node) override;
-    void visit(ArrayType& node) override;
-    void visit(UnitType& node) override;
-    void visit(ReferencePattern& node) override;
-    
-    // 字面量表达式
-    void visit(CharLiteral& node) override;
-    void visit(StringLiteral& node) override;
-    void visit(RawStringLiteral& node) override;
-    void visit(CStringLiteral& node) override;
-    void visit(RawCStringLiteral& node) override;
-    void visit(IntegerLiteral& node) override;
-    void visit(BoolLiteral& node) override;
-    
-    // 控制流
-    void visit(BreakExpression& node) override;
-    void visit(ContinueExpression& node) override;
-    void visit(ReturnExpression& node) override;
+    void visit(BlockExpression& node);
+    void visit(InfiniteLoopExpression& node);
+    void visit(PredicateLoopExpression& node);
     
     // 其他
-    void visit(SelfParam& node) override;
-    void visit(ShorthandSelf& node) override;
-    void visit(TypedSelf& node) override;
+    void visit(TypedSelf& node);
 };
\ No newline at end of file
@@ -4,132 +4,112 @@
 #include <cstring>
 
 #include "parser/astnode.hpp"
-#include "parser/visitor.hpp"
+#include "parser/node_table.hpp"
+#include "parser/walker.hpp"
 #include "const_value.hpp"
 #include "symbol.hpp"
 #include "scope.hpp"
 #include "utils.hpp"
 
-class TypeChecker : ASTVisitor {
+class TypeChecker : public ASTWalker<TypeChecker> {
 private:
     std::shared_ptr<Scope> current_scope;
     std::shared_ptr<Scope> root_scope;
+    TypeContext& types;
+
+    // 每个节点推导出的类型与可变性，按节点编号存放，进入 Crate 时建表
+    NodeTable<SymbolType> node_types;
+    NodeTable<bool> node_mutability;
 
     bool canAssign(SymbolType var_type, SymbolType expr_type);
     SymbolType autoDereference(SymbolType type);
     bool isIntegerType(const SymbolType& type);
-    std::pair<std::string, std::string> getBaseType(const SymbolType& type);
-    void checkIntegerOverflow(std::string, int);
+    void checkIntegerOverflow(uint64_t, int);
 
     int exit_num;
 
 public:
+    using ASTWalker<TypeChecker>::visit;
+
     TypeChecker(std::shared_ptr<Scope> root_scope);
     ~TypeChecker() = default;
 
+    const NodeTable<SymbolType>& nodeTypes() const { return node_types; }
+    const NodeTable<bool>& nodeMutability() const { return node_mutability; }
+
     // 顶层节点
-    void visit(Crate& node) override;
-    void visit(Item& node) override;
+    void visit(Crate& node);
+    void visit(Item& node);
 
     // 声明类节点 (Items)
-    void visit(Function& node) override;
-    void visit(Struct& node) override;
-    void visit(Enumeration& node) override;
-    void visit(ConstantItem& node) override;
-    void visit(Trait& node) override;
-    void visit(Implementation& node) override;
+    void visit(Function& node);
+    void visit(ConstantItem& node);
+    void visit(Trait& node);
 
     // 函数相关节点
-    void visit(FunctionParameters& node) override;
-    void visit(FunctionParam& node) override;
-    void visit(FunctionReturnType& node) override;
-
-    // 结构体相关节点
-    void visit(StructStruct& node) override;
-    void visit(StructFields& node) override;
-    void visit(StructField& node) override;
-
-    // 枚举相关节点
-    void visit(EnumVariants& node) override;
-    void visit(EnumVariant& node) override;
+    void visit(FunctionParam& node);
 
     // 实现相关节点
-    void visit(AssociatedItem& node) override;
-    void visit(InherentImpl& node) override;
-    void visit(TraitImpl& node) override;
+    void visit(AssociatedItem& node);
+    void visit(InherentImpl& node);
+    void visit(TraitImpl& node);
 
     // 语句类节点
-    void visit(Statement& node) override;
-    void visit(LetStatement& node) override;
-    void visit(ExpressionStatement& node) override;
-    void visit(Statements& node) override;
-
-    // 表达式类节点
-    void visit(Expression& node) override;
-    void visit(ExpressionWithoutBlock& node) override;
-    void visit(ExpressionWithBlock& node) override;
+    void visit(Statement& node);
+    void visit(LetStatement& node);
+    void visit(ExpressionStatement& node);
 
     // 控制流表达式
-    void visit(BlockExpression& node) override;
-    void visit(IfExpression& node) override;
-    void visit(LoopExpression& node) override;
-    void visit(InfiniteLoopExpression& node) override;
-    void visit(PredicateLoopExpression& node) override;
+    void visit(BlockExpression& node);
+    void visit(IfExpression& node);
+    void visit(LoopExpression& node);
+    void visit(InfiniteLoopExpression& node);
+    void visit(PredicateLoopExpression& node);
 
     // 模式类节点
-    void visit(PatternNoTopAlt& node) override;
-    void visit(IdentifierPattern& node) override;
+    void visit(PatternNoTopAlt& node);
+    void visit(IdentifierPattern& node);
 
     // 类型类节点
-    void visit(Type& node) override;
-    void visit(PathInExpression& node) override;
-    void visit(PathIdentSegment& node) override;
+    void visit(Type& node);
+    void visit(PathInExpression& node);
+    void visit(PathIdentSegment& node);
 
     // 其他需要遍历的节点
 
-    void checkFunctionParams(const std::vector<std::shared_ptr<Expression>>& call_params, const std::vector<std::shared_ptr<VariableSymbol>>& func_params);
-
-    void visit(CallExpression& node) override;
-    void visit(MethodCallExpression& node) override;
-    void visit(FieldExpression& node) override;
-    void visit(IndexExpression& node) override;
-    void visit(StructExpression& node) override;
-    void visit(ArrayExpression& node) override;
-    void visit(GroupedExpression& node) override;
-    void visit(UnaryExpression& node) override;
-    void visit(BorrowExpression& node) override;
-    void visit(DereferenceExpression& node) override;
-    void visit(BinaryExpression& node) override;
-    void visit(AssignmentExpression& node) override;
-    void visit(CompoundAssignmentExpression& node) override;
-    void visit(TypeCastExpression& node) override;
-    void visit(PathExpression& node) override;
-    void visit(Condition& node) override;
-    void visit(ArrayElements& node) override;
-    void visit(StructExprFields& node) override;
-    void visit(StructExprField& node) override;
-    void visit(CallParams& node) override;
-    void visit(ReferenceType& node) override;
-    void visit(ArrayType& node) override;
-    void visit(UnitType& node) override;
-    void visit(ReferencePattern& node) override;
+    void checkFunctionParams(const std::vector<Expression*>& call_params, const std::vector<std::shared_ptr<VariableSymbol>>& func_params);
+
+    void visit(CallExpression& node);
+    void visit(MethodCallExpression& node);
+    void visit(FieldExpression& node);
+    void visit(IndexExpression& node);
+    void visit(StructExpression& node);
+    void visit(ArrayExpression& node);
+    void visit(GroupedExpression& node);
+    void visit(UnaryExpression& node);
+    void visit(BorrowExpression& node);
+    void visit(DereferenceExpression& node);
+    void visit(BinaryExpression& node);
+    void visit(AssignmentExpression& node);
+    void visit(CompoundAssignmentExpression& node);
+    void visit(TypeCastExpression& node);
+    void visit(PathExpression& node);
+    void visit(Condition& node);
+    void visit(ArrayElements& node);
+    void visit(StructExprField& node);
+    void visit(ReferencePattern& node);
 
     // 字面量表达式
-    void visit(CharLiteral& node) override;
-    void visit(StringLiteral& node) override;
-    void visit(RawStringLiteral& node) override;
-    void visit(CStringLiteral& node) override;
-    void visit(RawCStringLiteral& node) override;
-    void visit(IntegerLiteral& node) override;
-    void visit(BoolLiteral& node) override;
+    void visit(CharLiteral& node);
+    void visit(StringLiteral& node);
+    void visit(RawStringLiteral& node);
+    void visit(CStringLiteral& node);
+    void visit(RawCStringLiteral& node);
+    void visit(IntegerLiteral& node);
+    void visit(BoolLiteral& node);
 
     // 控制流
-    void visit(BreakExpression& node) override;
-    void visit(ContinueExpression& node) override;
-    void visit(ReturnExpression& node) override;
-
-    // 其他
-    void visit(SelfParam& node) override;
-    void visit(ShorthandSelf& node) override;
-    void visit(TypedSelf& node) override;
+    void visit(BreakExpression& node);
+    void visit(ContinueExpression& node);
+    void visit(ReturnExpression& node);
 };
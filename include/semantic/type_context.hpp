@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include "lexer/interner.hpp"
+
+enum class TypeKind : uint8_t {
+    kNone,       // 编号 0：尚未推导出类型
+    kPrimitive,  // bool、char、i32 等内建类型，以及未定具体类型的整数字面量 integer
+    kUnit,       // ()
+    kNever,      // !
+    kNamed,      // 结构体、枚举（按声明区分），以及其他按名字出现的类型
+    kReference,
+    kArray
+};
+
+// 驻留后的类型。相等比较与哈希都只看编号，结构相同的类型编号相同。
+// 编号 0 表示尚未推导出类型，写出来是空串
+class TypeId {
+private:
+    uint32_t id = 0;
+public:
+    constexpr TypeId() = default;
+
+    static constexpr TypeId fromId(uint32_t id) {
+        TypeId type;
+        type.id = id;
+        return type;
+    }
+    constexpr uint32_t getId() const { return id; }
+    constexpr bool empty() const { return id == 0; }
+    // 类型的写法：[T]N 为长度为 N 的数组，[T] 为长度未知的数组，&T 为引用
+    const std::string& str() const;
+
+    constexpr bool operator==(const TypeId& other) const { return id == other.id; }
+    constexpr bool operator!=(const TypeId& other) const { return id != other.id; }
+};
+
+std::string operator+(const std::string&, const TypeId&);
+std::string operator+(const TypeId&, const std::string&);
+std::string operator+(const char*, const TypeId&);
+std::string operator+(const TypeId&, const char*);
+std::ostream& operator<<(std::ostream&, const TypeId&);
+
+class Symbol;
+
+template <>
+struct std::hash<TypeId> {
+    size_t operator()(const TypeId& type) const noexcept { return type.getId(); }
+};
+
+// 内建类型的编号在 TypeContext 构造时依次分配，是编译期常量
+namespace types {
+inline constexpr TypeId kUnit = TypeId::fromId(1);
+inline constexpr TypeId kNever = TypeId::fromId(2);
+inline constexpr TypeId kInteger = TypeId::fromId(3);
+inline constexpr TypeId kBool = TypeId::fromId(4);
+inline constexpr TypeId kChar = TypeId::fromId(5);
+inline constexpr TypeId kI32 = TypeId::fromId(6);
+inline constexpr TypeId kU32 = TypeId::fromId(7);
+inline constexpr TypeId kIsize = TypeId::fromId(8);
+inline constexpr TypeId kUsize = TypeId::fromId(9);
+inline constexpr TypeId kStr = TypeId::fromId(10);
+inline constexpr TypeId kString = TypeId::fromId(11);
+}
+
+// 全局类型表：结构相同的类型只保存一份（hash-consing），类型相等即编号相等。
+// 结构体与枚举按声明它们的符号区分，同名而声明不同的类型编号不同。
+// 编号分配后不再改变，子类型的编号总小于父类型
+class TypeContext {
+public:
+    static constexpr int64_t kUnknownLength = INT64_MIN;
+
+private:
+    struct TypeData {
+        TypeKind kind = TypeKind::kNone;
+        TypeId element;                    // 引用指向的类型、数组元素类型
+        int64_t length = kUnknownLength;   // 数组
+        Name name;                         // 内建类型、()、!、按名字出现的类型
+        std::string spelling;
+    };
+    struct Key {
+        TypeKind kind;
+        uint32_t element;
+        int64_t value;
+        bool operator==(const Key&) const = default;
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const noexcept {
+            uint64_t hash = uint64_t(key.kind) * 0x9e3779b97f4a7c15ull ^ key.element;
+            return hash * 0xff51afd7ed558ccdull ^ uint64_t(key.value);
+        }
+    };
+
+    // deque 扩容时已有元素不会移动，str() 返回的引用始终有效
+    std::deque<TypeData> entries;
+    // 引用与数组按结构查重，结构体与枚举按名字与声明查重
+    std::unordered_map<Key, TypeId, KeyHash> ids;
+    // 内建类型与没有声明的名字按名字查重
+    std::unordered_map<Name, TypeId> by_name;
+
+    TypeContext();
+    TypeId add(TypeData);
+    TypeId addNamed(TypeKind, Name);
+    TypeData namedData(TypeKind, Name) const;
+    const TypeData& data(TypeId type) const { return entries[type.getId()]; }
+
+public:
+    static TypeContext& global();
+
+    // 按名字取类型；i32、()、! 等内建类型名得到对应的内建类型，其余名字得到 kNamed。
+    // declaration 是名字解析到的结构体或枚举符号，只用来区分同名的类型，不会被解引用；
+    // 为空时（没有声明的名字）只按名字查重
+    TypeId named(Name, const Symbol* declaration = nullptr);
+    // 引用的可变性由符号与节点另行记录，不是类型的一部分
+    TypeId reference(TypeId);
+    TypeId array(TypeId element, int64_t length = kUnknownLength);
+
+    TypeKind kind(TypeId type) const { return data(type).kind; }
+    bool isReference(TypeId type) const { return kind(type) == TypeKind::kReference; }
+    bool isArray(TypeId type) const { return kind(type) == TypeKind::kArray; }
+    // 引用指向的类型或数组的元素类型，其余类型为空
+    TypeId element(TypeId type) const { return data(type).element; }
+    int64_t length(TypeId type) const { return data(type).length; }
+    // 内建类型、()、!、kNamed 的名字，其余类型为空名字
+    Name name(TypeId type) const { return data(type).name; }
+    const std::string& str(TypeId type) const { return data(type).spelling; }
+
+    // 去掉一层引用；不是引用时原样返回
+    TypeId dereference(TypeId type) const { return isReference(type) ? element(type) : type; }
+    // 剥去所有数组层得到的元素类型
+    TypeId innermost(TypeId type) const;
+    // integer、i32、u32、isize、usize
+    bool isInteger(TypeId type) const;
+
+    size_t size() const { return entries.size(); }
+};
@@ -4,99 +4,103 @@
 #include <array>
 #include <string>
 #include <cstring>
+#include <climits>
 #include <memory>
 #include "parser/astnode.hpp"
 #include "const_value.hpp"
 #include "symbol.hpp"
 #include "scope.hpp"
 
-inline std::string typeToString(std::shared_ptr<Type> type) {
+// 名字在 scope 中解析到的类型：最近的同名结构体或枚举声明，没有声明时（内建类型、Self 等）按名字取类型
+inline SymbolType namedType(const std::shared_ptr<Scope>& scope, const Name& name) {
+    auto declaration = scope ? scope->findTypeSymbol(name) : nullptr;
+    return TypeContext::global().named(name, declaration.get());
+}
+
+// 由类型节点得到类型，其中的名字在 scope 中解析。数组长度要经常量求值才知道，这里一律记为未知长度，见 handleArraySymbol
+inline SymbolType typeFromNode(const std::shared_ptr<Scope>& scope, Type* type) {
+    auto& types = TypeContext::global();
     if (!type || !type->child) {
-        return "unknown";
+        return types.named(names::kUnknown);
     }
     
     // 处理不同的类型
-    if (auto path_ident = std::dynamic_pointer_cast<PathIdentSegment>(type->child)) {
-        return path_ident->identifier;
-    } else if (auto ref_type = std::dynamic_pointer_cast<ReferenceType>(type->child)) {
-        std::string base_type = typeToString(ref_type->type);
-        // return (ref_type->is_mutable ? "&mut " : "&") + base_type;
-        return "&" + base_type;
-    } else if (auto array_type = std::dynamic_pointer_cast<ArrayType>(type->child)) {
-        std::string base_type = typeToString(array_type->type);
-        return "[" + base_type + "]";
-    } else if (auto unit_type = std::dynamic_pointer_cast<UnitType>(type->child)) {
-        return "()";
+    if (auto path_ident = dyn_cast<PathIdentSegment>(type->child)) {
+        return namedType(scope, path_ident->identifier);
+    } else if (auto ref_type = dyn_cast<ReferenceType>(type->child)) {
+        // 可变性另由符号和节点记录，引用类型中不区分
+        return types.reference(typeFromNode(scope, ref_type->type));
+    } else if (auto array_type = dyn_cast<ArrayType>(type->child)) {
+        return types.array(typeFromNode(scope, array_type->type));
+    } else if (auto unit_type = dyn_cast<UnitType>(type->child)) {
+        return types::kUnit;
     }
     
-    return "unknown";
+    return types.named(names::kUnknown);
+}
+
+// 去掉引用后是否为数组，即类型中是否有待求值的数组长度
+inline bool isArrayType(SymbolType type) {
+    auto& types = TypeContext::global();
+    while (types.isReference(type)) type = types.element(type);
+    return types.isArray(type);
 }
 
 // 辅助方法：从模式创建变量符号
 inline std::shared_ptr<VariableSymbol> createVariableSymbolFromPattern(
-    std::shared_ptr<PatternNoTopAlt> pattern, std::shared_ptr<Type> type) {
+    const std::shared_ptr<Scope>& scope, PatternNoTopAlt* pattern, Type* type) {
     
     if (!pattern || !pattern->child) {
         return nullptr;
     }
     
-    if (auto ident_pattern = std::dynamic_pointer_cast<IdentifierPattern>(pattern->child)) {
-        std::string type_str = typeToString(type);
+    if (auto ident_pattern = dyn_cast<IdentifierPattern>(pattern->child)) {
+        SymbolType type_str = typeFromNode(scope, type);
         bool is_ref = false, is_mut = false;
-        if (auto ref_type = std::dynamic_pointer_cast<ReferenceType>(type->child)) {
+        if (auto ref_type = dyn_cast<ReferenceType>(type->child)) {
             is_ref = true;
             is_mut = ref_type->is_mutable;
         }
         return std::make_shared<VariableSymbol>(ident_pattern->identifier, type_str, is_ref | ident_pattern->is_ref, is_mut * 2 + ident_pattern->is_mutable);
-    } else if (auto ref_pattern = std::dynamic_pointer_cast<ReferencePattern>(pattern->child)) {
-        return createVariableSymbolFromPattern(ref_pattern->pattern, type);
+    } else if (auto ref_pattern = dyn_cast<ReferencePattern>(pattern->child)) {
+        return createVariableSymbolFromPattern(scope, ref_pattern->pattern, type);
     }
     
     return nullptr;
 }
 
-inline std::shared_ptr<ConstValue> createConstValueFromExpression(std::shared_ptr<Scope> current_scope, std::shared_ptr<ASTNode> expression) {
+inline std::shared_ptr<ConstValue> createConstValueFromExpression(std::shared_ptr<Scope> current_scope, ASTNode* expression) {
     if (!expression) {
         return nullptr;
     }
     
-    // 处理 Expression 包装器
-    if (auto expr_wrapper = std::dynamic_pointer_cast<Expression>(expression)) {
-        if (expr_wrapper->child) {
-            return createConstValueFromExpression(current_scope, expr_wrapper->child);
-        }
-    }
-    
     // 尝试转换为不同的字面量类型
-    if (auto int_literal = std::dynamic_pointer_cast<IntegerLiteral>(expression)) {
-        try {
-            int value = std::stoi(int_literal->value);
-            auto result = std::make_shared<ConstValueInt>(value, expression);
-            return result;
-        } catch (const std::exception& e) {
-            // 转换失败，返回 null
+    if (auto int_literal = dyn_cast<IntegerLiteral>(expression)) {
+        // 超出 int 范围时无法求值，返回 null
+        if (int_literal->number > INT_MAX) {
             return nullptr;
         }
+        return std::make_shared<ConstValueInt>(static_cast<int>(int_literal->number), expression);
     }
-    if (auto bool_literal = std::dynamic_pointer_cast<BoolLiteral>(expression)) {
+    if (auto bool_literal = dyn_cast<BoolLiteral>(expression)) {
         return std::make_shared<ConstValueBool>(bool_literal->value, expression);
     }
-    if (auto char_literal = std::dynamic_pointer_cast<CharLiteral>(expression)) {
-        if (!char_literal->value.empty()) {
-            return std::make_shared<ConstValueChar>(char_literal->value[0], expression);
+    if (auto char_literal = dyn_cast<CharLiteral>(expression)) {
+        if (!char_literal->value.str().empty()) {
+            return std::make_shared<ConstValueChar>(char_literal->value.str()[0], expression);
         }
     }
-    if (auto string_literal = std::dynamic_pointer_cast<StringLiteral>(expression)) {
+    if (auto string_literal = dyn_cast<StringLiteral>(expression)) {
         return std::make_shared<ConstValueString>(string_literal->value, expression);
     }
 
-    if (auto path_expr = std::dynamic_pointer_cast<PathExpression>(expression)) {
+    if (auto path_expr = dyn_cast<PathExpression>(expression)) {
         if (path_expr->path_in_expression) {
-            return createConstValueFromExpression(current_scope, std::dynamic_pointer_cast<ASTNode>(path_expr->path_in_expression));
+            return createConstValueFromExpression(current_scope, path_expr->path_in_expression);
         }
     }
     
-    if (auto path_in_expr = std::dynamic_pointer_cast<PathInExpression>(expression)) {
+    if (auto path_in_expr = dyn_cast<PathInExpression>(expression)) {
         if (path_in_expr->segment2) {
             auto struct_identifier = path_in_expr->segment1->identifier;
             auto identifier = path_in_expr->segment2->identifier;
@@ -115,14 +119,14 @@ inline std::shared_ptr<ConstValue> createConstValueFromExpression(std::shared_pt
     }
 
     // 处理括号表达式
-    if (auto grouped_expr = std::dynamic_pointer_cast<GroupedExpression>(expression)) {
-        return createConstValueFromExpression(current_scope, std::dynamic_pointer_cast<ASTNode>(grouped_expr->expression));
+    if (auto grouped_expr = dyn_cast<GroupedExpression>(expression)) {
+        return createConstValueFromExpression(current_scope, grouped_expr->expression);
     }
 
     // 处理一元表达式（负号）
-    if (auto unary_expr = std::dynamic_pointer_cast<UnaryExpression>(expression)) {
+    if (auto unary_expr = dyn_cast<UnaryExpression>(expression)) {
         if (unary_expr->type == UnaryExpression::MINUS) {
-            auto operand_value = createConstValueFromExpression(current_scope, std::dynamic_pointer_cast<ASTNode>(unary_expr->expression));
+            auto operand_value = createConstValueFromExpression(current_scope, unary_expr->expression);
             if (!operand_value || !operand_value->isInt()) {
                 throw std::runtime_error("Const Evaluation Error: Unary minus can only be applied to integer constants");
             }
@@ -134,9 +138,9 @@ inline std::shared_ptr<ConstValue> createConstValueFromExpression(std::shared_pt
     }
 
     // 处理二元表达式（算术运算和位运算）
-    if (auto binary_expr = std::dynamic_pointer_cast<BinaryExpression>(expression)) {
-        auto left_value = createConstValueFromExpression(current_scope, std::dynamic_pointer_cast<ASTNode>(binary_expr->lhs));
-        auto right_value = createConstValueFromExpression(current_scope, std::dynamic_pointer_cast<ASTNode>(binary_expr->rhs));
+    if (auto binary_expr = dyn_cast<BinaryExpression>(expression)) {
+        auto left_value = createConstValueFromExpression(current_scope, binary_expr->lhs);
+        auto right_value = createConstValueFromExpression(current_scope, binary_expr->rhs);
         
         if (!left_value || !right_value) {
             throw std::runtime_error("Const Evaluation Error: Invalid operands in binary expression");
@@ -209,52 +213,45 @@ inline std::shared_ptr<ConstValue> createConstValueFromExpression(std::shared_pt
     throw std::runtime_error("Const Evaluation Error: Unsupported expression type in constant context");
 }
 
-inline std::string handleArraySymbol(std::shared_ptr<Scope> current_scope, std::shared_ptr<Type> node) {
-    if (auto ref_type = std::dynamic_pointer_cast<ReferenceType>(node->child)) {
-        std::string res = "&";
-        // if (ref_type->is_mutable) res += "mut";
-        return res + handleArraySymbol(current_scope, ref_type->type);
-    } else if (auto type_path = std::dynamic_pointer_cast<PathIdentSegment>(node->child)) {
-        return type_path->identifier;
-    } else if (auto array_type = std::dynamic_pointer_cast<ArrayType>(node->child)) {
+inline SymbolType handleArraySymbol(std::shared_ptr<Scope> current_scope, Type* node) {
+    auto& types = TypeContext::global();
+    if (auto ref_type = dyn_cast<ReferenceType>(node->child)) {
+        return types.reference(handleArraySymbol(current_scope, ref_type->type));
+    } else if (auto type_path = dyn_cast<PathIdentSegment>(node->child)) {
+        return namedType(current_scope, type_path->identifier);
+    } else if (auto array_type = dyn_cast<ArrayType>(node->child)) {
         auto expression = array_type->expression;
-        std::cout << array_type->expression->type << std::endl;
         auto length = createConstValueFromExpression(current_scope, expression);
         if (!length->isInt()) {
             throw std::runtime_error("Const Evaluation Error: Array length not integer");
         }
         int len = std::dynamic_pointer_cast<ConstValueInt>(length)->getValue();
         // std::cout << len << std::endl;
-        return "[" + handleArraySymbol(current_scope, array_type->type) + "]" + std::to_string(len);
+        return types.array(handleArraySymbol(current_scope, array_type->type), len);
     } else {
         // std::cout << "啊！" << std::endl;
         throw std::runtime_error("Const Evaluation Error: Array symbol parse failed");
     }
 }
 
-const std::vector<std::string> builtin_types = {"bool", "i32", "isize", "u32", "usize", "char", "str", "String", "()", "self", "Self"};
+// 去掉一层引用和所有数组层后，是内建类型、Self 或已声明的结构体、枚举
 inline bool checkTypeExists(std::shared_ptr<Scope> current_scope, SymbolType type) {
-    if (type.length() > 0 && type[0] == '&') type = type.substr(1);
-    if (type.length() >= 3 && type.substr(0, 3) == "mut") type = type.substr(3);
-    while (type.length() > 0 && type[0] == '[') {
-        while (type.back() != ']') type.pop_back();
-        type = type.substr(1, type.length() - 2);
-    }
+    auto& types = TypeContext::global();
+    type = types.innermost(types.dereference(type));
     // builtin types
-    for (auto builtin_type: builtin_types) {
-        if (type == builtin_type) {
-            return true;
-        }
-    }
-    if (current_scope->structSymbolExists(type)) return true;
-    if (current_scope->enumSymbolExists(type)) return true;
+    if (types.kind(type) == TypeKind::kUnit) return true;
+    if (types.kind(type) == TypeKind::kPrimitive && type != types::kInteger) return true;
+    Name name = types.name(type);
+    if (name == names::kSelfValue || name == names::kSelfType) return true;
+    if (current_scope->structSymbolExists(name)) return true;
+    if (current_scope->enumSymbolExists(name)) return true;
     return false;
 }
 
-inline std::string typeToString_(std::shared_ptr<Scope> current_scope, std::shared_ptr<Type> type) {
-    auto str = typeToString(type);
-    if (str.back() == ']') {
-        str = handleArraySymbol(current_scope, type);
+inline SymbolType typeFromNode_(std::shared_ptr<Scope> current_scope, Type* type) {
+    auto result = typeFromNode(current_scope, type);
+    if (isArrayType(result)) {
+        result = handleArraySymbol(current_scope, type);
     }
-    return str;
-}
\ No newline at end of file
+    return result;
+}
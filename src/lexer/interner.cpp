@@ -0,0 +1,28 @@
+#include "lexer/interner.hpp"
+#include <ostream>
+
+Name Name::fromId(uint32_t id) {
+    Name name;
+    name.id = id;
+    return name;
+}
+
+std::string operator+(const std::string& lhs, const Name& rhs) {
+    return lhs + rhs.str();
+}
+
+std::string operator+(const Name& lhs, const std::string& rhs) {
+    return lhs.str() + rhs;
+}
+
+std::string operator+(const char* lhs, const Name& rhs) {
+    return lhs + rhs.str();
+}
+
+std::string operator+(const Name& lhs, const char* rhs) {
+    return lhs.str() + rhs;
+}
+
+std::ostream& operator<<(std::ostream& os, const Name& name) {
+    return os << name.str();
+}
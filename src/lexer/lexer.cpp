@@ -1,93 +1,904 @@
 #include "lexer/lexer.hpp"
+#include "lexer/simd_scan.hpp"
+#include "lexer/unicode_xid.hpp"
+#include <boost/regex.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <thread>
 
-std::vector<std::pair<Token, std::string>> Lexer::lex(std::string str) {
-    std::vector<std::pair<Token, std::string>> res;
-    for (size_t i = 0; i < str.size(); ++i) {
-        while (i < str.size() && std::isspace(str[i])) {
-            i++;
-        }
-        if (i >= str.size()) break;
-        if (str.substr(i, 2) == "//") {
-            uint32_t cur = 0;
-            while (str[i + cur] != '\n' && str[i + cur] != '\r') {
-                cur++;
-            }
-            i += cur;
+namespace {
+
+// 标识符（及字符串字面量的后缀）中的非 ASCII 字符在正则中只按 UTF-8 的字节结构匹配，
+// matchPattern 再按 XID 属性截断
+constexpr const char* kIdentifierBytes = "([a-zA-Z]|[\\xC2-\\xF4][\\x80-\\xBF]+)([a-zA-Z0-9_]|[\\xC2-\\xF4][\\x80-\\xBF]+)*";
+
+// 参考实现使用的正则表达式表，仅在 lexReference 中首次使用时编译
+const std::vector<std::pair<Token, boost::regex>>& referencePatterns() {
+    static const std::vector<std::pair<Token, boost::regex>> patterns = {
+#define X(name, text) {Token::name, boost::regex(text)},
+        RCOMPILER_KEYWORDS(X)
+#undef X
+
+        {Token::kIdentifier, boost::regex(kIdentifierBytes)},
+
+        // {Token::kComment, boost::regex("((//([^\\n])*(\\n)?)|(\\/\\*[\\s\\S]*\\*\\/))")},
+
+        {Token::kCharLiteral, boost::regex(R"('([^'\\\n\r\t]|\\'|\\"|\\x[0-7][0-9a-fA-F]|\\n|\\r|\\t|\\\\|\\0)')")},
+        {Token::kStringLiteral, boost::regex(R"("(([^"\\\r\t])|(\\')|(\\")|((\\x[0-7][0-9a-fA-F])|(\\n)|(\\r)|(\\t)|(\\\\)|(\\0))|(\\\n))*")" "(?<suffix>" + std::string(kIdentifierBytes) + ")?")},
+        {Token::kRawStringLiteral, boost::regex(R"(r([#]+)([^\r])*?(\1))")},
+        {Token::kCStringLiteral, boost::regex(R"(c"(([^"\\\r\0])|(\\x[0-7][0-9a-fA-F])|(\\n)|(\\r)|(\\t)|\\\\|(\\\n))*")")},
+        {Token::kRawCStringLiteral, boost::regex(R"(cr([#]+)([^\r\0])*?(\1))")},
+        {Token::kIntegerLiteral, boost::regex("((0b[0-1_]*[0-1][0-1_]*)|(0o[0-7_]*[0-7][0-7_]*)|(0x[0-9a-fA-F_]*[0-9a-fA-F][0-9a-fA-F_]*)|([0-9][0-9_]*))((u32)|(i32)|(usize)|(isize))?")},
+
+        {Token::kPlus, boost::regex(R"(\+)")},
+        {Token::kMinus, boost::regex("-")},
+        {Token::kStar, boost::regex(R"(\*)")},
+        {Token::kSlash, boost::regex(R"(/)")},
+        {Token::kPercent, boost::regex(R"(%)")},
+        {Token::kCaret, boost::regex(R"(\^)")},
+        {Token::kNot, boost::regex(R"(!)")},
+        {Token::kAnd, boost::regex(R"(&)")},
+        {Token::kOr, boost::regex(R"(\|)")},
+        {Token::kAndAnd, boost::regex(R"(&&)")},
+        {Token::kOrOr, boost::regex(R"(\|\|)")},
+        {Token::kShl, boost::regex(R"(<<)")},
+        {Token::kShr, boost::regex(R"(>>)")},
+        {Token::kPlusEq, boost::regex(R"(\+=)")},
+        {Token::kMinusEq, boost::regex(R"(-=)")},
+        {Token::kStarEq, boost::regex(R"(\*=)")},
+        {Token::kSlashEq, boost::regex(R"(/=)")},
+        {Token::kPercentEq, boost::regex(R"(%=)")},
+        {Token::kCaretEq, boost::regex(R"(\^=)")},
+        {Token::kAndEq, boost::regex(R"(&=)")},
+        {Token::kOrEq, boost::regex(R"(\|=)")},
+        {Token::kShlEq, boost::regex(R"(<<=)")},
+        {Token::kShrEq, boost::regex(R"(>>=)")},
+        {Token::kEq, boost::regex(R"(=)")},
+        {Token::kEqEq, boost::regex(R"(==)")},
+        {Token::kNe, boost::regex(R"(!=)")},
+        {Token::kGt, boost::regex(R"(>)")},
+        {Token::kLt, boost::regex(R"(<)")},
+        {Token::kGe, boost::regex(R"(>=)")},
+        {Token::kLe, boost::regex(R"(<=)")},
+        {Token::kAt, boost::regex(R"(@)")},
+        {Token::kUnderscore, boost::regex(R"(_)")},
+        {Token::kDot, boost::regex(R"(\.)")},
+        {Token::kDotDot, boost::regex(R"(\.\.)")},
+        {Token::kDotDotDot, boost::regex(R"(\.\.\.)")},
+        {Token::kDotDotEq, boost::regex(R"(\.\.=)")},
+        {Token::kComma, boost::regex(R"(,)")},
+        {Token::kSemi, boost::regex(R"(;)")},
+        {Token::kColon, boost::regex(R"(:)")},
+        {Token::kPathSep, boost::regex(R"(::)")},
+        {Token::kRArrow, boost::regex(R"(->)")},
+        {Token::kFatArrow, boost::regex(R"(=>)")},
+        {Token::kLArrow, boost::regex(R"(<-)")},
+        {Token::kPound, boost::regex(R"(#)")},
+        {Token::kDollar, boost::regex(R"(\$)")},
+        {Token::kQuestion, boost::regex(R"(\?)")},
+        {Token::kTilde, boost::regex(R"(~)")},
+
+        {Token::kLCurly, boost::regex(R"(\{)")},
+        {Token::kRCurly, boost::regex(R"(\})")},
+        {Token::kLSquare, boost::regex(R"(\[)")},
+        {Token::kRSquare, boost::regex(R"(\])")},
+        {Token::kLParenthese, boost::regex(R"(\()")},
+        {Token::kRParenthese, boost::regex(R"(\))")},
+    };
+    return patterns;
+}
+
+struct Keyword {
+    std::string_view text;
+    Token token;
+};
+
+constexpr Keyword keywords[] = {
+#define X(name, text) {text, Token::name},
+    RCOMPILER_KEYWORDS(X)
+#undef X
+};
+
+constexpr size_t kKeywordTableBits = 7;
+constexpr size_t kKeywordTableSize = size_t(1) << kKeywordTableBits;
+
+constexpr size_t keywordMinLength() {
+    size_t res = keywords[0].text.size();
+    for (const auto& keyword: keywords) res = std::min(res, keyword.text.size());
+    return res;
+}
+constexpr size_t keywordMaxLength() {
+    size_t res = 0;
+    for (const auto& keyword: keywords) res = std::max(res, keyword.text.size());
+    return res;
+}
+constexpr size_t kKeywordMinLength = keywordMinLength();
+constexpr size_t kKeywordMaxLength = keywordMaxLength();
+static_assert(kKeywordMinLength >= 2, "keywordHash reads p[0] and p[1]");
+
+// 只看长度与首、次、中、末四个字节；调用方保证 len >= kKeywordMinLength
+constexpr uint32_t keywordHash(const char* p, size_t len, uint32_t seed) {
+    uint32_t h = seed ^ (static_cast<uint32_t>(len) * 0x9e3779b1u);
+    h = (h ^ static_cast<unsigned char>(p[0])) * 0x01000193u;
+    h = (h ^ static_cast<unsigned char>(p[1])) * 0x01000193u;
+    h = (h ^ static_cast<unsigned char>(p[len / 2])) * 0x01000193u;
+    h = (h ^ static_cast<unsigned char>(p[len - 1])) * 0x01000193u;
+    return h >> (32 - kKeywordTableBits);
+}
+
+constexpr bool isPerfectSeed(uint32_t seed) {
+    bool used[kKeywordTableSize] = {};
+    for (const auto& keyword: keywords) {
+        uint32_t h = keywordHash(keyword.text.data(), keyword.text.size(), seed);
+        if (used[h]) return false;
+        used[h] = true;
+    }
+    return true;
+}
+
+// 编译期搜索一个使所有关键字落在不同槽位的种子
+constexpr uint32_t findKeywordSeed() {
+    for (uint32_t seed = 0; seed < 100000; ++seed) {
+        if (isPerfectSeed(seed)) return seed;
+    }
+    return UINT32_MAX;
+}
+constexpr uint32_t kKeywordSeed = findKeywordSeed();
+static_assert(kKeywordSeed != UINT32_MAX, "no perfect hash seed for the keyword set");
+
+// 空槽位的 text 为空串，长度比较即可排除
+constexpr std::array<Keyword, kKeywordTableSize> buildKeywordTable() {
+    std::array<Keyword, kKeywordTableSize> table{};
+    for (auto& slot: table) slot = {"", Token::kIdentifier};
+    for (const auto& keyword: keywords) {
+        table[keywordHash(keyword.text.data(), keyword.text.size(), kKeywordSeed)] = keyword;
+    }
+    return table;
+}
+constexpr auto keywordTable = buildKeywordTable();
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+bool isHexDigit(char c) {
+    return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+bool isIdentStart(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+bool isIdentContinue(char c) {
+    return isIdentStart(c) || isDigit(c) || c == '_';
+}
+
+// 解码 i 处的非 ASCII 字符，返回码点与字节数；源码已通过 UTF-8 校验
+std::pair<uint32_t, size_t> decodeUtf8(std::string_view str, size_t i) {
+    auto c = static_cast<unsigned char>(str[i]);
+    // 跳过无法识别的字符时会逐字节前进，落在后续字节上时不构成字符
+    if (c < 0xC0) return {UINT32_MAX, 1};
+    size_t len = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : 2;
+    if (i + len > str.size()) return {UINT32_MAX, 1};
+    uint32_t cp = c & (0x7F >> len);
+    for (size_t k = 1; k < len; ++k) cp = cp << 6 | (static_cast<unsigned char>(str[i + k]) & 0x3F);
+    return {cp, len};
+}
+
+// 标识符首字符的字节数，不能开始标识符时为 0。ASCII 只接受字母，其余按 XID_Start 判断
+size_t identStartLength(std::string_view str, size_t i) {
+    char c = str[i];
+    if (!(c & 0x80)) return isIdentStart(c) ? 1 : 0;
+    auto [cp, len] = decodeUtf8(str, i);
+    return isXidStart(cp) ? len : 0;
+}
+
+// 参考实现用：s 中可以构成标识符的最长前缀的字节数，首字符按 XID_Start、其余按 XID_Continue 判断
+size_t xidPrefixLength(std::string_view s) {
+    size_t k = 0;
+    while (k < s.size()) {
+        if (!(s[k] & 0x80)) {
+            k++;
             continue;
         }
-        if (str.substr(i, 2) == "/*") {
-            uint32_t cur = 2, cnt = 1;
-            while (cnt > 0) {
-                if (str.substr(i + cur, 2) == "/*") {
-                    cnt++;
-                } else if (str.substr(i + cur, 2) == "*/") {
-                    cnt--;
+        auto [cp, len] = decodeUtf8(s, k);
+        if (!(k == 0 ? isXidStart(cp) : isXidContinue(cp))) break;
+        k += len;
+    }
+    return k;
+}
+
+// 标识符扫描完成后，通过完美哈希定位唯一可能的关键字，再做一次比较确认
+Token classifyIdentifier(const char* p, size_t len) {
+    if (len < kKeywordMinLength || len > kKeywordMaxLength) return Token::kIdentifier;
+    const auto& slot = keywordTable[keywordHash(p, len, kKeywordSeed)];
+    if (slot.text.size() == len && std::memcmp(slot.text.data(), p, len) == 0) return slot.token;
+    return Token::kIdentifier;
+}
+
+size_t scanIdentifier(std::string_view str, size_t i) {
+    size_t k = i + identStartLength(str, i);
+    while (k < str.size()) {
+        if (isIdentContinue(str[k])) {
+            k++;
+        } else if (str[k] & 0x80) {
+            auto [cp, len] = decodeUtf8(str, k);
+            if (!isXidContinue(cp)) break;
+            k += len;
+        } else {
+            break;
+        }
+    }
+    return k - i;
+}
+
+// 转义序列：\x 后须为 [0-7][0-9a-fA-F]，其余允许的转义字符由 simple 给出
+// 返回转义序列长度，0 表示非法
+size_t scanEscape(std::string_view str, size_t k, const char* simple) {
+    if (k + 1 >= str.size()) return 0;
+    char e = str[k + 1];
+    if (e == 'x') {
+        if (k + 3 < str.size() && str[k + 2] >= '0' && str[k + 2] <= '7' && isHexDigit(str[k + 3])) return 4;
+        return 0;
+    }
+    if (e != '\0' && std::strchr(simple, e)) return 2;
+    return 0;
+}
+
+// kCharLiteral: '([^'\\\n\r\t]|escape)'
+size_t scanCharLiteral(std::string_view str, size_t i) {
+    size_t k = i + 1;
+    if (k >= str.size()) return 0;
+    char c = str[k];
+    if (c == '\\') {
+        size_t esc = scanEscape(str, k, "'\"nrt\\0");
+        if (esc == 0) return 0;
+        k += esc;
+    } else if (c == '\'' || c == '\n' || c == '\r' || c == '\t') {
+        return 0;
+    } else {
+        k++;
+    }
+    if (k < str.size() && str[k] == '\'') return k + 1 - i;
+    return 0;
+}
+
+// kStringLiteral: "([^"\\\r\t]|escape|\\\n)*" 加可选的标识符后缀。
+// 失败时若给出 stop，记下扫描停下的位置
+size_t scanStringLiteral(std::string_view str, size_t i, size_t* stop = nullptr) {
+    size_t k = i + 1;
+    while (true) {
+        // 普通字符批量跳过，只在引号、反斜杠和非法字符处停下
+        k = SimdScanner::findAny(str.data(), k, str.size(), '"', '\\', '\r', '\t');
+        if (k >= str.size()) break;
+        char c = str[k];
+        if (c == '"') break;
+        if (c == '\\') {
+            size_t esc = scanEscape(str, k, "'\"nrt\\0\n");
+            if (esc == 0) break;
+            k += esc;
+        } else {
+            break;
+        }
+    }
+    if (k >= str.size() || str[k] != '"') {
+        if (stop) *stop = k;
+        return 0;
+    }
+    k++;
+    if (k < str.size() && identStartLength(str, k)) k += scanIdentifier(str, k);
+    return k - i;
+}
+
+// kCStringLiteral: c"([^"\\\r\0]|escape|\\\n)*"，stop 同上
+size_t scanCStringLiteral(std::string_view str, size_t i, size_t* stop = nullptr) {
+    size_t k = i + 2;
+    while (true) {
+        k = SimdScanner::findAny(str.data(), k, str.size(), '"', '\\', '\r', '\0');
+        if (k >= str.size()) break;
+        char c = str[k];
+        if (c == '"') break;
+        if (c == '\\') {
+            size_t esc = scanEscape(str, k, "nrt\\\n");
+            if (esc == 0) break;
+            k += esc;
+        } else {
+            break;
+        }
+    }
+    if (k >= str.size() || str[k] != '"') {
+        if (stop) *stop = k;
+        return 0;
+    }
+    return k + 1 - i;
+}
+
+// kRawStringLiteral / kRawCStringLiteral: prefix(#+)(body)*?(\1)
+// 与正则的回溯行为一致：先尝试全部的 #，失败后依次减少 # 的个数；
+// body 按惰性匹配寻找第一个结束分隔符，且不能跨越 excluded 中的字符。
+// 分隔符以 # 开头，因此只需在 # 与被排除的字符处停下检查。
+// 若给出 stop，记下各次失败的尝试中停得最远的位置
+size_t scanRawLiteral(std::string_view str, size_t i, size_t prefix, bool exclude_nul, size_t* stop = nullptr) {
+    size_t n = str.size();
+    size_t hashes = 0;
+    char excluded = exclude_nul ? '\0' : '\r';
+    while (i + prefix + hashes < n && str[i + prefix + hashes] == '#') hashes++;
+    for (size_t k = hashes; k >= 1; --k) {
+        size_t q = i + prefix + k;
+        while (true) {
+            q = SimdScanner::findAny(str.data(), q, n, '#', '\r', excluded, '\r');
+            if (q >= n || str[q] != '#') break;
+            size_t h = 0;
+            while (h < k && q + h < n && str[q + h] == '#') h++;
+            if (h == k) return q + k - i;
+            q++;
+        }
+        if (stop) *stop = std::max(*stop, q);
+    }
+    return 0;
+}
+
+// kIntegerLiteral: 带前缀的二/八/十六进制至少需要一位数字，否则退回十进制，随后是可选的类型后缀
+size_t scanIntegerLiteral(std::string_view str, size_t i) {
+    size_t n = str.size();
+    size_t k = i;
+    bool prefixed = false;
+    if (str[i] == '0' && i + 1 < n && (str[i + 1] == 'b' || str[i + 1] == 'o' || str[i + 1] == 'x')) {
+        char radix = str[i + 1];
+        auto is_radix_digit = [radix](char c) {
+            if (radix == 'b') return c == '0' || c == '1';
+            if (radix == 'o') return c >= '0' && c <= '7';
+            return isHexDigit(c);
+        };
+        size_t j = i + 2;
+        bool has_digit = false;
+        while (j < n && (is_radix_digit(str[j]) || str[j] == '_')) {
+            has_digit |= str[j] != '_';
+            j++;
+        }
+        if (has_digit) {
+            k = j;
+            prefixed = true;
+        }
+    }
+    if (!prefixed) {
+        k = i + 1;
+        while (k < n && (isDigit(str[k]) || str[k] == '_')) k++;
+    }
+    for (const char* suffix: {"u32", "i32", "usize", "isize"}) {
+        size_t len = std::strlen(suffix);
+        if (str.compare(k, len, suffix) == 0) {
+            k += len;
+            break;
+        }
+    }
+    return k - i;
+}
+
+// 并行扫描的分块预扫描：粗略跟踪注释、字符串、字符与原始字符串的状态，
+// 在每个目标位置之后取第一个处于普通状态的行首作为边界。
+// 这里不要求与词法分析完全一致，拼接时会校验并在必要时重新同步
+std::vector<size_t> findChunkBoundaries(std::string_view str, size_t chunks) {
+    const char* p = str.data();
+    size_t n = str.size();
+    std::vector<size_t> res{0};
+    size_t next = 1;
+    // [from, to) 处于普通状态，尝试在其中放置边界
+    auto place = [&](size_t from, size_t to) {
+        while (next < chunks) {
+            size_t target = std::max(from, n / chunks * next);
+            if (target >= to) return;
+            auto nl = static_cast<const char*>(std::memchr(p + target, '\n', to - target));
+            if (nl == nullptr) return;
+            size_t boundary = nl - p + 1;
+            if (boundary > res.back() && boundary < n) res.push_back(boundary);
+            next++;
+        }
+    };
+    size_t i = 0;
+    while (i < n && next < chunks) {
+        size_t j = SimdScanner::findAny(p, i, n, '/', '"', '#', '\'');
+        place(i, j);
+        if (j >= n) break;
+        char c = p[j];
+        char c1 = j + 1 < n ? p[j + 1] : '\0';
+        if (c == '/' && c1 == '/') {
+            i = SimdScanner::findAny(p, j + 2, n, '\n', '\r', '\n', '\r');
+        } else if (c == '/' && c1 == '*') {
+            size_t depth = 1;
+            i = j + 2;
+            while (depth > 0) {
+                i = SimdScanner::findAny(p, i, n, '/', '*', '/', '*');
+                if (i + 1 >= n) {
+                    i = n;
+                    break;
                 }
-                cur++;
+                if (p[i] == '/' && p[i + 1] == '*') depth++, i += 2;
+                else if (p[i] == '*' && p[i + 1] == '/') depth--, i += 2;
+                else i++;
             }
-            i += cur + 1;
-            continue;
+        } else if (c == '"') {
+            i = j + 1;
+            while (true) {
+                i = SimdScanner::findAny(p, i, n, '"', '\\', '"', '\\');
+                if (i >= n) break;
+                if (p[i] == '"') {
+                    i++;
+                    break;
+                }
+                i += 2;
+            }
+        } else if (c == '#' && j > 0 && p[j - 1] == 'r') {
+            size_t hashes = 0;
+            while (j + hashes < n && p[j + hashes] == '#') hashes++;
+            i = j + hashes;
+            while (true) {
+                i = SimdScanner::findAny(p, i, n, '#', '#', '#', '#');
+                size_t h = 0;
+                while (i + h < n && h < hashes && p[i + h] == '#') h++;
+                if (i >= n || h == hashes) {
+                    i = std::min(n, i + h);
+                    break;
+                }
+                i += h;
+            }
+        } else if (c == '\'' && c1 == '\\' && j + 3 < n && p[j + 3] == '\'') {
+            i = j + 4;
+        } else if (c == '\'' && j + 2 < n && p[j + 2] == '\'') {
+            i = j + 3;
+        } else {
+            i = j + 1;
         }
-        size_t best_len = 0;
-        std::pair<Token, std::string> best_match;
-        for (auto [token, reg]: patterns) {
-            boost::smatch match;
-            auto sub = str.substr(i);
-            if (boost::regex_search(sub, match, reg) && match.position() == 0) {
-                auto match_str = match.str();
-                if (match_str.size() > best_len) {
-                    best_len = match_str.size();
-                    best_match = std::make_pair(token, match_str);
+    }
+    res.push_back(n);
+    return res;
+}
+
+// 普通 token 的扫描最多读到结尾之后这么多字节（整数后缀、转义、注释起始等）
+constexpr size_t kLookahead = 8;
+
+// 若 i 处的扫描可能读到了结尾之后任意远的位置，返回它停下的位置，否则返回 0：
+// 失败的字符串尝试，被退回为标识符的 r#、c"、cr#，以及减少了 # 个数才匹配上的原始字面量。
+// 停下的位置由失败的尝试重新扫描一遍得到，这类情况很少
+size_t farScanReach(std::string_view str, size_t i, Token token, size_t len) {
+    size_t n = str.size();
+    char c1 = i + 1 < n ? str[i + 1] : '\0';
+    char c2 = i + 2 < n ? str[i + 2] : '\0';
+    size_t stop = 0;
+    if (len == 0) {
+        if (str[i] == '"') scanStringLiteral(str, i, &stop);
+        return stop;
+    }
+    if (token == Token::kIdentifier) {
+        if (str[i] == 'r' && c1 == '#') scanRawLiteral(str, i, 1, false, &stop);
+        else if (str[i] == 'c' && c1 == '"') scanCStringLiteral(str, i, &stop);
+        else if (str[i] == 'c' && c1 == 'r' && c2 == '#') scanRawLiteral(str, i, 2, true, &stop);
+        return stop;
+    }
+    if (token == Token::kRawStringLiteral || token == Token::kRawCStringLiteral) {
+        // 全部的 # 都匹配上时，token 至少包含两倍的 #，且以同样多的 # 结尾
+        size_t prefix = token == Token::kRawStringLiteral ? 1 : 2;
+        size_t leading = 0;
+        while (i + prefix + leading < n && str[i + prefix + leading] == '#') leading++;
+        bool full = len >= prefix + 2 * leading;
+        for (size_t h = 1; full && h <= leading; ++h) full = str[i + len - h] == '#';
+        if (!full) scanRawLiteral(str, i, prefix, token == Token::kRawCStringLiteral, &stop);
+        return stop;
+    }
+    return 0;
+}
+
+// 编辑是否可能改变编辑点之前的一次远距离扫描（基于编辑前的源码 old）。
+// 这类扫描只在少数几种字节处停下检查（引号、反斜杠、#、非法字符），其余字节被整段跳过：
+// 编辑落在扫描停下的位置之后，或者增删的文本及编辑点之前 kLookahead 个字节内都没有这些字节时，
+// 扫描的结果不变，只是停下的位置随之平移
+bool farScanAffected(std::string_view old, const FarScan& scan, const TextEdit& edit) {
+    if (scan.reach + kLookahead <= edit.begin) return false;
+    size_t n = old.size();
+    size_t i = scan.offset;
+    size_t body;
+    std::string_view stops;
+    if (old[i] == '"') {
+        body = i + 1;
+        stops = "\"\\\r\t";
+    } else if (old[i] == 'c' && i + 1 < n && old[i + 1] == '"') {
+        body = i + 2;
+        stops = std::string_view("\"\\\r\0", 4);
+    } else {
+        // 原始字面量：前缀之后的 # 决定了要找的结束分隔符
+        bool c_string = old[i] == 'c';
+        body = i + (c_string ? 2 : 1);
+        while (body < n && old[body] == '#') body++;
+        stops = c_string ? std::string_view("#\r\0", 3) : std::string_view("#\r");
+    }
+    if (edit.begin < body + kLookahead) return true;
+    std::string_view removed = old.substr(edit.begin - kLookahead, edit.end - edit.begin + kLookahead);
+    return removed.find_first_of(stops) != std::string_view::npos
+        || std::string_view(edit.text).find_first_of(stops) != std::string_view::npos;
+}
+
+} // namespace
+
+void Lexer::validateSource(const SourceBuffer& source, size_t begin, size_t end) {
+    std::string_view str = source.view();
+    size_t bad = SimdScanner::validateUtf8(str.data(), begin, end);
+    if (bad < end) {
+        auto [line, column] = source.location(bad);
+        throw std::runtime_error("Invalid UTF-8 in source at " + std::to_string(line) + ":" + std::to_string(column));
+    }
+}
+
+void Lexer::validateSource(const SourceBuffer& source) {
+    validateSource(source, 0, source.size());
+}
+
+size_t Lexer::skipTrivia(std::string_view str, size_t i) {
+    size_t n = str.size();
+    const char* p = str.data();
+    while (i < n) {
+        if (isSpace(str[i])) {
+            i = SimdScanner::skipSpace(p, i + 1, n);
+        } else if (str[i] == '/' && i + 1 < n && str[i + 1] == '/') {
+            i = SimdScanner::findAny(p, i + 2, n, '\n', '\r', '\n', '\n');
+        } else if (str[i] == '/' && i + 1 < n && str[i + 1] == '*') {
+            // 块注释可以嵌套，只在 '/' 与 '*' 处检查是否构成标记
+            size_t depth = 1;
+            i += 2;
+            while (depth > 0) {
+                i = SimdScanner::findAny(p, i, n, '/', '*', '/', '*');
+                if (i >= n) break;
+                if (str[i] == '/' && i + 1 < n && str[i + 1] == '*') {
+                    depth++;
+                    i += 2;
+                } else if (str[i] == '*' && i + 1 < n && str[i + 1] == '/') {
+                    depth--;
+                    i += 2;
+                } else {
+                    i++;
                 }
             }
+        } else {
+            break;
+        }
+    }
+    return i;
+}
+
+std::pair<Token, size_t> Lexer::scanToken(std::string_view str, size_t i) {
+    size_t n = str.size();
+    char c = str[i];
+    char c1 = i + 1 < n ? str[i + 1] : '\0';
+    char c2 = i + 2 < n ? str[i + 2] : '\0';
+
+    if (isIdentStart(c)) {
+        // 原始字符串与 C 字符串以标识符字符开头，匹配成功时总是比标识符更长
+        if (c == 'r' && c1 == '#') {
+            if (size_t len = scanRawLiteral(str, i, 1, false)) return {Token::kRawStringLiteral, len};
+        } else if (c == 'c' && c1 == '"') {
+            if (size_t len = scanCStringLiteral(str, i)) return {Token::kCStringLiteral, len};
+        } else if (c == 'c' && c1 == 'r' && c2 == '#') {
+            if (size_t len = scanRawLiteral(str, i, 2, true)) return {Token::kRawCStringLiteral, len};
+        }
+        size_t len = scanIdentifier(str, i);
+        return {classifyIdentifier(str.data() + i, len), len};
+    }
+    if (isDigit(c)) {
+        return {Token::kIntegerLiteral, scanIntegerLiteral(str, i)};
+    }
+    if (c & 0x80) {
+        // 非 ASCII 标识符不可能是关键字
+        if (identStartLength(str, i)) return {Token::kIdentifier, scanIdentifier(str, i)};
+        return {Token::kIdentifier, 0};
+    }
+
+    switch (c) {
+        case '\'': {
+            size_t len = scanCharLiteral(str, i);
+            return {Token::kCharLiteral, len};
+        }
+        case '"': {
+            size_t len = scanStringLiteral(str, i);
+            return {Token::kStringLiteral, len};
+        }
+        case '+':
+            if (c1 == '=') return {Token::kPlusEq, 2};
+            return {Token::kPlus, 1};
+        case '-':
+            if (c1 == '=') return {Token::kMinusEq, 2};
+            if (c1 == '>') return {Token::kRArrow, 2};
+            return {Token::kMinus, 1};
+        case '*':
+            if (c1 == '=') return {Token::kStarEq, 2};
+            return {Token::kStar, 1};
+        case '/':
+            if (c1 == '=') return {Token::kSlashEq, 2};
+            return {Token::kSlash, 1};
+        case '%':
+            if (c1 == '=') return {Token::kPercentEq, 2};
+            return {Token::kPercent, 1};
+        case '^':
+            if (c1 == '=') return {Token::kCaretEq, 2};
+            return {Token::kCaret, 1};
+        case '!':
+            if (c1 == '=') return {Token::kNe, 2};
+            return {Token::kNot, 1};
+        case '&':
+            if (c1 == '&') return {Token::kAndAnd, 2};
+            if (c1 == '=') return {Token::kAndEq, 2};
+            return {Token::kAnd, 1};
+        case '|':
+            if (c1 == '|') return {Token::kOrOr, 2};
+            if (c1 == '=') return {Token::kOrEq, 2};
+            return {Token::kOr, 1};
+        case '<':
+            if (c1 == '<' && c2 == '=') return {Token::kShlEq, 3};
+            if (c1 == '<') return {Token::kShl, 2};
+            if (c1 == '=') return {Token::kLe, 2};
+            if (c1 == '-') return {Token::kLArrow, 2};
+            return {Token::kLt, 1};
+        case '>':
+            if (c1 == '>' && c2 == '=') return {Token::kShrEq, 3};
+            if (c1 == '>') return {Token::kShr, 2};
+            if (c1 == '=') return {Token::kGe, 2};
+            return {Token::kGt, 1};
+        case '=':
+            if (c1 == '=') return {Token::kEqEq, 2};
+            if (c1 == '>') return {Token::kFatArrow, 2};
+            return {Token::kEq, 1};
+        case '.':
+            if (c1 == '.' && c2 == '.') return {Token::kDotDotDot, 3};
+            if (c1 == '.' && c2 == '=') return {Token::kDotDotEq, 3};
+            if (c1 == '.') return {Token::kDotDot, 2};
+            return {Token::kDot, 1};
+        case ':':
+            if (c1 == ':') return {Token::kPathSep, 2};
+            return {Token::kColon, 1};
+        case '@': return {Token::kAt, 1};
+        case '_': return {Token::kUnderscore, 1};
+        case ',': return {Token::kComma, 1};
+        case ';': return {Token::kSemi, 1};
+        case '#': return {Token::kPound, 1};
+        case '$': return {Token::kDollar, 1};
+        case '?': return {Token::kQuestion, 1};
+        case '~': return {Token::kTilde, 1};
+        case '{': return {Token::kLCurly, 1};
+        case '}': return {Token::kRCurly, 1};
+        case '[': return {Token::kLSquare, 1};
+        case ']': return {Token::kRSquare, 1};
+        case '(': return {Token::kLParenthese, 1};
+        case ')': return {Token::kRParenthese, 1};
+        default: return {Token::kEOF, 0};
+    }
+}
+
+std::pair<Token, size_t> Lexer::matchPattern(std::string_view str, size_t i) {
+    size_t best_len = 0;
+    Token best_token = Token::kEOF;
+    std::string sub(str.substr(i));
+    for (const auto& [token, reg]: referencePatterns()) {
+        boost::smatch match;
+        if (boost::regex_search(sub, match, reg) && match.position() == 0) {
+            size_t len = match.length();
+            if (token == Token::kIdentifier) {
+                len = xidPrefixLength(sub.substr(0, len));
+            } else if (token == Token::kStringLiteral && match["suffix"].matched) {
+                len = match.position("suffix") + xidPrefixLength(match.str("suffix"));
+            }
+            if (len > best_len) {
+                best_len = len;
+                best_token = token;
+            }
         }
-        if (best_len > 0) {
-            if (best_match.first != Token::kComment) res.push_back(best_match);
-            i += best_len - 1;
+    }
+    return {best_token, best_len};
+}
+
+TokenStream Lexer::lex(std::string str) {
+    return lex(std::make_shared<const SourceBuffer>(std::move(str)));
+}
+
+size_t Lexer::lexStep(std::string_view str, size_t i, TokenStream& res) {
+    auto [token, len] = scanToken(str, i);
+    if (size_t reach = farScanReach(str, i, token, len)) res.markFarScan(i, reach);
+    if (len > 0) {
+        res.push(token, i, len);
+        i += len;
+    } else {
+        // 无法识别的字符直接跳过
+        i++;
+    }
+    return skipTrivia(str, i);
+}
+
+size_t Lexer::lexRange(std::string_view str, size_t begin, size_t end, TokenStream& res) {
+    size_t i = skipTrivia(str, begin);
+    while (i < end && i < str.size()) {
+        i = lexStep(str, i, res);
+    }
+    return i;
+}
+
+TokenStream Lexer::lex(std::shared_ptr<const SourceBuffer> source) {
+    std::string_view str = source->view();
+    if (str.size() >= parallel_threshold) {
+        size_t threads = thread_count ? thread_count : std::thread::hardware_concurrency();
+        if (threads > 1) return lexParallel(source, threads);
+    }
+    TokenStream res(source);
+    // 经验上平均每 4 个字节一个 token
+    res.reserve(str.size() / 4 + 1);
+    // 校验与扫描按块交替进行，扫描时这一块仍在缓存中；块的结尾退到字符边界上
+    constexpr size_t kValidateBlock = size_t(64) << 10;
+    size_t i = 0;
+    for (size_t checked = 0; checked < str.size();) {
+        size_t next = std::min(str.size(), checked + kValidateBlock);
+        while (next < str.size() && next > checked + 1 && (static_cast<unsigned char>(str[next]) & 0xC0) == 0x80) next--;
+        validateSource(*source, checked, next);
+        checked = next;
+        i = lexRange(str, i, checked, res);
+    }
+    res.push(Token::kEOF, str.size(), 0);
+    res.resolvePayloads();
+    return res;
+}
+
+TokenStream Lexer::lexParallel(std::shared_ptr<const SourceBuffer> source, size_t chunks) {
+    validateSource(*source);
+    std::string_view str = source->view();
+    auto bounds = findChunkBoundaries(str, std::max<size_t>(chunks, 1));
+    size_t count = bounds.size() - 1;
+    std::vector<TokenStream> parts(count, TokenStream(source));
+    std::vector<size_t> stops(count);
+    std::vector<std::thread> workers;
+    for (size_t c = 1; c < count; ++c) {
+        workers.emplace_back([&, c] {
+            parts[c].reserve((bounds[c + 1] - bounds[c]) / 4 + 1);
+            stops[c] = lexRange(str, bounds[c], bounds[c + 1], parts[c]);
+        });
+    }
+    parts[0].reserve(bounds[1] / 4 + 1);
+    stops[0] = lexRange(str, 0, bounds[1], parts[0]);
+    for (auto& worker: workers) worker.join();
+
+    size_t total = 0;
+    for (const auto& part: parts) total += part.size();
+    TokenStream res(source);
+    res.reserve(total + 1);
+    res.append(parts[0], 0);
+    size_t pos = stops[0];
+    for (size_t c = 1; c < count; ++c) {
+        // 扫描状态只由停靠位置决定：一旦顺序扫描停在本块某个 token 的起点，之后的结果必然相同。
+        // 若前一块越过了边界（跨块的注释或字面量），就从越过处顺序扫描直到与本块重合
+        size_t idx = 0;
+        while (pos < stops[c]) {
+            while (idx < parts[c].size() && parts[c].offset(idx) < pos) idx++;
+            if (idx < parts[c].size() && parts[c].offset(idx) == pos) {
+                res.append(parts[c], idx);
+                pos = stops[c];
+                break;
+            }
+            pos = lexStep(str, pos, res);
+        }
+    }
+    res.push(Token::kEOF, str.size(), 0);
+    // 驻留表不是线程安全的，拼接完成后统一驻留与解码
+    res.resolvePayloads();
+    return res;
+}
+
+void Lexer::lexStreaming(std::shared_ptr<const SourceBuffer> source, TokenRing& ring) {
+    // 攒够一批再写入，减少与消费者之间的同步
+    constexpr size_t kBatch = 256;
+    std::string_view str = source->view();
+    TokenStream batch(source);
+    batch.reserve(kBatch + 1);
+    std::vector<RawToken> raw;
+    raw.reserve(kBatch + 1);
+    size_t i = skipTrivia(str, 0);
+    while (true) {
+        bool done = i >= str.size();
+        if (done) {
+            batch.push(Token::kEOF, str.size(), 0);
+        } else {
+            i = lexStep(str, i, batch);
+        }
+        if (done || batch.size() >= kBatch) {
+            raw.clear();
+            for (size_t k = 0; k < batch.size(); ++k) raw.push_back({batch.kind(k), batch.offset(k), batch.length(k)});
+            if (!ring.push(raw.data(), raw.size())) return;
+            batch.clear();
+        }
+        if (done) return;
+    }
+}
+
+size_t Lexer::relex(TokenStream& tokens, const TextEdit& edit) {
+    std::string_view old = tokens.buffer().view();
+    if (edit.begin > edit.end || edit.end > old.size()) {
+        throw std::runtime_error("Invalid edit range [" + std::to_string(edit.begin) + ", "
+                                 + std::to_string(edit.end) + ")");
+    }
+    std::string text;
+    text.reserve(old.size() - (edit.end - edit.begin) + edit.text.size());
+    text.append(old.substr(0, edit.begin)).append(edit.text).append(old.substr(edit.end));
+    auto source = std::make_shared<const SourceBuffer>(std::move(text));
+    std::string_view str = source->view();
+    int64_t delta = int64_t(edit.text.size()) - int64_t(edit.end - edit.begin);
+    // 编辑前的源码已经校验过，只需校验新文本，两端扩到与之相接的完整字符
+    auto continuation = [&](size_t k) { return (static_cast<unsigned char>(str[k]) & 0xC0) == 0x80; };
+    size_t check_begin = edit.begin > 0 ? edit.begin - 1 : 0;
+    while (check_begin > 0 && continuation(check_begin)) check_begin--;
+    size_t check_end = edit.begin + edit.text.size();
+    while (check_end < str.size() && continuation(check_end)) check_end++;
+    validateSource(*source, check_begin, check_end);
+
+    // 从最后一个扫描范围完全落在编辑之前的 token 重新开始；
+    // 若编辑之前有远距离扫描读到了编辑区且可能因编辑改变结果，必须从它开始
+    size_t eof = tokens.size() - 1;
+    size_t lo = 0, hi = eof;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (tokens.offset(mid) + tokens.length(mid) + kLookahead <= edit.begin) lo = mid + 1;
+        else hi = mid;
+    }
+    size_t restart = lo > 0 ? tokens.offset(lo - 1) : 0;
+    for (const FarScan& scan: tokens.getFarScans()) {
+        if (scan.offset >= std::min<size_t>(restart, edit.begin)) break;
+        if (farScanAffected(old, scan, edit)) {
+            restart = scan.offset;
+            break;
+        }
+    }
+    size_t first = lo > 0 ? lo - 1 : 0;
+    while (first > 0 && tokens.offset(first - 1) >= restart) first--;
+
+    // 扫描状态只由停靠位置决定：越过编辑区后，一旦停在某个旧 token 的起点（平移后），之后的结果与旧结果相同
+    TokenStream fresh(source);
+    size_t sync_from = edit.begin + edit.text.size();
+    size_t last = first;
+    size_t i = skipTrivia(str, restart);
+    while (i < str.size()) {
+        if (i >= sync_from) {
+            size_t old_pos = i - delta;
+            while (last < eof && tokens.offset(last) < old_pos) last++;
+            if (last < eof && tokens.offset(last) == old_pos) break;
+        }
+        i = lexStep(str, i, fresh);
+    }
+    if (i >= str.size()) last = eof;
+    fresh.resolvePayloads();
+    tokens.splice(first, last, fresh, restart, edit.end, delta);
+    return fresh.size();
+}
+
+TokenStream Lexer::lexReference(std::shared_ptr<const SourceBuffer> source) {
+    std::string_view view = source->view();
+    TokenStream res(source);
+    size_t i = skipTrivia(view, 0);
+    while (i < view.size()) {
+        auto [token, len] = matchPattern(view, i);
+        if (len > 0) {
+            if (token != Token::kComment) res.push(token, i, len);
+            i += len;
+        } else {
+            i++;
         }
+        i = skipTrivia(view, i);
     }
-    res.push_back(std::make_pair(Token::kEOF, "EOF"));
+    res.push(Token::kEOF, view.size(), 0);
     return res;
 }
 
 std::string tokenToString(Token token) {
     switch (token) {
         // strict keywords
-        case Token::kAs: return "kAs";
-        case Token::kBreak: return "kBreak";
-        case Token::kConst: return "kConst";
-        case Token::kContinue: return "kContinue";
-        case Token::kCrate: return "kCrate";
-        case Token::kElse: return "kElse";
-        case Token::kEnum: return "kEnum";
-        case Token::kFalse: return "kFalse";
-        case Token::kFn: return "kFn";
-        case Token::kFor: return "kFor";
-        case Token::kIf: return "kIf";
-        case Token::kImpl: return "kImpl";
-        case Token::kIn: return "kIn";
-        case Token::kLet: return "kLet";
-        case Token::kLoop: return "kLoop";
-        case Token::kMatch: return "kMatch";
-        case Token::kMod: return "kMod";
-        case Token::kMove: return "kMove";
-        case Token::kMut: return "kMut";
-        case Token::kRef: return "kRef";
-        case Token::kReturn: return "kReturn";
-        case Token::kSelf: return "kSelf";
-        case Token::kSelf_: return "kSelf_";
-        case Token::kStatic: return "kStatic";
-        case Token::kStruct: return "kStruct";
-        case Token::kSuper: return "kSuper";
-        case Token::kTrait: return "kTrait";
-        case Token::kTrue: return "kTrue";
-        case Token::kType: return "kType";
-        case Token::kUnsafe: return "kUnsafe";
-        case Token::kUse: return "kUse";
-        case Token::kWhere: return "kWhere";
-        case Token::kWhile: return "kWhile";
-        case Token::kDyn: return "kDyn";
+#define X(name, text) case Token::name: return #name;
+        RCOMPILER_KEYWORDS(X)
+#undef X
 
         // identifier
         case Token::kIdentifier: return "kIdentifier";
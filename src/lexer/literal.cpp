@@ -0,0 +1,119 @@
+#include "lexer/literal.hpp"
+#include <ostream>
+
+namespace {
+
+int digitValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 展开 body 中的转义序列；调用前 token 已通过扫描器检查，转义必然合法
+std::string unescape(std::string_view body) {
+    std::string res;
+    res.reserve(body.size());
+    for (size_t i = 0; i < body.size(); ++i) {
+        if (body[i] != '\\' || i + 1 >= body.size()) {
+            res.push_back(body[i]);
+            continue;
+        }
+        char e = body[++i];
+        switch (e) {
+            case 'n': res.push_back('\n'); break;
+            case 'r': res.push_back('\r'); break;
+            case 't': res.push_back('\t'); break;
+            case '0': res.push_back('\0'); break;
+            case 'x':
+                res.push_back(static_cast<char>(digitValue(body[i + 1]) * 16 + digitValue(body[i + 2])));
+                i += 2;
+                break;
+            case '\n':
+                // 续行：跳过换行及下一行开头的空白
+                while (i + 1 < body.size() && (body[i + 1] == ' ' || body[i + 1] == '\t'
+                       || body[i + 1] == '\n' || body[i + 1] == '\r')) i++;
+                break;
+            default: res.push_back(e); break;
+        }
+    }
+    return res;
+}
+
+// 原始字面量 prefix(#+)(body)(#+)：与扫描器相同，从最多的 # 开始尝试，
+// 第一个在 token 内找到结束分隔符的个数即为实际的 # 个数
+std::string_view rawBody(std::string_view text, size_t prefix) {
+    size_t hashes = 0;
+    while (prefix + hashes < text.size() && text[prefix + hashes] == '#') hashes++;
+    for (size_t k = hashes; k >= 1; --k) {
+        size_t q = text.find(std::string(k, '#'), prefix + k);
+        if (q != std::string_view::npos && q + k == text.size()) {
+            std::string_view body = text.substr(prefix + k, q - prefix - k);
+            if (body.size() >= 2 && body.front() == '"' && body.back() == '"') body = body.substr(1, body.size() - 2);
+            return body;
+        }
+    }
+    return {};
+}
+
+} // namespace
+
+IntegerValue decodeIntegerLiteral(std::string_view text) {
+    IntegerValue res;
+    size_t i = 0;
+    if (text.size() > 2 && text[0] == '0') {
+        if (text[1] == 'b') res.radix = 2, i = 2;
+        else if (text[1] == 'o') res.radix = 8, i = 2;
+        else if (text[1] == 'x') res.radix = 16, i = 2;
+    }
+    bool saturated = false;
+    for (; i < text.size(); ++i) {
+        char c = text[i];
+        if (c == '_') continue;
+        int digit = digitValue(c);
+        // 十进制字面量中的字母只可能是后缀的开始；十六进制的后缀 u/i 不是合法数字
+        if (digit < 0 || digit >= res.radix) break;
+        if (!saturated) {
+            if (res.value > (UINT64_MAX - digit) / res.radix) {
+                saturated = true;
+                res.value = UINT64_MAX;
+            } else {
+                res.value = res.value * res.radix + digit;
+            }
+        }
+    }
+    std::string_view suffix = text.substr(i);
+    if (suffix == "i32") res.suffix = IntegerSuffix::kI32;
+    else if (suffix == "u32") res.suffix = IntegerSuffix::kU32;
+    else if (suffix == "isize") res.suffix = IntegerSuffix::kISize;
+    else if (suffix == "usize") res.suffix = IntegerSuffix::kUSize;
+    return res;
+}
+
+std::string decodeTextLiteral(Token kind, std::string_view text) {
+    switch (kind) {
+        case Token::kCharLiteral:
+            return unescape(text.substr(1, text.size() - 2));
+        case Token::kStringLiteral:
+            // 结尾可能带有标识符后缀
+            return unescape(text.substr(1, text.rfind('"') - 1));
+        case Token::kCStringLiteral:
+            return unescape(text.substr(2, text.size() - 3));
+        case Token::kRawStringLiteral:
+            return std::string(rawBody(text, 1));
+        case Token::kRawCStringLiteral:
+            return std::string(rawBody(text, 2));
+        default:
+            return std::string(text);
+    }
+}
+
+LiteralId LiteralId::fromId(uint32_t id) {
+    LiteralId literal;
+    literal.id = id;
+    return literal;
+}
+
+std::ostream& operator<<(std::ostream& os, const LiteralId& literal) {
+    return os << literal.str();
+}
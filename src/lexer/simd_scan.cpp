@@ -0,0 +1,351 @@
+#include "lexer/simd_scan.hpp"
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RCOMPILER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+bool isSpaceByte(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+size_t skipSpaceScalar(const char* p, size_t i, size_t n) {
+    while (i < n && isSpaceByte(p[i])) i++;
+    return i;
+}
+
+size_t findAnyScalar(const char* p, size_t i, size_t n, char a, char b, char c, char d) {
+    while (i < n) {
+        char x = p[i];
+        if (x == a || x == b || x == c || x == d) return i;
+        i++;
+    }
+    return n;
+}
+
+size_t findNonAsciiScalar(const char* p, size_t i, size_t n) {
+    while (i < n && !(p[i] & 0x80)) i++;
+    return i;
+}
+
+// 校验从 i 开始的一个多字节序列（首字节不是 ASCII），合法时返回其长度，否则返回 0。
+// 拒绝过长编码、代理区码点与超过 U+10FFFF 的码点
+size_t utf8SequenceLength(const unsigned char* p, size_t i, size_t n) {
+    unsigned char c = p[i];
+    size_t len;
+    unsigned char lo = 0x80, hi = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF) {
+        len = 2;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        len = 3;
+        if (c == 0xE0) lo = 0xA0;
+        if (c == 0xED) hi = 0x9F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        len = 4;
+        if (c == 0xF0) lo = 0x90;
+        if (c == 0xF4) hi = 0x8F;
+    } else {
+        return 0;
+    }
+    if (i + len > n) return 0;
+    if (p[i + 1] < lo || p[i + 1] > hi) return 0;
+    for (size_t k = 2; k < len; ++k) {
+        if ((p[i + k] & 0xC0) != 0x80) return 0;
+    }
+    return len;
+}
+
+// 用 find_non_ascii 成块跳过 ASCII，非 ASCII 的片段逐个序列校验，直到重新回到 ASCII
+template <typename FindNonAscii>
+size_t validateUtf8Sequences(const char* p, size_t i, size_t n, FindNonAscii find_non_ascii) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(p);
+    while (true) {
+        i = find_non_ascii(p, i, n);
+        if (i >= n) return n;
+        while (i < n && (bytes[i] & 0x80)) {
+            size_t len = utf8SequenceLength(bytes, i, n);
+            if (len == 0) return i;
+            i += len;
+        }
+    }
+}
+
+size_t validateUtf8Scalar(const char* p, size_t i, size_t n) {
+    return validateUtf8Sequences(p, i, n, findNonAsciiScalar);
+}
+
+#ifdef RCOMPILER_X86
+
+// 空白为 ' ' 或 '\t'..'\r'；带符号比较下 >= 0x80 的字节为负，不会落入区间
+size_t skipSpaceSSE2(const char* p, size_t i, size_t n) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i lo = _mm_set1_epi8('\t' - 1);
+    const __m128i hi = _mm_set1_epi8('\r' + 1);
+    while (i + 16 <= n) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(v, space),
+                                  _mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmplt_epi8(v, hi)));
+        unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(ws)) & 0xffffu;
+        if (mask) return i + __builtin_ctz(mask);
+        i += 16;
+    }
+    return skipSpaceScalar(p, i, n);
+}
+
+size_t findAnySSE2(const char* p, size_t i, size_t n, char a, char b, char c, char d) {
+    const __m128i va = _mm_set1_epi8(a), vb = _mm_set1_epi8(b);
+    const __m128i vc = _mm_set1_epi8(c), vd = _mm_set1_epi8(d);
+    while (i + 16 <= n) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)),
+                                   _mm_or_si128(_mm_cmpeq_epi8(v, vc), _mm_cmpeq_epi8(v, vd)));
+        unsigned mask = _mm_movemask_epi8(hit);
+        if (mask) return i + __builtin_ctz(mask);
+        i += 16;
+    }
+    return findAnyScalar(p, i, n, a, b, c, d);
+}
+
+// 最高位为 1 的字节即非 ASCII，movemask 直接取出最高位
+size_t findNonAsciiSSE2(const char* p, size_t i, size_t n) {
+    while (i + 16 <= n) {
+        unsigned mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+        if (mask) return i + __builtin_ctz(mask);
+        i += 16;
+    }
+    return findNonAsciiScalar(p, i, n);
+}
+
+// SSE2 没有字节查表指令，多字节序列仍逐个检查
+size_t validateUtf8SSE2(const char* p, size_t i, size_t n) {
+    return validateUtf8Sequences(p, i, n, findNonAsciiSSE2);
+}
+
+__attribute__((target("avx2")))
+size_t skipSpaceAVX2(const char* p, size_t i, size_t n) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i lo = _mm256_set1_epi8('\t' - 1);
+    const __m256i hi = _mm256_set1_epi8('\r' + 1);
+    while (i + 32 <= n) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        __m256i ws = _mm256_or_si256(_mm256_cmpeq_epi8(v, space),
+                                     _mm256_and_si256(_mm256_cmpgt_epi8(v, lo), _mm256_cmpgt_epi8(hi, v)));
+        unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(ws));
+        if (mask) return i + __builtin_ctz(mask);
+        i += 32;
+    }
+    return skipSpaceSSE2(p, i, n);
+}
+
+__attribute__((target("avx2")))
+size_t findAnyAVX2(const char* p, size_t i, size_t n, char a, char b, char c, char d) {
+    const __m256i va = _mm256_set1_epi8(a), vb = _mm256_set1_epi8(b);
+    const __m256i vc = _mm256_set1_epi8(c), vd = _mm256_set1_epi8(d);
+    while (i + 32 <= n) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, va), _mm256_cmpeq_epi8(v, vb)),
+                                      _mm256_or_si256(_mm256_cmpeq_epi8(v, vc), _mm256_cmpeq_epi8(v, vd)));
+        unsigned mask = _mm256_movemask_epi8(hit);
+        if (mask) return i + __builtin_ctz(mask);
+        i += 32;
+    }
+    return findAnySSE2(p, i, n, a, b, c, d);
+}
+
+__attribute__((target("avx2")))
+size_t findNonAsciiAVX2(const char* p, size_t i, size_t n) {
+    // 一次检查 128 字节，纯 ASCII 的输入几乎只剩下内存带宽的开销
+    while (i + 128 <= n) {
+        const auto* q = reinterpret_cast<const __m256i*>(p + i);
+        __m256i a = _mm256_or_si256(_mm256_loadu_si256(q), _mm256_loadu_si256(q + 1));
+        __m256i b = _mm256_or_si256(_mm256_loadu_si256(q + 2), _mm256_loadu_si256(q + 3));
+        if (_mm256_movemask_epi8(_mm256_or_si256(a, b))) break;
+        i += 128;
+    }
+    while (i + 32 <= n) {
+        unsigned mask = _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+        if (mask) return i + __builtin_ctz(mask);
+        i += 32;
+    }
+    return findNonAsciiSSE2(p, i, n);
+}
+
+// 多字节序列的向量化校验（Keiser 与 Lemire 的查表法）。每个字节与它前面的一个字节按高 4 位、
+// 低 4 位查三张表，三者相与得到该字节对上可能出现的错误；前两个、前三个字节为三、四字节序列的
+// 首字节时，该字节必须是后续字节，与查表结果中 TWO_CONTS 位异或即可发现长度不符的序列
+namespace utf8 {
+constexpr uint8_t kTooShort = 1 << 0;     // 11______ 0_______ 或 11______ 11______
+constexpr uint8_t kTooLong = 1 << 1;      // 0_______ 10______
+constexpr uint8_t kOverlong3 = 1 << 2;    // 11100000 100_____
+constexpr uint8_t kTooLarge = 1 << 3;     // 11110100 1001____ 以及更大的首字节
+constexpr uint8_t kSurrogate = 1 << 4;    // 11101101 101_____
+constexpr uint8_t kOverlong2 = 1 << 5;    // 1100000_ 10______
+constexpr uint8_t kTooLarge1000 = 1 << 6; // 11110101 1000____ 以及更大的首字节
+constexpr uint8_t kOverlong4 = 1 << 6;    // 11110000 1000____
+constexpr uint8_t kTwoConts = 1 << 7;     // 10______ 10______
+constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+}
+
+__attribute__((target("avx2")))
+inline __m256i lookup16(__m256i index, uint8_t t0, uint8_t t1, uint8_t t2, uint8_t t3, uint8_t t4, uint8_t t5,
+                        uint8_t t6, uint8_t t7, uint8_t t8, uint8_t t9, uint8_t t10, uint8_t t11, uint8_t t12,
+                        uint8_t t13, uint8_t t14, uint8_t t15) {
+    __m256i table = _mm256_setr_epi8(t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15,
+                                     t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15);
+    return _mm256_shuffle_epi8(table, index);
+}
+
+// 32 个字节中每个字节所在序列的错误，prev 为紧挨在前面的 32 个字节
+__attribute__((target("avx2")))
+inline __m256i utf8Errors(__m256i input, __m256i prev) {
+    using namespace utf8;
+    const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+    // prevK 的第 j 个字节是 input 第 j 个字节之前的第 K 个字节
+    __m256i shifted = _mm256_permute2x128_si256(prev, input, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+    __m256i prev2 = _mm256_alignr_epi8(input, shifted, 14);
+    __m256i prev3 = _mm256_alignr_epi8(input, shifted, 13);
+
+    __m256i byte1_high = lookup16(_mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble),
+        kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+        kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+        kTooShort | kOverlong2,
+        kTooShort,
+        kTooShort | kOverlong3 | kSurrogate,
+        kTooShort | kTooLarge | kTooLarge1000 | kOverlong4);
+    __m256i byte1_low = lookup16(_mm256_and_si256(prev1, low_nibble),
+        kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+        kCarry | kOverlong2,
+        kCarry, kCarry,
+        kCarry | kTooLarge,
+        kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+        kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000);
+    __m256i byte2_high = lookup16(_mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble),
+        kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+        kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+        kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+        kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+        kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+        kTooShort, kTooShort, kTooShort, kTooShort);
+    __m256i special = _mm256_and_si256(_mm256_and_si256(byte1_high, byte1_low), byte2_high);
+
+    // 前两个字节不小于 0xE0 或前三个字节不小于 0xF0 时，本字节必须是后续字节
+    __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xE0 - 0x80)));
+    __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xF0 - 0x80)));
+    __m256i must_continue = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(char(0x80)));
+    return _mm256_xor_si256(must_continue, special);
+}
+
+__attribute__((target("avx2")))
+size_t validateUtf8AVX2(const char* p, size_t i, size_t n) {
+    size_t begin = i;
+    // 最后三个字节中未完结的序列首字节，要由下一块的开头补全
+    const __m256i last_lead = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, char(0xF0 - 1), char(0xE0 - 1), char(0xC0 - 1));
+    __m256i prev = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    // 各块的错误只做累积，循环中不分支；合法输入是常态，出错时再从头逐序列检查出确切位置
+    __m256i errors = _mm256_setzero_si256();
+    while (i + 64 <= n) {
+        const auto* q = reinterpret_cast<const __m256i*>(p + i);
+        __m256i first = _mm256_loadu_si256(q);
+        __m256i second = _mm256_loadu_si256(q + 1);
+        if (!_mm256_movemask_epi8(_mm256_or_si256(first, second))) {
+            // 纯 ASCII：前面不能留有未完结的序列
+            errors = _mm256_or_si256(errors, incomplete);
+            incomplete = _mm256_setzero_si256();
+        } else {
+            errors = _mm256_or_si256(errors, utf8Errors(first, prev));
+            errors = _mm256_or_si256(errors, utf8Errors(second, first));
+            incomplete = _mm256_subs_epu8(second, last_lead);
+        }
+        prev = second;
+        i += 64;
+    }
+    if (!_mm256_testz_si256(errors, errors)) {
+        return validateUtf8Sequences(p, begin, n, findNonAsciiAVX2);
+    }
+    // 不足 64 字节的结尾由逐序列的检查处理。前面的块中只有最后三个字节里可能有未完结的
+    // 序列，从其中第一个不是后续字节的位置重新检查即回到字符边界
+    const auto* bytes = reinterpret_cast<const unsigned char*>(p);
+    size_t start = i - std::min<size_t>(i - begin, 3);
+    while (start < i && (bytes[start] & 0xC0) == 0x80) start++;
+    return validateUtf8Sequences(p, start, n, findNonAsciiAVX2);
+}
+
+#endif
+
+using SkipSpaceFn = size_t (*)(const char*, size_t, size_t);
+using FindAnyFn = size_t (*)(const char*, size_t, size_t, char, char, char, char);
+using ValidateUtf8Fn = size_t (*)(const char*, size_t, size_t);
+
+struct Kernels {
+    SimdLevel level;
+    SkipSpaceFn skip_space;
+    FindAnyFn find_any;
+    ValidateUtf8Fn validate_utf8;
+};
+
+Kernels kernelsFor(SimdLevel level) {
+    switch (level) {
+#ifdef RCOMPILER_X86
+        case SimdLevel::kAVX2: return {level, skipSpaceAVX2, findAnyAVX2, validateUtf8AVX2};
+        case SimdLevel::kSSE2: return {level, skipSpaceSSE2, findAnySSE2, validateUtf8SSE2};
+#endif
+        default: return {SimdLevel::kScalar, skipSpaceScalar, findAnyScalar, validateUtf8Scalar};
+    }
+}
+
+Kernels& kernels() {
+    static Kernels current = kernelsFor(SimdScanner::detect());
+    return current;
+}
+
+} // namespace
+
+SimdLevel SimdScanner::detect() {
+#ifdef RCOMPILER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::kAVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::kSSE2;
+#endif
+    return SimdLevel::kScalar;
+}
+
+SimdLevel SimdScanner::level() {
+    return kernels().level;
+}
+
+void SimdScanner::setLevel(SimdLevel level) {
+    if (static_cast<int>(level) > static_cast<int>(detect())) level = detect();
+    kernels() = kernelsFor(level);
+}
+
+size_t SimdScanner::skipSpace(const char* p, size_t i, size_t n) {
+    return kernels().skip_space(p, i, n);
+}
+
+size_t SimdScanner::findAny(const char* p, size_t i, size_t n, char a, char b, char c, char d) {
+    return kernels().find_any(p, i, n, a, b, c, d);
+}
+
+size_t SimdScanner::validateUtf8(const char* p, size_t i, size_t n) {
+    return kernels().validate_utf8(p, i, n);
+}
+
+const char* simdLevelToString(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::kScalar: return "scalar";
+        case SimdLevel::kSSE2: return "sse2";
+        case SimdLevel::kAVX2: return "avx2";
+    }
+    return "unknown";
+}
@@ -0,0 +1,92 @@
+#include "lexer/source_file.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SourceFile::SourceFile(SourceFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+SourceFile& SourceFile::operator=(SourceFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        mapped = other.mapped;
+        length = other.length;
+        fallback = std::move(other.fallback);
+        data = mapped ? other.data : fallback.data();
+        other.data = nullptr;
+        other.length = 0;
+        other.mapped = false;
+    }
+    return *this;
+}
+
+SourceFile::~SourceFile() {
+    release();
+}
+
+void SourceFile::release() {
+    if (mapped) munmap(const_cast<char*>(data), length);
+    data = nullptr;
+    length = 0;
+    mapped = false;
+    fallback.clear();
+}
+
+SourceFile SourceFile::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+    }
+    try {
+        SourceFile file = fromDescriptor(fd);
+        ::close(fd);
+        return file;
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+}
+
+SourceFile SourceFile::fromDescriptor(int fd) {
+    SourceFile file;
+    struct stat st {};
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            madvise(addr, st.st_size, MADV_SEQUENTIAL);
+            madvise(addr, st.st_size, MADV_WILLNEED);
+            file.data = static_cast<const char*>(addr);
+            file.length = st.st_size;
+            file.mapped = true;
+            return file;
+        }
+    }
+    // 管道、终端等：按大块读到文件末尾
+    size_t capacity = S_ISREG(st.st_mode) && st.st_size > 0 ? st.st_size : 1 << 16;
+    std::string buffer(capacity, '\0');
+    size_t used = 0;
+    while (true) {
+        if (used == buffer.size()) buffer.resize(buffer.size() * 2);
+        ssize_t n = ::read(fd, buffer.data() + used, buffer.size() - used);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("read failed: ") + std::strerror(errno));
+        }
+        if (n == 0) break;
+        used += n;
+    }
+    buffer.resize(used);
+    file.fallback = std::move(buffer);
+    file.data = file.fallback.data();
+    file.length = used;
+    return file;
+}
+
+std::string_view SourceFile::view() const {
+    return std::string_view(data, length);
+}
@@ -0,0 +1,55 @@
+#include "lexer/token_ring.hpp"
+#include "lexer/lexer.hpp"
+#include <algorithm>
+#include <bit>
+
+TokenRing::TokenRing(size_t capacity)
+    : slots(std::bit_ceil(std::max<size_t>(capacity, 2))), mask(slots.size() - 1) {}
+
+bool TokenRing::push(const RawToken* tokens, size_t n) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    size_t k = 0;
+    while (k < n) {
+        size_t free = slots.size() - (t - head.load(std::memory_order_acquire));
+        if (free == 0) {
+            if (closed.load(std::memory_order_relaxed)) return false;
+            std::this_thread::yield();
+            continue;
+        }
+        size_t count = std::min(free, n - k);
+        for (size_t c = 0; c < count; ++c) slots[(t + c) & mask] = tokens[k + c];
+        t += count;
+        k += count;
+        tail.store(t, std::memory_order_release);
+    }
+    return !closed.load(std::memory_order_relaxed);
+}
+
+size_t TokenRing::pop(RawToken* out, size_t max) {
+    size_t h = head.load(std::memory_order_relaxed);
+    size_t t;
+    while ((t = tail.load(std::memory_order_acquire)) == h) std::this_thread::yield();
+    size_t count = std::min(t - h, max);
+    for (size_t c = 0; c < count; ++c) out[c] = slots[(h + c) & mask];
+    head.store(h + count, std::memory_order_release);
+    return count;
+}
+
+void TokenRing::close() {
+    closed.store(true, std::memory_order_relaxed);
+}
+
+TokenPipe::TokenPipe(std::shared_ptr<const SourceBuffer> source, size_t capacity)
+    : source(std::move(source)), ring(capacity) {
+    // 在调用线程上校验，非法输入的异常由调用者处理
+    Lexer::validateSource(*this->source);
+    worker = std::thread([this] {
+        Lexer lexer;
+        lexer.lexStreaming(this->source, ring);
+    });
+}
+
+TokenPipe::~TokenPipe() {
+    ring.close();
+    worker.join();
+}
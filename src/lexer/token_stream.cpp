@@ -0,0 +1,176 @@
+#include "lexer/token_stream.hpp"
+#include <algorithm>
+
+SourceBuffer::SourceBuffer(std::string text): owned(std::move(text)), text(owned) {}
+
+SourceBuffer::SourceBuffer(SourceFile file): file(std::move(file)), text(this->file.view()) {}
+
+std::string_view SourceBuffer::view() const {
+    return text;
+}
+
+size_t SourceBuffer::size() const {
+    return text.size();
+}
+
+void SourceBuffer::buildLineStarts() const {
+    line_starts.push_back(0);
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\n') line_starts.push_back(i + 1);
+    }
+}
+
+SourceLocation SourceBuffer::location(uint32_t offset) const {
+    std::call_once(line_starts_built, [this] { buildLineStarts(); });
+    auto it = std::upper_bound(line_starts.begin(), line_starts.end(), offset);
+    uint32_t line = it - line_starts.begin();
+    return {line, offset - *(it - 1) + 1};
+}
+
+namespace {
+
+// 第一个起始偏移不小于 offset 的远距离扫描
+std::vector<FarScan>::const_iterator farScanFrom(const std::vector<FarScan>& scans, uint32_t offset) {
+    return std::partition_point(scans.begin(), scans.end(), [offset](const FarScan& scan) { return scan.offset < offset; });
+}
+
+} // namespace
+
+TokenStream::TokenStream(std::shared_ptr<const SourceBuffer> source): source(std::move(source)) {}
+
+void TokenStream::reserve(size_t n) {
+    kinds.reserve(n);
+    offsets.reserve(n);
+    lengths.reserve(n);
+}
+
+void TokenStream::clear() {
+    kinds.clear();
+    offsets.clear();
+    lengths.clear();
+    payloads.clear();
+    integers.clear();
+    far_scans.clear();
+}
+
+void TokenStream::push(Token token, uint32_t offset, uint32_t length) {
+    kinds.push_back(token);
+    offsets.push_back(offset);
+    lengths.push_back(length);
+}
+
+void TokenStream::append(const TokenStream& other, size_t from) {
+    kinds.insert(kinds.end(), other.kinds.begin() + from, other.kinds.end());
+    offsets.insert(offsets.end(), other.offsets.begin() + from, other.offsets.end());
+    lengths.insert(lengths.end(), other.lengths.begin() + from, other.lengths.end());
+    if (from < other.size()) {
+        far_scans.insert(far_scans.end(), farScanFrom(other.far_scans, other.offsets[from]), other.far_scans.end());
+    }
+}
+
+TokenStream TokenStream::slice(size_t first, size_t last) const {
+    TokenStream res(source);
+    res.reserve(last - first + 1);
+    res.kinds.assign(kinds.begin() + first, kinds.begin() + last);
+    res.offsets.assign(offsets.begin() + first, offsets.begin() + last);
+    res.lengths.assign(lengths.begin() + first, lengths.begin() + last);
+    res.payloads.assign(payloads.begin() + first, payloads.begin() + last);
+    for (size_t i = 0; i < res.size(); ++i) {
+        if (res.kinds[i] == Token::kIntegerLiteral) {
+            res.integers.push_back(integers[res.payloads[i]]);
+            res.payloads[i] = res.integers.size() - 1;
+        }
+    }
+    uint32_t end = last < size() ? offsets[last] : source->size();
+    res.push(Token::kEOF, end, 0);
+    res.payloads.push_back(0);
+    return res;
+}
+
+void TokenStream::resolvePayloads(size_t from) {
+    auto& interner = Interner::global();
+    auto& literals = LiteralPool::global();
+    payloads.resize(from);
+    payloads.resize(kinds.size(), 0);
+    if (from == 0) integers.clear();
+    for (size_t i = from; i < kinds.size(); ++i) {
+        if (kinds[i] == Token::kIdentifier) {
+            payloads[i] = interner.intern(text(i));
+        } else if (kinds[i] == Token::kIntegerLiteral) {
+            payloads[i] = integers.size();
+            integers.push_back(decodeIntegerLiteral(text(i)));
+        } else if (kinds[i] >= Token::kCharLiteral && kinds[i] <= Token::kRawCStringLiteral) {
+            payloads[i] = literals.intern(decodeTextLiteral(kinds[i], text(i)));
+        }
+    }
+}
+
+void TokenStream::discardFront(size_t count) {
+    count = std::min(count, kinds.size());
+    kinds.erase(kinds.begin(), kinds.begin() + count);
+    offsets.erase(offsets.begin(), offsets.begin() + count);
+    lengths.erase(lengths.begin(), lengths.begin() + count);
+    payloads.erase(payloads.begin(), payloads.begin() + std::min(count, payloads.size()));
+    std::vector<IntegerValue> kept;
+    for (size_t i = 0; i < payloads.size(); ++i) {
+        if (kinds[i] == Token::kIntegerLiteral) {
+            kept.push_back(integers[payloads[i]]);
+            payloads[i] = kept.size() - 1;
+        }
+    }
+    integers = std::move(kept);
+    if (!offsets.empty()) {
+        far_scans.erase(far_scans.begin(), farScanFrom(far_scans, offsets.front()));
+    }
+}
+
+namespace {
+
+template <typename T>
+void spliceVector(std::vector<T>& vec, size_t first, size_t last, const std::vector<T>& replacement) {
+    size_t common = std::min(last - first, replacement.size());
+    std::copy(replacement.begin(), replacement.begin() + common, vec.begin() + first);
+    if (replacement.size() > common) {
+        vec.insert(vec.begin() + last, replacement.begin() + common, replacement.end());
+    } else {
+        vec.erase(vec.begin() + first + common, vec.begin() + last);
+    }
+}
+
+} // namespace
+
+void TokenStream::splice(size_t first, size_t last, const TokenStream& replacement, uint32_t region_begin,
+                         uint32_t edit_end, int64_t delta) {
+    uint32_t region_end = offsets[last];
+
+    // 新 token 的整数字面量追加到本流的表中，旧表项不再回收
+    std::vector<uint32_t> new_payloads = replacement.payloads;
+    for (size_t i = 0; i < replacement.size(); ++i) {
+        if (replacement.kinds[i] == Token::kIntegerLiteral) {
+            new_payloads[i] = integers.size();
+            integers.push_back(replacement.integers[replacement.payloads[i]]);
+        }
+    }
+
+    spliceVector(kinds, first, last, replacement.kinds);
+    spliceVector(offsets, first, last, replacement.offsets);
+    spliceVector(lengths, first, last, replacement.lengths);
+    spliceVector(payloads, first, last, new_payloads);
+    for (size_t i = first + replacement.size(); i < offsets.size(); ++i) {
+        offsets[i] += delta;
+    }
+
+    std::vector<FarScan> scans;
+    auto begin_it = farScanFrom(far_scans, region_begin);
+    auto end_it = farScanFrom(far_scans, region_end);
+    for (auto it = far_scans.cbegin(); it != begin_it; ++it) {
+        scans.push_back({it->offset, uint32_t(it->reach >= edit_end ? it->reach + delta : it->reach)});
+    }
+    scans.insert(scans.end(), replacement.far_scans.begin(), replacement.far_scans.end());
+    for (auto it = end_it; it != far_scans.cend(); ++it) {
+        scans.push_back({uint32_t(it->offset + delta), uint32_t(it->reach + delta)});
+    }
+    far_scans = std::move(scans);
+
+    source = replacement.source;
+}
@@ -2,6 +2,7 @@
 #include "lexer/lexer.hpp"
 #include "parser/parser.hpp"
 #include "parser/astprinter.hpp"
+#include "parser/ast_cache.hpp"
 #include "semantic/symbol.hpp"
 #include "semantic/scope.hpp"
 #include "semantic/symbol_collector.hpp"
@@ -9,29 +10,57 @@
 #include "semantic/struct_checker.hpp"
 #include "semantic/type_checker.hpp"
 
-int main() {
+// 用法：code [--ast-cache <目录>] [--recover]
+// 指定缓存目录后，源码与缓存中的某次编译相同时直接载入当时的 AST，跳过词法与语法分析；
+// --recover 时一次报告出所有语法错误，而不是停在第一个上
+int main(int argc, char* argv[]) {
+    std::string cache_directory;
+    bool recover = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--recover") {
+            recover = true;
+        } else if (argument == "--ast-cache" && i + 1 < argc) {
+            cache_directory = argv[++i];
+        } else if (argument.rfind("--ast-cache=", 0) == 0) {
+            cache_directory = argument.substr(std::string("--ast-cache=").size());
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--ast-cache <directory>] [--recover]" << std::endl;
+            return 1;
+        }
+    }
+
     freopen("test.in", "r", stdin);
     freopen("test.out", "w", stdout);
     
-    std::string code;
-    char ch = getchar();
-    while (ch != EOF) {
-        code += ch;
-        ch = getchar();
-    }
-    // std::cout << code << std::endl;
+    auto source = std::make_shared<const SourceBuffer>(SourceFile::fromDescriptor(fileno(stdin)));
 
-    Lexer lexer;
-    auto tokens = lexer.lex(code);
-    // std::cout << tokens.size() << std::endl;
-    // int id = 0;
-    // for (auto token: tokens) {
-    //     std::cout << id << ' ' << tokenToString(token.first) << ' ' << token.second << std::endl;
-    //     id++;
-    // }
-    
-    Parser parser(std::move(tokens));
-    auto root = parser.parseCrate();
+    std::unique_ptr<ASTCache> cache;
+    std::shared_ptr<Crate> root;
+    if (!cache_directory.empty()) {
+        cache = std::make_unique<ASTCache>(cache_directory);
+        root = cache->load(source->view());
+    }
+    if (!root) {
+        Lexer lexer;
+        auto tokens = lexer.lex(source);
+        // std::cout << tokens.size() << std::endl;
+        // for (size_t id = 0; id < tokens.size(); ++id) {
+        //     std::cout << id << ' ' << tokenToString(tokens.kind(id)) << ' ' << tokens.text(id) << std::endl;
+        // }
+        
+        Parser parser(std::move(tokens));
+        parser.setRecovery(recover);
+        root = parser.parseCrate();
+        if (!parser.getDiagnostics().empty()) {
+            for (const auto& diagnostic: parser.getDiagnostics()) {
+                std::cerr << diagnostic.message << std::endl;
+            }
+            return 1;
+        }
+        if (cache) cache->store(source->view(), *root);
+    }
+    if (cache) cache->printStats(std::cerr);
     ASTPrinter printer(std::cout, false);
     printer.set_indent_level(0);
     printer.visit(*root);
@@ -40,57 +69,57 @@ int main() {
     symbol_collector.visit(*root);
     auto root_scope = symbol_collector.getRootScope();
 
-    auto s_var_symbol = std::make_shared<VariableSymbol>("s", "&str", false, false);
-    auto print_symbol = std::make_shared<FuncSymbol>("print", "()", false, MethodType::NOT_METHOD);
-    auto println_symbol = std::make_shared<FuncSymbol>("println", "()", false, MethodType::NOT_METHOD);
+    auto s_var_symbol = std::make_shared<VariableSymbol>(Name("s"), TypeContext::global().reference(types::kStr), false, false);
+    auto print_symbol = std::make_shared<FuncSymbol>(Name("print"), types::kUnit, false, MethodType::NOT_METHOD);
+    auto println_symbol = std::make_shared<FuncSymbol>(Name("println"), types::kUnit, false, MethodType::NOT_METHOD);
     print_symbol->addParameter(s_var_symbol), println_symbol->addParameter(s_var_symbol);
-    auto n_int_symbol = std::make_shared<VariableSymbol>("n", "i32", false, false);
-    auto print_int_symbol = std::make_shared<FuncSymbol>("printInt", "()", false, MethodType::NOT_METHOD);
-    auto println_int_symbol = std::make_shared<FuncSymbol>("printlnInt", "()", false, MethodType::NOT_METHOD);
+    auto n_int_symbol = std::make_shared<VariableSymbol>(Name("n"), types::kI32, false, false);
+    auto print_int_symbol = std::make_shared<FuncSymbol>(Name("printInt"), types::kUnit, false, MethodType::NOT_METHOD);
+    auto println_int_symbol = std::make_shared<FuncSymbol>(Name("printlnInt"), types::kUnit, false, MethodType::NOT_METHOD);
     print_int_symbol->addParameter(n_int_symbol), println_int_symbol->addParameter(n_int_symbol);
-    root_scope->addFuncSymbol("print", print_symbol);
-    root_scope->addFuncSymbol("println", println_symbol);
-    root_scope->addFuncSymbol("printInt", print_int_symbol);
-    root_scope->addFuncSymbol("printlnInt", println_int_symbol);
+    root_scope->addFuncSymbol(Name("print"), print_symbol);
+    root_scope->addFuncSymbol(Name("println"), println_symbol);
+    root_scope->addFuncSymbol(Name("printInt"), print_int_symbol);
+    root_scope->addFuncSymbol(Name("printlnInt"), println_int_symbol);
     
     // 添加全局内建函数
-    auto get_string_symbol = std::make_shared<FuncSymbol>("getString", "String", false, MethodType::NOT_METHOD);
-    auto get_int_symbol = std::make_shared<FuncSymbol>("getInt", "i32", false, MethodType::NOT_METHOD);
-    auto code_param_symbol = std::make_shared<VariableSymbol>("code", "i32", false, false);
-    auto exit_symbol = std::make_shared<FuncSymbol>("exit", "()", false, MethodType::NOT_METHOD);
+    auto get_string_symbol = std::make_shared<FuncSymbol>(Name("getString"), types::kString, false, MethodType::NOT_METHOD);
+    auto get_int_symbol = std::make_shared<FuncSymbol>(Name("getInt"), types::kI32, false, MethodType::NOT_METHOD);
+    auto code_param_symbol = std::make_shared<VariableSymbol>(Name("code"), types::kI32, false, false);
+    auto exit_symbol = std::make_shared<FuncSymbol>(Name("exit"), types::kUnit, false, MethodType::NOT_METHOD);
     exit_symbol->addParameter(code_param_symbol);
     
-    root_scope->addFuncSymbol("getString", get_string_symbol);
-    root_scope->addFuncSymbol("getInt", get_int_symbol);
-    root_scope->addFuncSymbol("exit", exit_symbol);
+    root_scope->addFuncSymbol(Name("getString"), get_string_symbol);
+    root_scope->addFuncSymbol(Name("getInt"), get_int_symbol);
+    root_scope->addFuncSymbol(Name("exit"), exit_symbol);
     
     // 创建 u32 结构体并添加 to_string 方法
-    auto u32_struct = std::make_shared<StructSymbol>("u32", "u32");
-    auto u32_to_string_method = std::make_shared<FuncSymbol>("to_string", "String", false, MethodType::SELF_REF);
+    auto u32_struct = std::make_shared<StructSymbol>(Name("u32"), types::kU32);
+    auto u32_to_string_method = std::make_shared<FuncSymbol>(Name("to_string"), types::kString, false, MethodType::SELF_REF);
     u32_struct->addMethod(u32_to_string_method);
     
     // 创建 usize 结构体并添加 to_string 方法
-    auto usize_struct = std::make_shared<StructSymbol>("usize", "usize");
-    auto usize_to_string_method = std::make_shared<FuncSymbol>("to_string", "String", false, MethodType::SELF_REF);
+    auto usize_struct = std::make_shared<StructSymbol>(Name("usize"), types::kUsize);
+    auto usize_to_string_method = std::make_shared<FuncSymbol>(Name("to_string"), types::kString, false, MethodType::SELF_REF);
     usize_struct->addMethod(usize_to_string_method);
     
     // 创建 String 结构体并添加方法
-    auto string_struct = std::make_shared<StructSymbol>("String", "String");
-    auto string_as_str_method = std::make_shared<FuncSymbol>("as_str", "&str", false, MethodType::SELF_REF);
-    auto string_len_method = std::make_shared<FuncSymbol>("len", "u32", false, MethodType::SELF_REF);
+    auto string_struct = std::make_shared<StructSymbol>(Name("String"), types::kString);
+    auto string_as_str_method = std::make_shared<FuncSymbol>(Name("as_str"), TypeContext::global().reference(types::kStr), false, MethodType::SELF_REF);
+    auto string_len_method = std::make_shared<FuncSymbol>(Name("len"), types::kU32, false, MethodType::SELF_REF);
     string_struct->addMethod(string_as_str_method);
     string_struct->addMethod(string_len_method);
     
     // 创建 &str 结构体并添加 len 方法
-    auto str_struct = std::make_shared<StructSymbol>("str", "str");
-    auto str_len_method = std::make_shared<FuncSymbol>("len", "u32", false, MethodType::SELF_REF);
+    auto str_struct = std::make_shared<StructSymbol>(Name("str"), types::kStr);
+    auto str_len_method = std::make_shared<FuncSymbol>(Name("len"), types::kU32, false, MethodType::SELF_REF);
     str_struct->addMethod(str_len_method);
     
     // 将结构体添加到根作用域
-    root_scope->addStructSymbol("u32", u32_struct);
-    root_scope->addStructSymbol("usize", usize_struct);
-    root_scope->addStructSymbol("String", string_struct);
-    root_scope->addStructSymbol("str", str_struct);
+    root_scope->addStructSymbol(Name("u32"), u32_struct);
+    root_scope->addStructSymbol(Name("usize"), usize_struct);
+    root_scope->addStructSymbol(Name("String"), string_struct);
+    root_scope->addStructSymbol(Name("str"), str_struct);
 
     root_scope->printScope();
 
@@ -0,0 +1,29 @@
+#include "parser/ast_arena.hpp"
+#include <algorithm>
+#include <iterator>
+
+void ASTArena::grow(size_t minimum) {
+    size_t size = std::max(kBlockSize, minimum);
+    blocks.push_back(std::make_unique<std::byte[]>(size));
+    cursor = blocks.back().get();
+    limit = cursor + size;
+    bytes_reserved += size;
+}
+
+void ASTArena::adopt(ASTArena&& other) {
+    blocks.insert(blocks.end(), std::make_move_iterator(other.blocks.begin()), std::make_move_iterator(other.blocks.end()));
+    destructors.insert(destructors.end(), other.destructors.begin(), other.destructors.end());
+    node_count += other.node_count;
+    bytes_used += other.bytes_used;
+    bytes_reserved += other.bytes_reserved;
+    other.blocks.clear();
+    other.destructors.clear();
+    other.cursor = other.limit = nullptr;
+    other.node_count = other.bytes_used = other.bytes_reserved = 0;
+}
+
+ASTArena::~ASTArena() {
+    for (auto it = destructors.rbegin(); it != destructors.rend(); ++it) {
+        it->destroy(it->object);
+    }
+}
@@ -0,0 +1,648 @@
+#include "parser/ast_cache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <unistd.h>
+#include "lexer/source_file.hpp"
+#include "parser/ast_arena.hpp"
+#include "parser/walker.hpp"
+
+namespace {
+
+// File layout: Header, the string table (u32 length + bytes each), one record per node
+// with children before their parents, then the ids of the crate's items. The checksum in
+// the header is the hash of the whole file with the checksum itself zeroed; it is checked
+// before anything else is decoded.
+// The string table starts with every interned name and then every pooled literal, in id
+// order, so that loading interns them in the order lexing did and hands out the same ids
+// (scopes iterate hash maps keyed by name ids). The text of integer literals follows.
+// A record is [u8 kind][u32 id][fields...]; the fields are exactly the constructor
+// arguments of the node, encoded as:
+//   bool -> u8, int and enums -> u32, IntegerValue -> u64 value, u8 radix, u8 suffix,
+//   Name / LiteralId / std::string -> u32 string index,
+//   node pointer -> u32 id (kNull for nullptr), vector of nodes -> u32 count + ids
+constexpr char kMagic[8] = {'R', 'C', 'A', 'S', 'T', '\0', '\0', '\0'};
+// Identifies the build that wrote a cache file: the compiler and PARSER_BUILD_ID, which the
+// build system derives from the contents of the lexer and parser sources, so any change to
+// them invalidates existing caches without a timestamp. Builds that do not define it rely on
+// kFormatVersion alone
+#ifndef PARSER_BUILD_ID
+#define PARSER_BUILD_ID ""
+#endif
+#ifdef __VERSION__
+constexpr std::string_view kBuild = __VERSION__ " " PARSER_BUILD_ID;
+#else
+constexpr std::string_view kBuild = PARSER_BUILD_ID;
+#endif
+constexpr uint32_t kByteOrder = 0x01020304;
+constexpr uint32_t kNull = UINT32_MAX;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t name_count;
+    uint32_t literal_count;
+    uint32_t string_count;
+    uint32_t record_count;
+    uint32_t node_count;
+    uint32_t crate_id;
+    uint32_t item_count;
+    uint32_t reserved;
+    uint64_t source_size;
+    uint64_t source_hash;
+    uint64_t build_hash;
+    uint64_t checksum;
+};
+static_assert(std::is_trivially_copyable_v<Header> && sizeof(Header) == 80);
+
+// FNV-1a
+uint64_t hashBytes(std::string_view bytes, uint64_t hash = 14695981039346656037ull) {
+    for (unsigned char c: bytes) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// FNV-1a over eight bytes at a time. Each step is a bijection of the state, so changing any
+// single word always changes the result
+uint64_t hashWords(std::string_view bytes, uint64_t hash) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, bytes.data() + i, sizeof(uint64_t));
+        hash ^= word;
+        hash *= 1099511628211ull;
+    }
+    return hashBytes(bytes.substr(i), hash);
+}
+
+uint64_t checksum(Header header, std::string_view body) {
+    header.checksum = 0;
+    return hashWords(body, hashBytes(std::string_view(reinterpret_cast<const char*>(&header), sizeof(Header))));
+}
+
+// The constructor arguments of each node, in constructor order. Writer and Reader both
+// go through these, so a node kind only has to be described once.
+auto fields(Item& node) { return std::tuple(node.item); }
+auto fields(Function& node) {
+    return std::tuple(node.is_const, node.identifier, node.function_parameters, node.function_return_type, node.body());
+}
+auto fields(Struct& node) { return std::tuple(node.struct_struct); }
+auto fields(Enumeration& node) { return std::tuple(node.identifier, node.enum_variants); }
+auto fields(ConstantItem& node) { return std::tuple(node.identifier, node.type, node.expression); }
+auto fields(Trait& node) { return std::tuple(node.identifier, node.associated_item); }
+auto fields(Implementation& node) { return std::tuple(node.impl); }
+auto fields(FunctionParameters& node) { return std::tuple(node.self_param, node.function_param); }
+auto fields(SelfParam& node) { return std::tuple(node.child); }
+auto fields(ShorthandSelf& node) { return std::tuple(node.is_reference, node.is_mutable); }
+auto fields(TypedSelf& node) { return std::tuple(node.is_mutable, node.type); }
+auto fields(FunctionParam& node) { return std::tuple(node.pattern_no_top_alt, node.type); }
+auto fields(FunctionReturnType& node) { return std::tuple(node.type); }
+auto fields(StructStruct& node) { return std::tuple(node.identifier, node.struct_fields); }
+auto fields(StructFields& node) { return std::tuple(node.struct_fields); }
+auto fields(StructField& node) { return std::tuple(node.identifier, node.type); }
+auto fields(EnumVariants& node) { return std::tuple(node.enum_variant); }
+auto fields(EnumVariant& node) { return std::tuple(node.identifier); }
+auto fields(AssociatedItem& node) { return std::tuple(node.child); }
+auto fields(InherentImpl& node) { return std::tuple(node.type, node.associated_item); }
+auto fields(TraitImpl& node) { return std::tuple(node.identifier, node.type, node.associated_item); }
+auto fields(Statement& node) { return std::tuple(node.child); }
+auto fields(LetStatement& node) { return std::tuple(node.pattern_no_top_alt, node.type, node.expression); }
+auto fields(ExpressionStatement& node) { return std::tuple(node.child, node.has_semi); }
+auto fields(Statements& node) { return std::tuple(node.statements); }
+auto fields(CharLiteral& node) { return std::tuple(node.value); }
+auto fields(StringLiteral& node) { return std::tuple(node.value); }
+auto fields(RawStringLiteral& node) { return std::tuple(node.value); }
+auto fields(CStringLiteral& node) { return std::tuple(node.value); }
+auto fields(RawCStringLiteral& node) { return std::tuple(node.value); }
+auto fields(IntegerLiteral& node) {
+    return std::tuple(node.value, IntegerValue{node.number, node.radix, node.suffix});
+}
+auto fields(BoolLiteral& node) { return std::tuple(node.value); }
+auto fields(PathExpression& node) { return std::tuple(node.path_in_expression); }
+auto fields(UnaryExpression& node) { return std::tuple(node.type, node.expression); }
+auto fields(BorrowExpression& node) { return std::tuple(node.is_double, node.is_mutable, node.expression); }
+auto fields(DereferenceExpression& node) { return std::tuple(node.expression); }
+auto fields(GroupedExpression& node) { return std::tuple(node.expression); }
+auto fields(ArrayExpression& node) { return std::tuple(node.array_elements); }
+auto fields(IndexExpression& node) { return std::tuple(node.base_expression, node.index_expression); }
+auto fields(StructExpression& node) { return std::tuple(node.path_in_expression, node.struct_expr_fields); }
+auto fields(CallExpression& node) { return std::tuple(node.expression, node.call_params); }
+auto fields(MethodCallExpression& node) {
+    return std::tuple(node.expression, node.path_ident_segment, node.call_params);
+}
+auto fields(FieldExpression& node) { return std::tuple(node.expression, node.identifier); }
+auto fields(ContinueExpression&) { return std::tuple<>(); }
+auto fields(BreakExpression& node) { return std::tuple(node.expression); }
+auto fields(ReturnExpression& node) { return std::tuple(node.expression); }
+auto fields(BlockExpression& node) { return std::tuple(node.statements); }
+auto fields(LoopExpression& node) { return std::tuple(node.child); }
+auto fields(InfiniteLoopExpression& node) { return std::tuple(node.block_expression); }
+auto fields(PredicateLoopExpression& node) { return std::tuple(node.condition, node.block_expression); }
+auto fields(Condition& node) { return std::tuple(node.expression); }
+auto fields(IfExpression& node) { return std::tuple(node.condition, node.then_block, node.else_branch); }
+auto fields(AssignmentExpression& node) { return std::tuple(node.lhs, node.rhs); }
+auto fields(CompoundAssignmentExpression& node) { return std::tuple(node.type, node.lhs, node.rhs); }
+auto fields(BinaryExpression& node) { return std::tuple(node.binary_type, node.lhs, node.rhs); }
+auto fields(TypeCastExpression& node) { return std::tuple(node.expression, node.type); }
+auto fields(PatternNoTopAlt& node) { return std::tuple(node.child); }
+auto fields(IdentifierPattern& node) { return std::tuple(node.is_ref, node.is_mutable, node.identifier); }
+auto fields(ReferencePattern& node) { return std::tuple(node.is_double, node.is_mutable, node.pattern); }
+auto fields(Type& node) { return std::tuple(node.child); }
+auto fields(ReferenceType& node) { return std::tuple(node.is_mutable, node.type); }
+auto fields(ArrayType& node) { return std::tuple(node.type, node.expression); }
+auto fields(UnitType&) { return std::tuple<>(); }
+auto fields(PathInExpression& node) { return std::tuple(node.segment1, node.segment2); }
+auto fields(ArrayElements& node) { return std::tuple(node.expressions, node.is_semicolon_separated); }
+auto fields(StructExprFields& node) { return std::tuple(node.struct_expr_fields); }
+auto fields(StructExprField& node) { return std::tuple(node.identifier, node.expression); }
+auto fields(CallParams& node) { return std::tuple(node.expressions); }
+auto fields(PathIdentSegment& node) { return std::tuple(node.path_type, node.identifier); }
+auto fields(ErrorNode& node) { return std::tuple(node.message); }
+
+// One past the largest value of each enum stored in a node, for validation on load
+template <typename E> constexpr uint32_t enumEnd();
+template <> constexpr uint32_t enumEnd<UnaryExpression::UnaryType>() { return UnaryExpression::TRY + 1; }
+template <> constexpr uint32_t enumEnd<CompoundAssignmentExpression::CompoundAssignmentType>() {
+    return CompoundAssignmentExpression::SHR_EQ + 1;
+}
+template <> constexpr uint32_t enumEnd<BinaryExpression::BinaryType>() { return BinaryExpression::OR_OR + 1; }
+
+template <typename T> struct IsVector : std::false_type {};
+template <typename T> struct IsVector<std::vector<T>> : std::true_type {};
+
+template <typename T>
+void append(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+// Emits every node reachable from the crate, children first, walking on an explicit
+// stack so that deep trees do not exhaust the native one
+class Writer : public ASTWalker<Writer> {
+private:
+    std::string records;
+    uint32_t record_count = 0;
+    std::deque<std::string> storage;
+    std::vector<std::string_view> strings;
+    std::unordered_map<std::string_view, uint32_t> string_index;
+    std::vector<std::pair<ASTNode*, bool>> pending; // node, children already pushed
+    bool emitting = false;
+
+    uint32_t name_count = 0;
+    uint32_t literal_count = 0;
+
+    // The text is copied: put() gets copies of the fields, which die with the tuple
+    uint32_t string(std::string_view text) {
+        if (auto it = string_index.find(text); it != string_index.end()) return it->second;
+        std::string_view stored = storage.emplace_back(text);
+        strings.push_back(stored);
+        string_index.emplace(stored, uint32_t(strings.size() - 1));
+        return uint32_t(strings.size() - 1);
+    }
+
+    template <typename T>
+    void put(const T& value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            append<uint8_t>(records, value);
+        } else if constexpr (std::is_same_v<T, int> || std::is_enum_v<T>) {
+            append<uint32_t>(records, uint32_t(value));
+        } else if constexpr (std::is_same_v<T, IntegerValue>) {
+            append<uint64_t>(records, value.value);
+            append<uint8_t>(records, value.radix);
+            append<uint8_t>(records, uint8_t(value.suffix));
+        } else if constexpr (std::is_same_v<T, Name>) {
+            append<uint32_t>(records, value.getId());
+        } else if constexpr (std::is_same_v<T, LiteralId>) {
+            append<uint32_t>(records, name_count + value.getId());
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            append<uint32_t>(records, string(value));
+        } else if constexpr (std::is_pointer_v<T>) {
+            append<uint32_t>(records, value ? uint32_t(value->id) : kNull);
+        } else {
+            static_assert(IsVector<T>::value, "no encoding for this field");
+            append<uint32_t>(records, uint32_t(value.size()));
+            for (const auto& element: value) put(element);
+        }
+    }
+public:
+    template <typename Node>
+    void visit(Node& node) {
+        if constexpr (!std::is_same_v<Node, Crate>) {
+            if (!emitting) {
+                size_t first = pending.size();
+                node.forEachChild([this](auto* child) {
+                    if (child) pending.emplace_back(child, false);
+                });
+                std::reverse(pending.begin() + first, pending.end());
+                return;
+            }
+            append<uint8_t>(records, uint8_t(node.kind));
+            append<uint32_t>(records, node.id);
+            std::apply([this](const auto&... values) { (put(values), ...); }, fields(node));
+            ++record_count;
+        }
+    }
+
+    std::string write(Crate& crate, std::string_view source) {
+        // Function bodies still to be parsed lazily intern new names, so parse them first
+        crate.parseLazyBodies();
+        auto& interner = Interner::global();
+        auto& pool = LiteralPool::global();
+        name_count = uint32_t(interner.size());
+        literal_count = uint32_t(pool.size());
+        for (uint32_t id = 0; id < name_count; ++id) strings.push_back(interner.str(id));
+        for (uint32_t id = 0; id < literal_count; ++id) strings.push_back(pool.str(id));
+
+        for (auto it = crate.items.rbegin(); it != crate.items.rend(); ++it) pending.emplace_back(*it, false);
+        while (!pending.empty()) {
+            auto [node, expanded] = pending.back();
+            if (expanded) pending.pop_back();
+            else pending.back().second = true;
+            emitting = expanded;
+            walk(node);
+        }
+
+        Header header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = ASTCache::kFormatVersion;
+        header.byte_order = kByteOrder;
+        header.name_count = name_count;
+        header.literal_count = literal_count;
+        header.string_count = uint32_t(strings.size());
+        header.record_count = record_count;
+        header.node_count = uint32_t(crate.node_count);
+        header.crate_id = crate.id;
+        header.item_count = uint32_t(crate.items.size());
+        header.source_size = source.size();
+        header.source_hash = hashBytes(source);
+        header.build_hash = hashBytes(kBuild);
+
+        std::string out;
+        size_t string_bytes = 0;
+        for (auto text: strings) string_bytes += sizeof(uint32_t) + text.size();
+        out.reserve(sizeof(Header) + string_bytes + records.size() + sizeof(uint32_t) * crate.items.size());
+        out.append(reinterpret_cast<const char*>(&header), sizeof(Header));
+        for (auto text: strings) {
+            append<uint32_t>(out, uint32_t(text.size()));
+            out.append(text);
+        }
+        out.append(records);
+        for (auto* item: crate.items) append<uint32_t>(out, item->id);
+        header.checksum = checksum(header, std::string_view(out).substr(sizeof(Header)));
+        std::memcpy(out.data(), &header, sizeof(Header));
+        return out;
+    }
+};
+
+class Reader {
+private:
+    std::string_view bytes;
+    size_t offset = 0;
+    std::vector<std::string_view> strings;
+    // Ids the names and literals at the start of the string table stand for in the nodes
+    std::vector<uint32_t> names;
+    std::vector<uint32_t> literals;
+    std::vector<ASTNode*> by_id;
+    std::unique_ptr<ASTArena> arena;
+
+    [[noreturn]] static void fail() { throw std::runtime_error("AST cache: corrupted data"); }
+
+    template <typename T>
+    T raw() {
+        if (bytes.size() - offset < sizeof(T)) fail();
+        T value;
+        std::memcpy(&value, bytes.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    uint32_t index(size_t begin, size_t end) {
+        uint32_t value = raw<uint32_t>();
+        if (value < begin || value >= end) fail();
+        return value - uint32_t(begin);
+    }
+
+    template <typename T>
+    T node() {
+        uint32_t id = raw<uint32_t>();
+        if (id == kNull) return nullptr;
+        // Children are always written before their parents
+        if (id >= by_id.size() || !by_id[id] || !std::remove_pointer_t<T>::classof(by_id[id])) fail();
+        return static_cast<T>(by_id[id]);
+    }
+
+    template <typename T>
+    T get() {
+        if constexpr (std::is_same_v<T, bool>) {
+            uint8_t value = raw<uint8_t>();
+            if (value > 1) fail();
+            return value;
+        } else if constexpr (std::is_same_v<T, int>) {
+            return int(raw<uint32_t>());
+        } else if constexpr (std::is_enum_v<T>) {
+            uint32_t value = raw<uint32_t>();
+            if (value >= enumEnd<T>()) fail();
+            return T(value);
+        } else if constexpr (std::is_same_v<T, IntegerValue>) {
+            IntegerValue value;
+            value.value = raw<uint64_t>();
+            value.radix = raw<uint8_t>();
+            uint8_t suffix = raw<uint8_t>();
+            if (suffix > uint8_t(IntegerSuffix::kUSize)) fail();
+            value.suffix = IntegerSuffix(suffix);
+            return value;
+        } else if constexpr (std::is_same_v<T, Name>) {
+            return Name::fromId(names[index(0, names.size())]);
+        } else if constexpr (std::is_same_v<T, LiteralId>) {
+            return LiteralId::fromId(literals[index(names.size(), names.size() + literals.size())]);
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            size_t first = names.size() + literals.size();
+            return std::string(strings[first + index(first, strings.size())]);
+        } else if constexpr (std::is_pointer_v<T>) {
+            return node<T>();
+        } else {
+            static_assert(IsVector<T>::value, "no decoding for this field");
+            uint32_t count = raw<uint32_t>();
+            if (count > (bytes.size() - offset) / sizeof(uint32_t)) fail();
+            T values;
+            values.reserve(count);
+            for (uint32_t i = 0; i < count; ++i) values.push_back(get<typename T::value_type>());
+            return values;
+        }
+    }
+
+    // Braced initialisation evaluates the fields left to right, in the order they were written
+    template <typename... T>
+    std::tuple<T...> getAll(std::tuple<T...>*) {
+        return std::tuple<T...>{get<T>()...};
+    }
+
+    template <typename Node>
+    void build(NodeId id) {
+        using Fields = decltype(fields(std::declval<Node&>()));
+        Node* node = std::apply([this](auto&&... values) { return arena->make<Node>(std::move(values)...); },
+                                getAll(static_cast<Fields*>(nullptr)));
+        node->id = id;
+        by_id[id] = node;
+    }
+
+    void record() {
+        auto kind = NodeKind(raw<uint8_t>());
+        NodeId id = raw<uint32_t>();
+        if (id >= by_id.size() || by_id[id]) fail();
+        switch (kind) {
+            case NodeKind::kItem: return build<Item>(id);
+            case NodeKind::kFunction: return build<Function>(id);
+            case NodeKind::kStruct: return build<Struct>(id);
+            case NodeKind::kEnumeration: return build<Enumeration>(id);
+            case NodeKind::kConstantItem: return build<ConstantItem>(id);
+            case NodeKind::kTrait: return build<Trait>(id);
+            case NodeKind::kImplementation: return build<Implementation>(id);
+            case NodeKind::kFunctionParameters: return build<FunctionParameters>(id);
+            case NodeKind::kSelfParam: return build<SelfParam>(id);
+            case NodeKind::kShorthandSelf: return build<ShorthandSelf>(id);
+            case NodeKind::kTypedSelf: return build<TypedSelf>(id);
+            case NodeKind::kFunctionParam: return build<FunctionParam>(id);
+            case NodeKind::kFunctionReturnType: return build<FunctionReturnType>(id);
+            case NodeKind::kStructStruct: return build<StructStruct>(id);
+            case NodeKind::kStructFields: return build<StructFields>(id);
+            case NodeKind::kStructField: return build<StructField>(id);
+            case NodeKind::kEnumVariants: return build<EnumVariants>(id);
+            case NodeKind::kEnumVariant: return build<EnumVariant>(id);
+            case NodeKind::kAssociatedItem: return build<AssociatedItem>(id);
+            case NodeKind::kInherentImpl: return build<InherentImpl>(id);
+            case NodeKind::kTraitImpl: return build<TraitImpl>(id);
+            case NodeKind::kStatement: return build<Statement>(id);
+            case NodeKind::kLetStatement: return build<LetStatement>(id);
+            case NodeKind::kExpressionStatement: return build<ExpressionStatement>(id);
+            case NodeKind::kStatements: return build<Statements>(id);
+            case NodeKind::kCharLiteral: return build<CharLiteral>(id);
+            case NodeKind::kStringLiteral: return build<StringLiteral>(id);
+            case NodeKind::kRawStringLiteral: return build<RawStringLiteral>(id);
+            case NodeKind::kCStringLiteral: return build<CStringLiteral>(id);
+            case NodeKind::kRawCStringLiteral: return build<RawCStringLiteral>(id);
+            case NodeKind::kIntegerLiteral: return build<IntegerLiteral>(id);
+            case NodeKind::kBoolLiteral: return build<BoolLiteral>(id);
+            case NodeKind::kPathExpression: return build<PathExpression>(id);
+            case NodeKind::kUnaryExpression: return build<UnaryExpression>(id);
+            case NodeKind::kBorrowExpression: return build<BorrowExpression>(id);
+            case NodeKind::kDereferenceExpression: return build<DereferenceExpression>(id);
+            case NodeKind::kGroupedExpression: return build<GroupedExpression>(id);
+            case NodeKind::kArrayExpression: return build<ArrayExpression>(id);
+            case NodeKind::kIndexExpression: return build<IndexExpression>(id);
+            case NodeKind::kStructExpression: return build<StructExpression>(id);
+            case NodeKind::kCallExpression: return build<CallExpression>(id);
+            case NodeKind::kMethodCallExpression: return build<MethodCallExpression>(id);
+            case NodeKind::kFieldExpression: return build<FieldExpression>(id);
+            case NodeKind::kContinueExpression: return build<ContinueExpression>(id);
+            case NodeKind::kBreakExpression: return build<BreakExpression>(id);
+            case NodeKind::kReturnExpression: return build<ReturnExpression>(id);
+            case NodeKind::kBlockExpression: return build<BlockExpression>(id);
+            case NodeKind::kLoopExpression: return build<LoopExpression>(id);
+            case NodeKind::kInfiniteLoopExpression: return build<InfiniteLoopExpression>(id);
+            case NodeKind::kPredicateLoopExpression: return build<PredicateLoopExpression>(id);
+            case NodeKind::kCondition: return build<Condition>(id);
+            case NodeKind::kIfExpression: return build<IfExpression>(id);
+            case NodeKind::kAssignmentExpression: return build<AssignmentExpression>(id);
+            case NodeKind::kCompoundAssignmentExpression: return build<CompoundAssignmentExpression>(id);
+            case NodeKind::kBinaryExpression: return build<BinaryExpression>(id);
+            case NodeKind::kTypeCastExpression: return build<TypeCastExpression>(id);
+            case NodeKind::kPatternNoTopAlt: return build<PatternNoTopAlt>(id);
+            case NodeKind::kIdentifierPattern: return build<IdentifierPattern>(id);
+            case NodeKind::kReferencePattern: return build<ReferencePattern>(id);
+            case NodeKind::kType: return build<Type>(id);
+            case NodeKind::kReferenceType: return build<ReferenceType>(id);
+            case NodeKind::kArrayType: return build<ArrayType>(id);
+            case NodeKind::kUnitType: return build<UnitType>(id);
+            case NodeKind::kPathInExpression: return build<PathInExpression>(id);
+            case NodeKind::kArrayElements: return build<ArrayElements>(id);
+            case NodeKind::kStructExprFields: return build<StructExprFields>(id);
+            case NodeKind::kStructExprField: return build<StructExprField>(id);
+            case NodeKind::kCallParams: return build<CallParams>(id);
+            case NodeKind::kPathIdentSegment: return build<PathIdentSegment>(id);
+            case NodeKind::kErrorNode: return build<ErrorNode>(id);
+            default: fail();
+        }
+    }
+
+    // Decodes the records and the crate's items that follow the string table
+    std::shared_ptr<Crate> decode(const Header& header) {
+        arena = std::make_unique<ASTArena>();
+        by_id.assign(header.node_count, nullptr);
+        for (uint32_t i = 0; i < header.record_count; ++i) record();
+        if (by_id[header.crate_id]) fail();
+
+        std::vector<Item*> items;
+        items.reserve(std::min<size_t>(header.item_count, (bytes.size() - offset) / sizeof(uint32_t)));
+        for (uint32_t i = 0; i < header.item_count; ++i) {
+            auto* item = node<Item*>();
+            if (!item) fail();
+            items.push_back(item);
+        }
+        if (offset != bytes.size()) fail();
+
+        auto crate = std::make_shared<Crate>(std::move(items), std::move(arena));
+        crate->id = header.crate_id;
+        crate->node_count = header.node_count;
+        return crate;
+    }
+public:
+    explicit Reader(std::string_view bytes) : bytes(bytes) {}
+
+    std::shared_ptr<Crate> read(std::string_view source) {
+        auto header = raw<Header>();
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.byte_order != kByteOrder) fail();
+        if (header.version != ASTCache::kFormatVersion) {
+            throw std::runtime_error("AST cache: format version " + std::to_string(header.version)
+                                     + ", expected " + std::to_string(ASTCache::kFormatVersion));
+        }
+        if (header.build_hash != hashBytes(kBuild)) {
+            throw std::runtime_error("AST cache: written by a different build");
+        }
+        if (header.source_size != source.size() || header.source_hash != hashBytes(source)) {
+            throw std::runtime_error("AST cache: written for a different source");
+        }
+        // A damaged file may still decode into a well-formed tree, so it is rejected by its
+        // checksum before any of it is decoded
+        if (header.checksum != checksum(header, bytes.substr(sizeof(Header)))) fail();
+        // Every string and record takes at least four bytes and ids are dense, which bounds
+        // the allocations below
+        if (header.string_count > bytes.size() / 4 || header.record_count > bytes.size() / 4
+            || uint64_t(header.name_count) + header.literal_count > header.string_count
+            || header.node_count > bytes.size() || header.record_count >= header.node_count
+            || header.crate_id >= header.node_count) {
+            fail();
+        }
+
+        strings.reserve(header.string_count);
+        for (uint32_t i = 0; i < header.string_count; ++i) {
+            uint32_t length = raw<uint32_t>();
+            if (bytes.size() - offset < length) fail();
+            strings.push_back(bytes.substr(offset, length));
+            offset += length;
+        }
+        size_t nodes = offset;
+
+        // Nothing is interned until the whole file has been decoded, so a file that turns out
+        // to be broken leaves the interner and the literal pool untouched. The first pass
+        // takes the ids the strings had when the file was written; interning them in order
+        // normally hands out the very same ids, otherwise the nodes are decoded again
+        names.resize(header.name_count);
+        std::iota(names.begin(), names.end(), 0);
+        literals.resize(header.literal_count);
+        std::iota(literals.begin(), literals.end(), 0);
+        auto crate = decode(header);
+
+        std::vector<uint32_t> interned_names, interned_literals;
+        interned_names.reserve(header.name_count);
+        for (uint32_t i = 0; i < header.name_count; ++i) interned_names.push_back(Name(strings[i]).getId());
+        interned_literals.reserve(header.literal_count);
+        for (uint32_t i = 0; i < header.literal_count; ++i) {
+            interned_literals.push_back(LiteralId(strings[header.name_count + i]).getId());
+        }
+        if (interned_names != names || interned_literals != literals) {
+            names = std::move(interned_names);
+            literals = std::move(interned_literals);
+            offset = nodes;
+            crate = decode(header);
+        }
+        return crate;
+    }
+
+};
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+std::string serializeCrate(Crate& crate, std::string_view source) {
+    return Writer().write(crate, source);
+}
+
+std::shared_ptr<Crate> deserializeCrate(std::string_view bytes, std::string_view source) {
+    return Reader(bytes).read(source);
+}
+
+ASTCache::ASTCache(std::filesystem::path directory) : directory(std::move(directory)) {}
+
+std::filesystem::path ASTCache::pathFor(std::string_view source) const {
+    // The format version and the build are part of the key, so a newer compiler never even
+    // opens older files
+    static const uint64_t seed = hashBytes(kBuild, hashBytes("RCompiler AST v" + std::to_string(kFormatVersion)));
+    static const char digits[] = "0123456789abcdef";
+    uint64_t hash = hashBytes(source, seed);
+    std::string name(16, '0');
+    for (int i = 15; i >= 0; --i, hash >>= 4) name[i] = digits[hash & 15];
+    return directory / (name + ".ast");
+}
+
+std::shared_ptr<Crate> ASTCache::load(std::string_view source) {
+    auto start = std::chrono::steady_clock::now();
+    auto path = pathFor(source);
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        ++statistics.misses;
+        return nullptr;
+    }
+    try {
+        SourceFile file = SourceFile::open(path.string());
+        auto crate = deserializeCrate(file.view(), source);
+        ++statistics.hits;
+        statistics.bytes_loaded += file.size();
+        statistics.load_ms += millisecondsSince(start);
+        return crate;
+    } catch (const std::runtime_error&) {
+        ++statistics.misses;
+        ++statistics.invalid;
+        return nullptr;
+    }
+}
+
+void ASTCache::store(std::string_view source, Crate& crate) {
+    auto start = std::chrono::steady_clock::now();
+    std::string bytes = serializeCrate(crate, source);
+    auto path = pathFor(source);
+    auto temporary = path;
+    temporary += "." + std::to_string(getpid()) + ".tmp";
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), std::streamsize(bytes.size()));
+        if (!file) {
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return;
+    }
+    ++statistics.stores;
+    statistics.bytes_stored += bytes.size();
+    statistics.store_ms += millisecondsSince(start);
+}
+
+void ASTCache::printStats(std::ostream& output) const {
+    output << "AST cache: " << statistics.hits << " hits, " << statistics.misses << " misses ("
+           << statistics.invalid << " unusable), " << statistics.stores << " stores; loaded "
+           << statistics.bytes_loaded << " bytes in " << statistics.load_ms << " ms, stored "
+           << statistics.bytes_stored << " bytes in " << statistics.store_ms << " ms" << std::endl;
+}
@@ -1 +1,19 @@
 #include "parser/astnode.hpp"
+#include "parser/parser.hpp"
+
+Crate::Crate(std::vector<Item*>&& items, std::unique_ptr<ASTArena> arena)
+    : ASTNode(NodeKind::kCrate), items(std::move(items)), arena(std::move(arena)) {}
+
+Crate::~Crate() = default;
+
+void Crate::parseLazyBodies() {
+    if (lazy_parser) lazy_parser->parseLazyBodies();
+}
+
+BlockExpression* Function::body() {
+    if (lazy_parser) {
+        block_expression = lazy_parser->parseLazyBody(*this);
+        lazy_parser = nullptr;
+    }
+    return block_expression;
+}
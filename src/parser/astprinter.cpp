@@ -1,7 +1,38 @@
 #include "parser/astprinter.hpp"
 #include "parser/astnode.hpp"
+#include <cstdio>
 #include <iostream>
 
+namespace {
+
+// 字面量池中存放的是解码后的内容，打印时重新转义不可见字符、反斜杠与引号
+std::string escapeLiteral(const std::string& text, char quote) {
+    std::string res;
+    for (unsigned char c: text) {
+        switch (c) {
+            case '\n': res += "\\n"; break;
+            case '\r': res += "\\r"; break;
+            case '\t': res += "\\t"; break;
+            case '\0': res += "\\0"; break;
+            case '\\': res += "\\\\"; break;
+            default:
+                if (c == quote) {
+                    res += '\\';
+                    res += c;
+                } else if (c < 0x20 || c == 0x7f) {
+                    char buf[5];
+                    std::snprintf(buf, sizeof(buf), "\\x%02x", c);
+                    res += buf;
+                } else {
+                    res += c;
+                }
+        }
+    }
+    return res;
+}
+
+} // namespace
+
 ASTPrinter::ASTPrinter(std::ostream& output, bool use_colors)
     : output(output), indent_level(0), use_colors(use_colors) {}
 
@@ -42,7 +73,7 @@ void ASTPrinter::visit(Crate& node) {
     indent_level++;
     for (const auto& item : node.items) {
         if (item) {
-            item->accept(this);
+            walk(item);
         }
     }
     indent_level--;
@@ -52,7 +83,7 @@ void ASTPrinter::visit(Item& node) {
     print_with_indent(get_color_code("cyan") + "Item" + reset_color() + "\n");
     indent_level++;
     if (node.item) {
-        node.item->accept(this);
+        walk(node.item);
     }
     indent_level--;
 }
@@ -66,13 +97,13 @@ void ASTPrinter::visit(Function& node) {
     output << " " << get_color_code("white") << node.identifier << reset_color() << "\n";
     indent_level++;
     if (node.function_parameters) {
-        node.function_parameters->accept(this);
+        walk(node.function_parameters);
     }
     if (node.function_return_type) {
-        node.function_return_type->accept(this);
+        walk(node.function_return_type);
     }
-    if (node.block_expression) {
-        node.block_expression->accept(this);
+    if (node.body()) {
+        walk(node.body());
     }
     indent_level--;
 }
@@ -81,7 +112,7 @@ void ASTPrinter::visit(Struct& node) {
     print_with_indent(get_color_code("green") + "Struct" + reset_color() + "\n");
     indent_level++;
     if (node.struct_struct) {
-        node.struct_struct->accept(this);
+        walk(node.struct_struct);
     }
     indent_level--;
 }
@@ -91,7 +122,7 @@ void ASTPrinter::visit(Enumeration& node) {
     output << " " << get_color_code("white") << node.identifier << reset_color() << "\n";
     indent_level++;
     if (node.enum_variants) {
-        node.enum_variants->accept(this);
+        walk(node.enum_variants);
     }
     indent_level--;
 }
@@ -101,10 +132,10 @@ void ASTPrinter::visit(ConstantItem& node) {
     output << " " << get_color_code("white") << node.identifier << reset_color() << "\n";
     indent_level++;
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     indent_level--;
 }
@@ -115,7 +146,7 @@ void ASTPrinter::visit(Trait& node) {
     indent_level++;
     for (const auto& item : node.associated_item) {
         if (item) {
-            item->accept(this);
+            walk(item);
         }
     }
     indent_level--;
@@ -125,7 +156,7 @@ void ASTPrinter::visit(Implementation& node) {
     print_with_indent(get_color_code("green") + "Implementation" + reset_color() + "\n");
     indent_level++;
     if (node.impl) {
-        node.impl->accept(this);
+        walk(node.impl);
     }
     indent_level--;
 }
@@ -135,11 +166,11 @@ void ASTPrinter::visit(FunctionParameters& node) {
     print_with_indent(get_color_code("magenta") + "FunctionParameters" + reset_color() + "\n");
     indent_level++;
     if (node.self_param) {
-        node.self_param->accept(this);
+        walk(node.self_param);
     }
     for (const auto& param : node.function_param) {
         if (param) {
-            param->accept(this);
+            walk(param);
         }
     }
     indent_level--;
@@ -149,7 +180,7 @@ void ASTPrinter::visit(SelfParam& node) {
     print_with_indent(get_color_code("magenta") + "SelfParam" + reset_color() + "\n");
     indent_level++;
     if (node.child) {
-        node.child->accept(this);
+        walk(node.child);
     }
     indent_level--;
 }
@@ -173,7 +204,7 @@ void ASTPrinter::visit(TypedSelf& node) {
     output << " " << get_color_code("white") << "self" << reset_color() << "\n";
     indent_level++;
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     indent_level--;
 }
@@ -182,10 +213,10 @@ void ASTPrinter::visit(FunctionParam& node) {
     print_with_indent(get_color_code("magenta") + "FunctionParam" + reset_color() + "\n");
     indent_level++;
     if (node.pattern_no_top_alt) {
-        node.pattern_no_top_alt->accept(this);
+        walk(node.pattern_no_top_alt);
     }
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     indent_level--;
 }
@@ -194,7 +225,7 @@ void ASTPrinter::visit(FunctionReturnType& node) {
     print_with_indent(get_color_code("magenta") + "FunctionReturnType" + reset_color() + "\n");
     indent_level++;
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     indent_level--;
 }
@@ -205,7 +236,7 @@ void ASTPrinter::visit(StructStruct& node) {
     output << " " << get_color_code("white") << node.identifier << reset_color() << "\n";
     indent_level++;
     if (node.struct_fields) {
-        node.struct_fields->accept(this);
+        walk(node.struct_fields);
     }
     indent_level--;
 }
@@ -215,7 +246,7 @@ void ASTPrinter::visit(StructFields& node) {
     indent_level++;
     for (const auto& field : node.struct_fields) {
         if (field) {
-            field->accept(this);
+            walk(field);
         }
     }
     indent_level--;
@@ -226,7 +257,7 @@ void ASTPrinter::visit(StructField& node) {
     output << " " << get_color_code("white") << node.identifier << reset_color() << "\n";
     indent_level++;
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     indent_level--;
 }
@@ -237,7 +268,7 @@ void ASTPrinter::visit(EnumVariants& node) {
     indent_level++;
     for (const auto& variant : node.enum_variant) {
         if (variant) {
-            variant->accept(this);
+            walk(variant);
         }
     }
     indent_level--;
@@ -253,7 +284,7 @@ void ASTPrinter::visit(AssociatedItem& node) {
     print_with_indent(get_color_code("cyan") + "AssociatedItem" + reset_color() + "\n");
     indent_level++;
     if (node.child) {
-        node.child->accept(this);
+        walk(node.child);
     }
     indent_level--;
 }
@@ -262,11 +293,11 @@ void ASTPrinter::visit(InherentImpl& node) {
     print_with_indent(get_color_code("cyan") + "InherentImpl" + reset_color() + "\n");
     indent_level++;
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     for (const auto& item : node.associated_item) {
         if (item) {
-            item->accept(this);
+            walk(item);
         }
     }
     indent_level--;
@@ -277,11 +308,11 @@ void ASTPrinter::visit(TraitImpl& node) {
     output << " " << get_color_code("white") << node.identifier << reset_color() << "\n";
     indent_level++;
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     for (const auto& item : node.associated_item) {
         if (item) {
-            item->accept(this);
+            walk(item);
         }
     }
     indent_level--;
@@ -292,7 +323,7 @@ void ASTPrinter::visit(Statement& node) {
     print_with_indent(get_color_code("yellow") + "Statement" + reset_color() + "\n");
     indent_level++;
     if (node.child) {
-        node.child->accept(this);
+        walk(node.child);
     }
     indent_level--;
 }
@@ -301,13 +332,13 @@ void ASTPrinter::visit(LetStatement& node) {
     print_with_indent(get_color_code("yellow") + "LetStatement" + reset_color() + "\n");
     indent_level++;
     if (node.pattern_no_top_alt) {
-        node.pattern_no_top_alt->accept(this);
+        walk(node.pattern_no_top_alt);
     }
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     indent_level--;
 }
@@ -320,7 +351,7 @@ void ASTPrinter::visit(ExpressionStatement& node) {
     output << "\n";
     indent_level++;
     if (node.child) {
-        node.child->accept(this);
+        walk(node.child);
     }
     indent_level--;
 }
@@ -330,64 +361,36 @@ void ASTPrinter::visit(Statements& node) {
     indent_level++;
     for (const auto& stmt : node.statements) {
         if (stmt) {
-            stmt->accept(this);
+            walk(stmt);
         }
     }
     indent_level--;
 }
 
-// 表达式类节点
-void ASTPrinter::visit(Expression& node) {
-    print_with_indent(get_color_code("red") + "Expression" + reset_color() + "\n");
-    indent_level++;
-    if (node.child) {
-        node.child->accept(this);
-    }
-    indent_level--;
-}
-
-void ASTPrinter::visit(ExpressionWithoutBlock& node) {
-    print_with_indent(get_color_code("red") + "ExpressionWithoutBlock" + reset_color() + "\n");
-    indent_level++;
-    if (node.child) {
-        node.child->accept(this);
-    }
-    indent_level--;
-}
-
-void ASTPrinter::visit(ExpressionWithBlock& node) {
-    print_with_indent(get_color_code("red") + "ExpressionWithBlock" + reset_color() + "\n");
-    indent_level++;
-    if (node.child) {
-        node.child->accept(this);
-    }
-    indent_level--;
-}
-
 // 字面量表达式
 void ASTPrinter::visit(CharLiteral& node) {
     print_with_indent(get_color_code("green") + "CharLiteral" + reset_color());
-    output << " " << get_color_code("white") << "'" << node.value << "'" << reset_color() << "\n";
+    output << " " << get_color_code("white") << "'" << escapeLiteral(node.value.str(), '\'') << "'" << reset_color() << "\n";
 }
 
 void ASTPrinter::visit(StringLiteral& node) {
     print_with_indent(get_color_code("green") + "StringLiteral" + reset_color());
-    output << " " << get_color_code("white") << "\"" << node.value << "\"" << reset_color() << "\n";
+    output << " " << get_color_code("white") << "\"" << escapeLiteral(node.value.str(), '"') << "\"" << reset_color() << "\n";
 }
 
 void ASTPrinter::visit(RawStringLiteral& node) {
     print_with_indent(get_color_code("green") + "RawStringLiteral" + reset_color());
-    output << " " << get_color_code("white") << "r\"" << node.value << "\"" << reset_color() << "\n";
+    output << " " << get_color_code("white") << "r\"" << escapeLiteral(node.value.str(), '"') << "\"" << reset_color() << "\n";
 }
 
 void ASTPrinter::visit(CStringLiteral& node) {
     print_with_indent(get_color_code("green") + "CStringLiteral" + reset_color());
-    output << " " << get_color_code("white") << "c\"" << node.value << "\"" << reset_color() << "\n";
+    output << " " << get_color_code("white") << "c\"" << escapeLiteral(node.value.str(), '"') << "\"" << reset_color() << "\n";
 }
 
 void ASTPrinter::visit(RawCStringLiteral& node) {
     print_with_indent(get_color_code("green") + "RawCStringLiteral" + reset_color());
-    output << " " << get_color_code("white") << "cr\"" << node.value << "\"" << reset_color() << "\n";
+    output << " " << get_color_code("white") << "cr\"" << escapeLiteral(node.value.str(), '"') << "\"" << reset_color() << "\n";
 }
 
 void ASTPrinter::visit(IntegerLiteral& node) {
@@ -405,7 +408,7 @@ void ASTPrinter::visit(PathExpression& node) {
     print_with_indent(get_color_code("cyan") + "PathExpression" + reset_color() + "\n");
     indent_level++;
     if (node.path_in_expression) {
-        node.path_in_expression->accept(this);
+        walk(node.path_in_expression);
     }
     indent_level--;
 }
@@ -415,7 +418,7 @@ void ASTPrinter::visit(FieldExpression& node) {
     output << " ." << get_color_code("white") << node.identifier << reset_color() << "\n";
     indent_level++;
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     indent_level--;
 }
@@ -432,7 +435,7 @@ void ASTPrinter::visit(UnaryExpression& node) {
     output << " " << get_color_code("yellow") << op << reset_color() << "\n";
     indent_level++;
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     indent_level--;
 }
@@ -446,7 +449,7 @@ void ASTPrinter::visit(BorrowExpression& node) {
     output << reset_color() << "\n";
     indent_level++;
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     indent_level--;
 }
@@ -456,7 +459,7 @@ void ASTPrinter::visit(DereferenceExpression& node) {
     output << " " << get_color_code("yellow") << "*" << reset_color() << "\n";
     indent_level++;
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     indent_level--;
 }
@@ -487,10 +490,10 @@ void ASTPrinter::visit(BinaryExpression& node) {
     output << " " << get_color_code("yellow") << op << reset_color() << "\n";
     indent_level++;
     if (node.lhs) {
-        node.lhs->accept(this);
+        walk(node.lhs);
     }
     if (node.rhs) {
-        node.rhs->accept(this);
+        walk(node.rhs);
     }
     indent_level--;
 }
@@ -500,10 +503,10 @@ void ASTPrinter::visit(AssignmentExpression& node) {
     output << " " << get_color_code("yellow") << "=" << reset_color() << "\n";
     indent_level++;
     if (node.lhs) {
-        node.lhs->accept(this);
+        walk(node.lhs);
     }
     if (node.rhs) {
-        node.rhs->accept(this);
+        walk(node.rhs);
     }
     indent_level--;
 }
@@ -526,10 +529,10 @@ void ASTPrinter::visit(CompoundAssignmentExpression& node) {
     output << " " << get_color_code("yellow") << op << reset_color() << "\n";
     indent_level++;
     if (node.lhs) {
-        node.lhs->accept(this);
+        walk(node.lhs);
     }
     if (node.rhs) {
-        node.rhs->accept(this);
+        walk(node.rhs);
     }
     indent_level--;
 }
@@ -539,10 +542,10 @@ void ASTPrinter::visit(TypeCastExpression& node) {
     output << " " << get_color_code("yellow") << "as" << reset_color() << "\n";
     indent_level++;
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     indent_level--;
 }
@@ -552,10 +555,10 @@ void ASTPrinter::visit(CallExpression& node) {
     print_with_indent(get_color_code("cyan") + "CallExpression" + reset_color() + "\n");
     indent_level++;
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     if (node.call_params) {
-        node.call_params->accept(this);
+        walk(node.call_params);
     }
     indent_level--;
 }
@@ -564,13 +567,13 @@ void ASTPrinter::visit(MethodCallExpression& node) {
     print_with_indent(get_color_code("cyan") + "MethodCallExpression" + reset_color() + "\n");
     indent_level++;
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     if (node.path_ident_segment) {
-        node.path_ident_segment->accept(this);
+        walk(node.path_ident_segment);
     }
     if (node.call_params) {
-        node.call_params->accept(this);
+        walk(node.call_params);
     }
     indent_level--;
 }
@@ -579,10 +582,10 @@ void ASTPrinter::visit(IndexExpression& node) {
     print_with_indent(get_color_code("cyan") + "IndexExpression" + reset_color() + "\n");
     indent_level++;
     if (node.base_expression) {
-        node.base_expression->accept(this);
+        walk(node.base_expression);
     }
     if (node.index_expression) {
-        node.index_expression->accept(this);
+        walk(node.index_expression);
     }
     indent_level--;
 }
@@ -592,10 +595,10 @@ void ASTPrinter::visit(StructExpression& node) {
     print_with_indent(get_color_code("cyan") + "StructExpression" + reset_color() + "\n");
     indent_level++;
     if (node.path_in_expression) {
-        node.path_in_expression->accept(this);
+        walk(node.path_in_expression);
     }
     if (node.struct_expr_fields) {
-        node.struct_expr_fields->accept(this);
+        walk(node.struct_expr_fields);
     }
     indent_level--;
 }
@@ -604,7 +607,7 @@ void ASTPrinter::visit(ArrayExpression& node) {
     print_with_indent(get_color_code("cyan") + "ArrayExpression" + reset_color() + "\n");
     indent_level++;
     if (node.array_elements) {
-        node.array_elements->accept(this);
+        walk(node.array_elements);
     }
     indent_level--;
 }
@@ -613,7 +616,7 @@ void ASTPrinter::visit(GroupedExpression& node) {
     print_with_indent(get_color_code("cyan") + "GroupedExpression" + reset_color() + "\n");
     indent_level++;
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     indent_level--;
 }
@@ -623,7 +626,7 @@ void ASTPrinter::visit(BlockExpression& node) {
     print_with_indent(get_color_code("yellow") + "BlockExpression" + reset_color() + "\n");
     indent_level++;
     if (node.statements) {
-        node.statements->accept(this);
+        walk(node.statements);
     }
     indent_level--;
 }
@@ -632,13 +635,13 @@ void ASTPrinter::visit(IfExpression& node) {
     print_with_indent(get_color_code("yellow") + "IfExpression" + reset_color() + "\n");
     indent_level++;
     if (node.condition) {
-        node.condition->accept(this);
+        walk(node.condition);
     }
     if (node.then_block) {
-        node.then_block->accept(this);
+        walk(node.then_block);
     }
     if (node.else_branch) {
-        node.else_branch->accept(this);
+        walk(node.else_branch);
     }
     indent_level--;
 }
@@ -647,7 +650,7 @@ void ASTPrinter::visit(LoopExpression& node) {
     print_with_indent(get_color_code("yellow") + "LoopExpression" + reset_color() + "\n");
     indent_level++;
     if (node.child) {
-        node.child->accept(this);
+        walk(node.child);
     }
     indent_level--;
 }
@@ -656,7 +659,7 @@ void ASTPrinter::visit(InfiniteLoopExpression& node) {
     print_with_indent(get_color_code("yellow") + "InfiniteLoopExpression" + reset_color() + "\n");
     indent_level++;
     if (node.block_expression) {
-        node.block_expression->accept(this);
+        walk(node.block_expression);
     }
     indent_level--;
 }
@@ -665,10 +668,10 @@ void ASTPrinter::visit(PredicateLoopExpression& node) {
     print_with_indent(get_color_code("yellow") + "PredicateLoopExpression" + reset_color() + "\n");
     indent_level++;
     if (node.condition) {
-        node.condition->accept(this);
+        walk(node.condition);
     }
     if (node.block_expression) {
-        node.block_expression->accept(this);
+        walk(node.block_expression);
     }
     indent_level--;
 }
@@ -677,7 +680,7 @@ void ASTPrinter::visit(BreakExpression& node) {
     print_with_indent(get_color_code("yellow") + "BreakExpression" + reset_color() + "\n");
     indent_level++;
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     indent_level--;
 }
@@ -690,7 +693,7 @@ void ASTPrinter::visit(ReturnExpression& node) {
     print_with_indent(get_color_code("yellow") + "ReturnExpression" + reset_color() + "\n");
     indent_level++;
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     indent_level--;
 }
@@ -700,7 +703,7 @@ void ASTPrinter::visit(Condition& node) {
     print_with_indent(get_color_code("cyan") + "Condition" + reset_color() + "\n");
     indent_level++;
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     indent_level--;
 }
@@ -714,7 +717,7 @@ void ASTPrinter::visit(ArrayElements& node) {
     indent_level++;
     for (const auto& expr : node.expressions) {
         if (expr) {
-            expr->accept(this);
+            walk(expr);
         }
     }
     indent_level--;
@@ -725,7 +728,7 @@ void ASTPrinter::visit(StructExprFields& node) {
     indent_level++;
     for (const auto& field : node.struct_expr_fields) {
         if (field) {
-            field->accept(this);
+            walk(field);
         }
     }
     indent_level--;
@@ -736,7 +739,7 @@ void ASTPrinter::visit(StructExprField& node) {
     output << " " << get_color_code("white") << node.identifier << reset_color() << "\n";
     indent_level++;
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     indent_level--;
 }
@@ -746,7 +749,7 @@ void ASTPrinter::visit(CallParams& node) {
     indent_level++;
     for (const auto& expr : node.expressions) {
         if (expr) {
-            expr->accept(this);
+            walk(expr);
         }
     }
     indent_level--;
@@ -757,7 +760,7 @@ void ASTPrinter::visit(PatternNoTopAlt& node) {
     print_with_indent(get_color_code("blue") + "PatternNoTopAlt" + reset_color() + "\n");
     indent_level++;
     if (node.child) {
-        node.child->accept(this);
+        walk(node.child);
     }
     indent_level--;
 }
@@ -782,7 +785,7 @@ void ASTPrinter::visit(ReferencePattern& node) {
     output << reset_color() << "\n";
     indent_level++;
     if (node.pattern) {
-        node.pattern->accept(this);
+        walk(node.pattern);
     }
     indent_level--;
 }
@@ -792,7 +795,7 @@ void ASTPrinter::visit(Type& node) {
     print_with_indent(get_color_code("magenta") + "Type" + reset_color() + "\n");
     indent_level++;
     if (node.child) {
-        node.child->accept(this);
+        walk(node.child);
     }
     indent_level--;
 }
@@ -804,7 +807,7 @@ void ASTPrinter::visit(ReferenceType& node) {
     output << reset_color() << "\n";
     indent_level++;
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     indent_level--;
 }
@@ -813,10 +816,10 @@ void ASTPrinter::visit(ArrayType& node) {
     print_with_indent(get_color_code("magenta") + "ArrayType" + reset_color() + "\n");
     indent_level++;
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     indent_level--;
 }
@@ -830,10 +833,10 @@ void ASTPrinter::visit(PathInExpression& node) {
     print_with_indent(get_color_code("cyan") + "PathInExpression" + reset_color() + "\n");
     indent_level++;
     if (node.segment1) {
-        node.segment1->accept(this);
+        walk(node.segment1);
     }
     if (node.segment2) {
-        node.segment2->accept(this);
+        walk(node.segment2);
     }
     indent_level--;
 }
@@ -847,4 +850,9 @@ void ASTPrinter::visit(PathIdentSegment& node) {
         case 2: output << "Self"; break;
     }
     output << reset_color() << "\n";
-}
\ No newline at end of file
+}
+
+void ASTPrinter::visit(ErrorNode& node) {
+    print_with_indent(get_color_code("red") + "ErrorNode" + reset_color());
+    output << " " << node.message << "\n";
+}
@@ -1,13 +1,53 @@
 #include "parser/parser.hpp"
-
-Token Parser::peek() {
-    if (pos < tokens.size()) return tokens[pos].first;
-    else return Token::kEOF;
+#include <algorithm>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include "parser/walker.hpp"
+
+Parser::Parser(std::shared_ptr<const SourceBuffer> source, size_t window)
+    : tokens(source), pipe(std::make_unique<TokenPipe>(source, kRingCapacity)), window(window), incoming(1024) {}
+
+size_t Parser::fetch(size_t index) {
+    if (!pipe) return npos;
+    if (index < base) {
+        throw std::runtime_error("parse failed! Backtracking beyond the token window of " + std::to_string(window) + " tokens");
+    }
+    // Drop tokens that are more than `window` behind the current position
+    if (pos >= base + 2 * window) {
+        size_t drop = pos - window - base;
+        tokens.discardFront(drop);
+        base += drop;
+    }
+    while (index - base >= tokens.size() && !finished) {
+        size_t from = tokens.size();
+        size_t count = pipe->read(incoming.data(), incoming.size());
+        for (size_t i = 0; i < count; ++i) {
+            tokens.push(incoming[i].kind, incoming[i].offset, incoming[i].length);
+            if (incoming[i].kind == Token::kEOF) finished = true;
+        }
+        tokens.resolvePayloads(from);
+    }
+    return index - base < tokens.size() ? index - base : npos;
 }
-std::string Parser::get_string() {
-    if (pos < tokens.size()) return tokens[pos].second;
+
+std::string_view Parser::get_string() {
+    size_t i = at(pos);
+    if (i != npos) return tokens.text(i);
     else return "";
 }
+Name Parser::get_name() {
+    size_t i = at(pos);
+    if (i != npos) return tokens.name(i);
+    else return Name();
+}
+std::string Parser::location() {
+    size_t i = pos >= base ? at(pos) : 0;
+    if (tokens.size() == 0) return "";
+    auto [line, column] = tokens.location(std::min(i, tokens.size() - 1));
+    return " at " + std::to_string(line) + ":" + std::to_string(column);
+}
 void Parser::consume() {
     pos++;
 }
@@ -15,126 +55,14 @@ void Parser::match(Token token) {
     if (peek() == token) {
         consume();
     } else {
-        throw std::runtime_error(std::string("parse failed! Expected token ") + tokenToString(token) + std::string(" in match"));
-    }
-}
-
-int Parser::getTokenLeftBP(Token token) {
-    switch (token) {
-        // PATH_ACCESS = 200
-        case Token::kPathSep:
-        case Token::kDot:
-            return PATH_ACCESS;
-        
-        // CALL_INDEX = 190
-        case Token::kLParenthese:  // function call
-        case Token::kLSquare:     // array indexing
-            return CALL_INDEX;
-        
-        // STRUCT_EXPR = 180
-        case Token::kLCurly:      // struct expression
-            return STRUCT_EXPR;
-        
-        // TYPE_CAST = 160 (as operator)
-        case Token::kAs:
-            return TYPE_CAST;
-        
-        // MUL_DIV_MOD = 150
-        case Token::kStar:
-        case Token::kSlash:
-        case Token::kPercent:
-            return MUL_DIV_MOD;
-        
-        // ADD_SUB = 140
-        case Token::kPlus:
-        case Token::kMinus:
-            return ADD_SUB;
-        
-        // SHIFT = 130
-        case Token::kShl:
-        case Token::kShr:
-            return SHIFT;
-        
-        // BIT_AND = 120
-        case Token::kAnd:
-            return BIT_AND;
-        
-        // BIT_XOR = 110
-        case Token::kCaret:
-            return BIT_XOR;
-        
-        // BIT_OR = 100
-        case Token::kOr:
-            return BIT_OR;
-        
-        // COMPARISON = 90
-        case Token::kEqEq:
-        case Token::kNe:
-        case Token::kLt:
-        case Token::kLe:
-        case Token::kGt:
-        case Token::kGe:
-            return COMPARISON;
-        
-        // LOGIC_AND = 80
-        case Token::kAndAnd:
-            return LOGIC_AND;
-        
-        // LOGIC_OR = 70
-        case Token::kOrOr:
-            return LOGIC_OR;
-        
-        // ASSIGNMENT = 60
-        case Token::kEq:
-        case Token::kPlusEq:
-        case Token::kMinusEq:
-        case Token::kStarEq:
-        case Token::kSlashEq:
-        case Token::kPercentEq:
-        case Token::kCaretEq:
-        case Token::kAndEq:
-        case Token::kOrEq:
-        case Token::kShlEq:
-        case Token::kShrEq:
-        case Token::kDotDot:
-        case Token::kDotDotDot:
-        case Token::kDotDotEq:
-            return ASSIGNMENT;
-        
-        // FLOW_CONTROL = 50
-        case Token::kReturn:
-        case Token::kBreak:
-        case Token::kContinue:
-            return FLOW_CONTROL;
-        
-        default:
-            return 0; // No binding power for non-operators
-    }
-}
-
-int Parser::getTokenUnaryBP(Token token) {
-    switch (token) {
-        // UNARY = 170
-        case Token::kMinus:       // unary minus
-        case Token::kStar:        // dereference
-        case Token::kAnd:         // reference
-        case Token::kNot:         // logical not
-        case Token::kQuestion:    // try operator
-            return UNARY;
-        
-        default:
-            return 0; // No unary binding power for non-unary operators
+        throw std::runtime_error(expected(token));
     }
 }
-
-int Parser::getTokenRightBP(Token token) {
-    // For all operators, we treat them as left-associative
-    // So getTokenRightBP should return getTokenLeftBP + 1
-    int leftBP = getTokenLeftBP(token);
-    return leftBP > 0 ? leftBP + 1 : 0;
+std::string Parser::expected(Token token) {
+    return std::string("parse failed! Expected token ") + tokenToString(token) + std::string(" in match") + location();
 }
 
-std::shared_ptr<ASTNode> Parser::parsePrattPrefix() {
+Expression* Parser::parsePrattPrefix() {
     Token token = peek();
     
     switch (token) {
@@ -174,13 +102,9 @@ std::shared_ptr<ASTNode> Parser::parsePrattPrefix() {
             // std::cerr << "Identifier in Prefix!" << std::endl;
             // This could be a path expression or struct expression
             // We need to look ahead to determine
-            size_t tmp = pos;
-            consume(); // consume identifier
-            if (peek() == Token::kLCurly) {
-                pos = tmp; // reset position
+            if (peek(1) == Token::kLCurly) {
                 return parseStructExpression();
             } else {
-                pos = tmp; // reset position
                 return parsePathExpression();
             }
         }
@@ -224,245 +148,281 @@ std::shared_ptr<ASTNode> Parser::parsePrattPrefix() {
             return parseBoolLiteral();
         
         default:
-            throw std::runtime_error("parse failed! Unexpected token in prefix expression");
+            throw std::runtime_error(std::string("parse failed! Unexpected token in prefix expression") + location());
     }
 }
 
-std::shared_ptr<ASTNode> Parser::parsePrattExpression(int current_bp) {
-    // std::cerr << "PrattExpression:" << std::endl;
-    // Try to parse prefix expression
-    auto lhs = parsePrattPrefix();
-    if (!lhs) {
-        return nullptr;
+Expression* Parser::parsePrattExpression(int current_bp) {
+    return parseNested(current_bp, false);
+}
+
+std::shared_ptr<Crate> Parser::parseCrate() {
+    if (!pipe && !lazy_bodies && !recovery && tokens.size() >= parallel_threshold) {
+        size_t threads = thread_count ? thread_count : std::thread::hardware_concurrency();
+        if (threads > 1) return parseCrateParallel(threads);
     }
-    // std::cerr << "lhs is good!" << std::endl;
-    // std::cerr << pos << std::endl;
-    // While the next operator has higher binding power, consume it
-    while (true) {
-        Token next_token = peek();
+    return parseCrateSequential();
+}
 
-        // std::cerr << pos << ' ' << tokenToString(next_token) << std::endl;
-        
-        // Check for closing tokens that should break the loop
-        if (next_token == Token::kRParenthese || next_token == Token::kRSquare || next_token == Token::kRCurly) {
-            // std::cerr << "break!" << std::endl;
-            break;
+std::shared_ptr<Crate> Parser::parseCrateSequential() {
+    // std::cerr << "Crate: " << std::endl;
+    std::vector<Item*> items;
+    while (1) {
+        size_t start = pos;
+        Item* curItem = nullptr;
+        try {
+            curItem = parseItem();
+        } catch (const std::runtime_error& error) {
+            if (!recovery) throw;
+            curItem = make<Item>(report(error));
+            skipItem(start);
         }
-        
-        int next_bp = getTokenLeftBP(next_token);
-
-        // std::cerr << next_bp << ' ' << current_bp << std::endl;
-
-        if (next_bp <= current_bp) {
-            break;
+        if (curItem == nullptr) break;
+        items.push_back(std::move(curItem));
+        // Memo entries never outlive the item they were made for
+        memo.clear();
+    }
+    // std::cerr << "}\n";
+    auto crate = std::make_shared<Crate>(std::move(items), std::exchange(arena, std::make_unique<ASTArena>()));
+    crate->id = next_id++;
+    crate->node_count = std::exchange(next_id, 0);
+    if (!lazy_functions.empty()) {
+        // The crate keeps a parser of its own over every token for the bodies still to be
+        // parsed; their nodes get ids after the ones handed out so far
+        auto bodies = std::make_unique<Parser>(std::move(tokens));
+        bodies->next_id = crate->node_count;
+        bodies->lazy_owner = crate.get();
+        for (auto* function: lazy_functions) function->lazy_parser = bodies.get();
+        bodies->lazy_functions = std::move(lazy_functions);
+        lazy_functions.clear();
+        crate->lazy_parser = std::move(bodies);
+    }
+    return crate;
+}
+
+void Parser::skipDelimited() {
+    size_t depth = 0;
+    do {
+        Token token = peek();
+        if (token == Token::kEOF) {
+            throw std::runtime_error(std::string("parse failed! Unclosed function body") + location());
         }
-        
-        // Create proper expression node based on operator type
-        switch (next_token) {
-            // Function call
-            case Token::kLParenthese: {
-                lhs = parseCallExpressionFromInfix(std::dynamic_pointer_cast<Expression>(lhs));
-                break;
+        if (token == Token::kLParenthese || token == Token::kLSquare || token == Token::kLCurly) {
+            ++depth;
+        } else if (token == Token::kRParenthese || token == Token::kRSquare || token == Token::kRCurly) {
+            if (depth == 0) {
+                throw std::runtime_error(std::string("parse failed! Unbalanced delimiter in function body") + location());
             }
-            
-            // Index expression
-            case Token::kLSquare: {
-                lhs = parseIndexExpressionFromInfix(std::dynamic_pointer_cast<Expression>(lhs));
-                break;
-            }
-            
-            // Method call and field access
-            case Token::kDot: {
-                // Look ahead to determine if it's a method call or field access
-                auto lhs_ = lhs;
-                size_t tmp = pos;
-                try {
-                    lhs = parseMethodCallExpressionFromInfix(std::dynamic_pointer_cast<Expression>(lhs));
-                } catch (...) {
-                    pos = tmp;
-                    lhs = lhs_;
-                    lhs = parseFieldExpressionFromInfix(std::dynamic_pointer_cast<Expression>(lhs));
-                }
-                break;
-            }
-            
-            // Type cast
-            case Token::kAs: {
-                consume(); // Consume 'as'
-                auto type = parseType();
-                lhs = parseTypeCastExpression(std::dynamic_pointer_cast<Expression>(lhs), std::move(type));
-                break;
-            }
-            
-            // Assignment and binary operators - need to parse RHS
-            default: {
-                // std::cerr << "Are we here?" << std::endl;
-                // Consume the operator and parse the right-hand side
-                consume();
-                int right_bp = getTokenRightBP(next_token);
-                auto rhs = parsePrattExpression(right_bp);
-                
-                if (!rhs) {
-                    throw std::runtime_error("parse failed! Expected expression after operator");
-                }
-                
-                // Assignment
-                if (next_token == Token::kEq) {
-                    lhs = parseAssignmentExpression(std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                // Compound assignment
-                else if (next_token == Token::kPlusEq) {
-                    lhs = parseCompoundAssignmentExpression(CompoundAssignmentExpression::PLUS_EQ, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kMinusEq) {
-                    lhs = parseCompoundAssignmentExpression(CompoundAssignmentExpression::MINUS_EQ, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kStarEq) {
-                    lhs = parseCompoundAssignmentExpression(CompoundAssignmentExpression::STAR_EQ, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kSlashEq) {
-                    lhs = parseCompoundAssignmentExpression(CompoundAssignmentExpression::SLASH_EQ, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kPercentEq) {
-                    lhs = parseCompoundAssignmentExpression(CompoundAssignmentExpression::PERCENT_EQ, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kCaretEq) {
-                    lhs = parseCompoundAssignmentExpression(CompoundAssignmentExpression::CARET_EQ, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kAndEq) {
-                    lhs = parseCompoundAssignmentExpression(CompoundAssignmentExpression::AND_EQ, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kOrEq) {
-                    lhs = parseCompoundAssignmentExpression(CompoundAssignmentExpression::OR_EQ, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kShlEq) {
-                    lhs = parseCompoundAssignmentExpression(CompoundAssignmentExpression::SHL_EQ, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kShrEq) {
-                    lhs = parseCompoundAssignmentExpression(CompoundAssignmentExpression::SHR_EQ, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                // Binary operators
-                else if (next_token == Token::kPlus) {
-                    lhs = parseBinaryExpression(BinaryExpression::PLUS, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kMinus) {
-                    lhs = parseBinaryExpression(BinaryExpression::MINUS, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kStar) {
-                    lhs = parseBinaryExpression(BinaryExpression::STAR, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kSlash) {
-                    lhs = parseBinaryExpression(BinaryExpression::SLASH, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kPercent) {
-                    lhs = parseBinaryExpression(BinaryExpression::PERCENT, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kCaret) {
-                    lhs = parseBinaryExpression(BinaryExpression::CARET, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kAnd) {
-                    lhs = parseBinaryExpression(BinaryExpression::AND, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kOr) {
-                    lhs = parseBinaryExpression(BinaryExpression::OR, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kShl) {
-                    lhs = parseBinaryExpression(BinaryExpression::SHL, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kShr) {
-                    lhs = parseBinaryExpression(BinaryExpression::SHR, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kEqEq) {
-                    lhs = parseBinaryExpression(BinaryExpression::EQ_EQ, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kNe) {
-                    lhs = parseBinaryExpression(BinaryExpression::NE, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kGt) {
-                    lhs = parseBinaryExpression(BinaryExpression::GT, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kLt) {
-                    lhs = parseBinaryExpression(BinaryExpression::LT, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kGe) {
-                    lhs = parseBinaryExpression(BinaryExpression::GE, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kLe) {
-                    lhs = parseBinaryExpression(BinaryExpression::LE, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kAndAnd) {
-                    lhs = parseBinaryExpression(BinaryExpression::AND_AND, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else if (next_token == Token::kOrOr) {
-                    lhs = parseBinaryExpression(BinaryExpression::OR_OR, std::dynamic_pointer_cast<Expression>(lhs), std::dynamic_pointer_cast<Expression>(rhs));
-                }
-                else {
-                    throw std::runtime_error("parse failed! Unexpected operator in infix expression");
-                }
+            --depth;
+        }
+        consume();
+    } while (depth > 0);
+}
+
+BlockExpression* Parser::parseLazyBody(Function& function) {
+    pos = function.body_begin;
+    BlockExpression* body = parseBlockExpression();
+    memo.clear();
+    if (pos != function.body_end) {
+        throw std::runtime_error(std::string("parse failed! Function body does not end at its closing brace") + location());
+    }
+    if (lazy_owner) lazy_owner->node_count = next_id;
+    return body;
+}
+
+void Parser::parseLazyBodies() {
+    for (auto* function: lazy_functions) function->body();
+}
+
+std::vector<std::pair<size_t, size_t>> Parser::splitItems() {
+    std::vector<std::pair<size_t, size_t>> ranges;
+    const auto& kinds = tokens.getKinds();
+    size_t i = pos;
+    while (i < kinds.size() && kinds[i] != Token::kEOF) {
+        size_t begin = i;
+        // A constant's initializer may contain braces, so only its `;` ends it
+        bool constant = kinds[i] == Token::kConst && i + 1 < kinds.size() && kinds[i + 1] != Token::kFn;
+        size_t depth = 0;
+        while (true) {
+            if (i >= kinds.size() || kinds[i] == Token::kEOF) return {};
+            Token kind = kinds[i++];
+            if (kind == Token::kLParenthese || kind == Token::kLSquare || kind == Token::kLCurly) {
+                ++depth;
+            } else if (kind == Token::kRParenthese || kind == Token::kRSquare || kind == Token::kRCurly) {
+                if (depth == 0) return {};
+                if (--depth == 0 && kind == Token::kRCurly && !constant) break;
+            } else if (kind == Token::kSemi && depth == 0) {
                 break;
             }
         }
+        ranges.emplace_back(begin, i);
     }
-    
-    return lhs;
+    return ranges;
 }
 
-std::shared_ptr<Crate> Parser::parseCrate() {
-    // std::cerr << "Crate: " << std::endl;
-    std::vector<std::shared_ptr<Item>> items;
-    while (1) {
-        auto curItem = parseItem();
-        if (curItem == nullptr) break;
-        items.push_back(std::move(curItem));
+bool Parser::parseItemsEndingAt(const std::vector<size_t>& ends, std::vector<Item*>& items) {
+    try {
+        for (size_t end: ends) {
+            Item* item = parseItem();
+            memo.clear();
+            if (item == nullptr || pos != end) return false;
+            items.push_back(item);
+        }
+    } catch (const std::exception&) {
+        return false;
     }
-    // std::cerr << "}\n";
-    return std::make_shared<Crate>(std::move(items));
+    return true;
 }
 
-std::shared_ptr<Item> Parser::parseItem() {
+namespace {
+
+// Moves the ids of a separately parsed group of items past those of the groups before it
+class IdShifter : public ASTWalker<IdShifter> {
+public:
+    NodeId shift;
+    // Children still to be shifted; kept on the heap so that deep trees do not recurse
+    std::vector<ASTNode*> pending;
+
+    explicit IdShifter(NodeId shift) : shift(shift) {}
+
+    template <typename Node>
+    void visit(Node& node) {
+        node.id += shift;
+        node.forEachChild([this](auto* child) {
+            if (child) pending.push_back(child);
+        });
+    }
+    void shiftTree(ASTNode* root) {
+        pending.push_back(root);
+        while (!pending.empty()) {
+            ASTNode* node = pending.back();
+            pending.pop_back();
+            walk(node);
+        }
+    }
+};
+
+// Runs task(0), ..., task(count - 1) on `threads` threads, the calling thread included
+template <typename Task>
+void runTasks(size_t threads, size_t count, const Task& task) {
+    std::atomic<size_t> next{0};
+    auto work = [&] {
+        for (size_t i = next++; i < count; i = next++) task(i);
+    };
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < std::min(threads, count); ++t) workers.emplace_back(work);
+    work();
+    for (auto& worker: workers) worker.join();
+}
+
+}
+
+std::shared_ptr<Crate> Parser::parseCrateParallel(size_t threads) {
+    auto ranges = pipe ? std::vector<std::pair<size_t, size_t>>() : splitItems();
+    if (ranges.empty()) return parseCrateSequential();
+    // Consecutive items are grouped into a few groups per thread with about the same
+    // number of tokens, so that uneven items still keep every thread busy
+    size_t count = std::min(ranges.size(), std::max<size_t>(threads, 1) * 4);
+    size_t begin = ranges.front().first, total = ranges.back().second - begin;
+    std::vector<size_t> firsts;
+    for (size_t i = 0; i < ranges.size();) {
+        firsts.push_back(i);
+        size_t limit = begin + total * firsts.size() / count;
+        do ++i; while (i < ranges.size() && ranges[i].second <= limit);
+    }
+    firsts.push_back(ranges.size());
+
+    struct Group {
+        std::unique_ptr<Parser> parser;
+        std::vector<Item*> items;
+        bool parsed = false;
+    };
+    std::vector<Group> groups(firsts.size() - 1);
+    runTasks(threads, groups.size(), [&](size_t g) {
+        size_t first = ranges[firsts[g]].first, last = ranges[firsts[g + 1] - 1].second;
+        std::vector<size_t> ends;
+        for (size_t i = firsts[g]; i < firsts[g + 1]; ++i) ends.push_back(ranges[i].second - first);
+        groups[g].parser = std::make_unique<Parser>(tokens.slice(first, last));
+        groups[g].parsed = groups[g].parser->parseItemsEndingAt(ends, groups[g].items);
+    });
+    for (const auto& group: groups) {
+        if (!group.parsed) return parseCrateSequential();
+    }
+
+    // Each group numbered its nodes from 0; shifting them by the node count of the groups
+    // before gives the ids a sequential parse would have assigned
+    std::vector<NodeId> shifts(groups.size(), 0);
+    for (size_t g = 1; g < groups.size(); ++g) shifts[g] = shifts[g - 1] + groups[g - 1].parser->next_id;
+    runTasks(threads, groups.size(), [&](size_t g) {
+        if (shifts[g] == 0) return;
+        IdShifter shifter(shifts[g]);
+        for (auto* item: groups[g].items) shifter.shiftTree(item);
+    });
+
+    std::vector<Item*> items;
+    items.reserve(ranges.size());
+    auto merged = std::make_unique<ASTArena>();
+    NodeId nodes = 0;
+    for (auto& group: groups) {
+        items.insert(items.end(), group.items.begin(), group.items.end());
+        merged->adopt(std::move(*group.parser->arena));
+        nodes += group.parser->next_id;
+        reparses += group.parser->reparses;
+        memo_hits += group.parser->memo_hits;
+        memo_misses += group.parser->memo_misses;
+    }
+    pos = ranges.back().second;
+    parallel_groups = groups.size();
+    auto crate = std::make_shared<Crate>(std::move(items), std::move(merged));
+    crate->id = nodes;
+    crate->node_count = nodes + 1;
+    return crate;
+}
+
+Item* Parser::parseItem() {
     // std::cerr << "Item: " << std::endl;
     // std::cerr << pos << ' ' << tokenToString(peek()) << std::endl;
     // std::cerr << (int)peek() << std::endl;
     if (peek() == Token::kEOF) {
         return nullptr;
     } else if (peek() == Token::kFn) {
-        return std::make_shared<Item>(std::move(parseFunction()));
+        return make<Item>(std::move(parseFunction()));
     } else if (peek() == Token::kStruct) {
-        return std::make_shared<Item>(std::move(parseStruct()));
+        return make<Item>(std::move(parseStruct()));
     } else if (peek() == Token::kEnum) {
-        return std::make_shared<Item>(std::move(parseEnumeration()));
+        return make<Item>(std::move(parseEnumeration()));
     } else if (peek() == Token::kConst) {
-        if (pos < tokens.size() && tokens[pos + 1].first == Token::kFn) {
-            return std::make_shared<Item>(std::move(parseFunction()));
+        if (peek(1) == Token::kFn) {
+            return make<Item>(std::move(parseFunction()));
         } else {
-            return std::make_shared<Item>(std::move(parseConstantItem()));
+            return make<Item>(std::move(parseConstantItem()));
         }
     } else if (peek() == Token::kTrait) {
-        return std::make_shared<Item>(std::move(parseTrait()));
+        return make<Item>(std::move(parseTrait()));
     } else if (peek() == Token::kImpl) {
-        return std::make_shared<Item>(std::move(parseImplementation()));
+        return make<Item>(std::move(parseImplementation()));
     } else {
-        throw std::runtime_error("parse failed! Unexpected token in Item");
+        throw std::runtime_error(std::string("parse failed! Unexpected token in Item") + location());
     }
     // std::cerr << "}\n";
 }
-std::shared_ptr<Function> Parser::parseFunction() {
+Function* Parser::parseFunction() {
     // std::cerr << "Function: " << std::endl;
     bool is_const = false;
-    std::string identifier;
-    std::shared_ptr<FunctionParameters> function_parameters = nullptr;
-    std::shared_ptr<FunctionReturnType> function_return_type = nullptr;
-    std::shared_ptr<BlockExpression> block_expression = nullptr;
+    Name identifier;
+    FunctionParameters* function_parameters = nullptr;
+    FunctionReturnType* function_return_type = nullptr;
+    BlockExpression* block_expression = nullptr;
     if (peek() == Token::kConst) {
         consume();
         is_const = true;
     }
     match(Token::kFn);
     if (peek() == Token::kIdentifier) {
-        identifier = get_string();
+        identifier = get_name();
         consume();
     } else {
-        throw std::runtime_error("parse failed! Unexpected token in function");
+        throw std::runtime_error(std::string("parse failed! Unexpected token in function") + location());
     }
     // std::cerr << "function name: " << identifier << std::endl;
     match(Token::kLParenthese);
@@ -480,29 +440,39 @@ std::shared_ptr<Function> Parser::parseFunction() {
     // std::cerr << "function return type done" << std::endl;
     if (peek() == Token::kSemi) {
         consume();
+    } else if (lazy_bodies && !pipe && !recovery && peek() == Token::kLCurly) {
+        // Only the extent of the body is recorded; Function::body() parses it later
+        size_t body_begin = pos;
+        skipDelimited();
+        auto function = make<Function>(is_const, std::move(identifier), function_parameters, function_return_type, nullptr);
+        function->body_begin = body_begin;
+        function->body_end = pos;
+        function->lazy_parser = this;
+        lazy_functions.push_back(function);
+        return function;
     } else {
         // std::cerr << "start function block expression" << std::endl;
         block_expression = std::move(parseBlockExpression());
     }
     // std::cerr << "}\n";
-    return std::make_shared<Function>(is_const, 
+    return make<Function>(is_const, 
         std::move(identifier), 
         std::move(function_parameters), 
         std::move(function_return_type), 
         std::move(block_expression));
 }
-std::shared_ptr<Struct> Parser::parseStruct() {
-    return std::make_shared<Struct>(std::move(parseStructStruct()));
+Struct* Parser::parseStruct() {
+    return make<Struct>(std::move(parseStructStruct()));
 }
-std::shared_ptr<Enumeration> Parser::parseEnumeration() {
-    std::string identifier;
-    std::shared_ptr<EnumVariants> enum_variants;
+Enumeration* Parser::parseEnumeration() {
+    Name identifier;
+    EnumVariants* enum_variants = nullptr;
     match(Token::kEnum);
     if (peek() == Token::kIdentifier) {
-        identifier = get_string();
+        identifier = get_name();
         consume();
     } else {
-        throw std::runtime_error("parse failed! Unexpected token in struct");
+        throw std::runtime_error(std::string("parse failed! Unexpected token in struct") + location());
     }
     match(Token::kLCurly);
     if (peek() == Token::kRCurly) {
@@ -511,18 +481,18 @@ std::shared_ptr<Enumeration> Parser::parseEnumeration() {
         enum_variants = std::move(parseEnumVariants());
         match(Token::kRCurly);
     }
-    return std::make_shared<Enumeration>(std::move(identifier), std::move(enum_variants));
+    return make<Enumeration>(std::move(identifier), std::move(enum_variants));
 }
-std::shared_ptr<ConstantItem> Parser::parseConstantItem() {
-    std::string identifier;
-    std::shared_ptr<Type> type;
-    std::shared_ptr<Expression> expression;
+ConstantItem* Parser::parseConstantItem() {
+    Name identifier;
+    Type* type = nullptr;
+    Expression* expression = nullptr;
     match(Token::kConst);
     if (peek() == Token::kIdentifier) {
-        identifier = get_string();
+        identifier = get_name();
         consume();
     } else {
-        throw std::runtime_error("parse failed! Unexpected token in constant item");
+        throw std::runtime_error(std::string("parse failed! Unexpected token in constant item") + location());
     }
     match(Token::kColon);
     type = std::move(parseType());
@@ -531,17 +501,17 @@ std::shared_ptr<ConstantItem> Parser::parseConstantItem() {
         expression = std::move(parseExpression());
     }
     match(Token::kSemi);
-    return std::make_shared<ConstantItem>(std::move(identifier), std::move(type), std::move(expression));
+    return make<ConstantItem>(std::move(identifier), std::move(type), std::move(expression));
 }
-std::shared_ptr<Trait> Parser::parseTrait() {
-    std::string identifier;
-    std::vector<std::shared_ptr<AssociatedItem>> associated_item;
+Trait* Parser::parseTrait() {
+    Name identifier;
+    std::vector<AssociatedItem*> associated_item;
     match(Token::kTrait);
     if (peek() == Token::kIdentifier) {
-        identifier = get_string();
+        identifier = get_name();
         consume();
     } else {
-        throw std::runtime_error("parse failed! Unexpected token in trait");
+        throw std::runtime_error(std::string("parse failed! Unexpected token in trait") + location());
     }
     match(Token::kLCurly);
     while (1) {
@@ -553,35 +523,27 @@ std::shared_ptr<Trait> Parser::parseTrait() {
             associated_item.push_back(std::move(tmp));
         }
     }
-    return std::make_shared<Trait>(std::move(identifier), std::move(associated_item));
+    return make<Trait>(std::move(identifier), std::move(associated_item));
 }
-std::shared_ptr<Implementation> Parser::parseImplementation() {
+Implementation* Parser::parseImplementation() {
     match(Token::kImpl);
-    std::shared_ptr<ASTNode> child;
-    size_t tmp = pos;
-    try {
+    ASTNode* child = nullptr;
+    // TraitImpl → `impl` IDENTIFIER `for` Type ...; anything else is an InherentImpl
+    if (peek() == Token::kIdentifier && peek(1) == Token::kFor) {
         child = std::move(parseTraitImpl());
-    } catch (...) {
-        try {
-            pos = tmp;
-            child = std::move(parseInherentImpl());
-        } catch (...) {
-            throw std::runtime_error("parse failed! Unexpected token in implementation");
-        }
+    } else {
+        child = std::move(parseInherentImpl());
     }
-    return std::make_shared<Implementation>(std::move(child));
+    return make<Implementation>(std::move(child));
 }
-std::shared_ptr<FunctionParameters> Parser::parseFunctionParameters() {
+FunctionParameters* Parser::parseFunctionParameters() {
     // std::cerr << "FunctionParameter:";
     bool has_self = false;
-    std::shared_ptr<SelfParam> self_param = nullptr;
-    std::vector<std::shared_ptr<FunctionParam>> function_param;
-    size_t tmp = pos;
-    for (size_t _ = 0; _ < 3; ++_) {
-        if (peek() != Token::kSelf) consume();
-        else has_self = true;
+    SelfParam* self_param = nullptr;
+    std::vector<FunctionParam*> function_param;
+    for (size_t ahead = 0; ahead < 3; ++ahead) {
+        if (peek(ahead) == Token::kSelf) has_self = true;
     }
-    pos = tmp;
     // std::cerr << has_self << ' ' << pos << std::endl;
     if (has_self) {
         self_param = std::move(parseSelfParam());
@@ -597,21 +559,18 @@ std::shared_ptr<FunctionParameters> Parser::parseFunctionParameters() {
         }
     }
     // std::cerr << "}\n";
-    return std::make_shared<FunctionParameters>(std::move(self_param), std::move(function_param));
+    return make<FunctionParameters>(std::move(self_param), std::move(function_param));
 }
-std::shared_ptr<SelfParam> Parser::parseSelfParam() {
-    size_t tmp = pos;
-    while (peek() != Token::kSelf) consume();
-    consume();
-    if (peek() == Token::kColon) {
-        pos = tmp;
-        return std::make_shared<SelfParam>(std::move(parseTypedSelf()));
+SelfParam* Parser::parseSelfParam() {
+    size_t ahead = 0;
+    while (peek(ahead) != Token::kSelf) ++ahead;
+    if (peek(ahead + 1) == Token::kColon) {
+        return make<SelfParam>(std::move(parseTypedSelf()));
     } else {
-        pos = tmp;
-        return std::make_shared<SelfParam>(std::move(parseShorthandSelf()));
+        return make<SelfParam>(std::move(parseShorthandSelf()));
     }
 }
-std::shared_ptr<ShorthandSelf> Parser::parseShorthandSelf() {
+ShorthandSelf* Parser::parseShorthandSelf() {
     bool is_reference = false, is_mutable = false;
     if (peek() == Token::kAnd) {
         is_reference = true;
@@ -622,11 +581,11 @@ std::shared_ptr<ShorthandSelf> Parser::parseShorthandSelf() {
         consume();
     }
     match(Token::kSelf);
-    return std::make_shared<ShorthandSelf>(is_reference, is_mutable);
+    return make<ShorthandSelf>(is_reference, is_mutable);
 }
-std::shared_ptr<TypedSelf> Parser::parseTypedSelf() {
+TypedSelf* Parser::parseTypedSelf() {
     bool is_mutable = false;
-    std::shared_ptr<Type> type = nullptr;
+    Type* type = nullptr;
     if (peek() == Token::kMut) {
         is_mutable = true;
         consume();
@@ -634,35 +593,35 @@ std::shared_ptr<TypedSelf> Parser::parseTypedSelf() {
     match(Token::kSelf);
     match(Token::kColon);
     type = std::move(parseType());
-    return std::make_shared<TypedSelf>(is_mutable, std::move(type));
+    return make<TypedSelf>(is_mutable, std::move(type));
 }
-std::shared_ptr<FunctionParam> Parser::parseFunctionParam() {
-    std::shared_ptr<PatternNoTopAlt> pattern_no_top_alt;
-    std::shared_ptr<Type> type;
+FunctionParam* Parser::parseFunctionParam() {
+    PatternNoTopAlt* pattern_no_top_alt = nullptr;
+    Type* type = nullptr;
     pattern_no_top_alt = std::move(parsePatternNoTopAlt());
     match(Token::kColon);
     type = std::move(parseType());
-    return make_shared<FunctionParam>(std::move(pattern_no_top_alt), std::move(type));
+    return make<FunctionParam>(std::move(pattern_no_top_alt), std::move(type));
 }
-std::shared_ptr<FunctionReturnType> Parser::parseFunctionReturnType() {
+FunctionReturnType* Parser::parseFunctionReturnType() {
     if (peek() == Token::kRArrow) {
-        std::shared_ptr<Type> type;
+        Type* type = nullptr;
         consume();
         type = std::move(parseType());
-        return std::make_shared<FunctionReturnType>(std::move(type));
+        return make<FunctionReturnType>(std::move(type));
     } else {
         return nullptr;
     }
 }
-std::shared_ptr<StructStruct> Parser::parseStructStruct() {
-    std::string identifier;
-    std::shared_ptr<StructFields> struct_fields = nullptr;
+StructStruct* Parser::parseStructStruct() {
+    Name identifier;
+    StructFields* struct_fields = nullptr;
     match(Token::kStruct);
     if (peek() == Token::kIdentifier) {
-        identifier = get_string();
+        identifier = get_name();
         consume();
     } else {
-        throw std::runtime_error("parse failed! Unexpected token in structstruct");
+        throw std::runtime_error(std::string("parse failed! Unexpected token in structstruct") + location());
     }
     if (peek() == Token::kSemi) {
         consume();
@@ -675,10 +634,10 @@ std::shared_ptr<StructStruct> Parser::parseStructStruct() {
             match(Token::kRCurly);
         }
     }
-    return std::make_shared<StructStruct>(std::move(identifier), std::move(struct_fields));
+    return make<StructStruct>(std::move(identifier), std::move(struct_fields));
 }
-std::shared_ptr<StructFields> Parser::parseStructFields() {
-    std::vector<std::shared_ptr<StructField>> struct_field;
+StructFields* Parser::parseStructFields() {
+    std::vector<StructField*> struct_field;
     struct_field.push_back(std::move(parseStructField()));
     while (1) {
         if (peek() == Token::kComma) {
@@ -690,27 +649,27 @@ std::shared_ptr<StructFields> Parser::parseStructFields() {
             if (tmp != nullptr) {
                 struct_field.push_back(std::move(tmp));
             } else {
-                throw std::runtime_error("parse failed");
+                throw std::runtime_error(std::string("parse failed") + location());
             }
         }
     }
-    return std::make_shared<StructFields>(std::move(struct_field));
+    return make<StructFields>(std::move(struct_field));
 }
-std::shared_ptr<StructField> Parser::parseStructField() {
-    std::string identifier;
-    std::shared_ptr<Type> type;
+StructField* Parser::parseStructField() {
+    Name identifier;
+    Type* type = nullptr;
     if (peek() == Token::kIdentifier) {
-        identifier = get_string();
+        identifier = get_name();
         consume();
     } else {
-        throw std::runtime_error("parse failed! Unexpected token in struct field");
+        throw std::runtime_error(std::string("parse failed! Unexpected token in struct field") + location());
     }
     match(Token::kColon);
     type = std::move(parseType());
-    return std::make_shared<StructField>(std::move(identifier), std::move(type));
+    return make<StructField>(std::move(identifier), std::move(type));
 }
-std::shared_ptr<EnumVariants> Parser::parseEnumVariants() {
-    std::vector<std::shared_ptr<EnumVariant>> enum_variant;
+EnumVariants* Parser::parseEnumVariants() {
+    std::vector<EnumVariant*> enum_variant;
     enum_variant.push_back(std::move(parseEnumVariant()));
     while (1) {
         if (peek() == Token::kComma) {
@@ -722,38 +681,38 @@ std::shared_ptr<EnumVariants> Parser::parseEnumVariants() {
             if (tmp != nullptr) {
                 enum_variant.push_back(std::move(tmp));
             } else {
-                throw std::runtime_error("parse failed! Unexpected token in enum variants");
+                throw std::runtime_error(std::string("parse failed! Unexpected token in enum variants") + location());
             }
         }
     }
-    return std::make_shared<EnumVariants>(std::move(enum_variant));
+    return make<EnumVariants>(std::move(enum_variant));
 }
-std::shared_ptr<EnumVariant> Parser::parseEnumVariant() {
-    std::string identifier;
+EnumVariant* Parser::parseEnumVariant() {
+    Name identifier;
     if (peek() == Token::kIdentifier) {
-        identifier = get_string();
+        identifier = get_name();
         consume();
     } else {
-        throw std::runtime_error("parse failed! Unexpected token in enum variant");
+        throw std::runtime_error(std::string("parse failed! Unexpected token in enum variant") + location());
     }
-    return std::make_shared<EnumVariant>(std::move(identifier));
+    return make<EnumVariant>(std::move(identifier));
 }
-std::shared_ptr<AssociatedItem> Parser::parseAssociatedItem() {
+AssociatedItem* Parser::parseAssociatedItem() {
     if (peek() == Token::kConst) {
-        if (pos < tokens.size() && tokens[pos + 1].first == Token::kFn) {
-            return std::make_shared<AssociatedItem>(std::move(parseFunction()));
+        if (peek(1) == Token::kFn) {
+            return make<AssociatedItem>(std::move(parseFunction()));
         } else {
-            return std::make_shared<AssociatedItem>(std::move(parseConstantItem()));
+            return make<AssociatedItem>(std::move(parseConstantItem()));
         }
     } else {
-        return std::make_shared<AssociatedItem>(std::move(parseFunction()));
+        return make<AssociatedItem>(std::move(parseFunction()));
     }
 }
-std::shared_ptr<InherentImpl> Parser::parseInherentImpl() {
+InherentImpl* Parser::parseInherentImpl() {
     // std::cerr << "InherentImpl:" << std::endl;
     // std::cerr << pos << std::endl;
-    std::shared_ptr<Type> type;
-    std::vector<std::shared_ptr<AssociatedItem>> associated_item;
+    Type* type = nullptr;
+    std::vector<AssociatedItem*> associated_item;
     type = std::move(parseType());
     // std::cerr << "Type matched!" << std::endl;
     match(Token::kLCurly);
@@ -766,17 +725,17 @@ std::shared_ptr<InherentImpl> Parser::parseInherentImpl() {
             associated_item.push_back(std::move(tmp));
         }
     }
-    return std::make_shared<InherentImpl>(std::move(type), std::move(associated_item));
+    return make<InherentImpl>(std::move(type), std::move(associated_item));
 }
-std::shared_ptr<TraitImpl> Parser::parseTraitImpl() {
-    std::string identifier;
-    std::shared_ptr<Type> type;
-    std::vector<std::shared_ptr<AssociatedItem>> associated_item;
+TraitImpl* Parser::parseTraitImpl() {
+    Name identifier;
+    Type* type = nullptr;
+    std::vector<AssociatedItem*> associated_item;
     if (peek() == Token::kIdentifier) {
-        identifier = get_string();
+        identifier = get_name();
         consume();
     } else {
-        throw std::runtime_error("parse failed! Unexpected token in trait impl");
+        throw std::runtime_error(std::string("parse failed! Unexpected token in trait impl") + location());
     }
     match(Token::kFor);
     type = std::move(parseType());
@@ -790,34 +749,137 @@ std::shared_ptr<TraitImpl> Parser::parseTraitImpl() {
             associated_item.push_back(std::move(tmp));
         }
     }
-    return std::make_shared<TraitImpl>(std::move(identifier), std::move(type), std::move(associated_item));
+    return make<TraitImpl>(std::move(identifier), std::move(type), std::move(associated_item));
 }
 
-std::shared_ptr<Statement> Parser::parseStatement() {
+namespace {
+bool startsItem(Token token) {
+    return token == Token::kFn || token == Token::kStruct || token == Token::kEnum
+        || token == Token::kConst || token == Token::kTrait || token == Token::kImpl;
+}
+// Tokens accepted by parsePrattPrefix
+bool startsExpression(Token token) {
+    switch (token) {
+        case Token::kIf: case Token::kLoop: case Token::kWhile:
+        case Token::kReturn: case Token::kBreak: case Token::kContinue:
+        case Token::kLCurly: case Token::kLParenthese: case Token::kLSquare:
+        case Token::kSelf: case Token::kSelf_: case Token::kIdentifier:
+        case Token::kMinus: case Token::kNot: case Token::kQuestion: case Token::kStar: case Token::kAnd:
+        case Token::kCharLiteral: case Token::kStringLiteral: case Token::kRawStringLiteral:
+        case Token::kCStringLiteral: case Token::kRawCStringLiteral: case Token::kIntegerLiteral:
+        case Token::kTrue: case Token::kFalse:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Delimiters left open by the tokens passed so far, innermost last
+class OpenDelimiters {
+private:
+    std::vector<Token> open;
+    // Open delimiters of each kind, so that a closer matching nothing is rejected without a scan
+    size_t counts[3] = {};
+
+    static size_t slot(Token opener) {
+        return opener == Token::kLParenthese ? 0 : opener == Token::kLSquare ? 1 : 2;
+    }
+public:
+    // Statements and items only appear inside braces; an unclosed `(` or `[` does not hide them
+    bool inBraces() const { return counts[2] != 0; }
+    // Accounts for `token`; false for a closing delimiter that matches nothing open. A closer
+    // of an outer delimiter also closes the unclosed ones inside it, so the scans in here
+    // only ever walk over entries they remove
+    bool pass(Token token) {
+        Token opener;
+        switch (token) {
+            case Token::kLParenthese: case Token::kLSquare: case Token::kLCurly:
+                open.push_back(token);
+                ++counts[slot(token)];
+                return true;
+            case Token::kRParenthese: opener = Token::kLParenthese; break;
+            case Token::kRSquare: opener = Token::kLSquare; break;
+            case Token::kRCurly: opener = Token::kLCurly; break;
+            default: return true;
+        }
+        if (counts[slot(opener)] == 0) return false;
+        while (open.back() != opener) {
+            --counts[slot(open.back())];
+            open.pop_back();
+        }
+        --counts[slot(opener)];
+        open.pop_back();
+        return true;
+    }
+};
+}
+
+ErrorNode* Parser::report(const std::runtime_error& error) {
+    if (diagnostics.empty() || diagnostics.back().token != pos) {
+        size_t i = pos >= base ? at(pos) : npos;
+        SourceLocation where{0, 0};
+        if (tokens.size() != 0) where = tokens.location(std::min(i, tokens.size() - 1));
+        diagnostics.push_back({error.what(), pos, where});
+    }
+    return make<ErrorNode>(error.what());
+}
+
+void Parser::skipItem(size_t start) {
+    size_t error = std::max(pos, start + 1);
+    OpenDelimiters open;
+    for (pos = start; pos < error && peek() != Token::kEOF; consume()) {
+        open.pass(peek());
+    }
+    while (peek() != Token::kEOF && !(!open.inBraces() && startsItem(peek()))) {
+        // A stray closer at top level is skipped like any other token
+        open.pass(peek());
+        consume();
+    }
+}
+
+void Parser::skipStatement(size_t start) {
+    size_t error = std::max(pos, start + 1);
+    OpenDelimiters open;
+    for (pos = start; pos < error && peek() != Token::kEOF; consume()) {
+        open.pass(peek());
+    }
+    while (true) {
+        Token token = peek();
+        if (token == Token::kEOF) return;
+        if (!open.inBraces()) {
+            if (token == Token::kSemi) {
+                consume();
+                return;
+            }
+            if (startsItem(token)) return;
+        }
+        if (!open.pass(token) && token == Token::kRCurly) {
+            // Closes the block the statement is in
+            return;
+        }
+        consume();
+    }
+}
+
+Statement* Parser::parseStatement() {
     // std::cerr << "Statement:" << std::endl;
     // std::cerr << pos << ' ' << tokenToString(peek()) << std::endl;
     if (peek() == Token::kSemi) {
         consume();
-        return std::make_shared<Statement>(nullptr);
+        return make<Statement>(nullptr);
     } else if (peek() == Token::kLet) {
-        return std::make_shared<Statement>(std::move(parseLetStatement()));
+        return make<Statement>(std::move(parseLetStatement()));
+    } else if (startsItem(peek())) {
+        return make<Statement>(std::move(parseItem()));
     } else {
-        std::shared_ptr<ASTNode> child;
-        size_t tmp = pos;
-        try {
-            child = std::move(parseExpressionStatement());
-        } catch (...) {
-            pos = tmp;
-            child = std::move(parseItem());
-        }
-        return std::make_shared<Statement>(std::move(child));
+        return make<Statement>(std::move(parseExpressionStatement()));
     }
 }
-std::shared_ptr<LetStatement> Parser::parseLetStatement() {
+LetStatement* Parser::parseLetStatement() {
     // std::cerr << "LetStatement:" << std::endl;
-    std::shared_ptr<PatternNoTopAlt> pattern_no_top_alt;
-    std::shared_ptr<Type> type;
-    std::shared_ptr<Expression> expression;
+    PatternNoTopAlt* pattern_no_top_alt = nullptr;
+    Type* type = nullptr;
+    Expression* expression = nullptr;
     match(Token::kLet);
     pattern_no_top_alt = parsePatternNoTopAlt();
     match(Token::kColon);
@@ -830,84 +892,29 @@ std::shared_ptr<LetStatement> Parser::parseLetStatement() {
     // std::cerr << "expression matched!" << std::endl;
     match(Token::kSemi);
     // std::cerr << "semi matched!" << std::endl;
-    return std::make_shared<LetStatement>(std::move(pattern_no_top_alt), std::move(type), std::move(expression));
+    return make<LetStatement>(std::move(pattern_no_top_alt), std::move(type), std::move(expression));
 }
-std::shared_ptr<ExpressionStatement> Parser::parseExpressionStatement() {
+ExpressionStatement* Parser::parseExpressionStatement() {
     // std::cerr << "ExpressionStatement:" << std::endl;
-    std::shared_ptr<ASTNode> child;
-    size_t tmp = pos;
+    Expression* child = nullptr;
     bool has_semi = false;
-    if (peek() == Token::kIf || peek() == Token::kWhile || peek() == Token::kLCurly) {
-        pos = tmp;
+    Token token = peek();
+    if (token == Token::kIf || token == Token::kWhile || token == Token::kLoop || token == Token::kLCurly) {
         child = parseExpressionWithBlock();
-        if (peek() == Token::kSemi) {
-            consume();
-            has_semi = true;
-        }
     } else {
-        try {
-            child = parseExpressionWithoutBlock();
-            match(Token::kSemi);
-            has_semi = true;
-        } catch (...) {
-            // std::cerr << "failed ExpressionWithouBlock!" << std::endl;
-            pos = tmp;
-            child = parseExpressionWithBlock();
-            if (peek() == Token::kSemi) {
-                consume();
-                has_semi = true;
-            }
-            // std::cerr << "succeeded ExpressionWithouBlock " << pos << std::endl;
-        }
+        auto expression = parsePrattExpression(0);
+        match(Token::kSemi);
+        return make<ExpressionStatement>(std::move(expression), true);
     }
-    return std::make_shared<ExpressionStatement>(std::move(child), has_semi);
-}
-int ccnt = 0;
-std::shared_ptr<Statements> Parser::parseStatements() {
-    // std::cerr << "Statements:" << std::endl;
-    std::vector<std::shared_ptr<ASTNode>> statements;
-    ccnt++;
-    // std::cerr << ccnt << ' ' << pos << std::endl;
-    // Try to parse statements until we hit a closing brace or EOF
-    while (peek() != Token::kRCurly && peek() != Token::kEOF) {
-        size_t tmp = pos;
-        std::shared_ptr<ASTNode> statement;
-        
-        // First try to parse a Statement
-        try {
-            statement = std::move(parseStatement());
-            if (statement) {
-                statements.push_back(std::move(statement));
-                continue;
-            }
-        } catch (...) {
-            pos = tmp;
-        }
-        
-        // If Statement parsing failed, try to parse ExpressionWithoutBlock
-        try {
-            // std::cerr << "statements failed statement " << ccnt << ' ' << pos << ' ' << tmp << std::endl;
-            statement = std::move(parseExpressionWithoutBlock());
-            if (statement) {
-                // std::cerr << "succeeded ExpressionWithoutBlock in Statements " << pos << std::endl;
-                statements.push_back(std::move(statement));
-                // Check if there's a semicolon after the expression
-                break;
-            }
-        } catch (...) {
-            pos = tmp;
-        }
-        
-        // If both failed, break
-        break;
+    if (peek() == Token::kSemi) {
+        consume();
+        has_semi = true;
     }
-    
-    return std::make_shared<Statements>(std::move(statements));
+    return make<ExpressionStatement>(std::move(child), has_semi);
 }
-
-std::shared_ptr<Expression> Parser::parseExpression() {
+Expression* Parser::parseExpression() {
     // std::cerr << "Expression:" << std::endl;
-    // std::shared_ptr<ASTNode> child;
+    // ASTNode* child;
     // size_t tmp = pos;
     // try {
     //     child = parseExpressionWithBlock();
@@ -915,23 +922,18 @@ std::shared_ptr<Expression> Parser::parseExpression() {
     //     pos = tmp;
     //     child = parsePrattExpression(0);
     // }
-    auto child = parsePrattExpression(0);
-    return std::make_shared<Expression>(std::move(child));
+    return parsePrattExpression(0);
 }
-std::shared_ptr<ExpressionWithoutBlock> Parser::parseExpressionWithoutBlock() {
+Expression* Parser::parseExpressionWithoutBlock() {
     // std::cerr << "parseExpressionWithoutBlock: " << pos << std::endl;
     auto expression = parsePrattExpression(0);
 
     // std::cerr << "at least here" << std::endl;
     
-    // 检查返回的表达式是否可以被 cast 到 ExpressionWithBlock
-    if (std::dynamic_pointer_cast<ExpressionWithBlock>(expression)
-     || std::dynamic_pointer_cast<IfExpression>(expression)
-     || std::dynamic_pointer_cast<LoopExpression>(expression)
-     || std::dynamic_pointer_cast<BlockExpression>(expression)
-    ) {
+    // 检查返回的表达式是否为带块的表达式
+    if (isExpressionWithBlock(expression)) {
         // std::cerr << "this is not what we wanted" << std::endl;
-        throw std::runtime_error("parse failed! ExpressionWithBlock not allowed in ExpressionWithoutBlock context");
+        throw std::runtime_error(std::string("parse failed! ExpressionWithBlock not allowed in ExpressionWithoutBlock context") + location());
     }
 
     // if (expression == nullptr) std::cerr << "???" << std::endl;
@@ -939,30 +941,25 @@ std::shared_ptr<ExpressionWithoutBlock> Parser::parseExpressionWithoutBlock() {
     // std::cerr << "we are good!" << std::endl;
     // std::cerr << pos << std::endl;
     
-    // 如果不能 cast 到 ExpressionWithBlock，则正常运行，创建 ExpressionWithoutBlock
-    return std::make_shared<ExpressionWithoutBlock>(std::move(expression));
+    return expression;
 }
-std::shared_ptr<ExpressionWithBlock> Parser::parseExpressionWithBlock() {
+Expression* Parser::parseExpressionWithBlock() {
     // std::cerr << "ExpressionWithBlock:" << std::endl;
     // std::cerr << pos << ' ' << tokenToString(peek()) << std::endl;
-    std::shared_ptr<ASTNode> child;
     
     // Try to parse if expression
     if (peek() == Token::kIf) {
-        child = std::move(parseIfExpression());
-        return std::make_shared<ExpressionWithBlock>(std::move(child));
+        return parseIfExpression();
     }
     
     // Try to parse loop expression
     if (peek() == Token::kLoop || peek() == Token::kWhile) {
-        child = std::move(parseLoopExpression());
-        return std::make_shared<ExpressionWithBlock>(std::move(child));
+        return parseLoopExpression();
     }
     
     // Try to parse block expression
     if (peek() == Token::kLCurly) {
-        child = std::move(parseBlockExpression());
-        return std::make_shared<ExpressionWithBlock>(std::move(child));
+        return parseBlockExpression();
     }
 
     // std::cerr << "ExpressionWithBlock not matched!" << std::endl;
@@ -970,54 +967,660 @@ std::shared_ptr<ExpressionWithBlock> Parser::parseExpressionWithBlock() {
 
     return nullptr;
 }
-std::shared_ptr<BlockExpression> Parser::parseBlockExpression() {
-    // std::cerr << "BlockExpression:" << std::endl;
-    // std::cerr << "!!" << pos << std::endl;
-    std::shared_ptr<Statements> statements = nullptr;
-    
-    match(Token::kLCurly);
-    
-    // Check if there are statements inside the block
-    
-    auto tmp = pos;
-    if (peek() != Token::kRCurly) {
-        
-        statements = std::move(parseStatements());
+// Pratt parsing and block parsing driven by an explicit stack of frames. Every nested
+// operand, block, condition or statement pushes a frame instead of recursing, so deeply
+// nested input only grows the heap-allocated stack. Nodes are created in the same order
+// as a recursive descent would create them, which keeps node ids and memo hits unchanged.
+// Call arguments, indices, array elements and struct fields are frames as well; only nested
+// items and array type lengths re-enter from recursive descent. Such a call stacks its frames
+// on top of the caller's; no reference into the stack is held across it
+Expression* Parser::parseNested(int current_bp, bool with_block) {
+    // Drops the frames, statements and list elements of this call on every exit, parse
+    // errors included
+    struct Release {
+        Parser& parser;
+        size_t frames;
+        size_t statements;
+        size_t elements;
+        ~Release() {
+            parser.frames.resize(frames);
+            parser.block_statements.resize(statements);
+            parser.list_elements.resize(elements);
+        }
+    } release{*this, frames.size(), block_statements.size(), list_elements.size()};
+    auto& stack = frames;
+
+    auto push = [&](Frame::Kind kind, int bp) -> Frame& {
+        if (stack.size() >= max_depth) {
+            throw std::runtime_error(std::string("parse failed! Expression nested too deeply") + location());
+        }
+        // Copied from a constant rather than value-initialized: GCC clears a new frame with
+        // `rep stos`, whose start-up cost dominated pushing a frame for every binary operator
+        static constexpr Frame blank{};
+        Frame& frame = stack.emplace_back(blank);
+        frame.kind = kind;
+        frame.bp = bp;
+        return frame;
+    };
+    auto pop = [&] { stack.pop_back(); };
+
+    // kOperand: an operand starts at the current token
+    // kInfix: `value` is an operand, try to extend it with postfix and infix operators
+    // kReduce: `value` completes the operand of the top frame
+    // kWithBlock: `value` is a finished block, if or loop expression
+    // kStatement: the top frame is a block, at the start of a statement
+    enum class State { kOperand, kInfix, kReduce, kWithBlock, kStatement };
+    Expression* value = nullptr;
+
+    auto beginBlock = [&]() -> State {
+        size_t start = pos;
+        if (auto node = recall<BlockExpression>(MemoRule::kBlockExpression)) {
+            value = node;
+            return State::kWithBlock;
+        }
+        match(Token::kLCurly);
+        Frame& frame = push(Frame::kBlock, 0);
+        frame.start = start;
+        frame.body = pos;
+        frame.has_body = peek() != Token::kRCurly;
+        frame.statements = block_statements.size();
+        return State::kStatement;
+    };
+    auto beginIf = [&]() -> State {
+        size_t start = pos;
+        if (auto node = recall<IfExpression>(MemoRule::kIfExpression)) {
+            value = node;
+            return State::kWithBlock;
+        }
+        match(Token::kIf);
+        push(Frame::kIf, 0).start = start;
+        match(Token::kLParenthese);
+        push(Frame::kCondition, 0);
+        return State::kOperand;
+    };
+    auto beginLoop = [&]() -> State {
+        size_t start = pos;
+        if (auto node = recall<LoopExpression>(MemoRule::kLoopExpression)) {
+            value = node;
+            return State::kWithBlock;
+        }
+        Token token = peek();
+        consume();
+        Frame& frame = push(Frame::kLoop, 0);
+        frame.start = start;
+        frame.op = token;
+        if (token == Token::kLoop) {
+            return beginBlock();
+        }
+        match(Token::kLParenthese);
+        push(Frame::kCondition, 0);
+        return State::kOperand;
+    };
+    // The elements of the list of the top frame, which are removed from list_elements
+    auto takeElements = [&]<typename Node>() {
+        size_t first = stack.back().elements;
+        std::vector<Node*> elements;
+        elements.reserve(list_elements.size() - first);
+        for (size_t i = first; i < list_elements.size(); ++i) elements.push_back(cast<Node>(list_elements[i]));
+        list_elements.resize(first);
+        return elements;
+    };
+    // `(` read after a callee or method name; `part` is the method name of a method call
+    auto beginCall = [&](ASTNode* part) -> State {
+        if (peek() != Token::kRParenthese) {
+            Frame& frame = push(Frame::kCall, 0);
+            frame.lhs = value;
+            frame.part = part;
+            frame.elements = list_elements.size();
+            return State::kOperand;
+        }
+        consume();
+        if (part) {
+            value = make<MethodCallExpression>(value, cast<PathIdentSegment>(part), nullptr);
+        } else {
+            value = make<CallExpression>(value, nullptr);
+        }
+        return State::kInfix;
+    };
+    // Reads `IDENTIFIER :` of a struct expression field; its expression comes next
+    auto beginField = [&]() -> State {
+        if (peek() != Token::kIdentifier) {
+            throw std::runtime_error(std::string("parse failed! Expected identifier in struct field") + location());
+        }
+        stack.back().field = get_name();
+        consume();
+        match(Token::kColon);
+        return State::kOperand;
+    };
+    // The statements stopped at the end of the block or at a token that cannot start one
+    auto finishBlock = [&]() -> State {
+        Frame& frame = stack.back();
+        ErrorNode* missing = nullptr;
+        if (peek() != Token::kRCurly && (frame.recovered || (recovery && peek() == Token::kEOF))) {
+            // A block with broken statements is not read again, nor is one cut off by the end of
+            // input; a stray token is skipped with the statement it starts
+            missing = report(std::runtime_error(expected(Token::kRCurly)));
+            block_statements.push_back(missing);
+            if (peek() != Token::kEOF) {
+                skipStatement(pos);
+                return State::kStatement;
+            }
+        }
+        Statements* statements = nullptr;
+        if (frame.has_body) {
+            statements = make<Statements>(std::vector<ASTNode*>(block_statements.begin() + frame.statements, block_statements.end()));
+        }
+        if (missing) {
+            block_statements.resize(frame.statements);
+            value = make<BlockExpression>(statements);
+            pop();
+            return State::kWithBlock;
+        }
+        block_statements.resize(frame.statements);
+        if (peek() != Token::kRCurly) {
+            // Read the whole body again as a single expression, e.g. `{ if a { 1 } else { 2 } + 3 }`
+            ++reparses;
+            pos = frame.body;
+            frame.kind = Frame::kBlockBody;
+            return State::kOperand;
+        }
+        consume();
+        value = remember(MemoRule::kBlockExpression, frame.start, make<BlockExpression>(statements));
+        pop();
+        return State::kWithBlock;
+    };
+
+    push(Frame::kRoot, current_bp);
+    State state = State::kOperand;
+    while (true) {
+      try {
+        switch (state) {
+            case State::kOperand: {
+                Token token = peek();
+                switch (token) {
+                    case Token::kLCurly:
+                        state = beginBlock();
+                        break;
+                    case Token::kIf:
+                        state = beginIf();
+                        break;
+                    case Token::kLoop:
+                    case Token::kWhile:
+                        state = beginLoop();
+                        break;
+                    case Token::kLParenthese:
+                        consume();
+                        push(Frame::kGroup, 0);
+                        break;
+                    case Token::kLSquare:
+                        consume();
+                        if (peek() == Token::kRSquare) {
+                            consume();
+                            value = make<ArrayExpression>(nullptr);
+                            state = State::kInfix;
+                            break;
+                        }
+                        push(Frame::kArray, 0).elements = list_elements.size();
+                        break;
+                    case Token::kSelf:
+                    case Token::kSelf_:
+                    case Token::kIdentifier: {
+                        if (peek(1) != Token::kLCurly) {
+                            value = parsePathExpression();
+                            state = State::kInfix;
+                            break;
+                        }
+                        auto path = parsePathInExpression();
+                        match(Token::kLCurly);
+                        if (peek() == Token::kRCurly) {
+                            consume();
+                            value = make<StructExpression>(path, nullptr);
+                            state = State::kInfix;
+                            break;
+                        }
+                        Frame& frame = push(Frame::kStructField, 0);
+                        frame.part = path;
+                        frame.elements = list_elements.size();
+                        state = beginField();
+                        break;
+                    }
+                    case Token::kMinus:
+                    case Token::kNot:
+                    case Token::kQuestion:
+                    case Token::kStar:
+                        consume();
+                        push(Frame::kPrefix, operatorInfo(token).prefix_bp).op = token;
+                        break;
+                    case Token::kAnd: {
+                        consume();
+                        Frame& frame = push(Frame::kPrefix, operatorInfo(token).prefix_bp);
+                        frame.op = token;
+                        if (peek() == Token::kAnd) {
+                            frame.is_double = true;
+                            consume();
+                        }
+                        if (peek() == Token::kMut) {
+                            frame.is_mutable = true;
+                            consume();
+                        }
+                        break;
+                    }
+                    case Token::kReturn:
+                    case Token::kBreak: {
+                        consume();
+                        Token next = peek();
+                        if (next != Token::kSemi && next != Token::kRCurly && next != Token::kEOF) {
+                            push(Frame::kPrefix, 0).op = token;
+                            break;
+                        }
+                        if (token == Token::kReturn) {
+                            value = make<ReturnExpression>(nullptr);
+                        } else {
+                            value = make<BreakExpression>(nullptr);
+                        }
+                        state = State::kInfix;
+                        break;
+                    }
+                    default:
+                        value = parsePrattPrefix();
+                        state = State::kInfix;
+                        break;
+                }
+                break;
+            }
+
+            case State::kInfix: {
+                Token next_token = peek();
+                const OperatorInfo& info = operatorInfo(next_token);
+                // Closing delimiters have no binding power and always end the operand
+                if (info.left_bp <= stack.back().bp) {
+                    state = State::kReduce;
+                    break;
+                }
+                switch (info.has_node ? info.node : NodeKind::kBinaryExpression) {
+                    case NodeKind::kCallExpression:
+                        consume();
+                        state = beginCall(nullptr);
+                        break;
+                    case NodeKind::kIndexExpression:
+                        consume();
+                        push(Frame::kIndex, 0).lhs = value;
+                        state = State::kOperand;
+                        break;
+                    case NodeKind::kFieldExpression: {
+                        // `. PathIdentSegment (` is a method call, anything else is a field access
+                        Token segment = peek(1);
+                        if ((segment == Token::kIdentifier || segment == Token::kSelf || segment == Token::kSelf_)
+                            && peek(2) == Token::kLParenthese) {
+                            consume();
+                            auto method = parsePathIdentSegment();
+                            match(Token::kLParenthese);
+                            state = beginCall(method);
+                        } else {
+                            value = parseFieldExpressionFromInfix(value);
+                        }
+                        break;
+                    }
+                    case NodeKind::kTypeCastExpression: {
+                        consume();
+                        auto type = parseType();
+                        value = parseTypeCastExpression(value, type);
+                        break;
+                    }
+                    default: {
+                        // Assignment and binary operators: the right operand is parsed next
+                        consume();
+                        Frame& frame = push(Frame::kBinary, info.right_bp);
+                        frame.op = next_token;
+                        frame.info = &info;
+                        frame.lhs = value;
+                        state = State::kOperand;
+                        break;
+                    }
+                }
+                break;
+            }
+
+            case State::kReduce: {
+                Frame& frame = stack.back();
+                switch (frame.kind) {
+                    case Frame::kRoot:
+                        return value;
+                    case Frame::kBinary:
+                        value = parseInfixExpression(*frame.info, frame.lhs, value);
+                        pop();
+                        state = State::kInfix;
+                        break;
+                    case Frame::kPrefix:
+                        switch (frame.op) {
+                            case Token::kMinus:
+                                value = make<UnaryExpression>(UnaryExpression::MINUS, value);
+                                break;
+                            case Token::kNot:
+                                value = make<UnaryExpression>(UnaryExpression::NOT, value);
+                                break;
+                            case Token::kQuestion:
+                                value = make<UnaryExpression>(UnaryExpression::TRY, value);
+                                break;
+                            case Token::kStar:
+                                value = make<DereferenceExpression>(value);
+                                break;
+                            case Token::kAnd:
+                                value = make<BorrowExpression>(frame.is_double, frame.is_mutable, value);
+                                break;
+                            case Token::kReturn:
+                                value = make<ReturnExpression>(value);
+                                break;
+                            default:
+                                value = make<BreakExpression>(value);
+                                break;
+                        }
+                        pop();
+                        state = State::kInfix;
+                        break;
+                    case Frame::kGroup:
+                        match(Token::kRParenthese);
+                        value = make<GroupedExpression>(value);
+                        pop();
+                        state = State::kInfix;
+                        break;
+                    case Frame::kCondition: {
+                        match(Token::kRParenthese);
+                        Condition* condition = make<Condition>(value);
+                        pop();
+                        stack.back().condition = condition;
+                        state = beginBlock();
+                        break;
+                    }
+                    case Frame::kStatement:
+                        pop();
+                        if (peek() != Token::kSemi) {
+                            // An expression without `;` ends the block as its final expression
+                            block_statements.push_back(value);
+                            state = finishBlock();
+                        } else {
+                            consume();
+                            auto statement = make<ExpressionStatement>(value, true);
+                            block_statements.push_back(make<Statement>(statement));
+                            state = State::kStatement;
+                        }
+                        break;
+                    case Frame::kLet: {
+                        match(Token::kSemi);
+                        auto let_statement = make<LetStatement>(frame.pattern, frame.type, value);
+                        pop();
+                        block_statements.push_back(make<Statement>(let_statement));
+                        state = State::kStatement;
+                        break;
+                    }
+                    case Frame::kBlockBody: {
+                        if (isExpressionWithBlock(value)) {
+                            throw std::runtime_error(std::string("parse failed! ExpressionWithBlock not allowed in ExpressionWithoutBlock context") + location());
+                        }
+                        auto statements = make<Statements>(std::vector<ASTNode*>{value});
+                        match(Token::kRCurly);
+                        value = remember(MemoRule::kBlockExpression, frame.start, make<BlockExpression>(statements));
+                        pop();
+                        state = State::kWithBlock;
+                        break;
+                    }
+                    case Frame::kCall: {
+                        if (frame.maybe_group && peek() == Token::kRParenthese) {
+                            // A single parenthesized expression: the block ends its own statement
+                            consume();
+                            auto statement = make<ExpressionStatement>(frame.lhs, false);
+                            block_statements.push_back(make<Statement>(statement));
+                            value = make<GroupedExpression>(value);
+                            pop();
+                            state = State::kInfix;
+                            break;
+                        }
+                        frame.maybe_group = false;
+                        list_elements.push_back(value);
+                        if (peek() == Token::kComma) {
+                            consume();
+                            // A trailing comma may end the arguments
+                            if (peek() != Token::kRParenthese) {
+                                state = State::kOperand;
+                                break;
+                            }
+                        }
+                        auto params = make<CallParams>(takeElements.operator()<Expression>());
+                        match(Token::kRParenthese);
+                        if (frame.part) {
+                            value = make<MethodCallExpression>(frame.lhs, cast<PathIdentSegment>(frame.part), params);
+                        } else {
+                            value = make<CallExpression>(frame.lhs, params);
+                        }
+                        pop();
+                        state = State::kInfix;
+                        break;
+                    }
+                    case Frame::kIndex:
+                        match(Token::kRSquare);
+                        value = make<IndexExpression>(frame.lhs, value);
+                        pop();
+                        state = State::kInfix;
+                        break;
+                    case Frame::kArray: {
+                        list_elements.push_back(value);
+                        if (frame.is_repeat) {
+                            // `[value; length]` ends after the length
+                        } else if (list_elements.size() == frame.elements + 1 && peek() == Token::kSemi) {
+                            consume();
+                            frame.is_repeat = true;
+                            state = State::kOperand;
+                            break;
+                        } else if (peek() == Token::kComma) {
+                            consume();
+                            if (peek() != Token::kRSquare) {
+                                state = State::kOperand;
+                                break;
+                            }
+                        }
+                        auto elements = make<ArrayElements>(takeElements.operator()<Expression>(), frame.is_repeat);
+                        match(Token::kRSquare);
+                        value = make<ArrayExpression>(elements);
+                        pop();
+                        state = State::kInfix;
+                        break;
+                    }
+                    case Frame::kStructField: {
+                        list_elements.push_back(make<StructExprField>(frame.field, value));
+                        if (peek() == Token::kComma) {
+                            consume();
+                            if (peek() != Token::kRCurly) {
+                                state = beginField();
+                                break;
+                            }
+                        }
+                        auto fields = make<StructExprFields>(takeElements.operator()<StructExprField>());
+                        match(Token::kRCurly);
+                        value = make<StructExpression>(cast<PathInExpression>(frame.part), fields);
+                        pop();
+                        state = State::kInfix;
+                        break;
+                    }
+                    default:
+                        // Blocks, ifs and loops only take finished block-like expressions
+                        assert(false && "frame has no pending operand");
+                        break;
+                }
+                break;
+            }
+
+            case State::kWithBlock: {
+                Frame& frame = stack.back();
+                switch (frame.kind) {
+                    case Frame::kBlock: {
+                        Token next = peek();
+                        if (next == Token::kLParenthese) {
+                            // `{} ()` and `{} (a, b)` call the block; `{} (a)` stays a new statement
+                            push(Frame::kStatement, 0);
+                            consume();
+                            state = beginCall(nullptr);
+                            if (state == State::kOperand) stack.back().maybe_group = true;
+                            break;
+                        }
+                        if (!startsExpression(next) && operatorInfo(next).left_bp > 0) {
+                            // No statement starts here, so the block-like expression is the
+                            // operand of a longer one, e.g. `{ {1} as i32 }`
+                            push(Frame::kStatement, 0);
+                            state = State::kInfix;
+                            break;
+                        }
+                        // A block-like expression statement needs no `;`
+                        bool has_semi = false;
+                        if (peek() == Token::kSemi) {
+                            consume();
+                            has_semi = true;
+                        }
+                        auto statement = make<ExpressionStatement>(value, has_semi);
+                        block_statements.push_back(make<Statement>(statement));
+                        state = State::kStatement;
+                        break;
+                    }
+                    case Frame::kIf: {
+                        Expression* else_branch = nullptr;
+                        if (!frame.then_block) {
+                            frame.then_block = cast<BlockExpression>(value);
+                            if (peek() == Token::kElse) {
+                                consume();
+                                state = peek() == Token::kIf ? beginIf() : beginBlock();
+                                break;
+                            }
+                        } else {
+                            else_branch = value;
+                        }
+                        value = remember(MemoRule::kIfExpression, frame.start,
+                                         make<IfExpression>(frame.condition, frame.then_block, else_branch));
+                        pop();
+                        break;
+                    }
+                    case Frame::kLoop: {
+                        auto block = cast<BlockExpression>(value);
+                        ASTNode* child = nullptr;
+                        if (frame.op == Token::kLoop) {
+                            child = make<InfiniteLoopExpression>(block);
+                        } else {
+                            child = make<PredicateLoopExpression>(frame.condition, block);
+                        }
+                        value = remember(MemoRule::kLoopExpression, frame.start, make<LoopExpression>(child));
+                        pop();
+                        break;
+                    }
+                    case Frame::kRoot:
+                        if (with_block) {
+                            return value;
+                        }
+                        state = State::kInfix;
+                        break;
+                    default:
+                        // An operand that happens to be block-like, e.g. `{ 1 } + 2` after `=`
+                        state = State::kInfix;
+                        break;
+                }
+                break;
+            }
+
+            case State::kStatement: {
+                Token token = peek();
+                stack.back().statement = pos;
+                if (token == Token::kRCurly || token == Token::kEOF) {
+                    state = finishBlock();
+                } else if (token == Token::kSemi || startsItem(token)) {
+                    auto statement = parseStatement();
+                    block_statements.push_back(statement);
+                } else if (token == Token::kLet) {
+                    match(Token::kLet);
+                    auto pattern = parsePatternNoTopAlt();
+                    match(Token::kColon);
+                    auto type = parseType();
+                    match(Token::kEq);
+                    Frame& frame = push(Frame::kLet, 0);
+                    frame.pattern = pattern;
+                    frame.type = type;
+                    state = State::kOperand;
+                } else if (!startsExpression(token)) {
+                    state = finishBlock();
+                } else if (token == Token::kIf || token == Token::kWhile || token == Token::kLoop || token == Token::kLCurly) {
+                    state = State::kOperand;
+                } else {
+                    push(Frame::kStatement, 0);
+                    state = State::kOperand;
+                }
+                break;
+            }
+        }
+      } catch (const std::runtime_error& error) {
+        if (!recovery) throw;
+        // Resume in the innermost block of this call; without one the caller recovers
+        size_t block = stack.size();
+        while (block > release.frames && stack[block - 1].kind != Frame::kBlock
+               && stack[block - 1].kind != Frame::kBlockBody) {
+            --block;
+        }
+        if (block == release.frames) throw;
+        for (size_t i = block; i < stack.size(); ++i) {
+            if (stack[i].kind == Frame::kBlock || stack[i].kind == Frame::kBlockBody) {
+                block_statements.resize(stack[i].statements);
+                break;
+            }
+        }
+        for (size_t i = block; i < stack.size(); ++i) {
+            if (stack[i].kind == Frame::kCall || stack[i].kind == Frame::kArray || stack[i].kind == Frame::kStructField) {
+                list_elements.resize(stack[i].elements);
+                break;
+            }
+        }
+        stack.resize(block);
+        Frame& frame = stack.back();
+        if (frame.kind == Frame::kBlockBody) {
+            // The body was being read again as one expression; carry on with statements from here
+            frame.kind = Frame::kBlock;
+            frame.has_body = true;
+            frame.statements = block_statements.size();
+            frame.statement = frame.body;
+        }
+        frame.recovered = true;
+        block_statements.push_back(report(error));
+        skipStatement(frame.statement);
+        state = State::kStatement;
+      }
     }
-    
-    try {
-        match(Token::kRCurly);
-    } catch (...) {
-        // std::cerr << "we are here!" << std::endl;
-        pos = tmp;
-        std::vector<std::shared_ptr<ASTNode>> vec;
-        vec.push_back(std::move(parseExpressionWithoutBlock()));
-        statements = std::make_shared<Statements>(std::move(vec));
-        match(Token::kRCurly);
+}
+
+BlockExpression* Parser::parseBlockExpression() {
+    // Anything other than `{` is reported as a missing `{`
+    if (peek() != Token::kLCurly) {
+        match(Token::kLCurly);
     }
-    
-    return std::make_shared<BlockExpression>(std::move(statements));
+    return cast<BlockExpression>(parseNested(0, true));
 }
 
-std::shared_ptr<PatternNoTopAlt> Parser::parsePatternNoTopAlt() {
+PatternNoTopAlt* Parser::parsePatternNoTopAlt() {
     // PatternNoTopAlt → IdentifierPattern | ReferencePattern
     // std::cerr << "PatternNoTopAlt:" << std::endl;
 
-    try {
+    size_t ahead = 0;
+    if (peek(ahead) == Token::kRef) ++ahead;
+    if (peek(ahead) == Token::kMut) ++ahead;
+    if (peek(ahead) == Token::kIdentifier) {
         auto pattern = parseIdentifierPattern();
-        return std::make_shared<PatternNoTopAlt>(std::move(pattern));
-    } catch (...) {
-        auto pattern = parseReferencePattern();
-        return std::make_shared<PatternNoTopAlt>(std::move(pattern));
+        return make<PatternNoTopAlt>(std::move(pattern));
     }
+    // A leading `ref`/`mut` without an identifier is skipped, as before
+    pos += ahead;
+    auto pattern = parseReferencePattern();
+    return make<PatternNoTopAlt>(std::move(pattern));
 }
 
-std::shared_ptr<IdentifierPattern> Parser::parseIdentifierPattern() {
+IdentifierPattern* Parser::parseIdentifierPattern() {
     // std::cerr << "IdentifierPattern" << std::endl;
     // IdentifierPattern → `ref`? `mut`? IDENTIFIER
     bool is_ref = false;
     bool is_mutable = false;
-    std::string identifier;
+    Name identifier;
     
     // Check for 'ref'
     if (peek() == Token::kRef) {
@@ -1033,17 +1636,17 @@ std::shared_ptr<IdentifierPattern> Parser::parseIdentifierPattern() {
     
     // Expect identifier
     if (peek() == Token::kIdentifier) {
-        identifier = get_string();
+        identifier = get_name();
         // std::cerr << "IDENTIFIER: " << identifier << std::endl;
         consume(); // consume identifier
     } else {
-        throw std::runtime_error("parse failed! Expected identifier in pattern");
+        throw std::runtime_error(std::string("parse failed! Expected identifier in pattern") + location());
     }
     
-    return std::make_shared<IdentifierPattern>(is_ref, is_mutable, std::move(identifier));
+    return make<IdentifierPattern>(is_ref, is_mutable, std::move(identifier));
 }
 
-std::shared_ptr<ReferencePattern> Parser::parseReferencePattern() {
+ReferencePattern* Parser::parseReferencePattern() {
     // ReferencePattern → ( `&` | `&&` ) `mut`? PatternNoTopAlt
     
     size_t tmp = pos;
@@ -1070,35 +1673,29 @@ std::shared_ptr<ReferencePattern> Parser::parseReferencePattern() {
     
     auto pattern = parsePatternNoTopAlt();
     if (!pattern) {
-        throw std::runtime_error("parse failed! Expected pattern after reference");
+        throw std::runtime_error(std::string("parse failed! Expected pattern after reference") + location());
     }
     
-    return std::make_shared<ReferencePattern>(is_double, is_mutable, std::move(pattern));
+    return make<ReferencePattern>(is_double, is_mutable, std::move(pattern));
 }
 
-std::shared_ptr<Type> Parser::parseType() {
+Type* Parser::parseType() {
     // std::cerr << "Type:" << std::endl;
     // Type → PathIdentSegment | ReferenceType | ArrayType | UnitType
-    std::shared_ptr<ASTNode> child;
+    ASTNode* child = nullptr;
     
     // Try UnitType first: `(` `)`
-    if (peek() == Token::kLParenthese) {
-        size_t tmp = pos;
-        consume();
-        if (peek() == Token::kRParenthese) {
-            consume();
-            child = std::make_shared<UnitType>();
-            return std::make_shared<Type>(std::move(child));
-        } else {
-            pos = tmp; // backtrack
-        }
+    if (peek() == Token::kLParenthese && peek(1) == Token::kRParenthese) {
+        pos += 2;
+        child = make<UnitType>();
+        return make<Type>(std::move(child));
     }
     
     // Try ReferenceType: `&` `mut`? Type
     if (peek() == Token::kAnd) {
         child = parseReferenceType();
         if (child) {
-            return std::make_shared<Type>(std::move(child));
+            return make<Type>(std::move(child));
         }
     }
     
@@ -1106,21 +1703,21 @@ std::shared_ptr<Type> Parser::parseType() {
     if (peek() == Token::kLSquare) {
         child = parseArrayType();
         if (child) {
-            return std::make_shared<Type>(std::move(child));
+            return make<Type>(std::move(child));
         }
     }
     // std::cerr << "parsePathIdentSegment?" << std::endl;
     // Try PathIdentSegment
     child = parsePathIdentSegment();
     if (child) {
-        return std::make_shared<Type>(std::move(child));
+        return make<Type>(std::move(child));
     }
     
-    throw std::runtime_error("parse type failed!");
+    throw std::runtime_error(std::string("parse type failed!") + location());
     return nullptr;
 }
 
-std::shared_ptr<ReferenceType> Parser::parseReferenceType() {
+ReferenceType* Parser::parseReferenceType() {
     // ReferenceType → `&` `mut`? Type
     if (peek() != Token::kAnd) {
         return nullptr;
@@ -1136,13 +1733,13 @@ std::shared_ptr<ReferenceType> Parser::parseReferenceType() {
     
     auto type = parseType();
     if (!type) {
-        throw std::runtime_error("parse failed! Expected type after reference");
+        throw std::runtime_error(std::string("parse failed! Expected type after reference") + location());
     }
     
-    return std::make_shared<ReferenceType>(is_mutable, std::move(type));
+    return make<ReferenceType>(is_mutable, std::move(type));
 }
 
-std::shared_ptr<ArrayType> Parser::parseArrayType() {
+ArrayType* Parser::parseArrayType() {
     // ArrayType → `[` Type `;` Expression `]`
     if (peek() != Token::kLSquare) {
         return nullptr;
@@ -1152,28 +1749,28 @@ std::shared_ptr<ArrayType> Parser::parseArrayType() {
     
     auto type = parseType();
     if (!type) {
-        throw std::runtime_error("parse failed! Expected type in array type");
+        throw std::runtime_error(std::string("parse failed! Expected type in array type") + location());
     }
     
     if (peek() != Token::kSemi) {
-        throw std::runtime_error("parse failed! Expected ';' in array type");
+        throw std::runtime_error(std::string("parse failed! Expected ';' in array type") + location());
     }
     consume(); // consume ';'
     
-    auto expression = std::dynamic_pointer_cast<Expression>(parseExpression());
+    auto expression = parseExpression();
     if (!expression) {
-        throw std::runtime_error("parse failed! Expected expression in array type");
+        throw std::runtime_error(std::string("parse failed! Expected expression in array type") + location());
     }
     
     if (peek() != Token::kRSquare) {
-        throw std::runtime_error("parse failed! Expected ']' in array type");
+        throw std::runtime_error(std::string("parse failed! Expected ']' in array type") + location());
     }
     consume(); // consume ']'
     
-    return std::make_shared<ArrayType>(std::move(type), std::move(expression));
+    return make<ArrayType>(std::move(type), std::move(expression));
 }
 
-std::shared_ptr<UnitType> Parser::parseUnitType() {
+UnitType* Parser::parseUnitType() {
     // UnitType → `(` `)`
     if (peek() != Token::kLParenthese) {
         return nullptr;
@@ -1182,15 +1779,16 @@ std::shared_ptr<UnitType> Parser::parseUnitType() {
     consume(); // consume '('
     
     if (peek() != Token::kRParenthese) {
-        throw std::runtime_error("parse failed! Expected ')' for unit type");
+        throw std::runtime_error(std::string("parse failed! Expected ')' for unit type") + location());
     }
     consume(); // consume ')'
     
-    return std::make_shared<UnitType>();
+    return make<UnitType>();
 }
 
-std::shared_ptr<PathInExpression> Parser::parsePathInExpression() {
-    std::shared_ptr<PathIdentSegment> segment1, segment2;
+PathInExpression* Parser::parsePathInExpression() {
+    PathIdentSegment* segment1 = nullptr;
+    PathIdentSegment* segment2 = nullptr;
     segment1 = std::move(parsePathIdentSegment());
     if (peek() == Token::kPathSep) {
         consume();
@@ -1198,143 +1796,98 @@ std::shared_ptr<PathInExpression> Parser::parsePathInExpression() {
     } else {
         segment2 = nullptr;
     }
-    return std::make_shared<PathInExpression>(std::move(segment1), std::move(segment2));
+    return make<PathInExpression>(std::move(segment1), std::move(segment2));
 }
 
-std::shared_ptr<PathIdentSegment> Parser::parsePathIdentSegment() {
+PathIdentSegment* Parser::parsePathIdentSegment() {
     // std::cerr << "PathIdentSegment:" << std::endl;
     // std::cerr << pos << std::endl;
     if (peek() == Token::kIdentifier) {
-        std::string identifier = get_string();
+        Name identifier = get_name();
         // std::cerr << "IDENTIFIER: " << identifier << std::endl;
         consume();
-        return std::make_shared<PathIdentSegment>(0, std::move(identifier));
+        return make<PathIdentSegment>(0, std::move(identifier));
     } else if (peek() == Token::kSelf) {
         consume();
-        return std::make_shared<PathIdentSegment>(1, "self");
+        return make<PathIdentSegment>(1, names::kSelfValue);
     } else if (peek() == Token::kSelf_) {
         consume();
-        return std::make_shared<PathIdentSegment>(2, "Self");
+        return make<PathIdentSegment>(2, names::kSelfType);
     } else {
-        throw std::runtime_error("parse failed! Unexpected token in path ident segment");
+        throw std::runtime_error(std::string("parse failed! Unexpected token in path ident segment") + location());
     }
 }
 
 
-std::shared_ptr<CharLiteral> Parser::parseCharLiteral() {
-    std::string value = get_string();
+CharLiteral* Parser::parseCharLiteral() {
+    LiteralId value = tokens.literal(at(pos));
     consume();
-    return std::make_shared<CharLiteral>(std::move(value));
+    return make<CharLiteral>(value);
 }
 
-std::shared_ptr<StringLiteral> Parser::parseStringLiteral() {
-    std::string value = get_string();
+StringLiteral* Parser::parseStringLiteral() {
+    LiteralId value = tokens.literal(at(pos));
     consume();
-    return std::make_shared<StringLiteral>(std::move(value));
+    return make<StringLiteral>(value);
 }
 
-std::shared_ptr<RawStringLiteral> Parser::parseRawStringLiteral() {
-    std::string value = get_string();
+RawStringLiteral* Parser::parseRawStringLiteral() {
+    LiteralId value = tokens.literal(at(pos));
     consume();
-    return std::make_shared<RawStringLiteral>(std::move(value));
+    return make<RawStringLiteral>(value);
 }
 
-std::shared_ptr<CStringLiteral> Parser::parseCStringLiteral() {
-    std::string value = get_string();
+CStringLiteral* Parser::parseCStringLiteral() {
+    LiteralId value = tokens.literal(at(pos));
     consume();
-    return std::make_shared<CStringLiteral>(std::move(value));
+    return make<CStringLiteral>(value);
 }
 
-std::shared_ptr<RawCStringLiteral> Parser::parseRawCStringLiteral() {
-    std::string value = get_string();
+RawCStringLiteral* Parser::parseRawCStringLiteral() {
+    LiteralId value = tokens.literal(at(pos));
     consume();
-    return std::make_shared<RawCStringLiteral>(std::move(value));
+    return make<RawCStringLiteral>(value);
 }
 
-std::shared_ptr<IntegerLiteral> Parser::parseIntegerLiteral() {
-    std::string value = get_string();
+IntegerLiteral* Parser::parseIntegerLiteral() {
+    std::string value(get_string());
+    IntegerValue decoded = tokens.integer(at(pos));
     consume();
-    return std::make_shared<IntegerLiteral>(std::move(value));
+    return make<IntegerLiteral>(std::move(value), decoded);
 }
 
-std::shared_ptr<BoolLiteral> Parser::parseBoolLiteral() {
+BoolLiteral* Parser::parseBoolLiteral() {
     if (peek() == Token::kTrue) {
         consume();
-        return std::make_shared<BoolLiteral>(true);
+        return make<BoolLiteral>(true);
     } else if (peek() == Token::kFalse) {
         consume();
-        return std::make_shared<BoolLiteral>(false);
+        return make<BoolLiteral>(false);
     } else {
-        throw std::runtime_error("parse failed! Expected boolean literal");
+        throw std::runtime_error(std::string("parse failed! Expected boolean literal") + location());
     }
 }
 
-std::shared_ptr<Condition> Parser::parseCondition() {
+Condition* Parser::parseCondition() {
     // std::cerr << "Condition:" << std::endl;
     // std::cerr << pos << ' ' << tokenToString(peek()) << std::endl;
     match(Token::kLParenthese);
-    std::shared_ptr<Expression> expression = std::move(parseExpression());
-    
-    // Check if expression is StructExpression (should not be allowed)
-    // StructExpression can only be ExpressionWithoutBlock
-    if (expression) {
-        // For ExpressionWithoutBlock
-        if (auto expr_without_block = std::dynamic_pointer_cast<ExpressionWithoutBlock>(expression)) {
-            if (expr_without_block->child) {
-                if (std::dynamic_pointer_cast<StructExpression>(expr_without_block->child)) {
-                    throw std::runtime_error("parse failed! StructExpression not allowed in if condition");
-                }
-            }
-        }
-        // For direct Expression types (including StructExpression)
-        else if (std::dynamic_pointer_cast<StructExpression>(expression)) {
-            throw std::runtime_error("parse failed! StructExpression not allowed in if condition");
-        }
-    }
+    // The condition is parenthesized, so a struct expression such as `(b { x: 1 })` is accepted
+    Expression* expression = std::move(parseExpression());
     match(Token::kRParenthese);
-    return std::make_shared<Condition>(std::move(expression));
+    return make<Condition>(std::move(expression));
 }
 
-std::shared_ptr<IfExpression> Parser::parseIfExpression() {
-    // std::cerr << "IfExpression!" << std::endl;
-    std::shared_ptr<Condition> condition;
-    std::shared_ptr<BlockExpression> then_block;
-    std::shared_ptr<Expression> else_branch = nullptr;
-    
-    match(Token::kIf);
-
-    // std::cerr << "?" << std::endl;
-    
-    // Parse condition
-    condition = std::move(parseCondition());
-
-    // std::cerr << "Condition matched!" << std::endl;
-    
-    // Parse then block
-    then_block = std::move(parseBlockExpression());
-
-    // std::cerr << "BlockExpression matched!" << std::endl;
-    
-    // Parse optional else branch
-    if (peek() == Token::kElse) {
-        consume();
-        if (peek() == Token::kIf) {
-            // else if - parse another IfExpression
-            else_branch = std::move(parseIfExpression());
-        } else {
-            // else block - parse BlockExpression
-            else_branch = std::move(parseBlockExpression());
-        }
+IfExpression* Parser::parseIfExpression() {
+    if (peek() != Token::kIf) {
+        match(Token::kIf);
     }
-    
-    return std::make_shared<IfExpression>(std::move(condition),
-                                       std::move(then_block),
-                                       std::move(else_branch));
+    return cast<IfExpression>(parseNested(0, true));
 }
 
-std::shared_ptr<ReturnExpression> Parser::parseReturnExpression() {
+ReturnExpression* Parser::parseReturnExpression() {
     // std::cerr << "ReturnExpression!" << std::endl;
-    std::shared_ptr<Expression> expression = nullptr;
+    Expression* expression = nullptr;
     
     match(Token::kReturn);
     
@@ -1343,46 +1896,39 @@ std::shared_ptr<ReturnExpression> Parser::parseReturnExpression() {
         expression = std::move(parseExpression());
     }
     
-    return std::make_shared<ReturnExpression>(std::move(expression));
+    return make<ReturnExpression>(std::move(expression));
 }
 
 // Loop expressions
-std::shared_ptr<LoopExpression> Parser::parseLoopExpression() {
-    std::shared_ptr<ASTNode> child;
-    
-    if (peek() == Token::kLoop) {
-        child = std::move(parseInfiniteLoopExpression());
-    } else if (peek() == Token::kWhile) {
-        child = std::move(parsePredicateLoopExpression());
-    } else {
-        throw std::runtime_error("parse failed! Expected 'loop' or 'while'");
+LoopExpression* Parser::parseLoopExpression() {
+    if (peek() != Token::kLoop && peek() != Token::kWhile) {
+        throw std::runtime_error(std::string("parse failed! Expected 'loop' or 'while'") + location());
     }
-    
-    return std::make_shared<LoopExpression>(std::move(child));
+    return cast<LoopExpression>(parseNested(0, true));
 }
 
-std::shared_ptr<InfiniteLoopExpression> Parser::parseInfiniteLoopExpression() {
-    std::shared_ptr<BlockExpression> block_expression;
+InfiniteLoopExpression* Parser::parseInfiniteLoopExpression() {
+    BlockExpression* block_expression = nullptr;
     
     match(Token::kLoop);
     block_expression = std::move(parseBlockExpression());
     
-    return std::make_shared<InfiniteLoopExpression>(std::move(block_expression));
+    return make<InfiniteLoopExpression>(std::move(block_expression));
 }
 
-std::shared_ptr<PredicateLoopExpression> Parser::parsePredicateLoopExpression() {
-    std::shared_ptr<Condition> condition;
-    std::shared_ptr<BlockExpression> block_expression;
+PredicateLoopExpression* Parser::parsePredicateLoopExpression() {
+    Condition* condition = nullptr;
+    BlockExpression* block_expression = nullptr;
     
     match(Token::kWhile);
     condition = std::move(parseCondition());
     block_expression = std::move(parseBlockExpression());
     
-    return std::make_shared<PredicateLoopExpression>(std::move(condition), std::move(block_expression));
+    return make<PredicateLoopExpression>(std::move(condition), std::move(block_expression));
 }
 
-std::shared_ptr<BreakExpression> Parser::parseBreakExpression() {
-    std::shared_ptr<Expression> expression = nullptr;
+BreakExpression* Parser::parseBreakExpression() {
+    Expression* expression = nullptr;
     
     match(Token::kBreak);
     
@@ -1391,27 +1937,27 @@ std::shared_ptr<BreakExpression> Parser::parseBreakExpression() {
         expression = std::move(parseExpression());
     }
     
-    return std::make_shared<BreakExpression>(std::move(expression));
+    return make<BreakExpression>(std::move(expression));
 }
 
-std::shared_ptr<ContinueExpression> Parser::parseContinueExpression() {
+ContinueExpression* Parser::parseContinueExpression() {
     match(Token::kContinue);
-    return std::make_shared<ContinueExpression>();
+    return make<ContinueExpression>();
 }
 
 // Array and grouped expressions
-std::shared_ptr<GroupedExpression> Parser::parseGroupedExpression() {
-    std::shared_ptr<Expression> expression;
+GroupedExpression* Parser::parseGroupedExpression() {
+    Expression* expression = nullptr;
     
     match(Token::kLParenthese);
     expression = std::move(parseExpression());
     match(Token::kRParenthese);
     
-    return std::make_shared<GroupedExpression>(std::move(expression));
+    return make<GroupedExpression>(std::move(expression));
 }
 
-std::shared_ptr<ArrayExpression> Parser::parseArrayExpression() {
-    std::shared_ptr<ArrayElements> array_elements = nullptr;
+ArrayExpression* Parser::parseArrayExpression() {
+    ArrayElements* array_elements = nullptr;
     
     match(Token::kLSquare);
     
@@ -1422,11 +1968,11 @@ std::shared_ptr<ArrayExpression> Parser::parseArrayExpression() {
     
     match(Token::kRSquare);
     
-    return std::make_shared<ArrayExpression>(std::move(array_elements));
+    return make<ArrayExpression>(std::move(array_elements));
 }
 
-std::shared_ptr<ArrayElements> Parser::parseArrayElements() {
-    std::vector<std::shared_ptr<Expression>> expressions;
+ArrayElements* Parser::parseArrayElements() {
+    std::vector<Expression*> expressions;
     
     // Parse first expression
     expressions.push_back(std::move(parseExpression()));
@@ -1442,7 +1988,7 @@ std::shared_ptr<ArrayElements> Parser::parseArrayElements() {
         //     consume();
         // }
         
-        return std::make_shared<ArrayElements>(std::move(expressions), true);
+        return make<ArrayElements>(std::move(expressions), true);
     } else {
         // Comma separated: Expression ( , Expression )* ,?
         while (peek() == Token::kComma) {
@@ -1451,13 +1997,13 @@ std::shared_ptr<ArrayElements> Parser::parseArrayElements() {
             expressions.push_back(std::move(parseExpression()));
         }
         
-        return std::make_shared<ArrayElements>(std::move(expressions), false);
+        return make<ArrayElements>(std::move(expressions), false);
     }
 }
 
-std::shared_ptr<IndexExpression> Parser::parseIndexExpression() {
-    std::shared_ptr<Expression> base_expression;
-    std::shared_ptr<Expression> index_expression;
+IndexExpression* Parser::parseIndexExpression() {
+    Expression* base_expression = nullptr;
+    Expression* index_expression = nullptr;
     
     // Parse the base expression
     base_expression = std::move(parseExpression());
@@ -1467,24 +2013,24 @@ std::shared_ptr<IndexExpression> Parser::parseIndexExpression() {
     index_expression = std::move(parseExpression());
     match(Token::kRSquare);
     
-    return std::make_shared<IndexExpression>(std::move(base_expression), std::move(index_expression));
+    return make<IndexExpression>(std::move(base_expression), std::move(index_expression));
 }
 
-std::shared_ptr<IndexExpression> Parser::parseIndexExpressionFromInfix(std::shared_ptr<Expression> lhs) {
-    std::shared_ptr<Expression> index_expression;
+IndexExpression* Parser::parseIndexExpressionFromInfix(Expression* lhs) {
+    Expression* index_expression = nullptr;
     
     // Parse the index part [ Expression ]
     match(Token::kLSquare);
     index_expression = std::move(parseExpression());
     match(Token::kRSquare);
     
-    return std::make_shared<IndexExpression>(std::move(lhs), std::move(index_expression));
+    return make<IndexExpression>(std::move(lhs), std::move(index_expression));
 }
 
 // Struct expressions
-std::shared_ptr<StructExpression> Parser::parseStructExpression() {
-    std::shared_ptr<PathInExpression> path_in_expression;
-    std::shared_ptr<StructExprFields> struct_expr_fields = nullptr;
+StructExpression* Parser::parseStructExpression() {
+    PathInExpression* path_in_expression = nullptr;
+    StructExprFields* struct_expr_fields = nullptr;
     
     // Parse the path
     path_in_expression = std::move(parsePathInExpression());
@@ -1496,11 +2042,11 @@ std::shared_ptr<StructExpression> Parser::parseStructExpression() {
     }
     match(Token::kRCurly);
     
-    return std::make_shared<StructExpression>(std::move(path_in_expression), std::move(struct_expr_fields));
+    return make<StructExpression>(std::move(path_in_expression), std::move(struct_expr_fields));
 }
 
-std::shared_ptr<StructExprFields> Parser::parseStructExprFields() {
-    std::vector<std::shared_ptr<StructExprField>> struct_expr_fields;
+StructExprFields* Parser::parseStructExprFields() {
+    std::vector<StructExprField*> struct_expr_fields;
     
     // Parse first field
     struct_expr_fields.push_back(std::move(parseStructExprField()));
@@ -1515,32 +2061,32 @@ std::shared_ptr<StructExprFields> Parser::parseStructExprFields() {
         struct_expr_fields.push_back(std::move(parseStructExprField()));
     }
     
-    return std::make_shared<StructExprFields>(std::move(struct_expr_fields));
+    return make<StructExprFields>(std::move(struct_expr_fields));
 }
 
-std::shared_ptr<StructExprField> Parser::parseStructExprField() {
-    std::string identifier;
-    std::shared_ptr<Expression> expression;
+StructExprField* Parser::parseStructExprField() {
+    Name identifier;
+    Expression* expression = nullptr;
     
     // Parse identifier
     if (peek() == Token::kIdentifier) {
-        identifier = get_string();
+        identifier = get_name();
         consume();
     } else {
-        throw std::runtime_error("parse failed! Expected identifier in struct field");
+        throw std::runtime_error(std::string("parse failed! Expected identifier in struct field") + location());
     }
     
     // Parse colon and expression
     match(Token::kColon);
     expression = std::move(parseExpression());
     
-    return std::make_shared<StructExprField>(std::move(identifier), std::move(expression));
+    return make<StructExprField>(std::move(identifier), std::move(expression));
 }
 
 // Call expressions
-std::shared_ptr<CallExpression> Parser::parseCallExpression() {
-    std::shared_ptr<Expression> expression;
-    std::shared_ptr<CallParams> call_params = nullptr;
+CallExpression* Parser::parseCallExpression() {
+    Expression* expression = nullptr;
+    CallParams* call_params = nullptr;
     
     // Parse the expression (function to call)
     expression = std::move(parseExpression());
@@ -1552,12 +2098,12 @@ std::shared_ptr<CallExpression> Parser::parseCallExpression() {
     }
     match(Token::kRParenthese);
     
-    return std::make_shared<CallExpression>(std::move(expression), std::move(call_params));
+    return make<CallExpression>(std::move(expression), std::move(call_params));
 }
 
-std::shared_ptr<CallExpression> Parser::parseCallExpressionFromInfix(std::shared_ptr<Expression> lhs) {
+CallExpression* Parser::parseCallExpressionFromInfix(Expression* lhs) {
     // std::cerr << "CallExpressionFromInfix:" << std::endl;
-    std::shared_ptr<CallParams> call_params = nullptr;
+    CallParams* call_params = nullptr;
     
     // Parse the call parameters
     match(Token::kLParenthese);
@@ -1567,11 +2113,11 @@ std::shared_ptr<CallExpression> Parser::parseCallExpressionFromInfix(std::shared
     }
     match(Token::kRParenthese);
     // std::cerr << "CallExpressionFromInfix done!" << std::endl;
-    return std::make_shared<CallExpression>(std::move(lhs), std::move(call_params));
+    return make<CallExpression>(std::move(lhs), std::move(call_params));
 }
 
-std::shared_ptr<CallParams> Parser::parseCallParams() {
-    std::vector<std::shared_ptr<Expression>> expressions;
+CallParams* Parser::parseCallParams() {
+    std::vector<Expression*> expressions;
     
     // Parse first expression
     expressions.push_back(std::move(parseExpression()));
@@ -1586,14 +2132,14 @@ std::shared_ptr<CallParams> Parser::parseCallParams() {
         expressions.push_back(std::move(parseExpression()));
     }
     
-    return std::make_shared<CallParams>(std::move(expressions));
+    return make<CallParams>(std::move(expressions));
 }
 
 // Method call, field, and path expressions
-std::shared_ptr<MethodCallExpression> Parser::parseMethodCallExpression() {
-    std::shared_ptr<Expression> expression;
-    std::shared_ptr<PathIdentSegment> path_ident_segment;
-    std::shared_ptr<CallParams> call_params = nullptr;
+MethodCallExpression* Parser::parseMethodCallExpression() {
+    Expression* expression = nullptr;
+    PathIdentSegment* path_ident_segment = nullptr;
+    CallParams* call_params = nullptr;
     
     // Parse the base expression
     expression = std::move(parseExpression());
@@ -1608,12 +2154,12 @@ std::shared_ptr<MethodCallExpression> Parser::parseMethodCallExpression() {
     }
     match(Token::kRParenthese);
     
-    return std::make_shared<MethodCallExpression>(std::move(expression), std::move(path_ident_segment), std::move(call_params));
+    return make<MethodCallExpression>(std::move(expression), std::move(path_ident_segment), std::move(call_params));
 }
 
-std::shared_ptr<MethodCallExpression> Parser::parseMethodCallExpressionFromInfix(std::shared_ptr<Expression> lhs) {
-    std::shared_ptr<PathIdentSegment> path_ident_segment;
-    std::shared_ptr<CallParams> call_params = nullptr;
+MethodCallExpression* Parser::parseMethodCallExpressionFromInfix(Expression* lhs) {
+    PathIdentSegment* path_ident_segment = nullptr;
+    CallParams* call_params = nullptr;
     
     // Parse the method call part: . PathIdentSegment ( CallParams? )
     match(Token::kDot);
@@ -1625,12 +2171,12 @@ std::shared_ptr<MethodCallExpression> Parser::parseMethodCallExpressionFromInfix
     }
     match(Token::kRParenthese);
     
-    return std::make_shared<MethodCallExpression>(std::move(lhs), std::move(path_ident_segment), std::move(call_params));
+    return make<MethodCallExpression>(std::move(lhs), std::move(path_ident_segment), std::move(call_params));
 }
 
-std::shared_ptr<FieldExpression> Parser::parseFieldExpression() {
-    std::shared_ptr<Expression> expression;
-    std::string identifier;
+FieldExpression* Parser::parseFieldExpression() {
+    Expression* expression = nullptr;
+    Name identifier;
     
     // Parse the base expression
     expression = std::move(parseExpression());
@@ -1638,41 +2184,41 @@ std::shared_ptr<FieldExpression> Parser::parseFieldExpression() {
     // Parse the field access part: . IDENTIFIER
     match(Token::kDot);
     if (peek() == Token::kIdentifier) {
-        identifier = get_string();
+        identifier = get_name();
         consume();
     } else {
-        throw std::runtime_error("parse failed! Expected identifier in field expression");
+        throw std::runtime_error(std::string("parse failed! Expected identifier in field expression") + location());
     }
     
-    return std::make_shared<FieldExpression>(std::move(expression), std::move(identifier));
+    return make<FieldExpression>(std::move(expression), std::move(identifier));
 }
 
-std::shared_ptr<FieldExpression> Parser::parseFieldExpressionFromInfix(std::shared_ptr<Expression> lhs) {
-    std::string identifier;
+FieldExpression* Parser::parseFieldExpressionFromInfix(Expression* lhs) {
+    Name identifier;
     
     // Parse the field access part: . IDENTIFIER
     match(Token::kDot);
     if (peek() == Token::kIdentifier) {
-        identifier = get_string();
+        identifier = get_name();
         consume();
     } else {
-        throw std::runtime_error("parse failed! Expected identifier in field expression");
+        throw std::runtime_error(std::string("parse failed! Expected identifier in field expression") + location());
     }
     
-    return std::make_shared<FieldExpression>(std::move(lhs), std::move(identifier));
+    return make<FieldExpression>(std::move(lhs), std::move(identifier));
 }
 
-std::shared_ptr<PathExpression> Parser::parsePathExpression() {
-    std::shared_ptr<PathInExpression> path_in_expression;
+PathExpression* Parser::parsePathExpression() {
+    PathInExpression* path_in_expression = nullptr;
     
     // Parse the path in expression
     path_in_expression = std::move(parsePathInExpression());
     
-    return std::make_shared<PathExpression>(std::move(path_in_expression));
+    return make<PathExpression>(std::move(path_in_expression));
 }
 
 // Unary expressions
-std::shared_ptr<UnaryExpression> Parser::parseUnaryExpression() {
+UnaryExpression* Parser::parseUnaryExpression() {
     Token token = peek();
     UnaryExpression::UnaryType type;
     
@@ -1687,16 +2233,16 @@ std::shared_ptr<UnaryExpression> Parser::parseUnaryExpression() {
             type = UnaryExpression::TRY;
             break;
         default:
-            throw std::runtime_error("parse failed! Expected unary operator");
+            throw std::runtime_error(std::string("parse failed! Expected unary operator") + location());
     }
     
     consume();
-    auto expression = std::dynamic_pointer_cast<Expression>(parsePrattExpression(getTokenUnaryBP(token)));
+    auto expression = parsePrattExpression(operatorInfo(token).prefix_bp);
     
-    return std::make_shared<UnaryExpression>(type, std::move(expression));
+    return make<UnaryExpression>(type, std::move(expression));
 }
 
-std::shared_ptr<BorrowExpression> Parser::parseBorrowExpression() {
+BorrowExpression* Parser::parseBorrowExpression() {
     // std::cerr << "BorrowExpression:" << std::endl;
     // std::cerr << pos << std::endl;
     bool is_double = false;
@@ -1710,7 +2256,7 @@ std::shared_ptr<BorrowExpression> Parser::parseBorrowExpression() {
             consume();
         }
     } else {
-        throw std::runtime_error("parse failed! Expected & for borrow expression");
+        throw std::runtime_error(std::string("parse failed! Expected & for borrow expression") + location());
     }
     
     // Check for mut keyword
@@ -1719,36 +2265,53 @@ std::shared_ptr<BorrowExpression> Parser::parseBorrowExpression() {
         consume();
     }
     
-    auto expression = std::dynamic_pointer_cast<Expression>(parsePrattExpression(getTokenUnaryBP(Token::kAnd)));
+    auto expression = parsePrattExpression(operatorInfo(Token::kAnd).prefix_bp);
     
-    return std::make_shared<BorrowExpression>(is_double, is_mutable, std::move(expression));
+    return make<BorrowExpression>(is_double, is_mutable, std::move(expression));
 }
 
-std::shared_ptr<DereferenceExpression> Parser::parseDereferenceExpression() {
+DereferenceExpression* Parser::parseDereferenceExpression() {
     if (peek() != Token::kStar) {
-        throw std::runtime_error("parse failed! Expected * for dereference expression");
+        throw std::runtime_error(std::string("parse failed! Expected * for dereference expression") + location());
     }
     
     consume();
-    auto expression = std::dynamic_pointer_cast<Expression>(parsePrattExpression(getTokenUnaryBP(Token::kStar)));
+    auto expression = parsePrattExpression(operatorInfo(Token::kStar).prefix_bp);
     
-    return std::make_shared<DereferenceExpression>(std::move(expression));
+    return make<DereferenceExpression>(std::move(expression));
 }
 
 // Binary and assignment expressions
-std::shared_ptr<AssignmentExpression> Parser::parseAssignmentExpression(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs) {
-    return std::make_shared<AssignmentExpression>(std::move(lhs), std::move(rhs));
+// Builds the node for `lhs op rhs` once the right operand has been parsed
+Expression* Parser::parseInfixExpression(const OperatorInfo& op, Expression* lhs, Expression* rhs) {
+    if (op.has_node) {
+        switch (op.node) {
+            case NodeKind::kAssignmentExpression:
+                return parseAssignmentExpression(lhs, rhs);
+            case NodeKind::kCompoundAssignmentExpression:
+                return parseCompoundAssignmentExpression(CompoundAssignmentExpression::CompoundAssignmentType(op.type), lhs, rhs);
+            case NodeKind::kBinaryExpression:
+                return parseBinaryExpression(BinaryExpression::BinaryType(op.type), lhs, rhs);
+            default:
+                break;
+        }
+    }
+    throw std::runtime_error(std::string("parse failed! Unexpected operator in infix expression") + location());
+}
+
+AssignmentExpression* Parser::parseAssignmentExpression(Expression* lhs, Expression* rhs) {
+    return make<AssignmentExpression>(std::move(lhs), std::move(rhs));
 }
 
-std::shared_ptr<CompoundAssignmentExpression> Parser::parseCompoundAssignmentExpression(CompoundAssignmentExpression::CompoundAssignmentType type, std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs) {
-    return std::make_shared<CompoundAssignmentExpression>(type, std::move(lhs), std::move(rhs));
+CompoundAssignmentExpression* Parser::parseCompoundAssignmentExpression(CompoundAssignmentExpression::CompoundAssignmentType type, Expression* lhs, Expression* rhs) {
+    return make<CompoundAssignmentExpression>(type, std::move(lhs), std::move(rhs));
 }
 
-std::shared_ptr<BinaryExpression> Parser::parseBinaryExpression(BinaryExpression::BinaryType type, std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs) {
-    return std::make_shared<BinaryExpression>(type, std::move(lhs), std::move(rhs));
+BinaryExpression* Parser::parseBinaryExpression(BinaryExpression::BinaryType type, Expression* lhs, Expression* rhs) {
+    return make<BinaryExpression>(type, std::move(lhs), std::move(rhs));
 }
 
 // Type cast expression
-std::shared_ptr<TypeCastExpression> Parser::parseTypeCastExpression(std::shared_ptr<Expression> expression, std::shared_ptr<Type> type) {
-    return std::make_shared<TypeCastExpression>(std::move(expression), std::move(type));
+TypeCastExpression* Parser::parseTypeCastExpression(Expression* expression, Type* type) {
+    return make<TypeCastExpression>(std::move(expression), std::move(type));
 }
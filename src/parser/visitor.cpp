@@ -1 +0,0 @@
-#include "parser/visitor.hpp"
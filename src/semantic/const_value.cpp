@@ -5,14 +5,14 @@
 
 
 // ConstValue 基类实现
-ConstValue::ConstValue(std::shared_ptr<ASTNode> node) : expression_node(node) {}
+ConstValue::ConstValue(ASTNode* node) : expression_node(node) {}
 
-std::shared_ptr<ASTNode> ConstValue::getExpressionNode() const {
+ASTNode* ConstValue::getExpressionNode() const {
     return expression_node;
 }
 
 // ConstValueInt 实现
-ConstValueInt::ConstValueInt(int value, std::shared_ptr<ASTNode> node) 
+ConstValueInt::ConstValueInt(int value, ASTNode* node) 
     : ConstValue(node), value(value) {}
 
 int ConstValueInt::getValue() const {
@@ -32,7 +32,7 @@ std::string ConstValueInt::toString() const {
 }
 
 // ConstValueBool 实现
-ConstValueBool::ConstValueBool(bool value, std::shared_ptr<ASTNode> node) 
+ConstValueBool::ConstValueBool(bool value, ASTNode* node) 
     : ConstValue(node), value(value) {}
 
 bool ConstValueBool::getValue() const {
@@ -52,7 +52,7 @@ std::string ConstValueBool::toString() const {
 }
 
 // ConstValueChar 实现
-ConstValueChar::ConstValueChar(char value, std::shared_ptr<ASTNode> node) 
+ConstValueChar::ConstValueChar(char value, ASTNode* node) 
     : ConstValue(node), value(value) {}
 
 char ConstValueChar::getValue() const {
@@ -74,15 +74,15 @@ std::string ConstValueChar::toString() const {
 }
 
 // ConstValueString 实现
-ConstValueString::ConstValueString(const std::string& value, std::shared_ptr<ASTNode> node) 
+ConstValueString::ConstValueString(LiteralId value, ASTNode* node) 
     : ConstValue(node), value(value) {}
 
 const std::string& ConstValueString::getValue() const {
-    return value;
+    return value.str();
 }
 
 void ConstValueString::setValue(const std::string& value) {
-    this->value = value;
+    this->value = LiteralId(value);
 }
 
 std::string ConstValueString::getValueType() const {
@@ -90,11 +90,11 @@ std::string ConstValueString::getValueType() const {
 }
 
 std::string ConstValueString::toString() const {
-    return "\"" + value + "\"";
+    return "\"" + value.str() + "\"";
 }
 
 // ConstValueStruct 实现
-ConstValueStruct::ConstValueStruct(const std::string& struct_name, std::shared_ptr<ASTNode> node) 
+ConstValueStruct::ConstValueStruct(const std::string& struct_name, ASTNode* node) 
     : ConstValue(node), struct_name(struct_name) {}
 
 const std::string& ConstValueStruct::getStructName() const {
@@ -145,7 +145,7 @@ std::string ConstValueStruct::toString() const {
 }
 
 // ConstValueEnum 实现
-ConstValueEnum::ConstValueEnum(const std::string& enum_name, const std::string& variant_name, std::shared_ptr<ASTNode> node) 
+ConstValueEnum::ConstValueEnum(const std::string& enum_name, const std::string& variant_name, ASTNode* node) 
     : ConstValue(node), enum_name(enum_name), variant_name(variant_name) {}
 
 const std::string& ConstValueEnum::getEnumName() const {
@@ -36,26 +36,26 @@ void Scope::resetChild() {
     pos = 0;
 }
 
-void Scope::setSelfType(std::string self_type) {
+void Scope::setSelfType(Name self_type) {
     this->self_type = self_type;
 }
-std::string Scope::getSelfType() {
+Name Scope::getSelfType() {
     return this->self_type;
 }
 
-void Scope::setBreakType(std::string break_type) {
+void Scope::setBreakType(SymbolType break_type) {
     this->break_type = break_type;
 }
-std::string Scope::getBreakType() {
+SymbolType Scope::getBreakType() {
     return this->break_type;
 }
 
-std::string Scope::getImplSelfType() {
+Name Scope::getImplSelfType() {
     if (type == ScopeType::IMPL) return self_type;
     if (parent_scope) {
         return parent_scope->getImplSelfType();
     }
-    return "";
+    return Name();
 }
 
 void Scope::setHasBreak(bool has_break) {
@@ -85,11 +85,11 @@ void Scope::setParent(std::shared_ptr<Scope> parent) {
 }
 
 // 常量符号管理
-void Scope::addConstSymbol(const std::string& name, std::shared_ptr<ConstSymbol> symbol) {
+void Scope::addConstSymbol(const Name& name, std::shared_ptr<ConstSymbol> symbol) {
     const_symbols[name] = symbol;
 }
 
-std::shared_ptr<ConstSymbol> Scope::getConstSymbol(const std::string& name) const {
+std::shared_ptr<ConstSymbol> Scope::getConstSymbol(const Name& name) const {
     auto it = const_symbols.find(name);
     if (it != const_symbols.end()) {
         return it->second;
@@ -97,20 +97,20 @@ std::shared_ptr<ConstSymbol> Scope::getConstSymbol(const std::string& name) cons
     return nullptr;
 }
 
-bool Scope::hasConstSymbol(const std::string& name) const {
+bool Scope::hasConstSymbol(const Name& name) const {
     return const_symbols.find(name) != const_symbols.end();
 }
 
-const std::unordered_map<std::string, std::shared_ptr<ConstSymbol>>& Scope::getConstSymbols() const {
+const std::unordered_map<Name, std::shared_ptr<ConstSymbol>>& Scope::getConstSymbols() const {
     return const_symbols;
 }
 
 // 结构体符号管理
-void Scope::addStructSymbol(const std::string& name, std::shared_ptr<StructSymbol> symbol) {
+void Scope::addStructSymbol(const Name& name, std::shared_ptr<StructSymbol> symbol) {
     struct_symbols[name] = symbol;
 }
 
-std::shared_ptr<StructSymbol> Scope::getStructSymbol(const std::string& name) const {
+std::shared_ptr<StructSymbol> Scope::getStructSymbol(const Name& name) const {
     auto it = struct_symbols.find(name);
     if (it != struct_symbols.end()) {
         return it->second;
@@ -118,20 +118,20 @@ std::shared_ptr<StructSymbol> Scope::getStructSymbol(const std::string& name) co
     return nullptr;
 }
 
-bool Scope::hasStructSymbol(const std::string& name) const {
+bool Scope::hasStructSymbol(const Name& name) const {
     return struct_symbols.find(name) != struct_symbols.end();
 }
 
-const std::unordered_map<std::string, std::shared_ptr<StructSymbol>>& Scope::getStructSymbols() const {
+const std::unordered_map<Name, std::shared_ptr<StructSymbol>>& Scope::getStructSymbols() const {
     return struct_symbols;
 }
 
 // 枚举符号管理
-void Scope::addEnumSymbol(const std::string& name, std::shared_ptr<EnumSymbol> symbol) {
+void Scope::addEnumSymbol(const Name& name, std::shared_ptr<EnumSymbol> symbol) {
     enum_symbols[name] = symbol;
 }
 
-std::shared_ptr<EnumSymbol> Scope::getEnumSymbol(const std::string& name) const {
+std::shared_ptr<EnumSymbol> Scope::getEnumSymbol(const Name& name) const {
     auto it = enum_symbols.find(name);
     if (it != enum_symbols.end()) {
         return it->second;
@@ -139,23 +139,23 @@ std::shared_ptr<EnumSymbol> Scope::getEnumSymbol(const std::string& name) const
     return nullptr;
 }
 
-bool Scope::hasEnumSymbol(const std::string& name) const {
+bool Scope::hasEnumSymbol(const Name& name) const {
     return enum_symbols.find(name) != enum_symbols.end();
 }
 
-const std::unordered_map<std::string, std::shared_ptr<EnumSymbol>>& Scope::getEnumSymbols() const {
+const std::unordered_map<Name, std::shared_ptr<EnumSymbol>>& Scope::getEnumSymbols() const {
     return enum_symbols;
 }
 
 // 函数符号管理
-void Scope::addFuncSymbol(const std::string& name, std::shared_ptr<FuncSymbol> symbol) {
+void Scope::addFuncSymbol(const Name& name, std::shared_ptr<FuncSymbol> symbol) {
     if (func_symbols.find(name) != func_symbols.end()) {
         throw std::runtime_error("Semantic: function " + name + " redefinition");
     }
     func_symbols[name] = symbol;
 }
 
-std::shared_ptr<FuncSymbol> Scope::getFuncSymbol(const std::string& name) const {
+std::shared_ptr<FuncSymbol> Scope::getFuncSymbol(const Name& name) const {
     auto it = func_symbols.find(name);
     if (it != func_symbols.end()) {
         return it->second;
@@ -163,20 +163,20 @@ std::shared_ptr<FuncSymbol> Scope::getFuncSymbol(const std::string& name) const
     return nullptr;
 }
 
-bool Scope::hasFuncSymbol(const std::string& name) const {
+bool Scope::hasFuncSymbol(const Name& name) const {
     return func_symbols.find(name) != func_symbols.end();
 }
 
-const std::unordered_map<std::string, std::shared_ptr<FuncSymbol>>& Scope::getFuncSymbols() const {
+const std::unordered_map<Name, std::shared_ptr<FuncSymbol>>& Scope::getFuncSymbols() const {
     return func_symbols;
 }
 
 // 特征符号管理
-void Scope::addTraitSymbol(const std::string& name, std::shared_ptr<TraitSymbol> symbol) {
+void Scope::addTraitSymbol(const Name& name, std::shared_ptr<TraitSymbol> symbol) {
     trait_symbols[name] = symbol;
 }
 
-std::shared_ptr<TraitSymbol> Scope::getTraitSymbol(const std::string& name) const {
+std::shared_ptr<TraitSymbol> Scope::getTraitSymbol(const Name& name) const {
     auto it = trait_symbols.find(name);
     if (it != trait_symbols.end()) {
         return it->second;
@@ -184,28 +184,28 @@ std::shared_ptr<TraitSymbol> Scope::getTraitSymbol(const std::string& name) cons
     return nullptr;
 }
 
-bool Scope::hasTraitSymbol(const std::string& name) const {
+bool Scope::hasTraitSymbol(const Name& name) const {
     return trait_symbols.find(name) != trait_symbols.end();
 }
 
-const std::unordered_map<std::string, std::shared_ptr<TraitSymbol>>& Scope::getTraitSymbols() const {
+const std::unordered_map<Name, std::shared_ptr<TraitSymbol>>& Scope::getTraitSymbols() const {
     return trait_symbols;
 }
 
 // 变量表管理
-void Scope::addVariable(const std::string& name, const std::string& type, bool is_mutable) {
+void Scope::addVariable(const Name& name, const SymbolType& type, bool is_mutable) {
     variable_table[name] = VariableInfo(type, is_mutable);
 }
 
-std::string Scope::getVariableType(const std::string& name) const {
+SymbolType Scope::getVariableType(const Name& name) const {
     auto it = variable_table.find(name);
     if (it != variable_table.end()) {
         return it->second.type;
     }
-    return "";
+    return SymbolType();
 }
 
-bool Scope::isVariableMutable(const std::string& name) const {
+bool Scope::isVariableMutable(const Name& name) const {
     auto it = variable_table.find(name);
     if (it != variable_table.end()) {
         return it->second.is_mutable;
@@ -213,15 +213,15 @@ bool Scope::isVariableMutable(const std::string& name) const {
     return false;
 }
 
-bool Scope::hasVariable(const std::string& name) const {
+bool Scope::hasVariable(const Name& name) const {
     return variable_table.find(name) != variable_table.end();
 }
 
-const std::unordered_map<std::string, VariableInfo>& Scope::getVariableTable() const {
+const std::unordered_map<Name, VariableInfo>& Scope::getVariableTable() const {
     return variable_table;
 }
 
-std::string Scope::findVariableType(const std::string& name) const {
+SymbolType Scope::findVariableType(const Name& name) const {
     auto var_type = getVariableType(name);
     if (!var_type.empty()) {
         return var_type;
@@ -232,10 +232,10 @@ std::string Scope::findVariableType(const std::string& name) const {
         return parent_scope->findVariableType(name);
     }
     
-    return "";
+    return SymbolType();
 }
 
-bool Scope::findVariableMutable(const std::string& name) const {
+bool Scope::findVariableMutable(const Name& name) const {
     auto var_info = variable_table.find(name);
     if (var_info != variable_table.end()) {
         return var_info->second.is_mutable;
@@ -249,12 +249,12 @@ bool Scope::findVariableMutable(const std::string& name) const {
     return false;
 }
 
-bool Scope::variableExists(const std::string& name) const {
+bool Scope::variableExists(const Name& name) const {
     return !findVariableType(name).empty();
 }
 
 // 通用符号查找（在作用域链中查找）
-std::shared_ptr<Symbol> Scope::findSymbol(const std::string& name) const {
+std::shared_ptr<Symbol> Scope::findSymbol(const Name& name) const {
     // 首先在当前作用域查找常量符号
     auto const_sym = getConstSymbol(name);
     if (const_sym) return const_sym;
@@ -267,7 +267,7 @@ std::shared_ptr<Symbol> Scope::findSymbol(const std::string& name) const {
     return nullptr;
 }
 
-std::shared_ptr<ConstSymbol> Scope::findConstSymbol(const std::string& name) const {
+std::shared_ptr<ConstSymbol> Scope::findConstSymbol(const Name& name) const {
     auto const_sym = getConstSymbol(name);
     if (const_sym) return const_sym;
     
@@ -278,7 +278,7 @@ std::shared_ptr<ConstSymbol> Scope::findConstSymbol(const std::string& name) con
     return nullptr;
 }
 
-std::shared_ptr<StructSymbol> Scope::findStructSymbol(const std::string& name) const {
+std::shared_ptr<StructSymbol> Scope::findStructSymbol(const Name& name) const {
     auto struct_sym = getStructSymbol(name);
     if (struct_sym) return struct_sym;
     
@@ -289,7 +289,18 @@ std::shared_ptr<StructSymbol> Scope::findStructSymbol(const std::string& name) c
     return nullptr;
 }
 
-std::shared_ptr<EnumSymbol> Scope::findEnumSymbol(const std::string& name) const {
+std::shared_ptr<Symbol> Scope::findTypeSymbol(const Name& name) const {
+    if (auto struct_sym = getStructSymbol(name)) return struct_sym;
+    if (auto enum_sym = getEnumSymbol(name)) return enum_sym;
+    
+    if (parent_scope) {
+        return parent_scope->findTypeSymbol(name);
+    }
+    
+    return nullptr;
+}
+
+std::shared_ptr<EnumSymbol> Scope::findEnumSymbol(const Name& name) const {
     auto enum_sym = getEnumSymbol(name);
     if (enum_sym) return enum_sym;
     
@@ -300,7 +311,7 @@ std::shared_ptr<EnumSymbol> Scope::findEnumSymbol(const std::string& name) const
     return nullptr;
 }
 
-std::shared_ptr<FuncSymbol> Scope::findFuncSymbol(const std::string& name) const {
+std::shared_ptr<FuncSymbol> Scope::findFuncSymbol(const Name& name) const {
     auto func_sym = getFuncSymbol(name);
     if (func_sym) return func_sym;
     
@@ -311,7 +322,7 @@ std::shared_ptr<FuncSymbol> Scope::findFuncSymbol(const std::string& name) const
     return nullptr;
 }
 
-std::shared_ptr<TraitSymbol> Scope::findTraitSymbol(const std::string& name) const {
+std::shared_ptr<TraitSymbol> Scope::findTraitSymbol(const Name& name) const {
     auto trait_sym = getTraitSymbol(name);
     if (trait_sym) return trait_sym;
     
@@ -323,36 +334,36 @@ std::shared_ptr<TraitSymbol> Scope::findTraitSymbol(const std::string& name) con
 }
 
 // 检查符号是否存在于作用域链中
-bool Scope::symbolExists(const std::string& name) const {
+bool Scope::symbolExists(const Name& name) const {
     return findSymbol(name) != nullptr;
 }
 
-bool Scope::constSymbolExists(const std::string& name) const {
+bool Scope::constSymbolExists(const Name& name) const {
     return findSymbol(name) != nullptr;
 }
 
-bool Scope::structSymbolExists(const std::string& name) const {
+bool Scope::structSymbolExists(const Name& name) const {
     return findStructSymbol(name) != nullptr;
 }
 
-bool Scope::enumSymbolExists(const std::string& name) const {
+bool Scope::enumSymbolExists(const Name& name) const {
     return findEnumSymbol(name) != nullptr;
 }
 
-bool Scope::funcSymbolExists(const std::string& name) const {
+bool Scope::funcSymbolExists(const Name& name) const {
     return findFuncSymbol(name) != nullptr;
 }
 
-bool Scope::traitSymbolExists(const std::string& name) const {
+bool Scope::traitSymbolExists(const Name& name) const {
     return findTraitSymbol(name) != nullptr;
 }
 
 // 仅在当前作用域中查找
-std::shared_ptr<Symbol> Scope::getSymbolInCurrentScope(const std::string& name) const {
+std::shared_ptr<Symbol> Scope::getSymbolInCurrentScope(const Name& name) const {
     return getConstSymbol(name);
 }
 
-bool Scope::hasSymbolInCurrentScope(const std::string& name) const {
+bool Scope::hasSymbolInCurrentScope(const Name& name) const {
     return hasConstSymbol(name);
 }
 
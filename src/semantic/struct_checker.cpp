@@ -24,7 +24,7 @@ void StructChecker::handleInherentImpl() {
     }
 }
 
-void StructChecker::handleTraitImpl(std::string identifier) {
+void StructChecker::handleTraitImpl(const Name& identifier) {
     std::shared_ptr<StructSymbol> struct_symbol = current_scope->findStructSymbol(current_scope->getSelfType());
     std::shared_ptr<TraitSymbol> trait_symbol = current_scope->findTraitSymbol(identifier);
     if (struct_symbol == nullptr || trait_symbol == nullptr) {
@@ -77,18 +77,6 @@ void StructChecker::handleTraitImpl(std::string identifier) {
     }
 }
 
-void StructChecker::visit(Crate& node) {
-    for (auto item: node.items) {
-        item->accept(this);
-    }
-}
-
-void StructChecker::visit(Item& node) {
-    if (node.item) {
-        node.item->accept(this);
-    }
-}
-
 void StructChecker::visit(Function& node) {
     // std::cout << "visit function: " << node.identifier << std::endl;
 
@@ -115,21 +103,13 @@ void StructChecker::visit(Function& node) {
 
     // std::cout << "GOOD" << std::endl;
 
-    if (node.block_expression && current_scope) {
-        node.block_expression->accept(this);
+    if (node.body() && current_scope) {
+        walk(node.body());
     }
     current_scope = prev_scope;
     current_scope->nextChild();
 }
 
-void StructChecker::visit(Struct& node) {
-    // std::cout << "visit struct: " << std::endl;
-    // struct 不会创建新的 scope，直接访问其内容
-    if (node.struct_struct) {
-        node.struct_struct->accept(this);
-    }
-}
-
 void StructChecker::visit(Enumeration& node) {
     // std::cout << "visit enum: " << std::endl;
     // 检查枚举符号是否存在
@@ -140,7 +120,7 @@ void StructChecker::visit(Enumeration& node) {
     
     // 枚举不会创建新的 scope，直接访问其内容
     if (node.enum_variants) {
-        node.enum_variants->accept(this);
+        walk(node.enum_variants);
     }
 }
 
@@ -173,7 +153,7 @@ void StructChecker::visit(Trait& node) {
     // 处理关联项
     for (auto& item : node.associated_item) {
         if (item) {
-            item->accept(this);
+            walk(item);
         }
     }
     
@@ -181,13 +161,6 @@ void StructChecker::visit(Trait& node) {
     current_scope->nextChild();
 }
 
-void StructChecker::visit(Implementation& node) {
-    // std::cout << "visit impl: " << std::endl;
-    if (node.impl) {
-        node.impl->accept(this);
-    }
-}
-
 void StructChecker::visit(InherentImpl& node) {
     // std::cout << "visit inherent impl: " << std::endl;
     // 进入 impl 作用域
@@ -197,7 +170,7 @@ void StructChecker::visit(InherentImpl& node) {
     // 处理关联项
     for (auto& item : node.associated_item) {
         if (item) {
-            item->accept(this);
+            walk(item);
         }
     }
     
@@ -217,7 +190,7 @@ void StructChecker::visit(TraitImpl& node) {
     // 处理关联项
     for (auto& item : node.associated_item) {
         if (item) {
-            item->accept(this);
+            walk(item);
         }
     }
     
@@ -228,287 +201,37 @@ void StructChecker::visit(TraitImpl& node) {
     current_scope->nextChild();
 }
 
-void StructChecker::visit(AssociatedItem& node) {
-    // std::cout << "visit associated item: " << std::endl;
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
 // 函数相关节点
-void StructChecker::visit(FunctionParameters& node) {
-    if (node.self_param) {
-        node.self_param->accept(this);
-    }
-    for (auto& param : node.function_param) {
-        if (param) {
-            param->accept(this);
-        }
-    }
-}
-
-void StructChecker::visit(SelfParam& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-void StructChecker::visit(ShorthandSelf& node) {
-    // ShorthandSelf 不包含类型信息，无需类型检查
-}
-
-void StructChecker::visit(TypedSelf& node) {
-    if (node.type) {
-        node.type->accept(this);
-    }
-}
-
 void StructChecker::visit(FunctionParam& node) {
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     if (node.pattern_no_top_alt) {
-        node.pattern_no_top_alt->accept(this);
-    }
-}
-
-void StructChecker::visit(FunctionReturnType& node) {
-    if (node.type) {
-        node.type->accept(this);
-    }
-}
-
-// 结构体相关节点
-void StructChecker::visit(StructStruct& node) {
-    if (node.struct_fields) {
-        node.struct_fields->accept(this);
-    }
-}
-
-void StructChecker::visit(StructFields& node) {
-    for (auto& field : node.struct_fields) {
-        if (field) {
-            field->accept(this);
-        }
+        walk(node.pattern_no_top_alt);
     }
 }
 
-void StructChecker::visit(StructField& node) {
-    if (node.type) {
-        node.type->accept(this);
-    }
-}
-
-// 枚举相关节点
-void StructChecker::visit(EnumVariants& node) {
-    for (auto& variant : node.enum_variant) {
-        if (variant) {
-            variant->accept(this);
-        }
-    }
-}
-
-void StructChecker::visit(EnumVariant& node) {
-    // EnumVariant 不包含类型信息，无需类型检查
-}
-
 // 语句类节点
-void StructChecker::visit(Statement& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
 void StructChecker::visit(LetStatement& node) {
     // 检查 let statement 的类型是否存在
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     if (node.pattern_no_top_alt) {
-        node.pattern_no_top_alt->accept(this);
-    }
-}
-
-void StructChecker::visit(ExpressionStatement& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-void StructChecker::visit(Statements& node) {
-    for (auto& stmt : node.statements) {
-        if (stmt) {
-            stmt->accept(this);
-        }
-    }
-}
-
-// 表达式类节点
-void StructChecker::visit(Expression& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-void StructChecker::visit(ExpressionWithoutBlock& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-void StructChecker::visit(ExpressionWithBlock& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-// 字面量表达式
-void StructChecker::visit(CharLiteral& node) {
-    // 字面量不包含类型信息，无需类型检查
-}
-
-void StructChecker::visit(StringLiteral& node) {
-    // 字面量不包含类型信息，无需类型检查
-}
-
-void StructChecker::visit(RawStringLiteral& node) {
-    // 字面量不包含类型信息，无需类型检查
-}
-
-void StructChecker::visit(CStringLiteral& node) {
-    // 字面量不包含类型信息，无需类型检查
-}
-
-void StructChecker::visit(RawCStringLiteral& node) {
-    // 字面量不包含类型信息，无需类型检查
-}
-
-void StructChecker::visit(IntegerLiteral& node) {
-    // 字面量不包含类型信息，无需类型检查
-}
-
-void StructChecker::visit(BoolLiteral& node) {
-    // 字面量不包含类型信息，无需类型检查
-}
-
-// 路径和访问表达式
-void StructChecker::visit(PathExpression& node) {
-    if (node.path_in_expression) {
-        node.path_in_expression->accept(this);
-    }
-}
-
-void StructChecker::visit(FieldExpression& node) {
-    if (node.expression) {
-        node.expression->accept(this);
-    }
-}
-
-// 运算符表达式
-void StructChecker::visit(UnaryExpression& node) {
-    if (node.expression) {
-        node.expression->accept(this);
-    }
-}
-
-void StructChecker::visit(BorrowExpression& node) {
-    if (node.expression) {
-        node.expression->accept(this);
-    }
-}
-
-void StructChecker::visit(DereferenceExpression& node) {
-    if (node.expression) {
-        node.expression->accept(this);
-    }
-}
-
-void StructChecker::visit(BinaryExpression& node) {
-    if (node.lhs) {
-        node.lhs->accept(this);
-    }
-    if (node.rhs) {
-        node.rhs->accept(this);
-    }
-}
-
-void StructChecker::visit(AssignmentExpression& node) {
-    if (node.lhs) {
-        node.lhs->accept(this);
-    }
-    if (node.rhs) {
-        node.rhs->accept(this);
-    }
-}
-
-void StructChecker::visit(CompoundAssignmentExpression& node) {
-    if (node.lhs) {
-        node.lhs->accept(this);
-    }
-    if (node.rhs) {
-        node.rhs->accept(this);
-    }
-}
-
-void StructChecker::visit(TypeCastExpression& node) {
-    if (node.expression) {
-        node.expression->accept(this);
-    }
-    if (node.type) {
-        node.type->accept(this);
+        walk(node.pattern_no_top_alt);
     }
 }
 
 // 调用和索引表达式
-void StructChecker::visit(CallExpression& node) {
-    if (node.expression) {
-        node.expression->accept(this);
-    }
-    if (node.call_params) {
-        node.call_params->accept(this);
-    }
-}
-
 void StructChecker::visit(MethodCallExpression& node) {
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     if (node.call_params) {
-        node.call_params->accept(this);
-    }
-}
-
-void StructChecker::visit(IndexExpression& node) {
-    if (node.base_expression) {
-        node.base_expression->accept(this);
-    }
-    if (node.index_expression) {
-        node.index_expression->accept(this);
-    }
-}
-
-// 结构体和数组表达式
-void StructChecker::visit(StructExpression& node) {
-    if (node.path_in_expression) {
-        node.path_in_expression->accept(this);
-    }
-    if (node.struct_expr_fields) {
-        node.struct_expr_fields->accept(this);
-    }
-}
-
-void StructChecker::visit(ArrayExpression& node) {
-    if (node.array_elements) {
-        node.array_elements->accept(this);
-    }
-}
-
-void StructChecker::visit(GroupedExpression& node) {
-    if (node.expression) {
-        node.expression->accept(this);
+        walk(node.call_params);
     }
 }
 
@@ -519,38 +242,20 @@ void StructChecker::visit(BlockExpression& node) {
     current_scope = current_scope->getChild();
     
     if (node.statements) {
-        node.statements->accept(this);
+        walk(node.statements);
     }
     
     current_scope = prev_scope;
     current_scope->nextChild();
 }
 
-void StructChecker::visit(IfExpression& node) {
-    if (node.condition) {
-        node.condition->accept(this);
-    }
-    if (node.then_block) {
-        node.then_block->accept(this);
-    }
-    if (node.else_branch) {
-        node.else_branch->accept(this);
-    }
-}
-
-void StructChecker::visit(LoopExpression& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
 void StructChecker::visit(InfiniteLoopExpression& node) {
     // InfiniteLoopExpression 会创建新的 scope，需要进入
     auto prev_scope = current_scope;
     current_scope = current_scope->getChild();
     
     if (node.block_expression) {
-        node.block_expression->accept(this);
+        walk(node.block_expression);
     }
     
     current_scope = prev_scope;
@@ -563,122 +268,12 @@ void StructChecker::visit(PredicateLoopExpression& node) {
     current_scope = current_scope->getChild();
     
     if (node.condition) {
-        node.condition->accept(this);
+        walk(node.condition);
     }
     if (node.block_expression) {
-        node.block_expression->accept(this);
+        walk(node.block_expression);
     }
     
     current_scope = prev_scope;
     current_scope->nextChild();
 }
-
-void StructChecker::visit(BreakExpression& node) {
-    if (node.expression) {
-        node.expression->accept(this);
-    }
-}
-
-void StructChecker::visit(ContinueExpression& node) {
-    // ContinueExpression 不包含类型信息，无需类型检查
-}
-
-void StructChecker::visit(ReturnExpression& node) {
-    if (node.expression) {
-        node.expression->accept(this);
-    }
-}
-
-// 辅助表达式节点
-void StructChecker::visit(Condition& node) {
-    if (node.expression) {
-        node.expression->accept(this);
-    }
-}
-
-void StructChecker::visit(ArrayElements& node) {
-    for (auto& expr : node.expressions) {
-        if (expr) {
-            expr->accept(this);
-        }
-    }
-}
-
-void StructChecker::visit(StructExprFields& node) {
-    for (auto& field : node.struct_expr_fields) {
-        if (field) {
-            field->accept(this);
-        }
-    }
-}
-
-void StructChecker::visit(StructExprField& node) {
-    if (node.expression) {
-        node.expression->accept(this);
-    }
-}
-
-void StructChecker::visit(CallParams& node) {
-    for (auto& expr : node.expressions) {
-        if (expr) {
-            expr->accept(this);
-        }
-    }
-}
-
-// 模式类节点
-void StructChecker::visit(PatternNoTopAlt& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-void StructChecker::visit(IdentifierPattern& node) {
-    // IdentifierPattern 不包含类型信息，无需类型检查
-}
-
-void StructChecker::visit(ReferencePattern& node) {
-    if (node.pattern) {
-        node.pattern->accept(this);
-    }
-}
-
-// 类型类节点
-void StructChecker::visit(Type& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-void StructChecker::visit(ReferenceType& node) {
-    if (node.type) {
-        node.type->accept(this);
-    }
-}
-
-void StructChecker::visit(ArrayType& node) {
-    if (node.type) {
-        node.type->accept(this);
-    }
-    if (node.expression) {
-        node.expression->accept(this);
-    }
-}
-
-void StructChecker::visit(UnitType& node) {
-    // UnitType 不包含类型信息，无需类型检查
-}
-
-// 路径类节点
-void StructChecker::visit(PathInExpression& node) {
-    if (node.segment1) {
-        node.segment1->accept(this);
-    }
-    if (node.segment2) {
-        node.segment2->accept(this);
-    }
-}
-
-void StructChecker::visit(PathIdentSegment& node) {
-    // PathIdentSegment 不包含类型信息，无需类型检查
-}
@@ -13,13 +13,13 @@ SymbolType Symbol::getType() {
 }
 
 // ConstSymbol 类实现
-ConstSymbol::ConstSymbol(const std::string& identifier, const SymbolType& type)
+ConstSymbol::ConstSymbol(const Name& identifier, const SymbolType& type)
     : Symbol(type), identifier(identifier), value(nullptr) {}
 
-ConstSymbol::ConstSymbol(const std::string& identifier, const SymbolType& type, std::shared_ptr<ConstValue> value)
+ConstSymbol::ConstSymbol(const Name& identifier, const SymbolType& type, std::shared_ptr<ConstValue> value)
     : Symbol(type), identifier(identifier), value(value) {}
 
-std::string ConstSymbol::getIdentifier() const {
+Name ConstSymbol::getIdentifier() const {
     return identifier;
 }
 
@@ -36,10 +36,10 @@ bool ConstSymbol::hasValue() const {
 }
 
 // VariableSymbol 类实现
-VariableSymbol::VariableSymbol(const std::string identifier, const SymbolType type, bool is_ref, int is_mut)
+VariableSymbol::VariableSymbol(const Name& identifier, const SymbolType type, bool is_ref, int is_mut)
     : Symbol(type), identifier(identifier), is_ref(is_ref), is_mut(is_mut) {}
 
-std::string VariableSymbol::getIdentifier() const {
+Name VariableSymbol::getIdentifier() const {
     return identifier;
 }
 
@@ -52,10 +52,10 @@ int VariableSymbol::getMut() const {
 }
 
 // StructSymbol 类实现
-StructSymbol::StructSymbol(const std::string& identifier, const SymbolType& type)
+StructSymbol::StructSymbol(const Name& identifier, const SymbolType& type)
     : Symbol(type), identifier(identifier) {}
 
-std::string StructSymbol::getIdentifier() const {
+Name StructSymbol::getIdentifier() const {
     return identifier;
 }
 
@@ -65,15 +65,15 @@ void StructSymbol::addField(std::shared_ptr<VariableSymbol> field) {
     vars[field->getIdentifier()] = field;
 }
 
-void StructSymbol::eraseField(std::string str) {
-    vars.erase(vars.find(str));
+void StructSymbol::eraseField(const Name& name) {
+    vars.erase(vars.find(name));
 }
 
-bool StructSymbol::hasField(const std::string& name) const {
+bool StructSymbol::hasField(const Name& name) const {
     return vars.find(name) != vars.end();
 }
 
-std::shared_ptr<VariableSymbol> StructSymbol::getField(const std::string& name) const {
+std::shared_ptr<VariableSymbol> StructSymbol::getField(const Name& name) const {
     auto it = vars.find(name);
     return (it != vars.end()) ? it->second : nullptr;
 }
@@ -96,11 +96,11 @@ void StructSymbol::addAssociatedConst(std::shared_ptr<ConstSymbol> const_symbol)
     associated_consts[const_symbol->getIdentifier()] = const_symbol;
 }
 
-bool StructSymbol::hasAssociatedConst(const std::string& name) const {
+bool StructSymbol::hasAssociatedConst(const Name& name) const {
     return associated_consts.find(name) != associated_consts.end();
 }
 
-std::shared_ptr<ConstSymbol> StructSymbol::getAssociatedConst(const std::string& name) const {
+std::shared_ptr<ConstSymbol> StructSymbol::getAssociatedConst(const Name& name) const {
     auto it = associated_consts.find(name);
     return (it != associated_consts.end()) ? it->second : nullptr;
 }
@@ -119,11 +119,11 @@ void StructSymbol::addMethod(std::shared_ptr<FuncSymbol> method) {
     methods[method->getIdentifier()] = method;
 }
 
-bool StructSymbol::hasMethod(const std::string& name) const {
+bool StructSymbol::hasMethod(const Name& name) const {
     return methods.find(name) != methods.end();
 }
 
-std::shared_ptr<FuncSymbol> StructSymbol::getMethod(const std::string& name) const {
+std::shared_ptr<FuncSymbol> StructSymbol::getMethod(const Name& name) const {
     auto it = methods.find(name);
     return (it != methods.end()) ? it->second : nullptr;
 }
@@ -142,11 +142,11 @@ void StructSymbol::addAssociatedFunction(std::shared_ptr<FuncSymbol> function) {
     functions[function->getIdentifier()] = function;
 }
 
-bool StructSymbol::hasAssociatedFunction(const std::string& name) const {
+bool StructSymbol::hasAssociatedFunction(const Name& name) const {
     return functions.find(name) != functions.end();
 }
 
-std::shared_ptr<FuncSymbol> StructSymbol::getAssociatedFunction(const std::string& name) const {
+std::shared_ptr<FuncSymbol> StructSymbol::getAssociatedFunction(const Name& name) const {
     auto it = functions.find(name);
     return (it != functions.end()) ? it->second : nullptr;
 }
@@ -174,17 +174,17 @@ std::vector<std::shared_ptr<FuncSymbol>> StructSymbol::getAllAssociatedFunctions
 }
 
 // EnumVar 类实现
-EnumVar::EnumVar(const std::string& identifier) : identifier(identifier) {}
+EnumVar::EnumVar(const Name& identifier) : identifier(identifier) {}
 
-std::string EnumVar::getIdentifier() const {
+Name EnumVar::getIdentifier() const {
     return identifier;
 }
 
 // EnumSymbol 类实现
-EnumSymbol::EnumSymbol(const std::string& identifier, const SymbolType& type)
+EnumSymbol::EnumSymbol(const Name& identifier, const SymbolType& type)
     : Symbol(type), identifier(identifier) {}
 
-std::string EnumSymbol::getIdentifier() const {
+Name EnumSymbol::getIdentifier() const {
     return identifier;
 }
 
@@ -197,10 +197,10 @@ const std::vector<std::shared_ptr<EnumVar>>& EnumSymbol::getVariants() const {
 }
 
 // FuncSymbol 类实现
-FuncSymbol::FuncSymbol(const std::string& identifier, const SymbolType& return_type, bool is_const, MethodType method_type)
-    : Symbol("function"), identifier(identifier), return_type(return_type), is_const(is_const), method_type(method_type) {}
+FuncSymbol::FuncSymbol(const Name& identifier, const SymbolType& return_type, bool is_const, MethodType method_type)
+    : Symbol(TypeContext::global().named(names::kFunction)), identifier(identifier), return_type(return_type), is_const(is_const), method_type(method_type) {}
 
-std::string FuncSymbol::getIdentifier() const {
+Name FuncSymbol::getIdentifier() const {
     return identifier;
 }
 
@@ -245,15 +245,15 @@ SymbolType FuncSymbol::getReturnType() const {
     return return_type;
 }
 
-void FuncSymbol::setReturnType(std::string return_type) {
+void FuncSymbol::setReturnType(SymbolType return_type) {
     this->return_type = return_type;
 }
 
 // TraitSymbol 类实现
-TraitSymbol::TraitSymbol(const std::string& identifier)
-    : Symbol("trait"), identifier(identifier) {}
+TraitSymbol::TraitSymbol(const Name& identifier)
+    : Symbol(TypeContext::global().named(names::kTrait)), identifier(identifier) {}
 
-std::string TraitSymbol::getIdentifier() const {
+Name TraitSymbol::getIdentifier() const {
     return identifier;
 }
 
@@ -262,11 +262,11 @@ void TraitSymbol::addConstSymbol(std::shared_ptr<ConstSymbol> const_symbol) {
     const_symbols[const_symbol->getIdentifier()] = const_symbol;
 }
 
-bool TraitSymbol::hasConstSymbol(const std::string& name) const {
+bool TraitSymbol::hasConstSymbol(const Name& name) const {
     return const_symbols.find(name) != const_symbols.end();
 }
 
-std::shared_ptr<ConstSymbol> TraitSymbol::getConstSymbol(const std::string& name) const {
+std::shared_ptr<ConstSymbol> TraitSymbol::getConstSymbol(const Name& name) const {
     auto it = const_symbols.find(name);
     return (it != const_symbols.end()) ? it->second : nullptr;
 }
@@ -285,11 +285,11 @@ void TraitSymbol::addMethod(std::shared_ptr<FuncSymbol> method) {
     methods[method->getIdentifier()] = method;
 }
 
-bool TraitSymbol::hasMethod(const std::string& name) const {
+bool TraitSymbol::hasMethod(const Name& name) const {
     return methods.find(name) != methods.end();
 }
 
-std::shared_ptr<FuncSymbol> TraitSymbol::getMethod(const std::string& name) const {
+std::shared_ptr<FuncSymbol> TraitSymbol::getMethod(const Name& name) const {
     auto it = methods.find(name);
     return (it != methods.end()) ? it->second : nullptr;
 }
@@ -308,11 +308,11 @@ void TraitSymbol::addAssociatedFunction(std::shared_ptr<FuncSymbol> function) {
     functions[function->getIdentifier()] = function;
 }
 
-bool TraitSymbol::hasAssociatedFunction(const std::string& name) const {
+bool TraitSymbol::hasAssociatedFunction(const Name& name) const {
     return functions.find(name) != functions.end();
 }
 
-std::shared_ptr<FuncSymbol> TraitSymbol::getAssociatedFunction(const std::string& name) const {
+std::shared_ptr<FuncSymbol> TraitSymbol::getAssociatedFunction(const Name& name) const {
     auto it = functions.find(name);
     return (it != functions.end()) ? it->second : nullptr;
 }
@@ -340,21 +340,21 @@ std::vector<std::shared_ptr<FuncSymbol>> TraitSymbol::getAllAssociatedFunctions(
 }
 
 // ArraySymbol 类实现
-ArraySymbol::ArraySymbol(const std::string& identifier, const std::string& element_type)
-    : Symbol("array"), identifier(identifier), element_type(element_type), length(nullptr) {}
+ArraySymbol::ArraySymbol(const std::string& identifier, const SymbolType& element_type)
+    : Symbol(TypeContext::global().named(names::kArray)), identifier(identifier), element_type(element_type), length(nullptr) {}
 
-ArraySymbol::ArraySymbol(const std::string& identifier, const std::string& element_type, std::shared_ptr<ConstValue> length)
-    : Symbol("array"), identifier(identifier), element_type(element_type), length(length) {}
+ArraySymbol::ArraySymbol(const std::string& identifier, const SymbolType& element_type, std::shared_ptr<ConstValue> length)
+    : Symbol(TypeContext::global().named(names::kArray)), identifier(identifier), element_type(element_type), length(length) {}
 
 std::string ArraySymbol::getIdentifier() const {
     return identifier;
 }
 
-std::string ArraySymbol::getElementType() const {
+SymbolType ArraySymbol::getElementType() const {
     return element_type;
 }
 
-void ArraySymbol::setElementType(const std::string& element_type) {
+void ArraySymbol::setElementType(const SymbolType& element_type) {
     this->element_type = element_type;
 }
 
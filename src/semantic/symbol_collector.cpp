@@ -8,23 +8,50 @@ SymbolCollector::SymbolCollector() {
     current_scope = root_scope;
 }
 
-// 访问 Crate - 创建全局作用域并遍历所有 items
+// 访问 Crate - 先声明全部结构体与枚举，再处理各项
 void SymbolCollector::visit(Crate& node) {
-    // std::cout << "Visiting Crate, creating global scope" << std::endl;
-    
-    // 遍历所有顶层 items
-    for (auto& item : node.items) {
-        if (item) {
-            item->accept(this);
+    for (auto item: node.items) {
+        declareType(item);
+    }
+    for (auto item: node.items) {
+        walk(item);
+    }
+}
+
+// 在当前作用域中预先声明 item 中的结构体或枚举，类型写在声明之前也能解析到它
+void SymbolCollector::declareType(ASTNode* item) {
+    auto wrapper = dyn_cast<Item>(item);
+    if (!wrapper) {
+        return;
+    }
+    if (auto struct_item = dyn_cast<Struct>(wrapper->item)) {
+        if (struct_item->struct_struct) {
+            declareStruct(*struct_item->struct_struct);
         }
+    } else if (auto enum_item = dyn_cast<Enumeration>(wrapper->item)) {
+        declareEnum(*enum_item);
+    }
+}
+
+std::shared_ptr<StructSymbol> SymbolCollector::declareStruct(StructStruct& node) {
+    auto& symbol = declarations[&node];
+    if (!symbol) {
+        symbol = std::make_shared<StructSymbol>(node.identifier, TypeContext::global().named(names::kStruct));
+        current_scope->addStructSymbol(node.identifier, std::static_pointer_cast<StructSymbol>(symbol));
     }
+    return std::static_pointer_cast<StructSymbol>(symbol);
 }
 
-// 访问 Item
-void SymbolCollector::visit(Item& node) {
-    if (node.item) {
-        node.item->accept(this);
+std::shared_ptr<EnumSymbol> SymbolCollector::declareEnum(Enumeration& node) {
+    auto& symbol = declarations[&node];
+    if (!symbol) {
+        // 枚举的类型就是它自己
+        auto enum_symbol = std::make_shared<EnumSymbol>(node.identifier, SymbolType());
+        enum_symbol->setType(TypeContext::global().named(node.identifier, enum_symbol.get()));
+        current_scope->addEnumSymbol(node.identifier, enum_symbol);
+        symbol = enum_symbol;
     }
+    return std::static_pointer_cast<EnumSymbol>(symbol);
 }
 
 // 访问 Function - 处理函数符号和作用域
@@ -32,18 +59,18 @@ void SymbolCollector::visit(Function& node) {
     // std::cout << "Visiting Function: " << node.identifier << std::endl;
     
     // 创建函数符号
-    std::string return_type_str = "()";  // 默认返回类型
+    SymbolType return_type_str = types::kUnit;  // 默认返回类型
     if (node.function_return_type && node.function_return_type->type) {
-        return_type_str = typeToString(node.function_return_type->type);
-        if (return_type_str == "Self") {
-            return_type_str = current_scope->getImplSelfType();
+        return_type_str = typeFromNode(current_scope, node.function_return_type->type);
+        if (return_type_str == TypeContext::global().named(names::kSelfType)) {
+            return_type_str = namedType(current_scope, current_scope->getImplSelfType());
         }
     }
     
     // 分析 self 参数类型
     MethodType method_type = MethodType::NOT_METHOD;
     if (node.function_parameters && node.function_parameters->self_param) {
-        if (auto shorthand_self = std::dynamic_pointer_cast<ShorthandSelf>(node.function_parameters->self_param->child)) {
+        if (auto shorthand_self = dyn_cast<ShorthandSelf>(node.function_parameters->self_param->child)) {
             // 处理简写形式的 self: self, &self, mut self, &mut self
             if (shorthand_self->is_reference) {
                 if (shorthand_self->is_mutable) {
@@ -58,7 +85,7 @@ void SymbolCollector::visit(Function& node) {
                     method_type = MethodType::SELF_VALUE;     // self
                 }
             }
-        } else if (auto typed_self = std::dynamic_pointer_cast<TypedSelf>(node.function_parameters->self_param->child)) {
+        } else if (auto typed_self = dyn_cast<TypedSelf>(node.function_parameters->self_param->child)) {
             // 处理带类型注解的 self: self: Type, mut self: Type
             if (typed_self->is_mutable) {
                 method_type = MethodType::SELF_MUT_VALUE; // mut self: Type
@@ -81,11 +108,11 @@ void SymbolCollector::visit(Function& node) {
 
     // 访问函数参数
     if (node.function_parameters) {
-        node.function_parameters->accept(this);
+        walk(node.function_parameters);
         // 将参数添加到函数符号中
         for (auto& param : node.function_parameters->function_param) {
             if (param) {
-                auto var_symbol = createVariableSymbolFromPattern(param->pattern_no_top_alt, param->type);
+                auto var_symbol = createVariableSymbolFromPattern(current_scope, param->pattern_no_top_alt, param->type);
                 if (var_symbol) {
                     func_symbol->addParameter(var_symbol);
                 }
@@ -97,8 +124,8 @@ void SymbolCollector::visit(Function& node) {
     prev_scope->addFuncSymbol(node.identifier, func_symbol);
     
     // 访问函数体
-    if (node.block_expression) {
-        node.block_expression->accept(this);
+    if (node.body()) {
+        walk(node.body());
     }
     
     // 恢复作用域
@@ -108,36 +135,26 @@ void SymbolCollector::visit(Function& node) {
     prev_scope->addChild(func_scope);
 }
 
-// 访问 Struct - 处理结构体符号
-void SymbolCollector::visit(Struct& node) {
-    if (node.struct_struct) {
-        node.struct_struct->accept(this);
-    }
-}
-
 // 访问 StructStruct
 void SymbolCollector::visit(StructStruct& node) {
     // std::cout << "Visiting Struct: " << node.identifier << std::endl;
     
-    // 创建结构体符号
-    auto struct_symbol = std::make_shared<StructSymbol>(node.identifier, "Struct");
+    // 取出预先声明的结构体符号
+    auto struct_symbol = declareStruct(node);
     
     // 处理结构体字段
     if (node.struct_fields) {
-        node.struct_fields->accept(this);
+        walk(node.struct_fields);
         
         // 添加字段到结构体符号
         for (auto& field : node.struct_fields->struct_fields) {
             if (field) {
-                std::string field_type = typeToString(field->type);
+                SymbolType field_type = typeFromNode(current_scope, field->type);
                 auto field_symbol = std::make_shared<VariableSymbol>(field->identifier, field_type);
                 struct_symbol->addField(field_symbol);
             }
         }
     }
-    
-    // 将结构体符号添加到当前作用域
-    current_scope->addStructSymbol(node.identifier, struct_symbol);
 }
 
 // 访问 StructFields
@@ -154,12 +171,12 @@ void SymbolCollector::visit(StructField& node) {
 void SymbolCollector::visit(Enumeration& node) {
     // std::cout << "Visiting Enum: " << node.identifier << std::endl;
     
-    // 创建枚举符号
-    auto enum_symbol = std::make_shared<EnumSymbol>(node.identifier, node.identifier);
+    // 取出预先声明的枚举符号
+    auto enum_symbol = declareEnum(node);
     
     // 处理枚举变体
     if (node.enum_variants) {
-        node.enum_variants->accept(this);
+        walk(node.enum_variants);
         
         // 添加变体到枚举符号
         for (auto& variant : node.enum_variants->enum_variant) {
@@ -169,9 +186,6 @@ void SymbolCollector::visit(Enumeration& node) {
             }
         }
     }
-    
-    // 将枚举符号添加到当前作用域
-    current_scope->addEnumSymbol(node.identifier, enum_symbol);
 }
 
 // 访问 EnumVariants
@@ -179,18 +193,13 @@ void SymbolCollector::visit(EnumVariants& node) {
     // 变体处理在 Enumeration 中完成
 }
 
-// 访问 EnumVariant
-void SymbolCollector::visit(EnumVariant& node) {
-    // 变体处理在 Enumeration 中完成
-}
-
 // 访问 ConstantItem - 处理常量符号
 void SymbolCollector::visit(ConstantItem& node) {
     // std::cout << "Visiting Constant: " << node.identifier << std::endl;
     
-    std::string type_str = "unknown";
+    SymbolType type_str = TypeContext::global().named(names::kUnknown);
     if (node.type) {
-        type_str = typeToString(node.type);
+        type_str = typeFromNode(current_scope, node.type);
     }
     
     // 尝试从表达式创建 ConstValue
@@ -202,7 +211,7 @@ void SymbolCollector::visit(ConstantItem& node) {
     current_scope->addConstSymbol(node.identifier, const_symbol);
     
     // 访问常量的表达式（如果需要）
-    // 注意：这里我们不再调用 node.expression->accept(this)，因为表达式已经在 createConstValueFromExpression 中处理了
+    // 注意：这里我们不再调用 walk(node.expression)，因为表达式已经在 createConstValueFromExpression 中处理了
     // 如果需要进一步处理表达式内部的结构，可以在 createConstValueFromExpression 中扩展
 }
 
@@ -223,28 +232,28 @@ void SymbolCollector::visit(Trait& node) {
     // 处理关联项
     for (auto& item : node.associated_item) {
         if (item) {
-            item->accept(this);
+            walk(item);
             
             // 将关联项添加到特征符号中
             // 改为在 const_evaluator 中做这件事情。
             // if (item->child) {
-            //     if (auto const_item = std::dynamic_pointer_cast<ConstantItem>(item->child)) {
+            //     if (auto const_item = dynamic_cast<ConstantItem*>(item->child)) {
             //         std::string type_str = "unknown";
             //         if (const_item->type) {
-            //             type_str = typeToString(const_item->type);
+            //             type_str = typeFromNode(const_item->type);
             //         }
             //         auto const_symbol = std::make_shared<ConstSymbol>(const_item->identifier, type_str);
             //         trait_symbol->addConstSymbol(const_symbol);
-            //     } else if (auto func = std::dynamic_pointer_cast<Function>(item->child)) {
+            //     } else if (auto func = dynamic_cast<Function*>(item->child)) {
             //         std::cout << "trait func " << func->identifier << std::endl;
             //         std::string return_type_str = "()";
             //         if (func->function_return_type && func->function_return_type->type) {
-            //             return_type_str = typeToString(func->function_return_type->type);
+            //             return_type_str = typeFromNode(func->function_return_type->type);
             //         }
             //         // 分析 self 参数类型
             //         MethodType method_type = MethodType::NOT_METHOD;
             //         if (func->function_parameters && func->function_parameters->self_param) {
-            //             if (auto shorthand_self = std::dynamic_pointer_cast<ShorthandSelf>(func->function_parameters->self_param->child)) {
+            //             if (auto shorthand_self = dynamic_cast<ShorthandSelf*>(func->function_parameters->self_param->child)) {
             //                 // 处理简写形式的 self: self, &self, mut self, &mut self
             //                 if (shorthand_self->is_reference) {
             //                     if (shorthand_self->is_mutable) {
@@ -259,7 +268,7 @@ void SymbolCollector::visit(Trait& node) {
             //                         method_type = MethodType::SELF_VALUE;     // self
             //                     }
             //                 }
-            //             } else if (auto typed_self = std::dynamic_pointer_cast<TypedSelf>(func->function_parameters->self_param->child)) {
+            //             } else if (auto typed_self = dynamic_cast<TypedSelf*>(func->function_parameters->self_param->child)) {
             //                 // 处理带类型注解的 self: self: Type, mut self: Type
             //                 if (typed_self->is_mutable) {
             //                     method_type = MethodType::SELF_MUT_VALUE; // mut self: Type
@@ -304,13 +313,6 @@ void SymbolCollector::visit(Trait& node) {
     prev_scope->addChild(trait_scope);
 }
 
-// 访问 Implementation - 处理实现块和作用域
-void SymbolCollector::visit(Implementation& node) {
-    if (node.impl) {
-        node.impl->accept(this);
-    }
-}
-
 // 访问 InherentImpl
 void SymbolCollector::visit(InherentImpl& node) {
     // std::cout << "Visiting InherentImpl" << std::endl;
@@ -320,13 +322,13 @@ void SymbolCollector::visit(InherentImpl& node) {
     
     // 创建实现作用域
     auto impl_scope = std::make_shared<Scope>(ScopeType::IMPL, current_scope);
-    impl_scope->setSelfType(typeToString(node.type));
+    impl_scope->setSelfType(TypeContext::global().name(typeFromNode(current_scope, node.type)));
     current_scope = impl_scope;
     
     // 处理关联项
     for (auto& item : node.associated_item) {
         if (item) {
-            item->accept(this);
+            walk(item);
         }
     }
     
@@ -346,13 +348,13 @@ void SymbolCollector::visit(TraitImpl& node) {
     
     // 创建实现作用域
     auto impl_scope = std::make_shared<Scope>(ScopeType::IMPL, current_scope);
-    impl_scope->setSelfType(typeToString(node.type));
+    impl_scope->setSelfType(TypeContext::global().name(typeFromNode(current_scope, node.type)));
     current_scope = impl_scope;
     
     // 处理关联项
     for (auto& item : node.associated_item) {
         if (item) {
-            item->accept(this);
+            walk(item);
         }
     }
     
@@ -363,28 +365,6 @@ void SymbolCollector::visit(TraitImpl& node) {
     prev_scope->addChild(impl_scope);
 }
 
-// 访问 AssociatedItem
-void SymbolCollector::visit(AssociatedItem& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-// 访问 FunctionParameters
-void SymbolCollector::visit(FunctionParameters& node) {
-    // 处理 Self 参数
-    if (node.self_param) {
-        node.self_param->accept(this);
-    }
-    
-    // 处理其他参数
-    for (auto& param : node.function_param) {
-        if (param) {
-            param->accept(this);
-        }
-    }
-}
-
 // 访问 FunctionParam
 void SymbolCollector::visit(FunctionParam& node) {
     // 参数处理在 Function 中完成
@@ -395,18 +375,6 @@ void SymbolCollector::visit(FunctionReturnType& node) {
     // 返回类型处理在 Function 中完成
 }
 
-// 访问 SelfParam
-void SymbolCollector::visit(SelfParam& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-// 访问 ShorthandSelf
-void SymbolCollector::visit(ShorthandSelf& node) {
-    // Self 参数处理
-}
-
 // 访问 TypedSelf
 void SymbolCollector::visit(TypedSelf& node) {
     // Self 参数处理
@@ -423,9 +391,14 @@ void SymbolCollector::visit(BlockExpression& node) {
     auto block_scope = std::make_shared<Scope>(ScopeType::BLOCK, current_scope);
     current_scope = block_scope;
     
-    // 访问块中的语句
+    // 访问块中的语句，其中的结构体与枚举先行声明
     if (node.statements) {
-        node.statements->accept(this);
+        for (auto statement: node.statements->statements) {
+            if (auto item_statement = dyn_cast<Statement>(statement)) {
+                declareType(item_statement->child);
+            }
+        }
+        walk(node.statements);
     }
     
     // 恢复作用域
@@ -435,64 +408,13 @@ void SymbolCollector::visit(BlockExpression& node) {
     prev_scope->addChild(block_scope);
 }
 
-// 访问 Statements
-void SymbolCollector::visit(Statements& node) {
-    for (auto& stmt : node.statements) {
-        if (stmt) {
-            stmt->accept(this);
-        }
-    }
-}
-
-// 访问 Statement
-void SymbolCollector::visit(Statement& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
 // 访问 LetStatement
 void SymbolCollector::visit(LetStatement& node) {
     // 目前暂时不将 LetStatement 中的东西放入 Scope 的符号表。
     
     // 访问初始化表达式
     if (node.expression) {
-        node.expression->accept(this);
-    }
-}
-
-// 访问 ExpressionStatement
-void SymbolCollector::visit(ExpressionStatement& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-// 访问 Expression
-void SymbolCollector::visit(Expression& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-// 访问 ExpressionWithoutBlock
-void SymbolCollector::visit(ExpressionWithoutBlock& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-// 访问 ExpressionWithBlock
-void SymbolCollector::visit(ExpressionWithBlock& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-// 访问 LoopExpression - 处理循环表达式作用域
-void SymbolCollector::visit(LoopExpression& node) {
-    if (node.child) {
-        node.child->accept(this);
+        walk(node.expression);
     }
 }
 
@@ -509,7 +431,7 @@ void SymbolCollector::visit(InfiniteLoopExpression& node) {
     
     // 访问循环体
     if (node.block_expression) {
-        node.block_expression->accept(this);
+        walk(node.block_expression);
     }
     
     // 恢复作用域
@@ -532,12 +454,12 @@ void SymbolCollector::visit(PredicateLoopExpression& node) {
     
     // 访问条件
     if (node.condition) {
-        node.condition->accept(this);
+        walk(node.condition);
     }
     
     // 访问循环体
     if (node.block_expression) {
-        node.block_expression->accept(this);
+        walk(node.block_expression);
     }
     
     // 恢复作用域
@@ -546,210 +468,3 @@ void SymbolCollector::visit(PredicateLoopExpression& node) {
     // 将循环作用域添加为父作用域的子作用域
     prev_scope->addChild(loop_scope);
 }
-
-// 访问 IfExpression
-void SymbolCollector::visit(IfExpression& node) {
-    // 访问条件
-    if (node.condition) {
-        node.condition->accept(this);
-    }
-    
-    // 访问 then 块
-    if (node.then_block) {
-        node.then_block->accept(this);
-    }
-    
-    // 访问 else 分支
-    if (node.else_branch) {
-        node.else_branch->accept(this);
-    }
-}
-
-// 访问 PatternNoTopAlt
-void SymbolCollector::visit(PatternNoTopAlt& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-// 访问 IdentifierPattern
-void SymbolCollector::visit(IdentifierPattern& node) {
-    // 模式处理在 createVariableSymbolFromPattern 中完成
-}
-
-// 访问 Type
-void SymbolCollector::visit(Type& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-// 访问 PathInExpression
-void SymbolCollector::visit(PathInExpression& node) {
-    if (node.segment1) {
-        node.segment1->accept(this);
-    }
-    if (node.segment2) {
-        node.segment2->accept(this);
-    }
-}
-
-// 访问 PathIdentSegment
-void SymbolCollector::visit(PathIdentSegment& node) {
-    // 路径段处理
-}
-
-// 以下是需要完整遍历的其他节点方法
-void SymbolCollector::visit(CallExpression& node) {
-    if (node.expression) node.expression->accept(this);
-    if (node.call_params) node.call_params->accept(this);
-}
-
-void SymbolCollector::visit(MethodCallExpression& node) {
-    if (node.expression) node.expression->accept(this);
-    if (node.path_ident_segment) node.path_ident_segment->accept(this);
-    if (node.call_params) node.call_params->accept(this);
-}
-
-void SymbolCollector::visit(FieldExpression& node) {
-    if (node.expression) node.expression->accept(this);
-}
-
-void SymbolCollector::visit(IndexExpression& node) {
-    if (node.base_expression) node.base_expression->accept(this);
-    if (node.index_expression) node.index_expression->accept(this);
-}
-
-void SymbolCollector::visit(StructExpression& node) {
-    if (node.path_in_expression) node.path_in_expression->accept(this);
-    if (node.struct_expr_fields) node.struct_expr_fields->accept(this);
-}
-
-void SymbolCollector::visit(ArrayExpression& node) {
-    if (node.array_elements) node.array_elements->accept(this);
-}
-
-void SymbolCollector::visit(GroupedExpression& node) {
-    if (node.expression) node.expression->accept(this);
-}
-
-void SymbolCollector::visit(UnaryExpression& node) {
-    if (node.expression) node.expression->accept(this);
-}
-
-void SymbolCollector::visit(BorrowExpression& node) {
-    if (node.expression) node.expression->accept(this);
-}
-
-void SymbolCollector::visit(DereferenceExpression& node) {
-    if (node.expression) node.expression->accept(this);
-}
-
-void SymbolCollector::visit(BinaryExpression& node) {
-    if (node.lhs) node.lhs->accept(this);
-    if (node.rhs) node.rhs->accept(this);
-}
-
-void SymbolCollector::visit(AssignmentExpression& node) {
-    if (node.lhs) node.lhs->accept(this);
-    if (node.rhs) node.rhs->accept(this);
-}
-
-void SymbolCollector::visit(CompoundAssignmentExpression& node) {
-    if (node.lhs) node.lhs->accept(this);
-    if (node.rhs) node.rhs->accept(this);
-}
-
-void SymbolCollector::visit(TypeCastExpression& node) {
-    if (node.expression) node.expression->accept(this);
-    if (node.type) node.type->accept(this);
-}
-
-void SymbolCollector::visit(PathExpression& node) {
-    if (node.path_in_expression) node.path_in_expression->accept(this);
-}
-
-void SymbolCollector::visit(Condition& node) {
-    if (node.expression) node.expression->accept(this);
-}
-
-void SymbolCollector::visit(ArrayElements& node) {
-    for (auto& expr : node.expressions) {
-        if (expr) expr->accept(this);
-    }
-}
-
-void SymbolCollector::visit(StructExprFields& node) {
-    for (auto& field : node.struct_expr_fields) {
-        if (field) field->accept(this);
-    }
-}
-
-void SymbolCollector::visit(StructExprField& node) {
-    if (node.expression) node.expression->accept(this);
-}
-
-void SymbolCollector::visit(CallParams& node) {
-    for (auto& expr : node.expressions) {
-        if (expr) expr->accept(this);
-    }
-}
-
-void SymbolCollector::visit(ReferenceType& node) {
-    if (node.type) node.type->accept(this);
-}
-
-void SymbolCollector::visit(ArrayType& node) {
-    if (node.type) node.type->accept(this);
-    if (node.expression) node.expression->accept(this);
-}
-
-void SymbolCollector::visit(UnitType& node) {
-    // 单元类型，无需进一步处理
-}
-
-void SymbolCollector::visit(ReferencePattern& node) {
-    if (node.pattern) node.pattern->accept(this);
-}
-
-// 字面量表达式
-void SymbolCollector::visit(CharLiteral& node) {
-    // 字面量，无需进一步处理
-}
-
-void SymbolCollector::visit(StringLiteral& node) {
-    // 字面量，无需进一步处理
-}
-
-void SymbolCollector::visit(RawStringLiteral& node) {
-    // 字面量，无需进一步处理
-}
-
-void SymbolCollector::visit(CStringLiteral& node) {
-    // 字面量，无需进一步处理
-}
-
-void SymbolCollector::visit(RawCStringLiteral& node) {
-    // 字面量，无需进一步处理
-}
-
-void SymbolCollector::visit(IntegerLiteral& node) {
-    // 字面量，无需进一步处理
-}
-
-void SymbolCollector::visit(BoolLiteral& node) {
-    // 字面量，无需进一步处理
-}
-
-// 控制流
-void SymbolCollector::visit(BreakExpression& node) {
-    if (node.expression) node.expression->accept(this);
-}
-
-void SymbolCollector::visit(ContinueExpression& node) {
-    // continue 表达式，无需进一步处理
-}
-
-void SymbolCollector::visit(ReturnExpression& node) {
-    if (node.expression) node.expression->accept(this);
-}
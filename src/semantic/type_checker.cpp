@@ -1,78 +1,50 @@
 #include "semantic/type_checker.hpp"
 #include <iostream>
 
-std::pair<std::string, std::string> TypeChecker::getBaseType(const SymbolType& type) {
-    std::string base_type = "", len_type = "";
-    size_t pos = 0;
-    while (pos < type.length() && type[pos] == '[') {
-        len_type += "[";
-        pos++;
-    }
-    while (pos < type.length() && type[pos] != ']') {
-        base_type += type[pos];
-        pos++;
-    }
-    while (pos < type.length()) {
-        len_type += type[pos];
-        pos++;
-    }
-    return std::make_pair(base_type, len_type);
-}
-
+// 两边各去掉一层引用后按结构比较：数组逐层比较长度，最内层的元素类型相同，或是 integer
+// 与具体整型、u32 与 usize、i32 与 isize 这几种组合；最内层为 ! 时可以赋给任何类型
 bool TypeChecker::canAssign(SymbolType var_type, SymbolType expr_type) {
     var_type = autoDereference(var_type), expr_type = autoDereference(expr_type);
-    auto res1 = getBaseType(var_type), res2 = getBaseType(expr_type);
-    if (res1 == res2) return true;
-    if (((res1.first == "i32" || res1.first == "u32" || res1.first == "isize" || res1.first == "usize") && res2.first == "integer") && (res1.second == res2.second)) return true;
-    if (((res1.first == "usize" && res2.first == "u32") || (res1.first == "u32" && res2.first == "usize")) && (res1.second == res2.second)) return true;
-    if (((res1.first == "isize" && res2.first == "i32") || (res1.first == "i32" && res2.first == "isize")) && (res1.second == res2.second)) return true;
-    if (res2.first == "!") return true;
+    if (var_type == expr_type) return true;
+    if (types.innermost(expr_type) == types::kNever) return true;
+    while (types.isArray(var_type) && types.isArray(expr_type)) {
+        if (types.length(var_type) != types.length(expr_type)) return false;
+        var_type = types.element(var_type), expr_type = types.element(expr_type);
+    }
+    if (types.isArray(var_type) || types.isArray(expr_type)) return false;
+    if (var_type == expr_type) return true;
+    if (types.isInteger(var_type) && expr_type == types::kInteger) return true;
+    if ((var_type == types::kUsize && expr_type == types::kU32) || (var_type == types::kU32 && expr_type == types::kUsize)) return true;
+    if ((var_type == types::kIsize && expr_type == types::kI32) || (var_type == types::kI32 && expr_type == types::kIsize)) return true;
     return false;
 }
 
 SymbolType TypeChecker::autoDereference(SymbolType type) {
-    if (type[0] == '&') {
-        return type.substr(1);
-    }
-    return type;
+    return types.dereference(type);
 }
 
 bool TypeChecker::isIntegerType(const SymbolType& type) {
-    return type == "integer" || type == "i32" || type == "u32" || type == "isize" || type == "usize";
+    return types.isInteger(type);
 }
 
-void TypeChecker::checkIntegerOverflow(std::string str, int type) {
-    // std::cout << str << ' ' << type << std::endl;
-    long long num = 0;
+// type: 1 为无符号，0 为取负后的有符号（允许 2^31），-1 为有符号
+void TypeChecker::checkIntegerOverflow(uint64_t num, int type) {
     if (type == 1) {
-        for (size_t _ = 0; _ < str.length(); ++_) {
-            if (!isdigit(str[_])) break;
-            num = num * 10ll + str[_] - '0';
-            if (num > UINT_MAX) {
-                throw std::runtime_error("Semantic: initialize unsigned int overflow");
-            }
+        if (num > UINT_MAX) {
+            throw std::runtime_error("Semantic: initialize unsigned int overflow");
         }
     } else if (type == 0) {
-        for (size_t _ = 0; _ < str.length(); ++_) {
-            if (!isdigit(str[_])) break;
-            num = num * 10ll + (str[_] - '0');
-            if (num - 1ll > INT_MAX) {
-                throw std::runtime_error("Semantic: initialize signed int overflow");
-            }
+        if (num > static_cast<uint64_t>(INT_MAX) + 1) {
+            throw std::runtime_error("Semantic: initialize signed int overflow");
         }
     } else {
-        for (size_t _ = 0; _ < str.length(); ++_) {
-            if (!isdigit(str[_])) break;
-            num = num * 10ll + (str[_] - '0');
-            // std::cout << num << std::endl;
-            if (num > INT_MAX) {
-                throw std::runtime_error("Semantic: initialize signed int overflow");
-            }
+        if (num > INT_MAX) {
+            throw std::runtime_error("Semantic: initialize signed int overflow");
         }
     }
 }
 
-TypeChecker::TypeChecker(std::shared_ptr<Scope> root_scope) {
+TypeChecker::TypeChecker(std::shared_ptr<Scope> root_scope): types(TypeContext::global()) {
     exit_num = 0;
     this->root_scope = root_scope;
     this->current_scope = root_scope;
@@ -80,8 +52,12 @@ TypeChecker::TypeChecker(std::shared_ptr<Scope> root_scope) {
 
 void TypeChecker::visit(Crate& node) {
     std::cout << "[TypeChecker] Entering Crate node" << std::endl;
+    // 表按当前的节点数建立，先把延迟解析的函数体都解析出来
+    node.parseLazyBodies();
+    node_types.reset(node);
+    node_mutability.reset(node);
     for (auto item: node.items) {
-        item->accept(this);
+        walk(item);
     }
     if (exit_num > 1) {
         throw std::runtime_error("Semantic: more than 1 exit!");
@@ -91,9 +67,9 @@ void TypeChecker::visit(Crate& node) {
 void TypeChecker::visit(Item& node) {
     std::cout << "[TypeChecker] Entering Item node" << std::endl;
     if (node.item) {
-        node.item->accept(this);
+        walk(node.item);
     }
-    node.type = node.item->type;
+    node_types[node] = node_types[node.item];
 }
 
 void TypeChecker::visit(Function& node) {
@@ -107,23 +83,23 @@ void TypeChecker::visit(Function& node) {
         current_scope->addVariable(func_params[_]->getIdentifier(), func_params[_]->getType(), func_params[_]->getMut() >= 1);
     }
     if (func_symbol->getMethodType() == MethodType::SELF_VALUE || func_symbol->getMethodType() == MethodType::SELF_REF) {
-        auto self_type = current_scope->getImplSelfType();
-        current_scope->addVariable("self", self_type, false);
+        auto self_type = namedType(current_scope, current_scope->getImplSelfType());
+        current_scope->addVariable(names::kSelfValue, self_type, false);
     } else if (func_symbol->getMethodType() == MethodType::SELF_MUT_VALUE || func_symbol->getMethodType() == MethodType::SELF_MUT_REF) {
-        auto self_type = current_scope->getImplSelfType();
-        current_scope->addVariable("self", self_type, true);
+        auto self_type = namedType(current_scope, current_scope->getImplSelfType());
+        current_scope->addVariable(names::kSelfValue, self_type, true);
     } 
 
-    if (node.identifier == "main" && func_symbol->getReturnType() != "()") {
+    if (node.identifier == names::kMain && func_symbol->getReturnType() != types::kUnit) {
         throw std::runtime_error("Semantic: Function main should return ()");
     }
 
-    if (node.block_expression && current_scope) {
-        node.block_expression->accept(this);
+    if (node.body() && current_scope) {
+        walk(node.body());
     }
 
-    if (node.identifier == "main") {
-        auto block_expr = node.block_expression;
+    if (node.identifier == names::kMain) {
+        auto block_expr = node.body();
         if (!block_expr || !block_expr->statements) {
             throw std::runtime_error("Semantic: exit missing0");
         }
@@ -131,31 +107,31 @@ void TypeChecker::visit(Function& node) {
         if (stmts.empty()) {
             throw std::runtime_error("Semantic: exit wrong place1");
         }
-        std::shared_ptr<ExpressionWithoutBlock> expr_without_block = std::dynamic_pointer_cast<ExpressionWithoutBlock>(stmts.back());
-        if (!expr_without_block) {
-            auto stmt = std::dynamic_pointer_cast<Statement>(stmts.back());
-            auto expr_stmt = std::dynamic_pointer_cast<ExpressionStatement>(stmt->child);
-            expr_without_block = std::dynamic_pointer_cast<ExpressionWithoutBlock>(expr_stmt->child);
-            if (!expr_without_block) {
-                throw std::runtime_error("Semantic: exit wrong place2");
-            }
+        // 最后一句是尾表达式，或是表达式语句中的表达式，且不能带块
+        ASTNode* last = stmts.back();
+        if (auto stmt = dyn_cast<Statement>(last)) {
+            auto expr_stmt = dyn_cast<ExpressionStatement>(stmt->child);
+            last = expr_stmt ? expr_stmt->child : nullptr;
         }
-        auto call_expr = std::dynamic_pointer_cast<CallExpression>(expr_without_block->child);
+        if (!last || isExpressionWithBlock(last)) {
+            throw std::runtime_error("Semantic: exit wrong place2");
+        }
+        auto call_expr = dyn_cast<CallExpression>(last);
         if (!call_expr) {
             throw std::runtime_error("Semantic: exit wrong place3");
         }
-        auto path_expr = std::dynamic_pointer_cast<PathExpression>(call_expr->expression);
-        auto path_in_expr = std::dynamic_pointer_cast<PathInExpression>(path_expr->path_in_expression);
+        auto path_expr = dyn_cast<PathExpression>(call_expr->expression);
+        auto path_in_expr = dyn_cast<PathInExpression>(path_expr->path_in_expression);
         auto identifier = path_in_expr->segment1->identifier;
-        if (identifier != "exit") {
+        if (identifier != names::kExit) {
             throw std::runtime_error("Semantic: exit missing!");
         }
     }
 
-    if (node.block_expression) {
-        auto return_type = node.block_expression->type;
-        // std::cout << func_symbol->getReturnType() << ' ' << return_type << ' ' << node.block_expression->is_last_stmt_return << std::endl;
-        if (!canAssign(func_symbol->getReturnType(), return_type) && (!node.block_expression->is_last_stmt_return)) {
+    if (node.body()) {
+        auto return_type = node_types[node.body()];
+        // std::cout << func_symbol->getReturnType() << ' ' << return_type << ' ' << node.body()->is_last_stmt_return << std::endl;
+        if (!canAssign(func_symbol->getReturnType(), return_type) && (!node.body()->is_last_stmt_return)) {
             throw std::runtime_error("Semantic: Function return type not match " + func_symbol->getIdentifier());
         }
     }
@@ -164,21 +140,9 @@ void TypeChecker::visit(Function& node) {
     current_scope->nextChild();
 }
 
-void TypeChecker::visit(Struct& node) {
-    if (node.struct_struct) {
-        node.struct_struct->accept(this);
-    }
-}
-
-void TypeChecker::visit(Enumeration& node) {
-    if (node.enum_variants) {
-        node.enum_variants->accept(this);
-    }
-}
-
 void TypeChecker::visit(ConstantItem& node) {
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
 }
 
@@ -190,7 +154,7 @@ void TypeChecker::visit(Trait& node) {
     std::cout << "GOOD" << std::endl;
     for (auto& item : node.associated_item) {
         if (item) {
-            item->accept(this);
+            walk(item);
         }
     }
     
@@ -198,12 +162,6 @@ void TypeChecker::visit(Trait& node) {
     current_scope->nextChild();
 }
 
-void TypeChecker::visit(Implementation& node) {
-    if (node.impl) {
-        node.impl->accept(this);
-    }
-}
-
 void TypeChecker::visit(InherentImpl& node) {
     auto prev_scope = current_scope;
     current_scope = current_scope->getChild();
@@ -211,7 +169,7 @@ void TypeChecker::visit(InherentImpl& node) {
     // 处理关联项
     for (auto& item : node.associated_item) {
         if (item) {
-            item->accept(this);
+            walk(item);
         }
     }
     
@@ -226,7 +184,7 @@ void TypeChecker::visit(TraitImpl& node) {
     // 处理关联项
     for (auto& item : node.associated_item) {
         if (item) {
-            item->accept(this);
+            walk(item);
         }
     }
     
@@ -237,308 +195,204 @@ void TypeChecker::visit(TraitImpl& node) {
 void TypeChecker::visit(AssociatedItem& node) {
     std::cout << "[TypeChecker] Entering AssociatedItem node" << std::endl;
     if (node.child) {
-        node.child->accept(this);
+        walk(node.child);
     }
-    node.type = node.child->type;
+    node_types[node] = node_types[node.child];
 }
 
 // 函数相关节点
-void TypeChecker::visit(FunctionParameters& node) {
-    if (node.self_param) {
-        node.self_param->accept(this);
-    }
-    for (auto& param : node.function_param) {
-        if (param) {
-            param->accept(this);
-        }
-    }
-}
-
-void TypeChecker::visit(SelfParam& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-}
-
-void TypeChecker::visit(ShorthandSelf& node) {
-    // ShorthandSelf 不包含类型信息，无需类型检查
-}
-
-void TypeChecker::visit(TypedSelf& node) {
-    if (node.type) {
-        node.type->accept(this);
-    }
-}
-
 void TypeChecker::visit(FunctionParam& node) {
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     if (node.pattern_no_top_alt) {
-        node.pattern_no_top_alt->accept(this);
-    }
-}
-
-void TypeChecker::visit(FunctionReturnType& node) {
-    if (node.type) {
-        node.type->accept(this);
-    }
-}
-
-// 结构体相关节点
-void TypeChecker::visit(StructStruct& node) {
-    if (node.struct_fields) {
-        node.struct_fields->accept(this);
-    }
-}
-
-void TypeChecker::visit(StructFields& node) {
-    for (auto& field : node.struct_fields) {
-        if (field) {
-            field->accept(this);
-        }
-    }
-}
-
-void TypeChecker::visit(StructField& node) {
-    if (node.type) {
-        node.type->accept(this);
-    }
-}
-
-// 枚举相关节点
-void TypeChecker::visit(EnumVariants& node) {
-    for (auto& variant : node.enum_variant) {
-        if (variant) {
-            variant->accept(this);
-        }
+        walk(node.pattern_no_top_alt);
     }
 }
 
-void TypeChecker::visit(EnumVariant& node) {
-
-}
-
 // 语句类节点
 void TypeChecker::visit(Statement& node) {
     if (node.child) {
-        node.child->accept(this);
+        walk(node.child);
     }
-    if (node.child != nullptr) node.type = node.child->type;
-    else node.type = "()";
+    if (node.child != nullptr) node_types[node] = node_types[node.child];
+    else node_types[node] = types::kUnit;
 }
 
 void TypeChecker::visit(LetStatement& node) {
     std::cout << "[TypeChecker] Entering LetStatement node" << std::endl;
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     if (node.pattern_no_top_alt) {
-        node.pattern_no_top_alt->accept(this);
+        walk(node.pattern_no_top_alt);
     }
-    auto var_type = typeToString_(current_scope, node.type);
-    auto expr_type = node.expression->type;
+    auto var_type = typeFromNode_(current_scope, node.type);
+    auto expr_type = node_types[node.expression];
     std::cout << "[TypeChecker] LetStatement: var_type = " << var_type << ", expr_type = " << expr_type << std::endl;
     if (!canAssign(var_type, expr_type)) {
         throw std::runtime_error("Semantic: Type Error in LetStmt");
     }
     if (node.pattern_no_top_alt && node.pattern_no_top_alt->child) {
-        auto identifier_patther = std::dynamic_pointer_cast<IdentifierPattern>(node.pattern_no_top_alt->child);
+        auto identifier_patther = dyn_cast<IdentifierPattern>(node.pattern_no_top_alt->child);
         if (identifier_patther) {
             auto var_identifier = identifier_patther->identifier;
             bool var_mutability = identifier_patther->is_mutable;
-            if (auto ref_type = std::dynamic_pointer_cast<ReferenceType>(node.type->child)) {
+            if (auto ref_type = dyn_cast<ReferenceType>(node.type->child)) {
                 var_mutability |= ref_type->is_mutable;
             }
             current_scope->addVariable(var_identifier, var_type, var_mutability);
             std::cout << "[TypeChecker] LetStatement: added variable " << var_identifier << " with type " << var_type << " mutability " << var_mutability << std::endl;
         }
     }
-    static_cast<ASTNode&>(node).type = "()";
+    node_types[node] = types::kUnit;
 }
 
 void TypeChecker::visit(ExpressionStatement& node) {
     if (node.child) {
-        node.child->accept(this);
-    }
-    node.mutability = node.child->mutability;
-    node.type = node.child->type;
-}
-
-void TypeChecker::visit(Statements& node) {
-    for (auto& stmt : node.statements) {
-        if (stmt) {
-            stmt->accept(this);
-        }
-    }
-}
-
-// 表达式类节点
-void TypeChecker::visit(Expression& node) {
-    std::cout << "[TypeChecker] Entering Expression node" << std::endl;
-    if (node.child) {
-        node.child->accept(this);
-    }
-    node.type = node.child->type;
-}
-
-void TypeChecker::visit(ExpressionWithoutBlock& node) {
-    if (node.child) {
-        node.child->accept(this);
+        walk(node.child);
     }
-    node.type = node.child->type;
-}
-
-void TypeChecker::visit(ExpressionWithBlock& node) {
-    if (node.child) {
-        node.child->accept(this);
-    }
-    node.type = node.child->type;
+    node_mutability[node] = node_mutability[node.child];
+    node_types[node] = node_types[node.child];
 }
 
 // 字面量表达式
 void TypeChecker::visit(CharLiteral& node) {
     // 字面量不包含类型信息，无需类型检查
-    node.type = "char";
+    node_types[node] = types::kChar;
 }
 
 void TypeChecker::visit(StringLiteral& node) {
     // 字面量不包含类型信息，无需类型检查
-    node.type = "str";
+    node_types[node] = types::kStr;
 }
 
 void TypeChecker::visit(RawStringLiteral& node) {
     // 字面量不包含类型信息，无需类型检查
-    node.type = "str";
+    node_types[node] = types::kStr;
 }
 
 void TypeChecker::visit(CStringLiteral& node) {
     // 字面量不包含类型信息，无需类型检查
-    node.type = "str";
+    node_types[node] = types::kStr;
 }
 
 void TypeChecker::visit(RawCStringLiteral& node) {
     // 字面量不包含类型信息，无需类型检查
-    node.type = "str";
+    node_types[node] = types::kStr;
 }
 
 void TypeChecker::visit(IntegerLiteral& node) {
-    // 字面量不包含类型信息，无需类型检查
-    // std::cout << "?" << std::endl;
-    std::string number = node.value;
-    // std::cout << number << std::endl;
-    if (node.value.length() > 3) {
-        if (node.value.substr(node.value.length() - 3, 3) == "u32") {
-            node.type = "u32";
-            number = node.value.substr(0, node.value.length() - 3);
-            checkIntegerOverflow(number, 1);
-        } else if (node.value.substr(node.value.length() - 3, 3) == "i32") {
-            node.type = "i32";
-            number = node.value.substr(0, node.value.length() - 3);
-            checkIntegerOverflow(number, 0);
-        } else {
-            node.type = "integer";
-            checkIntegerOverflow(number, 1);
-        }
-    } else {
-        node.type = "integer";
-        checkIntegerOverflow(number, 1);
+    // 字面量的数值与后缀已在词法分析时解码
+    switch (node.suffix) {
+        case IntegerSuffix::kU32:
+            node_types[node] = types::kU32;
+            checkIntegerOverflow(node.number, 1);
+            break;
+        case IntegerSuffix::kI32:
+            node_types[node] = types::kI32;
+            checkIntegerOverflow(node.number, 0);
+            break;
+        default:
+            node_types[node] = types::kInteger;
+            checkIntegerOverflow(node.number, 1);
+            break;
     }
 }
 
 void TypeChecker::visit(BoolLiteral& node) {
     // 字面量不包含类型信息，无需类型检查
-    node.type = "bool";
+    node_types[node] = types::kBool;
 }
 
 // 路径和访问表达式
 void TypeChecker::visit(PathExpression& node) {
     std::cout << "[TypeChecker] Entering PathExpr node" << std::endl;
     if (node.path_in_expression) {
-        node.path_in_expression->accept(this);
+        walk(node.path_in_expression);
     }
     if (node.path_in_expression && node.path_in_expression->segment2) {
         auto struct_name = node.path_in_expression->segment1->identifier;
-        if (struct_name == "Self") {
+        if (struct_name == names::kSelfType) {
             struct_name = current_scope->getImplSelfType();
         }
         if (auto struct_symbol = current_scope->findStructSymbol(struct_name)) {
             if (auto const_symbol = struct_symbol->getAssociatedConst(node.path_in_expression->segment2->identifier)) {
-                node.type = const_symbol->getType();
+                node_types[node] = const_symbol->getType();
             }
         } else if (current_scope->enumSymbolExists(struct_name)) {
-            node.type = struct_name;
+            node_types[node] = namedType(current_scope, struct_name);
         }
     } else if (node.path_in_expression && node.path_in_expression->segment1) {
         auto var_name = node.path_in_expression->segment1->identifier;
         if (current_scope->constSymbolExists(var_name)) {
             auto const_symbol = current_scope->findConstSymbol(var_name);
-            node.type = const_symbol->getType();
+            node_types[node] = const_symbol->getType();
         } else if (current_scope->variableExists(var_name)) {
-            node.type = current_scope->findVariableType(var_name);
+            node_types[node] = current_scope->findVariableType(var_name);
         } else {
-            node.type = node.path_in_expression->type;
+            node_types[node] = node_types[node.path_in_expression];
         }
-        node.mutability = node.path_in_expression->mutability;
+        node_mutability[node] = node_mutability[node.path_in_expression];
     }
 }
 
 void TypeChecker::visit(FieldExpression& node) {
     std::cout << "[TypeChecker] Entering FieldExpression node" << std::endl;
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
-    auto deref_type = autoDereference(node.expression->type);
+    auto deref_type = autoDereference(node_types[node.expression]);
     std::shared_ptr<StructSymbol> struct_symbol;
-    struct_symbol = current_scope->findStructSymbol(deref_type);
+    struct_symbol = current_scope->findStructSymbol(types.name(deref_type));
     if (!struct_symbol) {
         throw std::runtime_error("Semantic: FieldExpr struct not found");
     }
     if (!struct_symbol->hasField(node.identifier)) {
         throw std::runtime_error("Semantic: FieldExpr field not found");
     }
-    node.mutability = node.expression->mutability;
+    node_mutability[node] = node_mutability[node.expression];
     // std::cout << node.expression->mutability << std::endl;
-    node.type = struct_symbol->getField(node.identifier)->getType();
+    node_types[node] = struct_symbol->getField(node.identifier)->getType();
 }
 
 // 运算符表达式
 void TypeChecker::visit(UnaryExpression& node) {
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     
     // 根据不同的 unary_type 进行特定的类型检查
     switch (node.type) {
         case UnaryExpression::MINUS:  // -
             // '-' 可以作用到 integer（或 i32, u32, isize, usize）上
-            if (!isIntegerType(node.expression->type)) {
+            if (!isIntegerType(node_types[node.expression])) {
                 throw std::runtime_error("Semantic: Unary minus operator can only be applied to integer types");
             }
-            if (node.expression->type == "integer") {
-                if (auto int_literal = std::dynamic_pointer_cast<IntegerLiteral>(node.expression)) {
-                    checkIntegerOverflow(int_literal->value, 0);
-                    static_cast<ASTNode&>(node).type = "i32";
+            if (node_types[node.expression] == types::kInteger) {
+                if (auto int_literal = dyn_cast<IntegerLiteral>(node.expression)) {
+                    checkIntegerOverflow(int_literal->number, 0);
+                    node_types[node] = types::kI32;
                 } else {
                     // UnaryExpression 的类型与其成员 expr 相同
-                    static_cast<ASTNode&>(node).type = node.expression->type;
+                    node_types[node] = node_types[node.expression];
                 }
             } else {
                 // UnaryExpression 的类型与其成员 expr 相同
-                static_cast<ASTNode&>(node).type = node.expression->type;
+                node_types[node] = node_types[node.expression];
             }
             break;
             
         case UnaryExpression::NOT:    // !
             // '!' 可以作用到 integer 或者 bool 上
-            if (!isIntegerType(node.expression->type) && node.expression->type != "bool") {
+            if (!isIntegerType(node_types[node.expression]) && node_types[node.expression] != types::kBool) {
                 throw std::runtime_error("Semantic: Unary logical not operator can only be applied to integer or bool types");
             }
             // UnaryExpression 的类型与其成员 expr 相同
-            static_cast<ASTNode&>(node).type = node.expression->type;
+            node_types[node] = node_types[node.expression];
             break;
             
         case UnaryExpression::TRY:    // ?
@@ -552,60 +406,60 @@ void TypeChecker::visit(UnaryExpression& node) {
 
 void TypeChecker::visit(BorrowExpression& node) {
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     
     // 借用表达式的类型为引用类型
     // 根据借用表达式的属性构造引用类型
-    std::string ref_prefix = "&";
+    // 可变性记在 node_mutability 中，引用类型中不区分
+    SymbolType type = types.reference(node_types[node.expression]);
     if (node.is_double) {
-        ref_prefix = "&&";
+        type = types.reference(type);
     }
     if (node.is_mutable) {
-        // ref_prefix += "mut ";
-        node.mutability = true;
+        node_mutability[node] = true;
     }
     
     // 借用表达式的类型为 &T 或 &mut T
-    node.type = ref_prefix + node.expression->type;
+    node_types[node] = type;
 }
 
 void TypeChecker::visit(DereferenceExpression& node) {
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     
     // 检查表达式类型是否为引用类型
-    if (node.expression->type.empty() || node.expression->type[0] != '&') {
+    if (!types.isReference(node_types[node.expression])) {
         throw std::runtime_error("Semantic: Cannot dereference non-reference type");
     }
     
     // 解引用表达式的类型为去掉引用标记后的类型
     // 使用 autoDereference 函数来正确处理多重引用
-    node.type = autoDereference(node.expression->type);
-    node.mutability = node.expression->mutability;
+    node_types[node] = autoDereference(node_types[node.expression]);
+    node_mutability[node] = node_mutability[node.expression];
 }
 
 void TypeChecker::visit(BinaryExpression& node) {
     std::cout << "[TypeChecker] Entering BinaryExpression node" << std::endl;
     if (node.lhs) {
-        node.lhs->accept(this);
+        walk(node.lhs);
     }
     if (node.rhs) {
-        node.rhs->accept(this);
+        walk(node.rhs);
     }
     
-    std::cout << "[TypeChecker] BinaryExpression: LHS type = " << node.lhs->type << ", RHS type = " << node.rhs->type << ' ' << node.binary_type << std::endl;
+    std::cout << "[TypeChecker] BinaryExpression: LHS type = " << node_types[node.lhs] << ", RHS type = " << node_types[node.rhs] << ' ' << node.binary_type << std::endl;
 
-    if (node.lhs->type == "integer" && (node.rhs->type == "i32" || node.rhs->type == "isize")) {
-        if (auto int_literal = std::dynamic_pointer_cast<IntegerLiteral>(node.lhs)) {
-            checkIntegerOverflow(int_literal->value, -1);
+    if (node_types[node.lhs] == types::kInteger && (node_types[node.rhs] == types::kI32 || node_types[node.rhs] == types::kIsize)) {
+        if (auto int_literal = dyn_cast<IntegerLiteral>(node.lhs)) {
+            checkIntegerOverflow(int_literal->number, -1);
         }
     }
 
-    if (node.rhs->type == "integer" && (node.lhs->type == "i32" || node.lhs->type == "isize")) {
-        if (auto int_literal = std::dynamic_pointer_cast<IntegerLiteral>(node.rhs)) {
-            checkIntegerOverflow(int_literal->value, -1);
+    if (node_types[node.rhs] == types::kInteger && (node_types[node.lhs] == types::kI32 || node_types[node.lhs] == types::kIsize)) {
+        if (auto int_literal = dyn_cast<IntegerLiteral>(node.rhs)) {
+            checkIntegerOverflow(int_literal->number, -1);
         }
     }
     
@@ -613,22 +467,22 @@ void TypeChecker::visit(BinaryExpression& node) {
     switch (node.binary_type) {
         // 算术运算符：要求操作数为整数类型或字符串类型（仅限 +），不能是 bool
         case BinaryExpression::PLUS:        // +
-            if (node.lhs->type == "bool" || node.rhs->type == "bool") {
+            if (node_types[node.lhs] == types::kBool || node_types[node.rhs] == types::kBool) {
                 throw std::runtime_error("Semantic: Arithmetic operators cannot be applied to bool type");
             }
             // 处理字符串连接
-            if (node.lhs->type == "String" && node.lhs->mutability && node.rhs->type == "str") {
-                node.type = "str";
-            } else if (node.lhs->type == "str" || node.rhs->type == "str") {
+            if (node_types[node.lhs] == types::kString && node_mutability[node.lhs] && node_types[node.rhs] == types::kStr) {
+                node_types[node] = types::kStr;
+            } else if (node_types[node.lhs] == types::kStr || node_types[node.rhs] == types::kStr) {
                 throw std::runtime_error("Semantic: String concatenation requires both operands to be string type");
             } else {
                 // 处理整数类型匹配和 integer 类型推断
-                if (node.lhs->type == node.rhs->type) {
-                    node.type = node.lhs->type;
-                } else if (node.lhs->type == "integer" && (node.rhs->type == "i32" || node.rhs->type == "u32" || node.rhs->type == "isize" || node.rhs->type == "usize")) {
-                    node.type = node.rhs->type;
-                } else if (node.rhs->type == "integer" && (node.lhs->type == "i32" || node.lhs->type == "u32" || node.lhs->type == "isize" || node.lhs->type == "usize")) {
-                    node.type = node.lhs->type;
+                if (node_types[node.lhs] == node_types[node.rhs]) {
+                    node_types[node] = node_types[node.lhs];
+                } else if (node_types[node.lhs] == types::kInteger && (node_types[node.rhs] == types::kI32 || node_types[node.rhs] == types::kU32 || node_types[node.rhs] == types::kIsize || node_types[node.rhs] == types::kUsize)) {
+                    node_types[node] = node_types[node.rhs];
+                } else if (node_types[node.rhs] == types::kInteger && (node_types[node.lhs] == types::kI32 || node_types[node.lhs] == types::kU32 || node_types[node.lhs] == types::kIsize || node_types[node.lhs] == types::kUsize)) {
+                    node_types[node] = node_types[node.lhs];
                 } else {
                     throw std::runtime_error("Semantic: Arithmetic operators require matching types (integer or string)");
                 }
@@ -638,16 +492,16 @@ void TypeChecker::visit(BinaryExpression& node) {
         case BinaryExpression::STAR:        // *
         case BinaryExpression::SLASH:       // /
         case BinaryExpression::PERCENT:     // % {
-            if (node.lhs->type == "bool" || node.rhs->type == "bool") {
+            if (node_types[node.lhs] == types::kBool || node_types[node.rhs] == types::kBool) {
                 throw std::runtime_error("Semantic: Arithmetic operators cannot be applied to bool type");
             }
             // 处理类型匹配和 integer 类型推断
-            if (node.lhs->type == node.rhs->type) {
-                node.type = node.lhs->type;
-            } else if (node.lhs->type == "integer" && (node.rhs->type == "i32" || node.rhs->type == "u32" || node.rhs->type == "isize" || node.rhs->type == "usize")) {
-                node.type = node.rhs->type;
-            } else if (node.rhs->type == "integer" && (node.lhs->type == "i32" || node.lhs->type == "u32" || node.lhs->type == "isize" || node.lhs->type == "usize")) {
-                node.type = node.lhs->type;
+            if (node_types[node.lhs] == node_types[node.rhs]) {
+                node_types[node] = node_types[node.lhs];
+            } else if (node_types[node.lhs] == types::kInteger && (node_types[node.rhs] == types::kI32 || node_types[node.rhs] == types::kU32 || node_types[node.rhs] == types::kIsize || node_types[node.rhs] == types::kUsize)) {
+                node_types[node] = node_types[node.rhs];
+            } else if (node_types[node.rhs] == types::kInteger && (node_types[node.lhs] == types::kI32 || node_types[node.lhs] == types::kU32 || node_types[node.lhs] == types::kIsize || node_types[node.lhs] == types::kUsize)) {
+                node_types[node] = node_types[node.lhs];
             } else {
                 throw std::runtime_error("Semantic: Arithmetic operators require matching integer types");
             }
@@ -657,15 +511,15 @@ void TypeChecker::visit(BinaryExpression& node) {
         case BinaryExpression::CARET:       // ^
         case BinaryExpression::AND:         // &
         case BinaryExpression::OR:          // |
-            if (node.lhs->type == "bool" || node.rhs->type == "bool") {
+            if (node_types[node.lhs] == types::kBool || node_types[node.rhs] == types::kBool) {
 
             } else {
-                if (node.lhs->type == node.rhs->type) {
-                    node.type = node.lhs->type;
-                } else if (node.lhs->type == "integer" && (node.rhs->type == "i32" || node.rhs->type == "u32" || node.rhs->type == "isize" || node.rhs->type == "usize")) {
-                    node.type = node.rhs->type;
-                } else if (node.rhs->type == "integer" && (node.lhs->type == "i32" || node.lhs->type == "u32" || node.lhs->type == "isize" || node.lhs->type == "usize")) {
-                    node.type = node.lhs->type;
+                if (node_types[node.lhs] == node_types[node.rhs]) {
+                    node_types[node] = node_types[node.lhs];
+                } else if (node_types[node.lhs] == types::kInteger && (node_types[node.rhs] == types::kI32 || node_types[node.rhs] == types::kU32 || node_types[node.rhs] == types::kIsize || node_types[node.rhs] == types::kUsize)) {
+                    node_types[node] = node_types[node.rhs];
+                } else if (node_types[node.rhs] == types::kInteger && (node_types[node.lhs] == types::kI32 || node_types[node.lhs] == types::kU32 || node_types[node.lhs] == types::kIsize || node_types[node.lhs] == types::kUsize)) {
+                    node_types[node] = node_types[node.lhs];
                 } else {
                     throw std::runtime_error("Semantic: Bitwise operators require matching integer types");
                 }
@@ -673,17 +527,17 @@ void TypeChecker::visit(BinaryExpression& node) {
             break;
         case BinaryExpression::SHL:         // <<
         case BinaryExpression::SHR:         // >>
-            if (!isIntegerType(node.lhs->type) || !isIntegerType(node.rhs->type)) {
+            if (!isIntegerType(node_types[node.lhs]) || !isIntegerType(node_types[node.rhs])) {
                 throw std::runtime_error("Semantic: Bitwise shift operators require matching integer types");
             }
-            if (node.lhs->type == node.rhs->type) {
-                node.type = node.lhs->type;
-            } else if (node.lhs->type == "integer" && (node.rhs->type == "i32" || node.rhs->type == "u32" || node.rhs->type == "isize" || node.rhs->type == "usize")) {
-                node.type = node.rhs->type;
-            } else if (node.rhs->type == "integer" && (node.lhs->type == "i32" || node.lhs->type == "u32" || node.lhs->type == "isize" || node.lhs->type == "usize")) {
-                node.type = node.lhs->type;
+            if (node_types[node.lhs] == node_types[node.rhs]) {
+                node_types[node] = node_types[node.lhs];
+            } else if (node_types[node.lhs] == types::kInteger && (node_types[node.rhs] == types::kI32 || node_types[node.rhs] == types::kU32 || node_types[node.rhs] == types::kIsize || node_types[node.rhs] == types::kUsize)) {
+                node_types[node] = node_types[node.rhs];
+            } else if (node_types[node.rhs] == types::kInteger && (node_types[node.lhs] == types::kI32 || node_types[node.lhs] == types::kU32 || node_types[node.lhs] == types::kIsize || node_types[node.lhs] == types::kUsize)) {
+                node_types[node] = node_types[node.lhs];
             } else {
-                node.type = node.lhs->type;
+                node_types[node] = node_types[node.lhs];
             }
             break;
             
@@ -695,60 +549,60 @@ void TypeChecker::visit(BinaryExpression& node) {
         case BinaryExpression::GE:          // >=
         case BinaryExpression::LE:          // <= {
             // 处理类型匹配和 integer 类型推断
-            if (node.lhs->type == node.rhs->type) {
+            if (node_types[node.lhs] == node_types[node.rhs]) {
                 // 类型相同，直接接受
-            } else if (node.lhs->type == "integer" && (node.rhs->type == "i32" || node.rhs->type == "u32" || node.rhs->type == "isize" || node.rhs->type == "usize")) {
+            } else if (node_types[node.lhs] == types::kInteger && (node_types[node.rhs] == types::kI32 || node_types[node.rhs] == types::kU32 || node_types[node.rhs] == types::kIsize || node_types[node.rhs] == types::kUsize)) {
                 // integer 提升到具体类型
-            } else if (node.rhs->type == "integer" && (node.lhs->type == "i32" || node.lhs->type == "u32" || node.lhs->type == "isize" || node.lhs->type == "usize")) {
+            } else if (node_types[node.rhs] == types::kInteger && (node_types[node.lhs] == types::kI32 || node_types[node.lhs] == types::kU32 || node_types[node.lhs] == types::kIsize || node_types[node.lhs] == types::kUsize)) {
                 // integer 提升到具体类型
             } else {
                 throw std::runtime_error("Semantic: Comparison operators require matching types (integer, string, or same types)");
             }
-            node.type = "bool";
+            node_types[node] = types::kBool;
             break;
             
         // 逻辑运算符：要求操作数必须为 bool 类型，返回 bool
         case BinaryExpression::AND_AND:     // &&
         case BinaryExpression::OR_OR:       // || {
             // 检查操作数是否为 bool 类型
-            if (node.lhs->type != "bool" || node.rhs->type != "bool") {
+            if (node_types[node.lhs] != types::kBool || node_types[node.rhs] != types::kBool) {
                 throw std::runtime_error("Semantic: Logical operators require bool type operands");
             }
-            node.type = "bool";
+            node_types[node] = types::kBool;
             break;
             
         default:
             throw std::runtime_error("Semantic: BinaryExpression unknown binary type");
     }
     
-    std::cout << "[TypeChecker] BinaryExpression result type: " << node.type << std::endl;
+    std::cout << "[TypeChecker] BinaryExpression result type: " << node_types[node] << std::endl;
 }
 
 void TypeChecker::visit(AssignmentExpression& node) {
     std::cout << "[TypeChecker] Entering AssignmentExpression node" << std::endl;
 
     if (node.lhs) {
-        node.lhs->accept(this);
+        walk(node.lhs);
     }
     if (node.rhs) {
-        node.rhs->accept(this);
+        walk(node.rhs);
     }
     
     // 获取左边表达式的类型，如果是引用类型则需要解引用
-    SymbolType lhs_type = autoDereference(node.lhs->type);
-    SymbolType rhs_type = node.rhs->type;
+    SymbolType lhs_type = autoDereference(node_types[node.lhs]);
+    SymbolType rhs_type = node_types[node.rhs];
     
     // 检查类型是否兼容
     if (!canAssign(lhs_type, rhs_type)) {
         throw std::runtime_error("Semantic: Assignment type mismatch");
     }
     
-    if (!node.lhs->mutability) {
+    if (!node_mutability[node.lhs]) {
         throw std::runtime_error("Semantic: Cannot assign to immutable variable");
     }
     // // 检查左边是否是可赋值的左值
     // // 这里需要检查左边表达式是否为可修改的变量、字段访问、数组访问等
-    // if (auto path_expr = std::dynamic_pointer_cast<PathExpression>(node.lhs)) {
+    // if (auto path_expr = dynamic_cast<PathExpression*>(node.lhs)) {
     //     // 简单变量赋值
     //     if (path_expr->path_in_expression && path_expr->path_in_expression->segment1) {
     //         auto var_name = path_expr->path_in_expression->segment1->identifier;
@@ -756,14 +610,14 @@ void TypeChecker::visit(AssignmentExpression& node) {
     //             throw std::runtime_error("Semantic: Cannot assign to immutable variable");
     //         }
     //     }
-    // } else if (auto field_expr = std::dynamic_pointer_cast<FieldExpression>(node.lhs)) {
+    // } else if (auto field_expr = dynamic_cast<FieldExpression*>(node.lhs)) {
     //     // 字段赋值，需要检查字段的可变性
     //     if (!field_expr->mutability) {
     //         throw std::runtime_error("Semantic: Cannot assign to immutable field");
     //     }
-    // } else if (auto index_expr = std::dynamic_pointer_cast<IndexExpression>(node.lhs)) {
+    // } else if (auto index_expr = dynamic_cast<IndexExpression*>(node.lhs)) {
     //     // 数组索引赋值，需要检查数组的可变性
-    //     if (auto path_expr = std::dynamic_pointer_cast<PathExpression>(index_expr->base_expression)) {
+    //     if (auto path_expr = dynamic_cast<PathExpression*>(index_expr->base_expression)) {
     //         if (path_expr->path_in_expression && path_expr->path_in_expression->segment1) {
     //             auto var_name = path_expr->path_in_expression->segment1->identifier;
     //             if (!current_scope->findVariableMutable(var_name)) {
@@ -777,20 +631,20 @@ void TypeChecker::visit(AssignmentExpression& node) {
     // }
     
     // 赋值表达式的类型为单元类型
-    node.type = "()";
+    node_types[node] = types::kUnit;
 }
 
 void TypeChecker::visit(CompoundAssignmentExpression& node) {
     if (node.lhs) {
-        node.lhs->accept(this);
+        walk(node.lhs);
     }
     if (node.rhs) {
-        node.rhs->accept(this);
+        walk(node.rhs);
     }
     
     // 获取左边表达式的类型，如果是引用类型则需要解引用
-    SymbolType lhs_type = autoDereference(node.lhs->type);
-    SymbolType rhs_type = node.rhs->type;
+    SymbolType lhs_type = autoDereference(node_types[node.lhs]);
+    SymbolType rhs_type = node_types[node.rhs];
     
     // 检查类型是否兼容
     if (!canAssign(lhs_type, rhs_type)) {
@@ -798,30 +652,30 @@ void TypeChecker::visit(CompoundAssignmentExpression& node) {
     }
     
     // 检查操作数是否为整数类型（复合赋值运算符只支持整数，不支持字符串）
-    if (lhs_type == "bool" || rhs_type == "bool" || lhs_type == "str" || rhs_type == "str") {
+    if (lhs_type == types::kBool || rhs_type == types::kBool || lhs_type == types::kStr || rhs_type == types::kStr) {
         throw std::runtime_error("Semantic: Compound assignment operators cannot be applied to bool or string type");
     }
 
-    if (!node.lhs->mutability) {
+    if (!node_mutability[node.lhs]) {
         throw std::runtime_error("Semantic: Cannot compound assign to immutable variable");
     }
     
     // 复合赋值表达式的类型为左边操作数的类型
     // 使用继承自 ASTNode 的 type 字段，而不是 CompoundAssignmentType 字段
-    static_cast<ASTNode&>(node).type = lhs_type;
+    node_types[node] = lhs_type;
 }
 
 void TypeChecker::visit(TypeCastExpression& node) {
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     if (node.type) {
-        node.type->accept(this);
+        walk(node.type);
     }
     
     // 获取源类型和目标类型
-    SymbolType source_type = node.expression->type;
-    SymbolType target_type = typeToString(node.type);
+    SymbolType source_type = node_types[node.expression];
+    SymbolType target_type = typeFromNode(current_scope, node.type);
 
     source_type = autoDereference(source_type);
     
@@ -835,11 +689,11 @@ void TypeChecker::visit(TypeCastExpression& node) {
     
     // 规则2: Primitive to integer cast
     // bool -> integer: false -> 0, true -> 1
-    else if (source_type == "bool" && isIntegerType(target_type)) {
+    else if (source_type == types::kBool && isIntegerType(target_type)) {
         is_valid_cast = true;
     }
     // char -> integer: 转换为 Unicode 码点值
-    else if (source_type == "char" && isIntegerType(target_type)) {
+    else if (source_type == types::kChar && isIntegerType(target_type)) {
         is_valid_cast = true;
     }
     
@@ -849,29 +703,29 @@ void TypeChecker::visit(TypeCastExpression& node) {
     
     // 类型转换表达式的类型就是目标类型
     // 使用继承自 ASTNode 的 type 字段
-    static_cast<ASTNode&>(node).type = target_type;
+    node_types[node] = target_type;
 }
 
-void TypeChecker::checkFunctionParams(const std::vector<std::shared_ptr<Expression>>& call_params, const std::vector<std::shared_ptr<VariableSymbol>>& func_params) {
+void TypeChecker::checkFunctionParams(const std::vector<Expression*>& call_params, const std::vector<std::shared_ptr<VariableSymbol>>& func_params) {
     // std::cout << call_params.size() << ' ' << func_params.size() << std::endl;
     if (call_params.size() != func_params.size()) {
         throw std::runtime_error("Semantic: CallExpr function param number not match");
     }
     for (size_t _ = 0; _ < call_params.size(); ++_) {
-        if (!canAssign(func_params[_]->getType(), call_params[_]->type)) {
+        if (!canAssign(func_params[_]->getType(), node_types[call_params[_]])) {
             // std::cout << func_params[_]->getType() << ' ' << call_params[_]->type << std::endl;
             throw std::runtime_error("Semantic: CallExpr function param type not match");
         }
         // std::cout << call_params[_]->type << std::endl;
-        if (call_params[_]->type == "integer" && (func_params[_]->getType() == "i32" || func_params[_]->getType() == "isize")) {
-            if (auto int_literal = std::dynamic_pointer_cast<IntegerLiteral>(call_params[_]->child)) {
+        if (node_types[call_params[_]] == types::kInteger && (func_params[_]->getType() == types::kI32 || func_params[_]->getType() == types::kIsize)) {
+            if (auto int_literal = dyn_cast<IntegerLiteral>(call_params[_])) {
                 // std::cout << "?" << std::endl;
-                checkIntegerOverflow(int_literal->value, -1);
+                checkIntegerOverflow(int_literal->number, -1);
             }
         }
         if (func_params[_]->getMut() >= 2) {
-            if (auto path_expr = std::dynamic_pointer_cast<PathExpression>(call_params[_]->child)) {
-                if (auto path_in_expr = std::dynamic_pointer_cast<PathInExpression>(path_expr->path_in_expression)) {
+            if (auto path_expr = dyn_cast<PathExpression>(call_params[_])) {
+                if (auto path_in_expr = dyn_cast<PathInExpression>(path_expr->path_in_expression)) {
                     auto identifier = path_in_expr->segment1->identifier;
                     if (!current_scope->findVariableMutable(identifier)) {
                         // std::cout << identifier << std::endl;
@@ -881,7 +735,7 @@ void TypeChecker::checkFunctionParams(const std::vector<std::shared_ptr<Expressi
                     throw std::runtime_error("Semantic: CallExpr function param mutability not match2");
                 }
             } else {
-                if (auto borrow_expr = std::dynamic_pointer_cast<BorrowExpression>(call_params[_]->child)) {
+                if (auto borrow_expr = dyn_cast<BorrowExpression>(call_params[_])) {
                     if (!borrow_expr->is_mutable) {
                         throw std::runtime_error("Semantic: CallExpr function param mutability not match3");
                     }
@@ -897,21 +751,21 @@ void TypeChecker::checkFunctionParams(const std::vector<std::shared_ptr<Expressi
 void TypeChecker::visit(CallExpression& node) {
     std::cout << "[TypeChecker] Entering CallExpression node" << std::endl;
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     if (node.call_params) {
-        node.call_params->accept(this);
+        walk(node.call_params);
     }
-    if (auto path_expr = std::dynamic_pointer_cast<PathExpression>(node.expression)) {
+    if (auto path_expr = dyn_cast<PathExpression>(node.expression)) {
         // std::cout << "GOOD" << std::endl;
-        auto path_in_expr = std::dynamic_pointer_cast<PathInExpression>(path_expr->path_in_expression);
+        auto path_in_expr = dyn_cast<PathInExpression>(path_expr->path_in_expression);
         // std::cout << "GOOD" << std::endl;
         // std::cout << (path_in_expr == nullptr) << std::endl;
         if (path_in_expr->segment2) {
             // std::cout << "?" << std::endl;
             auto struct_identifier = path_in_expr->segment1->identifier;
             std::cout << struct_identifier << std::endl;
-            if (struct_identifier == "Self") {
+            if (struct_identifier == names::kSelfType) {
                 struct_identifier = current_scope->getImplSelfType();
             }
             auto struct_symbol = current_scope->findStructSymbol(struct_identifier);
@@ -931,8 +785,8 @@ void TypeChecker::visit(CallExpression& node) {
                             throw std::runtime_error("Semantic: CallExpr param number not match");
                         }
                     }
-                    node.type = func_symbol->getReturnType();
-                    std::cout << "[TypeChecker] CallExpression to associated function: " << path_in_expr->segment2->identifier << ", return type: " << node.type << std::endl;
+                    node_types[node] = func_symbol->getReturnType();
+                    std::cout << "[TypeChecker] CallExpression to associated function: " << path_in_expr->segment2->identifier << ", return type: " << node_types[node] << std::endl;
                 } else {
                     std::cout << path_in_expr->segment2->identifier << std::endl;
                     throw std::runtime_error("Semantic: CallExpr function not found2");
@@ -943,7 +797,7 @@ void TypeChecker::visit(CallExpression& node) {
         } else {
             // std::cout << "!" << std::endl;
             auto identifier = path_in_expr->segment1->identifier;
-            if (identifier == "exit") {
+            if (identifier == names::kExit) {
                 exit_num++;
                 // std::cout << "?" << std::endl;
                 auto scope = current_scope;
@@ -953,7 +807,7 @@ void TypeChecker::visit(CallExpression& node) {
                 if (!scope) {
                     throw std::runtime_error("Semantic: exit wrong place");
                 }
-                if (scope->getSelfType() != "main") {
+                if (scope->getSelfType() != names::kMain) {
                     throw std::runtime_error("Semantic: exit wrong place");
                 }
             }
@@ -971,8 +825,8 @@ void TypeChecker::visit(CallExpression& node) {
                         throw std::runtime_error("Semantic: CallExpr param number not match");
                     }
                 }
-                node.type = func_symbol->getReturnType();
-                std::cout << "[TypeChecker] CallExpression to function: " << path_in_expr->segment1->identifier << ", return type: " << node.type << std::endl;
+                node_types[node] = func_symbol->getReturnType();
+                std::cout << "[TypeChecker] CallExpression to function: " << path_in_expr->segment1->identifier << ", return type: " << node_types[node] << std::endl;
             } else {
                 std::cout << path_in_expr->segment1->identifier << std::endl;
                 throw std::runtime_error("Semantic: CallExpr function not found1");
@@ -986,29 +840,29 @@ void TypeChecker::visit(CallExpression& node) {
 void TypeChecker::visit(MethodCallExpression& node) {
     std::cout << "[TypeChecker] Entering MethodCallExpression node" << std::endl;
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
     if (node.call_params) {
-        node.call_params->accept(this);
+        walk(node.call_params);
     }
-    std::string var_type;
+    SymbolType var_type;
 
-    var_type = autoDereference(node.expression->type);
-    if (var_type == "integer") {
-        var_type = "u32";
+    var_type = autoDereference(node_types[node.expression]);
+    if (var_type == types::kInteger) {
+        var_type = types::kU32;
     }
 
-    if (node.path_ident_segment->identifier == "len") {
-        if (var_type[0] == '[') {
+    if (node.path_ident_segment->identifier == names::kLen) {
+        if (types.isArray(var_type)) {
             if (node.call_params != nullptr) {
                 throw std::runtime_error("Semantic: MethodCallExpr param number not match");
             }
-            node.type = "u32";
+            node_types[node] = types::kU32;
             return;
         }
     }
     // std::cout << var_type << std::endl;
-    auto struct_symbol = current_scope->findStructSymbol(var_type);
+    auto struct_symbol = current_scope->findStructSymbol(types.name(var_type));
     // std::cout << struct_symbol->getIdentifier() << std::endl;
     if (struct_symbol) {
         auto func_symbol = struct_symbol->getMethod(node.path_ident_segment->identifier);
@@ -1020,7 +874,7 @@ void TypeChecker::visit(MethodCallExpression& node) {
             auto method_type = func_symbol->getMethodType();
             // std::cout << func_symbol->getMethodTypeString() << std::endl;
             if (method_type == MethodType::SELF_MUT_REF || method_type == MethodType::SELF_MUT_VALUE) {
-                if (!node.expression->mutability) {
+                if (!node_mutability[node.expression]) {
                     // std::cout << func_symbol->getIdentifier() << std::endl;
                     throw std::runtime_error("Semantic: MethodCallExpr not mutable");
                 }
@@ -1034,8 +888,8 @@ void TypeChecker::visit(MethodCallExpression& node) {
                     throw std::runtime_error("Semantic: MethodCallExpr param number not match");
                 }
             }
-            node.type = func_symbol->getReturnType();
-            std::cout << "[TypeChecker] MethodCallExpression to method: " << node.path_ident_segment->identifier << " on type " << var_type << ", return type: " << node.type << std::endl;
+            node_types[node] = func_symbol->getReturnType();
+            std::cout << "[TypeChecker] MethodCallExpression to method: " << node.path_ident_segment->identifier << " on type " << var_type << ", return type: " << node_types[node] << std::endl;
         } else {
             throw std::runtime_error("Semantic: MethodCallExpr function not found");
         }
@@ -1046,34 +900,30 @@ void TypeChecker::visit(MethodCallExpression& node) {
 
 void TypeChecker::visit(IndexExpression& node) {
     if (node.base_expression) {
-        node.base_expression->accept(this);
+        walk(node.base_expression);
     }
     if (node.index_expression) {
-        node.index_expression->accept(this);
+        walk(node.index_expression);
     }
-    if (node.index_expression->type != "integer" && node.index_expression->type != "usize") {
+    if (node_types[node.index_expression] != types::kInteger && node_types[node.index_expression] != types::kUsize) {
         throw std::runtime_error("Semantic: IndexExpr index not usize");
     }
-    auto arr_type = autoDereference(node.base_expression->type);
-    if (arr_type[0] != '[') {
+    auto arr_type = autoDereference(node_types[node.base_expression]);
+    if (!types.isArray(arr_type)) {
         // std::cout << arr_type << std::endl;
         throw std::runtime_error("Semantic: IndexExpr not array");
     }
-    auto type = arr_type;
-    while (type.back() != ']') type.pop_back();
-    type = type.substr(1, type.length() - 2);
-    type = autoDereference(type);
-    node.type = type;
-    node.mutability = node.base_expression->mutability;
+    node_types[node] = autoDereference(types.element(arr_type));
+    node_mutability[node] = node_mutability[node.base_expression];
 }
 
 // 结构体和数组表达式
 void TypeChecker::visit(StructExpression& node) {
     if (node.path_in_expression) {
-        node.path_in_expression->accept(this);
+        walk(node.path_in_expression);
     }
     if (node.struct_expr_fields) {
-        node.struct_expr_fields->accept(this);
+        walk(node.struct_expr_fields);
     }
     auto struct_symbol = current_scope->findStructSymbol(node.path_in_expression->segment1->identifier);
     auto struct_expr_fields = node.struct_expr_fields->struct_expr_fields;
@@ -1083,28 +933,28 @@ void TypeChecker::visit(StructExpression& node) {
     }
     for (size_t _ = 0; _ < struct_expr_fields.size(); ++_) {
         auto identifier = struct_expr_fields[_]->identifier;
-        auto type = struct_expr_fields[_]->type;
+        auto type = node_types[struct_expr_fields[_]];
         auto struct_field = struct_symbol->getField(identifier);
         if (!canAssign(struct_field->getType(), type)) {
             // std::cout << struct_field->getType() << ' ' << type << std::endl;
             throw std::runtime_error("Semantic: StructExpression field type not match");
         }
     }
-    node.type = struct_symbol->getIdentifier();
+    node_types[node] = types.named(struct_symbol->getIdentifier(), struct_symbol.get());
 }
 
 void TypeChecker::visit(ArrayExpression& node) {
     if (node.array_elements) {
-        node.array_elements->accept(this);
+        walk(node.array_elements);
     }
-    node.type = node.array_elements->type;
+    node_types[node] = node_types[node.array_elements];
 }
 
 void TypeChecker::visit(GroupedExpression& node) {
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
-    node.type = node.expression->type;
+    node_types[node] = node_types[node.expression];
 }
 
 // 控制流表达式
@@ -1115,68 +965,65 @@ void TypeChecker::visit(BlockExpression& node) {
     current_scope = current_scope->getChild();
     
     if (node.statements) {
-        node.statements->accept(this);
+        walk(node.statements);
     }
 
     std::cout << "[TypeChecker] checking BlockExpression node" << std::endl;
     // 实现尾表达式检测和类型推断
     if (node.statements && !node.statements->statements.empty()) {
         // 检测尾表达式
-        std::shared_ptr<ASTNode> tail_expression = nullptr;
+        ASTNode* tail_expression = nullptr;
         
         // 从最后一个语句开始向前查找尾表达式
         auto it = node.statements->statements.rbegin();
 
         // 检查是否为 ExpressionStatement
-        if (auto stmt = std::dynamic_pointer_cast<Statement>(*it)) {
-            if (auto expr_stmt = std::dynamic_pointer_cast<ExpressionStatement>(stmt->child)) {
+        if (auto stmt = dyn_cast<Statement>(*it)) {
+            if (auto expr_stmt = dyn_cast<ExpressionStatement>(stmt->child)) {
                 if (!expr_stmt->has_semi) {
                     // 没有分号的 ExpressionStatement 是尾表达式
                     tail_expression = expr_stmt->child;
                 }
-                if (auto expr_without_block = std::dynamic_pointer_cast<ExpressionWithoutBlock>(expr_stmt->child)) {
-                    if (auto return_expr = std::dynamic_pointer_cast<ReturnExpression>(expr_without_block->child)) {
-                        node.is_last_stmt_return = true;
-                    }
-                }  else if (auto expr_with_block = std::dynamic_pointer_cast<ExpressionWithBlock>(expr_stmt->child)) {
-                    if (auto loop_expr = std::dynamic_pointer_cast<LoopExpression>(expr_with_block->child)) {
-                        node.is_last_stmt_return = loop_expr->is_last_stmt_return;
-                    }
+                if (isa<ReturnExpression>(expr_stmt->child)) {
+                    node.is_last_stmt_return = true;
+                } else if (auto loop_expr = dyn_cast<LoopExpression>(expr_stmt->child)) {
+                    node.is_last_stmt_return = loop_expr->is_last_stmt_return;
                 }
             }
-        } else if (auto expr_without_block = std::dynamic_pointer_cast<ExpressionWithoutBlock>(*it)) {
-            tail_expression = expr_without_block;
-            if (auto return_expr = std::dynamic_pointer_cast<ReturnExpression>(expr_without_block->child)) {
+        } else if (isa<Expression>(*it)) {
+            // 末尾不带分号的表达式直接作为尾表达式存放
+            tail_expression = *it;
+            if (isa<ReturnExpression>(*it)) {
                 node.is_last_stmt_return = true;
             }
         }
         
         if (tail_expression) {
             // 有尾表达式的情况，使用该表达式的类型
-            node.type = tail_expression->type;
+            node_types[node] = node_types[tail_expression];
         } else {
             // 没有尾表达式，需要判断是否为 ! 类型
             auto last_stmt = node.statements->statements.back();
-            std::string last_stmt_type = last_stmt ? last_stmt->type : "()";
+            SymbolType last_stmt_type = last_stmt ? node_types[last_stmt] : types::kUnit;
             
             // 检查最后一句是否是 break | continue | return
             bool is_never_type = false;
-            if (last_stmt_type == "!") {
+            if (last_stmt_type == types::kNever) {
                 is_never_type = true;
             }
             
             if (is_never_type) {
-                node.type = "!";
+                node_types[node] = types::kNever;
             } else {
-                node.type = "()";
+                node_types[node] = types::kUnit;
             }
         }
     } else {
         // 没有语句，类型为 ()
-        node.type = "()";
+        node_types[node] = types::kUnit;
     }
     
-    std::cout << "[TypeChecker] BlockExpression type: " << node.type << std::endl;
+    std::cout << "[TypeChecker] BlockExpression type: " << node_types[node] << std::endl;
     current_scope = prev_scope;
     current_scope->nextChild();
 }
@@ -1184,41 +1031,41 @@ void TypeChecker::visit(BlockExpression& node) {
 void TypeChecker::visit(IfExpression& node) {
     std::cout << "[TypeChecker] Entering IfExpression node" << std::endl;
     if (node.condition) {
-        node.condition->accept(this);
+        walk(node.condition);
     }
     
     // 检查条件必须是 bool 类型
-    if (node.condition->type != "bool") {
+    if (node_types[node.condition] != types::kBool) {
         throw std::runtime_error("Semantic: If condition must be bool type");
     }
     
     if (node.then_block) {
-        node.then_block->accept(this);
+        walk(node.then_block);
     }
     if (node.else_branch) {
-        node.else_branch->accept(this);
+        walk(node.else_branch);
     }
 
     if (!node.else_branch) {
-        node.type = "()";
+        node_types[node] = types::kUnit;
     } else {
         // 类型推断逻辑
-        std::string then_type = node.then_block ? node.then_block->type : "()";
-        std::string else_type = node.else_branch ? node.else_branch->type : "()";
+        SymbolType then_type = node.then_block ? node_types[node.then_block] : types::kUnit;
+        SymbolType else_type = node.else_branch ? node_types[node.else_branch] : types::kUnit;
 
         // 处理 never 类型（!）
-        bool then_is_never = (then_type == "!");
-        bool else_is_never = (else_type == "!");
+        bool then_is_never = (then_type == types::kNever);
+        bool else_is_never = (else_type == types::kNever);
 
         if (then_is_never && else_is_never) {
             // 两个分支都是 never，结果是 never
-            node.type = "!";
+            node_types[node] = types::kNever;
         } else if (then_is_never) {
             // then 分支是 never，结果是 else 分支类型
-            node.type = else_type;
+            node_types[node] = else_type;
         } else if (else_is_never) {
             // else 分支是 never，结果是 then 分支类型
-            node.type = then_type;
+            node_types[node] = then_type;
         } else {
             // 两个分支都不是 never，需要类型兼容
             bool types_compatible = false;
@@ -1226,16 +1073,16 @@ void TypeChecker::visit(IfExpression& node) {
             // 如果类型相同，则兼容
             if (then_type == else_type) {
                 types_compatible = true;
-                node.type = then_type;
+                node_types[node] = then_type;
             }
             // 处理 integer 类型推断
-            else if (then_type == "integer" && isIntegerType(else_type)) {
+            else if (then_type == types::kInteger && isIntegerType(else_type)) {
                 types_compatible = true;
-                node.type = else_type; // 使用具体类型
+                node_types[node] = else_type; // 使用具体类型
             }
-            else if (else_type == "integer" && isIntegerType(then_type)) {
+            else if (else_type == types::kInteger && isIntegerType(then_type)) {
                 types_compatible = true;
-                node.type = then_type; // 使用具体类型
+                node_types[node] = then_type; // 使用具体类型
             }
             
             if (!types_compatible) {
@@ -1243,15 +1090,15 @@ void TypeChecker::visit(IfExpression& node) {
             }
         }
     }
-    std::cout << "[TypeChecker] IfExpression type: " << node.type << std::endl;
+    std::cout << "[TypeChecker] IfExpression type: " << node_types[node] << std::endl;
 }
 
 void TypeChecker::visit(LoopExpression& node) {
     if (node.child) {
-        node.child->accept(this);
+        walk(node.child);
     }
-    node.type = node.child->type;
-    if (auto infinite_loop_expr = std::dynamic_pointer_cast<InfiniteLoopExpression>(node.child)) {
+    node_types[node] = node_types[node.child];
+    if (auto infinite_loop_expr = dyn_cast<InfiniteLoopExpression>(node.child)) {
         node.is_last_stmt_return = infinite_loop_expr->is_last_stmt_return;
     }
 }
@@ -1262,16 +1109,16 @@ void TypeChecker::visit(InfiniteLoopExpression& node) {
     current_scope = current_scope->getChild();
     
     if (node.block_expression) {
-        node.block_expression->accept(this);
+        walk(node.block_expression);
     }
     
     // 获取 LOOP scope 的 break_type 作为 InfiniteLoopExpression 的类型
-    std::string break_type = current_scope->getBreakType();
+    SymbolType break_type = current_scope->getBreakType();
     if (break_type.empty()) {
         // 如果没有 break 语句，类型为 ()
-        node.type = "()";
+        node_types[node] = types::kUnit;
     } else {
-        node.type = break_type;
+        node_types[node] = break_type;
     }
 
     // std::cout << prev_scope->hasBreak() << ' ' << prev_scope->hasReturn() << std::endl;
@@ -1291,24 +1138,24 @@ void TypeChecker::visit(PredicateLoopExpression& node) {
     current_scope = current_scope->getChild();
     
     if (node.condition) {
-        node.condition->accept(this);
+        walk(node.condition);
     }
     if (node.block_expression) {
-        node.block_expression->accept(this);
+        walk(node.block_expression);
     }
     
     current_scope = prev_scope;
     current_scope->nextChild();
 
-    node.type = "()";
+    node_types[node] = types::kUnit;
 }
 
 void TypeChecker::visit(BreakExpression& node) {
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
 
-    node.type = "!";
+    node_types[node] = types::kNever;
 
     auto scope = current_scope;
     bool in_loop = false;
@@ -1325,8 +1172,8 @@ void TypeChecker::visit(BreakExpression& node) {
     }
 
     // 记录 break 表达式的类型到 LOOP scope
-    std::string break_expr_type = node.expression ? node.expression->type : "()";
-    std::string current_break_type = scope->getBreakType();
+    SymbolType break_expr_type = node.expression ? node_types[node.expression] : types::kUnit;
+    SymbolType current_break_type = scope->getBreakType();
     
     if (current_break_type.empty()) {
         // 第一次设置 break_type
@@ -1340,12 +1187,12 @@ void TypeChecker::visit(BreakExpression& node) {
             types_compatible = true;
         }
         // 如果一个是 integer，另一个是具体整型，则兼容
-        else if (current_break_type == "integer" && isIntegerType(break_expr_type)) {
+        else if (current_break_type == types::kInteger && isIntegerType(break_expr_type)) {
             types_compatible = true;
             // 将 break_type 更新为具体类型
             scope->setBreakType(break_expr_type);
         }
-        else if (break_expr_type == "integer" && isIntegerType(current_break_type)) {
+        else if (break_expr_type == types::kInteger && isIntegerType(current_break_type)) {
             types_compatible = true;
             // 保持当前的具体类型
         }
@@ -1357,7 +1204,7 @@ void TypeChecker::visit(BreakExpression& node) {
 }
 
 void TypeChecker::visit(ContinueExpression& node) {
-    node.type = "!";
+    node_types[node] = types::kNever;
 
     auto scope = current_scope;
     bool in_loop = false;
@@ -1375,12 +1222,12 @@ void TypeChecker::visit(ContinueExpression& node) {
 
 void TypeChecker::visit(ReturnExpression& node) {
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
 
     // 查找包含当前 return 语句的函数作用域
     auto scope = current_scope;
-    std::string func_name = "";
+    Name func_name;
     
     // 向上遍历作用域链，找到第一个 FUNCTION 类型的作用域
     while (scope) {
@@ -1408,18 +1255,18 @@ void TypeChecker::visit(ReturnExpression& node) {
                 
                 // 检查返回表达式类型是否与函数返回类型匹配
                 if (node.expression) {
-                    auto expr_type = node.expression->type;
+                    auto expr_type = node_types[node.expression];
                     if (!canAssign(return_type, expr_type)) {
                         throw std::runtime_error("Semantic: Return type mismatch: expected " + return_type + ", got " + expr_type);
                     }
-                    if ((return_type == "i32" || return_type == "isize") && expr_type == "integer") {
-                        if (auto int_literal = std::dynamic_pointer_cast<IntegerLiteral>(node.expression->child)) {
-                            checkIntegerOverflow(int_literal->value, -1);
+                    if ((return_type == types::kI32 || return_type == types::kIsize) && expr_type == types::kInteger) {
+                        if (auto int_literal = dyn_cast<IntegerLiteral>(node.expression)) {
+                            checkIntegerOverflow(int_literal->number, -1);
                         }
                     }
                 } else {
                     // 无返回值的函数，返回类型必须是 "()"
-                    if (return_type != "()") {
+                    if (return_type != types::kUnit) {
                         throw std::runtime_error("Semantic: Return type mismatch: expected " + return_type + ", got ()");
                     }
                 }
@@ -1428,24 +1275,24 @@ void TypeChecker::visit(ReturnExpression& node) {
     }
     
     // ReturnExpression 的类型为 "!" (never type)
-    node.type = "!";
+    node_types[node] = types::kNever;
 }
 
 // 辅助表达式节点
 void TypeChecker::visit(Condition& node) {
     if (node.expression) {
-        node.expression->accept(this);
+        walk(node.expression);
     }
-    if (node.expression->type != "bool") {
+    if (node_types[node.expression] != types::kBool) {
         throw std::runtime_error("Semantic: Condition not bool");
     }
-    node.type = "bool";
+    node_types[node] = types::kBool;
 }
 
 void TypeChecker::visit(ArrayElements& node) {
     for (auto& expr : node.expressions) {
         if (expr) {
-            expr->accept(this);
+            walk(expr);
         }
     }
     if (node.is_semicolon_separated) {
@@ -1454,107 +1301,72 @@ void TypeChecker::visit(ArrayElements& node) {
             throw std::runtime_error("Semantic: Array length not integer");
         }
         auto len_int = std::dynamic_pointer_cast<ConstValueInt>(len);
-        SymbolType type = '[' + node.expressions[0]->type + ']' + std::to_string(len_int->getValue());
-        node.type = type;
+        SymbolType type = types.array(node_types[node.expressions[0]], len_int->getValue());
+        node_types[node] = type;
     } else {
-        SymbolType base_type = node.expressions[0]->type;
+        SymbolType base_type = node_types[node.expressions[0]];
         for (auto & expr : node.expressions) {
-            if (canAssign(expr->type, base_type)) {
-                base_type = expr->type;
-            } else if (canAssign(base_type, expr->type)) {
+            if (canAssign(node_types[expr], base_type)) {
+                base_type = node_types[expr];
+            } else if (canAssign(base_type, node_types[expr])) {
                 
             } else {
                 throw std::runtime_error("Semantic: Array expr type not match");
             }
         }
-        SymbolType type = '[' + base_type + ']' + std::to_string(node.expressions.size());
-        node.type = type;
-    }
-}
-
-void TypeChecker::visit(StructExprFields& node) {
-    for (auto& field : node.struct_expr_fields) {
-        if (field) {
-            field->accept(this);
-        }
+        SymbolType type = types.array(base_type, node.expressions.size());
+        node_types[node] = type;
     }
 }
 
 void TypeChecker::visit(StructExprField& node) {
     if (node.expression) {
-        node.expression->accept(this);
-    }
-    node.type = node.expression->type;
-}
-
-void TypeChecker::visit(CallParams& node) {
-    for (auto& expr : node.expressions) {
-        if (expr) {
-            expr->accept(this);
-        }
+        walk(node.expression);
     }
+    node_types[node] = node_types[node.expression];
 }
 
 // 模式类节点
 void TypeChecker::visit(PatternNoTopAlt& node) {
     if (node.child) {
-        node.child->accept(this);
+        walk(node.child);
     }
-    node.type = node.child->type;
+    node_types[node] = node_types[node.child];
 }
 
 void TypeChecker::visit(IdentifierPattern& node) {
     // IdentifierPattern 不包含类型信息，无需类型检查
-    node.type = current_scope->findVariableType(node.identifier);
+    node_types[node] = current_scope->findVariableType(node.identifier);
 }
 
 void TypeChecker::visit(ReferencePattern& node) {
     if (node.pattern) {
-        node.pattern->accept(this);
+        walk(node.pattern);
     }
-    node.type = "&" + node.pattern->type;
-    if (node.is_mutable) node.mutability = true; 
+    node_types[node] = types.reference(node_types[node.pattern]);
+    if (node.is_mutable) node_mutability[node] = true; 
 }
 
 // 类型类节点
 void TypeChecker::visit(Type& node) {
     if (node.child) {
-        node.child->accept(this);
+        walk(node.child);
     }
-    node.type = typeToString_(current_scope, std::make_shared<Type>(node));
-}
-
-void TypeChecker::visit(ReferenceType& node) {
-    if (node.type) {
-        node.type->accept(this);
-    }
-}
-
-void TypeChecker::visit(ArrayType& node) {
-    if (node.type) {
-        node.type->accept(this);
-    }
-    if (node.expression) {
-        node.expression->accept(this);
-    }
-}
-
-void TypeChecker::visit(UnitType& node) {
-    // UnitType 不包含类型信息，无需类型检查
+    node_types[node] = typeFromNode_(current_scope, &node);
 }
 
 // 路径类节点
 void TypeChecker::visit(PathInExpression& node) {
     std::cout << "[TypeChecker] Entering PathInExpr node" << std::endl;
     if (node.segment1) {
-        node.segment1->accept(this);
+        walk(node.segment1);
     }
     if (node.segment2) {
-        node.segment2->accept(this);
-        node.type = node.segment1->type + "::" + node.segment2->type;
+        walk(node.segment2);
+        // 带两段的路径由外层的 PathExpression、CallExpression 按符号解析，这里不另造 A::B 的类型名
     } else {
-        node.mutability = node.segment1->mutability;
-        node.type = node.segment1->type;
+        node_mutability[node] = node_mutability[node.segment1];
+        node_types[node] = node_types[node.segment1];
     }
 }
 
@@ -1564,21 +1376,21 @@ void TypeChecker::visit(PathIdentSegment& node) {
     if (node.path_type == 0) {
         if (current_scope->constSymbolExists(node.identifier)) {
             auto const_symbol = current_scope->findConstSymbol(node.identifier);
-            node.type = const_symbol->getType();
+            node_types[node] = const_symbol->getType();
         } else if (current_scope->variableExists(node.identifier)) {
-            node.mutability = current_scope->findVariableMutable(node.identifier);
-            node.type = current_scope->findVariableType(node.identifier);
+            node_mutability[node] = current_scope->findVariableMutable(node.identifier);
+            node_types[node] = current_scope->findVariableType(node.identifier);
         } else {
-            node.type = node.identifier;
+            node_types[node] = namedType(current_scope, node.identifier);
         }
     } else if (node.path_type == 1) {
-        if (current_scope->variableExists("self")) {
-            node.mutability = current_scope->findVariableMutable(node.identifier);
-            node.type = current_scope->findVariableType(node.identifier);
+        if (current_scope->variableExists(names::kSelfValue)) {
+            node_mutability[node] = current_scope->findVariableMutable(node.identifier);
+            node_types[node] = current_scope->findVariableType(node.identifier);
         } else {
             throw std::runtime_error("Semantic: PathIdentSegment unexpected self");
         }
     } else {
-        node.type = current_scope->getImplSelfType();
+        node_types[node] = namedType(current_scope, current_scope->getImplSelfType());
     }
 }
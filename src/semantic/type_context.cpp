@@ -0,0 +1,116 @@
+#include "semantic/type_context.hpp"
+#include <ostream>
+#include <stdexcept>
+
+TypeContext::TypeContext() {
+    entries.emplace_back();
+    // 顺序与 types 命名空间中的常量一致
+    addNamed(TypeKind::kUnit, Name("()"));
+    addNamed(TypeKind::kNever, Name("!"));
+    for (const char* name: {"integer", "bool", "char", "i32", "u32", "isize", "usize", "str", "String"}) {
+        addNamed(TypeKind::kPrimitive, Name(name));
+    }
+    if (entries.size() != types::kString.getId() + 1) {
+        throw std::runtime_error("TypeContext: builtin types out of order");
+    }
+}
+
+TypeContext& TypeContext::global() {
+    static TypeContext context;
+    return context;
+}
+
+TypeId TypeContext::add(TypeData type) {
+    TypeId id = TypeId::fromId(entries.size());
+    entries.push_back(std::move(type));
+    return id;
+}
+
+TypeContext::TypeData TypeContext::namedData(TypeKind kind, Name name) const {
+    TypeData type;
+    type.kind = kind;
+    type.name = name;
+    type.spelling = name.str();
+    return type;
+}
+
+TypeId TypeContext::addNamed(TypeKind kind, Name name) {
+    TypeId id = add(namedData(kind, name));
+    by_name.emplace(name, id);
+    return id;
+}
+
+TypeId TypeContext::named(Name name, const Symbol* declaration) {
+    auto it = by_name.find(name);
+    // 内建类型名总是内建类型，main 中为其登记的方法符号不改变这一点
+    if (it != by_name.end() && (!declaration || kind(it->second) != TypeKind::kNamed)) return it->second;
+    if (!declaration) return addNamed(TypeKind::kNamed, name);
+    Key key{TypeKind::kNamed, name.getId(), int64_t(reinterpret_cast<uintptr_t>(declaration))};
+    auto found = ids.find(key);
+    if (found != ids.end()) return found->second;
+    TypeId id = add(namedData(TypeKind::kNamed, name));
+    ids.emplace(key, id);
+    return id;
+}
+
+TypeId TypeContext::reference(TypeId element) {
+    Key key{TypeKind::kReference, element.getId(), 0};
+    auto it = ids.find(key);
+    if (it != ids.end()) return it->second;
+    TypeData type;
+    type.kind = TypeKind::kReference;
+    type.element = element;
+    type.spelling = "&" + str(element);
+    TypeId id = add(std::move(type));
+    ids.emplace(key, id);
+    return id;
+}
+
+TypeId TypeContext::array(TypeId element, int64_t length) {
+    Key key{TypeKind::kArray, element.getId(), length};
+    auto it = ids.find(key);
+    if (it != ids.end()) return it->second;
+    TypeData type;
+    type.kind = TypeKind::kArray;
+    type.element = element;
+    type.length = length;
+    type.spelling = "[" + str(element) + "]";
+    if (length != kUnknownLength) type.spelling += std::to_string(length);
+    TypeId id = add(std::move(type));
+    ids.emplace(key, id);
+    return id;
+}
+
+TypeId TypeContext::innermost(TypeId type) const {
+    while (isArray(type)) type = element(type);
+    return type;
+}
+
+bool TypeContext::isInteger(TypeId type) const {
+    return type == types::kInteger || type == types::kI32 || type == types::kU32
+        || type == types::kIsize || type == types::kUsize;
+}
+
+const std::string& TypeId::str() const {
+    return TypeContext::global().str(*this);
+}
+
+std::string operator+(const std::string& lhs, const TypeId& rhs) {
+    return lhs + rhs.str();
+}
+
+std::string operator+(const TypeId& lhs, const std::string& rhs) {
+    return lhs.str() + rhs;
+}
+
+std::string operator+(const char* lhs, const TypeId& rhs) {
+    return lhs + rhs.str();
+}
+
+std::string operator+(const TypeId& lhs, const char* rhs) {
+    return lhs.str() + rhs;
+}
+
+std::ostream& operator<<(std::ostream& os, const TypeId& type) {
+    return os << type.str();
+}
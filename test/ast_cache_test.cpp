@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <filesystem>
+#include <unistd.h>
+#include "lexer/lexer.hpp"
+#include "parser/parser.hpp"
+#include "parser/ast_cache.hpp"
+#include "parser/walker.hpp"
+#include "test_util.hpp"
+
+// 按先序记录每个节点的种类与编号。待访问的节点放在堆上的栈里，深层的树也不会耗尽栈
+class Outline : public ASTWalker<Outline> {
+public:
+    std::vector<ASTNode*> pending;
+    std::vector<std::pair<NodeKind, NodeId>> nodes;
+
+    template <typename Node>
+    void visit(Node& node) {
+        nodes.emplace_back(node.kind, node.id);
+        size_t first = pending.size();
+        node.forEachChild([this](auto* child) {
+            if (child) pending.push_back(child);
+        });
+        std::reverse(pending.begin() + first, pending.end());
+    }
+
+    static std::vector<std::pair<NodeKind, NodeId>> of(Crate& crate) {
+        Outline outline;
+        outline.pending.push_back(&crate);
+        while (!outline.pending.empty()) {
+            ASTNode* node = outline.pending.back();
+            outline.pending.pop_back();
+            outline.walk(node);
+        }
+        return outline.nodes;
+    }
+};
+
+bool same(Crate& expected, Crate& actual, bool compare_dump = true) {
+    return expected.node_count == actual.node_count && expected.id == actual.id
+        && Outline::of(expected) == Outline::of(actual)
+        && (!compare_dump || dump(expected) == dump(actual));
+}
+
+double since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 在新进程中先驻留几个无关的名字，使缓存中名字的编号与驻留表对不上，再从缓存还原
+int loadInFreshProcess(const std::filesystem::path& directory, const std::string& file_path) {
+    Name("ast_cache_test_unrelated_a"), Name("ast_cache_test_unrelated_b");
+    auto source_file = std::make_shared<const SourceBuffer>(SourceFile::open(file_path));
+    std::string source(source_file->view());
+    ASTCache cache(directory);
+    auto loaded = cache.load(source);
+    Lexer lexer;
+    Parser parser(lexer.lex(source_file));
+    auto expected = parser.parseCrate();
+    if (!loaded || !same(*expected, *loaded)) {
+        std::cout << "Cached AST differs from the parse in a fresh process" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// AST 缓存测试：序列化后还原出的树（包括节点编号）与解析结果一致；缓存目录按源码内容命中，
+// 损坏的缓存文件当作未命中而不是崩溃
+int main(int argc, char* argv[]) {
+    if (argc == 4 && std::string(argv[1]) == "--fresh") {
+        return loadInFreshProcess(argv[2], argv[3]);
+    }
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <file.rx>" << std::endl;
+        return 1;
+    }
+
+    std::string file_path = argv[1];
+    if (!std::filesystem::exists(file_path)) {
+        std::cerr << "Error: Test file not found: " << file_path << std::endl;
+        return 1;
+    }
+
+    auto source_file = std::make_shared<const SourceBuffer>(SourceFile::open(file_path));
+    std::string source(source_file->view());
+    Lexer lexer;
+
+    auto start = std::chrono::steady_clock::now();
+    Parser parser(lexer.lex(source_file));
+    auto expected = parser.parseCrate();
+    double parse_time = since(start);
+
+    std::string bytes = serializeCrate(*expected, source);
+    std::cout << "Serialized: " << bytes.size() << " bytes for " << expected->node_count << " nodes" << std::endl;
+    if (!same(*expected, *deserializeCrate(bytes, source))) {
+        std::cout << "Deserialized AST differs from the parse" << std::endl;
+        return 1;
+    }
+
+    // 延迟解析的函数体在写入前解析出来
+    {
+        Parser lazy_parser(lexer.lex(source_file));
+        lazy_parser.setLazyBodies(true);
+        auto lazy = lazy_parser.parseCrate();
+        std::string lazy_bytes = serializeCrate(*lazy, source);
+        if (dump(*deserializeCrate(lazy_bytes, source)) != dump(*expected)) {
+            std::cout << "Lazily parsed bodies are missing from the cache" << std::endl;
+            return 1;
+        }
+    }
+
+    auto directory = std::filesystem::temp_directory_path() / ("ast_cache_test." + std::to_string(getpid()));
+    std::filesystem::remove_all(directory);
+    bool ok = true;
+    {
+        ASTCache cache(directory);
+        if (cache.load(source)) {
+            std::cout << "Hit in an empty cache" << std::endl;
+            ok = false;
+        }
+        cache.store(source, *expected);
+        start = std::chrono::steady_clock::now();
+        auto loaded = cache.load(source);
+        double load_time = since(start);
+        std::cout << "Parse: " << parse_time << " ms, load: " << load_time << " ms" << std::endl;
+        if (!loaded || !same(*expected, *loaded)) {
+            std::cout << "Cached AST differs from the parse" << std::endl;
+            ok = false;
+        }
+        if (cache.load(source + "\nfn extra() {}\n")) {
+            std::cout << "Hit for a different source" << std::endl;
+            ok = false;
+        }
+        std::string command = std::string(argv[0]) + " --fresh " + directory.string() + " " + file_path;
+        if (std::system(command.c_str()) != 0) ok = false;
+
+        // 截断与改写过的缓存文件都应当作未命中，也不会往驻留表中添加名字
+        size_t names = Interner::global().size(), literals = LiteralPool::global().size();
+        auto path = cache.pathFor(source);
+        size_t unusable = 0;
+        for (size_t length: {size_t(0), size_t(10), bytes.size() / 2, bytes.size() - 1}) {
+            std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), std::streamsize(length));
+            if (cache.load(source)) unusable = size_t(-1);
+            else ++unusable;
+        }
+        std::string stale = bytes;
+        stale[8] ^= 1; // 格式版本
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(stale.data(), std::streamsize(stale.size()));
+        if (cache.load(source)) unusable = size_t(-1);
+        // 其他构建写下的缓存
+        std::string foreign = bytes;
+        foreign[64] ^= 1;
+        try {
+            deserializeCrate(foreign, source);
+            unusable = size_t(-1);
+        } catch (const std::runtime_error& e) {
+            if (std::string(e.what()).find("different build") == std::string::npos) unusable = size_t(-1);
+        }
+        if (unusable != 4) {
+            std::cout << "Truncated or stale cache files are not rejected" << std::endl;
+            ok = false;
+        }
+        // 任意改写一个字节都应被校验和发现，而不是还原出另一棵树
+        size_t accepted = 0;
+        for (size_t position = 0; position < bytes.size(); position += std::max<size_t>(1, bytes.size() / 2000)) {
+            std::string corrupted = bytes;
+            corrupted[position] ^= 0x5a;
+            try {
+                deserializeCrate(corrupted, source);
+                ++accepted;
+            } catch (const std::runtime_error&) {
+            }
+        }
+        if (accepted) {
+            std::cout << accepted << " corrupted cache files were accepted" << std::endl;
+            ok = false;
+        }
+        std::string corrupted = bytes;
+        corrupted[bytes.size() / 2] ^= 0x5a;
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(corrupted.data(), std::streamsize(corrupted.size()));
+        if (cache.load(source)) {
+            std::cout << "A corrupted cache file was loaded" << std::endl;
+            ok = false;
+        }
+        if (Interner::global().size() != names || LiteralPool::global().size() != literals) {
+            std::cout << "Unusable cache files added names or literals" << std::endl;
+            ok = false;
+        }
+
+        const auto& stats = cache.stats();
+        std::cout << "Hits: " << stats.hits << ", misses: " << stats.misses << " (" << stats.invalid
+                  << " unusable), stores: " << stats.stores << std::endl;
+        if (stats.hits != 1 || stats.misses != 8 || stats.invalid != 6 || stats.stores != 1) {
+            std::cout << "Unexpected cache statistics" << std::endl;
+            ok = false;
+        }
+    }
+    std::filesystem::remove_all(directory);
+
+    // 10 万层嵌套的块：写入与还原都不随树的深度递归
+    {
+        std::string deep = "fn main() { ";
+        for (int i = 0; i < 100000; ++i) deep += "{ ";
+        deep += "1";
+        for (int i = 0; i < 100000; ++i) deep += " }";
+        deep += " }";
+        Parser deep_parser(lexer.lex(deep));
+        auto tree = deep_parser.parseCrate();
+        if (!same(*tree, *deserializeCrate(serializeCrate(*tree, deep), deep), false)) {
+            std::cout << "Deep tree differs after a round trip" << std::endl;
+            ok = false;
+        }
+    }
+
+    std::cout << (ok ? "OK" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <filesystem>
+#include "lexer/lexer.hpp"
+#include "parser/parser.hpp"
+#include "parser/astprinter.hpp"
+#include "parser/node_table.hpp"
+#include "parser/walker.hpp"
+
+// 统计全部节点：只写一个模板 visit，对每种节点计数后继续默认遍历
+class NodeCounter : public ASTWalker<NodeCounter> {
+public:
+    size_t count = 0;
+
+    template <typename Node>
+    void visit(Node& node) {
+        ++count;
+        walkChildren(node);
+    }
+};
+
+// 检查节点编号：每个编号都小于 node_count 且只出现一次
+class IdChecker : public ASTWalker<IdChecker> {
+public:
+    NodeTable<bool> seen;
+    bool dense = true;
+
+    explicit IdChecker(const Crate& crate) : seen(crate) {}
+
+    template <typename Node>
+    void visit(Node& node) {
+        if (node.id >= seen.size() || seen[node]) {
+            dense = false;
+            return;
+        }
+        seen[node] = true;
+        walkChildren(node);
+    }
+};
+
+// 只关心整数字面量，其余节点走默认遍历
+class IntegerCounter : public ASTWalker<IntegerCounter> {
+public:
+    using ASTWalker<IntegerCounter>::visit;
+
+    size_t count = 0;
+
+    void visit(IntegerLiteral&) { ++count; }
+};
+
+template <typename Function>
+double bestOf(int rounds, Function&& function) {
+    double best = 0;
+    for (int round = 0; round < rounds; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        auto end = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+        if (round == 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+// AST 遍历测试：检查默认遍历能到达每个节点，并给出各遍历的耗时
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <file.rx>" << std::endl;
+        return 1;
+    }
+
+    std::string file_path = argv[1];
+    if (!std::filesystem::exists(file_path)) {
+        std::cerr << "Error: Test file not found: " << file_path << std::endl;
+        return 1;
+    }
+
+    auto source = std::make_shared<const SourceBuffer>(SourceFile::open(file_path));
+    Lexer lexer;
+    Parser parser(lexer.lex(source));
+    auto root = parser.parseCrate();
+
+    // 除 Crate 外的节点都分配在 arena 中，且每个节点恰好被一个父节点引用
+    NodeCounter nodes;
+    nodes.visit(*root);
+    std::cout << "Nodes: " << nodes.count << std::endl;
+    if (nodes.count != root->arena->nodeCount() + 1) {
+        std::cout << "Walker reached " << nodes.count << " nodes, arena holds "
+                  << root->arena->nodeCount() << " plus the crate" << std::endl;
+        return 1;
+    }
+
+    IdChecker ids(*root);
+    ids.visit(*root);
+    if (!ids.dense || root->node_count != nodes.count) {
+        std::cout << "Node ids are not dense: " << root->node_count << " ids for " << nodes.count << " nodes" << std::endl;
+        return 1;
+    }
+
+    double walk_time = bestOf(20, [&] {
+        NodeCounter counter;
+        counter.visit(*root);
+    });
+    std::cout << "Walk: " << walk_time << " ms" << std::endl;
+
+    size_t integers = 0;
+    double integer_time = bestOf(20, [&] {
+        IntegerCounter counter;
+        counter.visit(*root);
+        integers = counter.count;
+    });
+    std::cout << "Integer literals: " << integers << ", " << integer_time << " ms" << std::endl;
+
+    double printer_time = bestOf(5, [&] {
+        std::ostringstream output;
+        ASTPrinter printer(output, false);
+        printer.visit(*root);
+    });
+    std::cout << "Printer: " << printer_time << " ms" << std::endl;
+    std::cout << "OK" << std::endl;
+    return 0;
+}
@@ -0,0 +1,233 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include "lexer/lexer.hpp"
+#include "lexer/simd_scan.hpp"
+
+bool sameTokens(const TokenStream& tokens, const TokenStream& expected) {
+    for (size_t i = 0; i < tokens.size() || i < expected.size(); ++i) {
+        if (i >= tokens.size() || i >= expected.size() || tokens.kind(i) != expected.kind(i)
+            || tokens.offset(i) != expected.offset(i) || tokens.length(i) != expected.length(i)) {
+            std::cout << "Mismatch at token " << i << ": ";
+            if (i < tokens.size()) std::cout << tokenToString(tokens.kind(i)) << " " << tokens.text(i);
+            std::cout << " vs ";
+            if (i < expected.size()) std::cout << tokenToString(expected.kind(i)) << " " << expected.text(i);
+            if (i < tokens.size()) {
+                auto [line, column] = tokens.location(i);
+                std::cout << " (line " << line << ", column " << column << ")";
+            }
+            std::cout << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// 字面量解码与字面量池去重
+bool checkLiteralDecoding() {
+    struct Case {
+        Token kind;
+        const char* text;
+        std::string expected;
+    } cases[] = {
+        {Token::kCharLiteral, "'a'", "a"},
+        {Token::kCharLiteral, "'\\n'", "\n"},
+        {Token::kCharLiteral, "'\\''", "'"},
+        {Token::kCharLiteral, "'\\x41'", "A"},
+        {Token::kStringLiteral, "\"a\\tb\\x7f\\0\"", std::string("a\tb\x7f\0", 5)},
+        {Token::kStringLiteral, "\"line \\\n    next\"", "line next"},
+        {Token::kStringLiteral, "\"suffix\"abc", "suffix"},
+        {Token::kCStringLiteral, "c\"c\\\\str\"", "c\\str"},
+        {Token::kRawStringLiteral, "r#\"raw \\n \"q\"\"#", "raw \\n \"q\""},
+        {Token::kRawStringLiteral, "r##\"a\"#b\"##", "a\"#b"},
+        {Token::kRawCStringLiteral, "cr#\"raw c\"#", "raw c"},
+    };
+    for (const auto& c: cases) {
+        std::string decoded = decodeTextLiteral(c.kind, c.text);
+        if (decoded != c.expected) {
+            std::cout << "Decoding " << c.text << " gave \"" << decoded << "\"" << std::endl;
+            return false;
+        }
+    }
+    auto tokens = Lexer().lex(std::string("\"hi\\n\" r#\"hi\n\"# \"hi\\x0a\" \"other\""));
+    if (tokens.literal(0) != tokens.literal(1) || tokens.literal(0) != tokens.literal(2)
+        || tokens.literal(0) == tokens.literal(3)) {
+        std::cout << "Literal pool does not deduplicate identical contents" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// UTF-8 校验与 Unicode 标识符
+bool checkUnicode() {
+    struct Case {
+        std::string text;
+        size_t expected;
+    } cases[] = {
+        {"plain ascii", 11},
+        {"caf\xc3\xa9 \xe4\xb8\xad \xf0\x9f\x98\x80", 14},
+        {"bad \xff", 4},
+        {"overlong \xc0\xaf", 9},
+        {"surrogate \xed\xa0\x80", 10},
+        {"too large \xf4\x90\x80\x80", 10},
+        {"truncated \xe4\xb8", 10},
+        {std::string(200, 'a') + "\x80", 200},
+    };
+    SimdLevel best = SimdScanner::detect();
+    for (int level = 0; level <= static_cast<int>(best); ++level) {
+        SimdScanner::setLevel(static_cast<SimdLevel>(level));
+        for (const auto& c: cases) {
+            size_t result = SimdScanner::validateUtf8(c.text.data(), 0, c.text.size());
+            if (result != c.expected) {
+                std::cout << "UTF-8 validation (" << simdLevelToString(SimdScanner::level()) << ") returned "
+                          << result << " instead of " << c.expected << std::endl;
+                return false;
+            }
+        }
+    }
+    auto tokens = Lexer().lex(std::string("let \xe5\x8f\x98\xe9\x87\x8f = caf\xc3\xa9_1 \xe2\x82\xac;"));
+    const char* expected[] = {"let", "\xe5\x8f\x98\xe9\x87\x8f", "=", "caf\xc3\xa9_1", ";", ""};
+    if (tokens.size() != std::size(expected)) {
+        std::cout << "Unicode identifiers: got " << tokens.size() << " tokens" << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (tokens.text(i) != expected[i]) {
+            std::cout << "Unicode identifiers: token " << i << " is " << tokens.text(i) << std::endl;
+            return false;
+        }
+    }
+    // 正则参考实现对 Unicode 标识符给出同样的结果，包括夹在其中的非 XID 字符与关键字
+    auto reference_source = std::make_shared<const SourceBuffer>(std::string(
+        "fn \xe5\x87\xbd\xe6\x95\xb0(caf\xc3\xa9: i32) -> \xce\xb1\xce\xb2 { let \xd0\xb6_1 = fn\xe2\x82\xac"
+        "x; \xe2\x82\xac\xe5\x8f\x98 \xf0\x9f\x98\x80" "a a\xcc\x81 \xcc\x81" "b r\xc3\xa9 \"s\"\xc3\xa9 1\xc3\xa9 }"));
+    if (!sameTokens(Lexer().lex(reference_source), Lexer().lexReference(reference_source))) {
+        std::cout << "Unicode identifiers differ from the reference lexer" << std::endl;
+        return false;
+    }
+    try {
+        Lexer().lex(std::string("let x = \"\xc3\";"));
+        std::cout << "Invalid UTF-8 was not rejected" << std::endl;
+        return false;
+    } catch (const std::runtime_error&) {
+    }
+    return true;
+}
+
+// 词法分析一致性测试：对比手写扫描器与正则参考实现的输出，并给出耗时
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <file.rx>" << std::endl;
+        return 1;
+    }
+
+    if (!checkLiteralDecoding() || !checkUnicode()) return 1;
+
+    std::string file_path = argv[1];
+    if (!std::filesystem::exists(file_path)) {
+        std::cerr << "Error: Test file not found: " << file_path << std::endl;
+        return 1;
+    }
+
+    auto source = std::make_shared<const SourceBuffer>(SourceFile::open(file_path));
+
+    Lexer lexer;
+    auto start = std::chrono::steady_clock::now();
+    auto expected = lexer.lexReference(source);
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "Tokens: " << expected.size() << std::endl;
+    std::cout << "Reference: " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+
+    // 依次在每个可用的指令集下运行扫描器，结果都应与参考实现一致
+    SimdLevel best = SimdScanner::detect();
+    for (int level = 0; level <= static_cast<int>(best); ++level) {
+        SimdScanner::setLevel(static_cast<SimdLevel>(level));
+        start = std::chrono::steady_clock::now();
+        auto tokens = lexer.lex(source);
+        end = std::chrono::steady_clock::now();
+        std::cout << "Scanner (" << simdLevelToString(SimdScanner::level()) << "): "
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+        if (!sameTokens(tokens, expected)) return 1;
+    }
+
+    // 分块并行扫描的拼接结果同样应与参考实现一致
+    for (size_t chunks: {2, 4, 16}) {
+        start = std::chrono::steady_clock::now();
+        auto tokens = lexer.lexParallel(source, chunks);
+        end = std::chrono::steady_clock::now();
+        std::cout << "Parallel (" << chunks << " chunks): "
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+        if (!sameTokens(tokens, expected)) return 1;
+    }
+    // 流式扫描：从环形队列依次读出的 token 应与参考实现一致
+    {
+        start = std::chrono::steady_clock::now();
+        TokenPipe pipe(source, 64);
+        TokenStream streamed(source);
+        RawToken buffer[32];
+        bool finished = false;
+        while (!finished) {
+            size_t count = pipe.read(buffer, 32);
+            for (size_t i = 0; i < count; ++i) {
+                streamed.push(buffer[i].kind, buffer[i].offset, buffer[i].length);
+                finished |= buffer[i].kind == Token::kEOF;
+            }
+        }
+        end = std::chrono::steady_clock::now();
+        std::cout << "Streaming: " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+        if (!sameTokens(streamed, expected)) return 1;
+    }
+
+    // 增量扫描：随机编辑后重扫，结果应与对编辑后全文重新扫描一致
+    const char* fragments[] = {"", " ", "\n", "x", "fn", "let a = 1;", "\"", "'", "'a'", "\\", "r#", "#", "\"#",
+                               "c\"", "cr#\"", "/*", "*/", "//", "0x1f_u32", "12usize", "{", "}", "=="};
+    std::mt19937 rng(20240521);
+    auto tokens = lexer.lex(source);
+    double relex_time = 0;
+    size_t relexed = 0;
+    const int edits = 500;
+    for (int round = 0; round < edits; ++round) {
+        size_t size = tokens.buffer().size();
+        TextEdit edit;
+        edit.begin = rng() % (size + 1);
+        edit.end = std::min(size, edit.begin + rng() % 16);
+        // 编辑的两端落在字符边界上，不把多字节字符切开
+        const std::string_view text = tokens.buffer().view();
+        while (edit.begin > 0 && edit.begin < size && (static_cast<unsigned char>(text[edit.begin]) & 0xC0) == 0x80) edit.begin--;
+        while (edit.end < size && (static_cast<unsigned char>(text[edit.end]) & 0xC0) == 0x80) edit.end++;
+        edit.text = fragments[rng() % std::size(fragments)];
+        start = std::chrono::steady_clock::now();
+        relexed += lexer.relex(tokens, edit);
+        end = std::chrono::steady_clock::now();
+        relex_time += std::chrono::duration<double, std::micro>(end - start).count();
+        auto full = lexer.lex(tokens.sharedBuffer());
+        if (!sameTokens(tokens, full)) {
+            std::cout << "Relex mismatch after edit " << round << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "Relex: " << relex_time / edits << " us/edit, " << double(relexed) / edits << " tokens/edit" << std::endl;
+
+    // 开头的 r#x 一直扫到文件末尾都没找到 #：之后不含 # 的编辑只需重扫编辑点附近，
+    // 插入 # 则从开头重扫，整段成为一个原始字符串
+    {
+        std::string text = "r#x ";
+        for (int k = 0; k < 2000; ++k) text += "let a" + std::to_string(k) + " = \"s\";\n";
+        auto marked = lexer.lex(text);
+        size_t middle = text.rfind("let", text.size() / 2);
+        size_t local = lexer.relex(marked, TextEdit{middle, middle, "y"});
+        if (local > 8 || !sameTokens(marked, lexer.lex(marked.sharedBuffer()))) {
+            std::cout << "Relex after r#x re-scanned " << local << " tokens" << std::endl;
+            return 1;
+        }
+        lexer.relex(marked, TextEdit{middle, middle, "#"});
+        if (marked.kind(0) != Token::kRawStringLiteral || !sameTokens(marked, lexer.lex(marked.sharedBuffer()))) {
+            std::cout << "Inserting # did not re-scan the r# at the start" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "OK" << std::endl;
+    return 0;
+}
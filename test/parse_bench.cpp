@@ -0,0 +1,109 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include "lexer/lexer.hpp"
+#include "parser/parser.hpp"
+#include "test_util.hpp"
+
+// 语法分析测试：并行解析的结果（包括节点编号）应与顺序解析完全一致，并给出耗时
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <file.rx>" << std::endl;
+        return 1;
+    }
+
+    std::string file_path = argv[1];
+    if (!std::filesystem::exists(file_path)) {
+        std::cerr << "Error: Test file not found: " << file_path << std::endl;
+        return 1;
+    }
+
+    auto source = std::make_shared<const SourceBuffer>(SourceFile::open(file_path));
+    Lexer lexer;
+    auto tokens = lexer.lex(source);
+    std::cout << "Tokens: " << tokens.size() << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    Parser sequential_parser{TokenStream(tokens)};
+    sequential_parser.setParallelThreshold(size_t(-1));
+    auto expected = sequential_parser.parseCrate();
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "Sequential: " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    std::string expected_dump = dump(*expected);
+    auto expected_ids = collectIds(*expected);
+
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads: {size_t(1), size_t(2), size_t(4), hardware}) {
+        Parser parser{TokenStream(tokens)};
+        start = std::chrono::steady_clock::now();
+        auto crate = parser.parseCrateParallel(threads);
+        end = std::chrono::steady_clock::now();
+        std::cout << "Parallel (" << threads << " threads): "
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+        if (crate->node_count != expected->node_count || collectIds(*crate) != expected_ids) {
+            std::cout << "Node ids differ from the sequential parse" << std::endl;
+            return 1;
+        }
+        if (dump(*crate) != expected_dump) {
+            std::cout << "AST differs from the sequential parse" << std::endl;
+            return 1;
+        }
+    }
+
+    // 延迟解析函数体：只解析签名，函数体全部解析出来之后与直接解析的结果一致
+    {
+        Parser parser{TokenStream(tokens)};
+        parser.setLazyBodies(true);
+        start = std::chrono::steady_clock::now();
+        auto crate = parser.parseCrate();
+        end = std::chrono::steady_clock::now();
+        std::cout << "Lazy (signatures only): "
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+        start = std::chrono::steady_clock::now();
+        crate->parseLazyBodies();
+        end = std::chrono::steady_clock::now();
+        std::cout << "Lazy (bodies): " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+        if (crate->node_count != expected->node_count || dump(*crate) != expected_dump) {
+            std::cout << "Lazily parsed AST differs from the eager parse" << std::endl;
+            return 1;
+        }
+    }
+    {
+        Parser parser(lexer.lex(std::string("fn ok() -> i32 { 1 }\nfn broken() { let x = ; }\n")));
+        parser.setLazyBodies(true);
+        auto crate = parser.parseCrate();
+        auto broken = cast<Function>(crate->items[1]->item);
+        bool thrown = false;
+        try {
+            broken->body();
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        if (!thrown || !cast<Function>(crate->items[0]->item)->body()) {
+            std::cout << "Lazy body errors are not reported on demand" << std::endl;
+            return 1;
+        }
+    }
+
+    // 解析失败时应回退为顺序解析，报出与之相同的错误
+    std::string broken = std::string(source->view()) + "\nfn broken() { let x = ; }\nfn after() {}\n";
+    std::string errors[2];
+    for (int parallel = 0; parallel < 2; ++parallel) {
+        Parser parser(lexer.lex(broken));
+        try {
+            if (parallel) parser.parseCrateParallel(4);
+            else parser.parseCrate();
+        } catch (const std::runtime_error& e) {
+            errors[parallel] = e.what();
+        }
+    }
+    if (errors[0].empty() || errors[0] != errors[1]) {
+        std::cout << "Parse errors differ: \"" << errors[0] << "\" vs \"" << errors[1] << "\"" << std::endl;
+        return 1;
+    }
+    std::cout << "OK" << std::endl;
+    return 0;
+}
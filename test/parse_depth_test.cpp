@@ -0,0 +1,163 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include "lexer/lexer.hpp"
+#include "parser/parser.hpp"
+#include "parser/walker.hpp"
+#include "test_util.hpp"
+
+// 统计节点数与树的深度。待访问的节点放在堆上的栈里，不随树的深度递归
+class DepthMeter : public ASTWalker<DepthMeter> {
+public:
+    std::vector<std::pair<ASTNode*, size_t>> pending;
+    size_t current = 0;
+    size_t deepest = 0;
+    size_t count = 0;
+
+    template <typename Node>
+    void visit(Node& node) {
+        ++count;
+        node.forEachChild([this](auto* child) {
+            if (child) pending.emplace_back(child, current + 1);
+        });
+    }
+
+    void measure(Crate& crate) {
+        pending.emplace_back(&crate, 1);
+        while (!pending.empty()) {
+            auto [node, depth] = pending.back();
+            pending.pop_back();
+            current = depth;
+            deepest = std::max(deepest, depth);
+            walk(node);
+        }
+    }
+};
+
+// 每种写法给出深度为 n 的程序。二元运算都按左结合解析（包括赋值），运算符链只是一棵
+// 向左延伸的深树，解析时并不嵌套
+struct Shape {
+    const char* name;
+    bool nests;
+    std::function<std::string(size_t)> source;
+};
+
+const std::vector<Shape> shapes = {
+    {"nested blocks", true, [](size_t n) {
+        return "fn main() { " + repeat("{ ", n) + "1" + repeat(" }", n) + " }";
+    }},
+    {"nested parentheses", true, [](size_t n) {
+        return "fn main() { let x: i32 = " + repeat("(", n) + "1" + repeat(")", n) + "; }";
+    }},
+    {"prefix operators", true, [](size_t n) {
+        return "fn main() { let x: i32 = " + repeat("- ! * & ", n / 4) + "x; }";
+    }},
+    {"operator chain", false, [](size_t n) {
+        return "fn main() { let x: i32 = 1" + repeat(" + 1", n) + "; }";
+    }},
+    {"assignment chain", false, [](size_t n) {
+        return "fn main() { " + repeat("x = ", n) + "1; }";
+    }},
+    {"nested ifs", true, [](size_t n) {
+        return "fn main() { " + repeat("if (x) { ", n) + "1" + repeat(" }", n) + " }";
+    }},
+    {"else-if chain", true, [](size_t n) {
+        return "fn main() { if (x) { 0 }" + repeat(" else if (x) { 1 }", n) + " else { 2 } }";
+    }},
+    {"nested loops", true, [](size_t n) {
+        return "fn main() { " + repeat("while (x) { loop { ", n / 2) + repeat("} } ", n / 2) + "}";
+    }},
+    {"mixed", true, [](size_t n) {
+        return "fn main() { let x: i32 = " + repeat("{ return (-", n / 3) + "1" + repeat(") }", n / 3) + "; }";
+    }},
+    {"nested calls", true, [](size_t n) {
+        return "fn main() { " + repeat("f(", n) + "1" + repeat(")", n) + "; }";
+    }},
+    {"nested method calls", true, [](size_t n) {
+        return "fn main() { " + repeat("x.f(0, ", n) + "1" + repeat(")", n) + "; }";
+    }},
+    {"nested indices", true, [](size_t n) {
+        return "fn main() { let x: i32 = " + repeat("a[", n) + "0" + repeat("]", n) + "; }";
+    }},
+    {"nested arrays", true, [](size_t n) {
+        return "fn main() { let x: i32 = " + repeat("[1, ", n / 2) + repeat("[0; ", n / 2) + "2"
+               + repeat("]", n / 2) + repeat(", 3]", n / 2) + "; }";
+    }},
+    {"nested struct fields", true, [](size_t n) {
+        return "fn main() { let x: S = " + repeat("S { a: 1, b: ", n) + "S {}" + repeat(" }", n) + "; }";
+    }},
+};
+
+double parseTime(const std::string& source, size_t& bytes, size_t& depth, size_t& nodes, bool& consistent) {
+    Lexer lexer;
+    double best = 0;
+    for (int round = 0; round < 3; ++round) {
+        Parser parser(lexer.lex(source));
+        auto start = std::chrono::steady_clock::now();
+        auto crate = parser.parseCrate();
+        auto end = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+        if (round == 0 || elapsed < best) best = elapsed;
+        bytes = crate->arena->bytesUsed();
+        DepthMeter meter;
+        meter.measure(*crate);
+        depth = meter.deepest;
+        nodes = meter.count;
+        consistent = meter.count == crate->arena->nodeCount() + 1 && meter.count == crate->node_count;
+    }
+    return best;
+}
+
+bool expectTooDeep(const std::string& source, size_t max_depth) {
+    Lexer lexer;
+    Parser parser(lexer.lex(source));
+    if (max_depth) parser.setMaxDepth(max_depth);
+    try {
+        parser.parseCrate();
+    } catch (const std::runtime_error& e) {
+        return std::string(e.what()).find("nested too deeply") != std::string::npos;
+    }
+    return false;
+}
+
+// 深层嵌套测试：10 万层的嵌套应能解析而不耗尽栈，耗时与 arena 用量随深度线性增长；
+// 超过深度上限时报出解析错误
+int main() {
+    const size_t depth = 100000;
+    bool ok = true;
+
+    for (const auto& shape: shapes) {
+        size_t small_bytes, small_depth, small_nodes, bytes, tree_depth, nodes;
+        bool small_consistent, consistent;
+        double small_time = parseTime(shape.source(depth / 4), small_bytes, small_depth, small_nodes, small_consistent);
+        double time = parseTime(shape.source(depth), bytes, tree_depth, nodes, consistent);
+        std::cout << shape.name << ": " << nodes << " nodes, depth " << tree_depth << ", "
+                  << time << " ms (" << small_time << " ms at a quarter of the depth)" << std::endl;
+        if (!small_consistent || !consistent) {
+            std::cout << "  nodes are missing from the tree" << std::endl;
+            ok = false;
+        }
+        if (tree_depth < depth / 4) {
+            std::cout << "  the tree is only " << tree_depth << " levels deep" << std::endl;
+            ok = false;
+        }
+        // 深度翻 4 倍，内存应约为 4 倍；平方级的耗时会是 16 倍，这里留出足够的余量
+        if (bytes > 5 * small_bytes || time > 10 * small_time + 5) {
+            std::cout << "  parsing does not scale linearly: " << small_bytes << " -> " << bytes << " bytes" << std::endl;
+            ok = false;
+        }
+    }
+
+    // 深度上限：默认上限足以容纳上面的输入，调低后同样的输入报错而不是崩溃
+    for (const auto& shape: shapes) {
+        if (!shape.nests) continue;
+        if (!expectTooDeep(shape.source(4000), 1000)) {
+            std::cout << shape.name << ": no error past a depth limit of 1000" << std::endl;
+            ok = false;
+        }
+    }
+    std::cout << (ok ? "OK" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "lexer/lexer.hpp"
+#include "parser/parser.hpp"
+#include "test_util.hpp"
+
+// 各种顶层项轮流出现，大小不一，预扫描要正确找出每个项的结尾
+std::string makeSource(int items) {
+    std::string source;
+    for (int i = 0; i < items; ++i) {
+        std::string n = std::to_string(i);
+        switch (i % 6) {
+            case 0:
+                source += "struct S" + n + " { a: i32, b: [u32; " + n + "], c: &S" + n + " }\n";
+                break;
+            case 1:
+                source += "enum E" + n + " { A, B, C }\n";
+                break;
+            case 2:
+                source += "const C" + n + ": usize = (" + n + " + 1) * 2;\n";
+                break;
+            case 3:
+                source += "trait T" + n + " { fn f(&self) -> i32; const K: i32 = " + n + "; }\n";
+                break;
+            case 4:
+                source += "impl S" + std::to_string(i - 4) + " { fn get(&self) -> i32 { self.a }"
+                          " fn set(&mut self, v: i32) { self.a = v; } }\n";
+                break;
+            default:
+                source += "fn f" + n + "(x: i32, y: &mut [i32; 3]) -> i32 {\n"
+                          "    let mut k: i32 = x;\n"
+                          "    while (k < " + n + ") { k += 1; if (k % 3 == 0) { continue; } else { y[0] = k; } }\n"
+                          "    let p: S0 = S0 { a: k, b: [0; 0], c: &p };\n"
+                          "    let v: i32 = loop { break { { k } + 1 }; };\n"
+                          "    { {} () }\n"
+                          "    if (x > 0) { f" + n + "(x - 1, y) } else { v }\n"
+                          "}\n";
+                break;
+        }
+    }
+    return source;
+}
+
+// 并行解析测试：阈值压到 0、用多个工作线程解析，结果（包括节点编号）应与顺序解析完全一致，
+// 并且确实走了并行路径而不是回退为顺序解析
+int main() {
+    bool ok = true;
+    Lexer lexer;
+    auto tokens = lexer.lex(makeSource(600));
+    std::cout << "Tokens: " << tokens.size() << std::endl;
+
+    Parser sequential_parser{TokenStream(tokens)};
+    sequential_parser.setParallelThreshold(size_t(-1));
+    auto expected = sequential_parser.parseCrate();
+    std::string expected_dump = dump(*expected);
+    auto expected_ids = collectIds(*expected);
+    if (sequential_parser.getParallelGroups() != 0) {
+        std::cout << "The sequential parse used the parallel path" << std::endl;
+        ok = false;
+    }
+
+    for (size_t threads: {size_t(2), size_t(3), size_t(4), size_t(8)}) {
+        Parser parser{TokenStream(tokens)};
+        parser.setParallelThreshold(0);
+        parser.setThreadCount(threads);
+        auto crate = parser.parseCrate();
+        std::cout << threads << " threads: " << parser.getParallelGroups() << " groups" << std::endl;
+        if (parser.getParallelGroups() < 2) {
+            std::cout << "  the parallel path was not taken" << std::endl;
+            ok = false;
+        }
+        if (crate->node_count != expected->node_count || collectIds(*crate) != expected_ids) {
+            std::cout << "  node ids differ from the sequential parse" << std::endl;
+            ok = false;
+        }
+        if (dump(*crate) != expected_dump) {
+            std::cout << "  AST differs from the sequential parse" << std::endl;
+            ok = false;
+        }
+    }
+
+    // 只有一个项时没有可分的组，并行路径也应给出同样的结果
+    {
+        auto single = lexer.lex(makeSource(1));
+        Parser parser{TokenStream(single)};
+        parser.setParallelThreshold(0);
+        parser.setThreadCount(4);
+        std::string parallel = dump(*parser.parseCrate());
+        Parser reference{TokenStream(single)};
+        reference.setParallelThreshold(size_t(-1));
+        if (parallel != dump(*reference.parseCrate())) {
+            std::cout << "A single item parses differently on the parallel path" << std::endl;
+            ok = false;
+        }
+    }
+
+    std::cout << (ok ? "OK" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include "lexer/lexer.hpp"
+#include "parser/parser.hpp"
+#include "parser/walker.hpp"
+#include "test_util.hpp"
+
+// 统计树中的 ErrorNode。待访问的节点放在堆上的栈里，不随树的深度递归
+class ErrorCounter : public ASTWalker<ErrorCounter> {
+public:
+    std::vector<ASTNode*> pending;
+    size_t errors = 0;
+
+    template <typename Node>
+    void visit(Node& node) {
+        if constexpr (std::is_same_v<Node, ErrorNode>) ++errors;
+        node.forEachChild([this](auto* child) {
+            if (child) pending.push_back(child);
+        });
+    }
+
+    static size_t of(Crate& crate) {
+        ErrorCounter counter;
+        counter.pending.push_back(&crate);
+        while (!counter.pending.empty()) {
+            ASTNode* node = counter.pending.back();
+            counter.pending.pop_back();
+            counter.walk(node);
+        }
+        return counter.errors;
+    }
+};
+
+// 不开恢复模式时抛出的错误信息；没有错误时为空。threads 大于 1 时按条目并行解析
+std::string firstError(const std::string& source, size_t threads = 1) {
+    Lexer lexer;
+    Parser parser(lexer.lex(source));
+    if (threads > 1) {
+        parser.setParallelThreshold(0);
+        parser.setThreadCount(threads);
+    }
+    try {
+        parser.parseCrate();
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+    return "";
+}
+
+struct Recovered {
+    std::shared_ptr<Crate> crate;
+    std::vector<ParseDiagnostic> diagnostics;
+    double time = 0;
+};
+
+Recovered recover(const std::string& source) {
+    Lexer lexer;
+    Parser parser(lexer.lex(source));
+    parser.setRecovery(true);
+    Recovered result;
+    auto start = std::chrono::steady_clock::now();
+    result.crate = parser.parseCrate();
+    result.time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    result.diagnostics = parser.getDiagnostics();
+    return result;
+}
+
+struct Broken {
+    const char* name;
+    std::string source;
+    size_t errors; // 应报告的错误数
+};
+
+const std::vector<Broken> broken = {
+    {"statements", "fn main() { let x: i32 = ; let y: i32 = 1; y = * ; exit(0); }", 2},
+    {"items", "fn f( { } struct S { a: } fn main() { exit(0); } enum { }", 3},
+    {"statements and items", "fn main() { let = 1; } fn g() -> { } fn h() { x + ; }", 3},
+    {"mismatched delimiters", "fn main() { let x: i32 = (1 + 2]; f(1, 2]; let y: i32 = 3; }", 2},
+    {"stray closers", "fn main() { ) ; let x: i32 = 1; ] ; } } fn g() { }", 3},
+    {"nested blocks", "fn main() { if (x) { let a: i32 = ; } else { 1 + ; } loop { let = ; } }", 3},
+    {"unterminated block", "fn main() { let x: i32 = 1; if (x) { let y: i32 = ;", 2},
+    {"end of input", "fn main() { let x: i32 = ", 1},
+};
+
+// 错误恢复测试：恢复模式下第一条诊断与普通模式抛出的错误一致，正确的程序不受影响，一次
+// 解析报告出所有互不相关的错误，并且耗时随错误数线性增长
+int main() {
+    bool ok = true;
+
+    const std::vector<std::string> clean = {
+        "fn main() { let x: i32 = 1; if (x > 0) { x = x + 1; } else { exit(1); } exit(0); }",
+        "struct P { x: i32, y: i32 } impl P { fn sum(&self) -> i32 { self.x + self.y } }\n"
+        "enum E { A, B } const N: usize = 3; fn main() { let a: [i32; 3] = [1, 2, 3]; "
+        "let mut i: usize = 0; while (i < N) { i += 1; } loop { break; } { if (a) { 1 } else { 2 } + 3 }; }",
+    };
+    for (const auto& source: clean) {
+        Lexer lexer;
+        Parser parser(lexer.lex(source));
+        auto expected = parser.parseCrate();
+        auto result = recover(source);
+        if (!result.diagnostics.empty() || dump(*expected) != dump(*result.crate)
+            || expected->node_count != result.crate->node_count) {
+            std::cout << "Recovery mode changes a program without errors" << std::endl;
+            ok = false;
+        }
+    }
+
+    for (const auto& test: broken) {
+        std::string first = firstError(test.source);
+        auto result = recover(test.source);
+        size_t errors = ErrorCounter::of(*result.crate);
+        std::cout << test.name << ": " << result.diagnostics.size() << " errors" << std::endl;
+        for (const auto& diagnostic: result.diagnostics) {
+            std::cout << "  " << diagnostic.message << std::endl;
+        }
+        if (result.diagnostics.empty() || result.diagnostics.front().message != first) {
+            std::cout << "  the first error differs from the one thrown without recovery: " << first << std::endl;
+            ok = false;
+        }
+        if (result.diagnostics.size() != test.errors) {
+            std::cout << "  expected " << test.errors << " errors" << std::endl;
+            ok = false;
+        }
+        // 同一处的错误只报告一次，但每条诊断在树中都有对应的 ErrorNode
+        if (errors < result.diagnostics.size()) {
+            std::cout << "  the tree has " << errors << " error nodes" << std::endl;
+            ok = false;
+        }
+    }
+
+    // 并行解析时多个线程同时遇到错误并查询位置，报告的错误应与顺序解析相同
+    std::string items;
+    for (size_t i = 0; i < 64; ++i) {
+        items += "fn f" + std::to_string(i) + "() {\n    let x: i32 = " + (i % 8 == 3 ? "; }\n" : "1; }\n");
+        items += "struct S" + std::to_string(i) + " { a: " + (i % 8 == 5 ? "}\n" : "i32 }\n");
+    }
+    std::string sequential = firstError(items), parallel = firstError(items, 8);
+    std::cout << "parallel: " << parallel << std::endl;
+    if (sequential.empty() || parallel != sequential) {
+        std::cout << "  the parallel parse reports a different error: " << sequential << std::endl;
+        ok = false;
+    }
+
+    // 错误数翻 4 倍，耗时应约为 4 倍
+    const std::vector<std::pair<const char*, std::function<std::string(size_t)>>> scaling = {
+        {"broken statements", [](size_t n) {
+            return "fn main() { " + repeat("let x: i32 = ; f(1, ]; ", n) + "}";
+        }},
+        {"broken items", [](size_t n) {
+            return repeat("fn f( { ( } struct S { a: } ", n) + "fn main() { }";
+        }},
+        {"unclosed blocks", [](size_t n) {
+            return "fn main() { " + repeat("{ let x = ; ", n);
+        }},
+    };
+    const size_t count = 40000;
+    for (const auto& [name, source]: scaling) {
+        auto small = recover(source(count / 4));
+        auto large = recover(source(count));
+        std::cout << name << ": " << large.diagnostics.size() << " errors in " << large.time << " ms ("
+                  << small.time << " ms for a quarter of them)" << std::endl;
+        if (large.diagnostics.size() < count) {
+            std::cout << "  errors are missing" << std::endl;
+            ok = false;
+        }
+        if (large.time > 10 * small.time + 5) {
+            std::cout << "  recovery does not scale linearly" << std::endl;
+            ok = false;
+        }
+    }
+
+    std::cout << (ok ? "OK" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lexer/lexer.hpp"
+#include "parser/parser.hpp"
+#include "test_util.hpp"
+
+// 解析 source；出错时返回以 "ERR " 开头的错误信息。reparses 非空时记下块体重新解析的次数
+std::string parse(const std::string& source, bool recovery = false, size_t* reparses = nullptr) {
+    Lexer lexer;
+    Parser parser(lexer.lex(source));
+    parser.setRecovery(recovery);
+    try {
+        auto crate = parser.parseCrate();
+        if (reparses) *reparses = parser.getReparseCount();
+        if (!parser.getDiagnostics().empty()) return "ERR " + parser.getDiagnostics().front().message;
+        return dump(*crate);
+    } catch (const std::runtime_error& e) {
+        return std::string("ERR ") + e.what();
+    }
+}
+
+struct Accepted {
+    const char* source;
+    // 解析结果中应出现的一行（去掉缩进）
+    const char* expected;
+};
+
+// 原先的递归下降解析器接受的写法：语句中途出错时，整个块体重新当作一个表达式解析。
+// 现在由块、if 或循环语句之后的 token 直接决定，不再重新解析
+const std::vector<Accepted> accepted = {
+    {"fn y() { { while (1) { } () } }", "CallExpression"},
+    {"fn y() { {} (a, b) }", "CallExpression"},
+    {"fn y() { {} (a) }", "GroupedExpression"},
+    {"fn y() { if (a) { } [1] }", "ArrayExpression"},
+    {"fn y() { { {1} as i32 } }", "TypeCastExpression as"},
+    {"fn y() { if (a) { 1 } else { 2 } + 3 }", "BinaryExpression +"},
+    {"fn y() { loop { }.f(); }", "MethodCallExpression"},
+    {"fn y() { { {} () } }", "CallExpression"},
+    {"fn y() { { if (a) { } () } }", "CallExpression"},
+    {"fn y() { {} () }", "CallExpression"},
+    {"fn y() { if (a) { } else { } () }", "CallExpression"},
+    {"fn y() { let x: i32 = { {} () }; x }", "CallExpression"},
+    // 条件带括号，其中的结构体表达式不会与块混淆
+    {"fn f() { while (b { x: 1 }) {} }", "StructExpression"},
+    {"fn f() { if (b { x: 1 }) {} }", "StructExpression"},
+    {"fn f() { if (a) { } else if (S { x: 1, y: 2 }) { } }", "StructExpression"},
+};
+
+bool contains(const std::string& tree, const std::string& line) {
+    std::istringstream lines(tree);
+    std::string current;
+    while (std::getline(lines, current)) {
+        if (current.substr(current.find_first_not_of(' ')) == line) return true;
+    }
+    return false;
+}
+
+// 解析器回归测试：原先能解析的写法仍能解析，恢复模式下的结果与普通模式相同
+int main() {
+    bool ok = true;
+
+    for (const auto& test: accepted) {
+        size_t reparses = 0;
+        std::string tree = parse(test.source, false, &reparses);
+        if (tree.rfind("ERR ", 0) == 0 || !contains(tree, test.expected)) {
+            std::cout << test.source << ": " << tree.substr(0, tree.find('\n')) << std::endl;
+            ok = false;
+            continue;
+        }
+        if (reparses != 0) {
+            std::cout << test.source << ": the block body was parsed again" << std::endl;
+            ok = false;
+        }
+        if (parse(test.source, true) != tree) {
+            std::cout << test.source << ": recovery mode parses it differently" << std::endl;
+            ok = false;
+        }
+    }
+
+    // 块体重新解析仍然失败时，报告的是最先遇到的错误
+    std::string error = parse("fn y() { { {} () x } }");
+    std::string recovered = parse("fn y() { { {} () x } }", true);
+    std::cout << "still broken: " << error << std::endl;
+    if (error.rfind("ERR ", 0) != 0 || recovered != error) {
+        std::cout << "  recovery mode reports " << recovered << std::endl;
+        ok = false;
+    }
+
+    std::cout << (ok ? "OK" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -1,5 +1,4 @@
 #include <iostream>
-#include <fstream>
 #include <string>
 #include <filesystem>
 #include "lexer/lexer.hpp"
@@ -26,23 +25,18 @@ int main(int argc, char* argv[]) {
     }
 
     // 读取文件内容
-    std::ifstream file(file_path);
-    if (!file.is_open()) {
+    std::shared_ptr<const SourceBuffer> source;
+    try {
+        source = std::make_shared<const SourceBuffer>(SourceFile::open(file_path));
+    } catch (const std::exception& e) {
         std::cerr << "错误: 无法打开文件: " << file_path << std::endl;
         return -1;
     }
 
-    std::string source_code;
-    std::string line;
-    while (std::getline(file, line)) {
-        source_code += line + "\n";
-    }
-    file.close();
-
     try {
         // 词法分析
         Lexer lexer;
-        auto tokens = lexer.lex(source_code);
+        auto tokens = lexer.lex(source);
         
         // 语法分析
         Parser parser(std::move(tokens));
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include "parser/astprinter.hpp"
+#include "parser/walker.hpp"
+
+// 各个解析测试与基准共用的辅助函数
+
+// 不带颜色的树形输出，用于比较两次解析的结果
+inline std::string dump(Crate& crate) {
+    std::ostringstream output;
+    ASTPrinter printer(output, false);
+    printer.visit(crate);
+    return output.str();
+}
+
+// 按先序记录每个节点的编号
+class IdCollector : public ASTWalker<IdCollector> {
+public:
+    std::vector<NodeId> ids;
+
+    template <typename Node>
+    void visit(Node& node) {
+        ids.push_back(node.id);
+        walkChildren(node);
+    }
+};
+
+inline std::vector<NodeId> collectIds(Crate& crate) {
+    IdCollector collector;
+    collector.visit(crate);
+    return collector.ids;
+}
+
+// 把 text 重复 times 次，用于生成深层嵌套或大量出错的输入
+inline std::string repeat(const std::string& text, size_t times) {
+    std::string result;
+    result.reserve(text.size() * times);
+    for (size_t i = 0; i < times; ++i) result += text;
+    return result;
+}
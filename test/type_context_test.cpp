@@ -0,0 +1,88 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "semantic/type_context.hpp"
+
+bool ok = true;
+
+void expect(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cout << "  failed: " << what << std::endl;
+        ok = false;
+    }
+}
+
+void expectSpelling(TypeId type, const std::string& spelling) {
+    expect(type.str() == spelling, "spelled " + type.str() + ", expected " + spelling);
+}
+
+// 类型表测试：结构相同的类型编号相同，写法与原先的字符串表示一致
+int main() {
+    auto& types = TypeContext::global();
+
+    // 内建类型名得到编译期常量对应的内建类型
+    expect(types.named(Name("i32")) == types::kI32, "i32 is a builtin");
+    expect(types.named(Name("()")) == types::kUnit, "() is the unit type");
+    expect(types.named(Name("!")) == types::kNever, "! is the never type");
+    expect(types.kind(types::kString) == TypeKind::kPrimitive, "String is primitive");
+    expect(types.kind(types::kUnit) == TypeKind::kUnit, "unit kind");
+    expect(TypeId().empty() && TypeId().str().empty(), "the empty type is spelled as an empty string");
+
+    TypeId point = types.named(Name("Point"));
+    expect(types.kind(point) == TypeKind::kNamed && types.name(point).str() == "Point", "struct types are named");
+    expect(types.named(Name("Point")) == point, "named types are interned");
+
+    // 结构体与枚举按声明区分；符号只用作区分，不会被解引用
+    char declarations[2];
+    auto outer_point = reinterpret_cast<const Symbol*>(&declarations[0]);
+    auto inner_point = reinterpret_cast<const Symbol*>(&declarations[1]);
+    TypeId declared = types.named(Name("Point"), outer_point);
+    expect(types.named(Name("Point"), outer_point) == declared, "declared types are interned");
+    expect(types.named(Name("Point"), inner_point) != declared, "same name, different declaration");
+    expect(declared != point, "a declared type differs from an undeclared name");
+    expect(types.name(declared).str() == "Point" && types.kind(declared) == TypeKind::kNamed, "declared types are named");
+    expectSpelling(declared, "Point");
+    expect(types.named(Name("u32"), outer_point) == types::kU32, "builtin names stay builtin");
+
+    // 数组与引用按结构查重
+    TypeId inner = types.array(types::kI32, 3);
+    TypeId outer = types.array(inner, 5);
+    expect(types.array(types.array(types::kI32, 3), 5) == outer, "arrays are interned");
+    expect(types.array(types::kI32, 4) != inner, "length is part of an array type");
+    expect(types.array(types::kI32) != inner, "an unknown length differs from a known one");
+    expect(types.element(outer) == inner && types.length(outer) == 5, "array parts");
+    expect(types.innermost(outer) == types::kI32, "innermost element");
+    expectSpelling(outer, "[[i32]3]5");
+    expectSpelling(types.array(types::kU32), "[u32]");
+
+    TypeId ref = types.reference(outer);
+    expect(types.reference(outer) == ref, "references are interned");
+    expect(types.dereference(ref) == outer && types.dereference(outer) == outer, "dereference strips one level");
+    expectSpelling(ref, "&[[i32]3]5");
+    expectSpelling(types.reference(types.reference(types::kStr)), "&&str");
+    expectSpelling(types.reference(point), "&Point");
+    expectSpelling(types.array(types.reference(types::kBool), 2), "[&bool]2");
+
+    expect(types.isInteger(types::kInteger) && types.isInteger(types::kUsize), "integer types");
+    expect(!types.isInteger(types::kBool) && !types.isInteger(inner), "non-integer types");
+
+    // 再次构造同样的类型不会新增表项
+    const int count = 100000;
+    auto build = [&](int i) {
+        return types.reference(types.array(types.array(types::kUsize, i % 97), i));
+    };
+    std::vector<TypeId> first;
+    for (int i = 0; i < count; ++i) first.push_back(build(i));
+    size_t size = types.size();
+    for (int i = 0; i < count; ++i) {
+        if (build(i) != first[i]) {
+            expect(false, "type " + std::to_string(i) + " changed its id");
+            break;
+        }
+    }
+    expect(types.size() == size, "building the same types again adds no entries");
+    std::cout << types.size() << " types" << std::endl;
+
+    std::cout << (ok ? "OK" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}